@@ -143,13 +143,15 @@ HRESULT ArrayGLSLType::GetArraySize(__out int* pArraySize) const
 //
 //  Function:   IsEqualType
 //
-//  Synopsis:   Test equality of two types
+//  Synopsis:   Test equality of two types. Array types from the same type
+//              table are equal exactly when they are the same object, but
+//              types created outside of one need the full comparison.
 //
 //-----------------------------------------------------------------------------
 bool ArrayGLSLType::IsEqualType(__in const GLSLType* pOther) const
 {
-    bool fEqual = false;
-    if (pOther->IsArrayType())
+    bool fEqual = (this == pOther);
+    if (!fEqual && pOther->IsArrayType())
     {
         const ArrayGLSLType* pOtherArray = pOther->AsArrayType();
         if (_arraySize == pOtherArray->GetArraySize())
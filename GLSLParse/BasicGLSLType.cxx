@@ -123,18 +123,15 @@ HRESULT BasicGLSLType::GetBasicType(__out int* pBasicType) const
 //
 //  Function:   IsEqualType
 //
-//  Synopsis:   Test equality of two types
+//  Synopsis:   Test equality of two types. There is only one object for
+//              each basic type, so equal types are the same object.
 //
 //-----------------------------------------------------------------------------
 bool BasicGLSLType::IsEqualType(__in const GLSLType* pOther) const
 {
-    bool fEqual = false;
-    if (pOther->IsBasicType())
-    {
-        fEqual = (_basicType == pOther->AsBasicType()->GetBasicType());
-    }
+    Assert((this == pOther) == (pOther->IsBasicType() && _basicType == pOther->AsBasicType()->GetBasicType()));
 
-    return fEqual;
+    return (this == pOther);
 }
 
 //+----------------------------------------------------------------------------
@@ -35,6 +35,8 @@
 //  Synopsis:   Object to represent a GLSL type.
 //
 //              Basic types are the built in types (like float, vec2, etc).
+//              There is one immutable object per type, shared by the whole
+//              process, which CGLSLTypeTable hands out.
 //
 //------------------------------------------------------------------------------
 class BasicGLSLType : public GLSLType
@@ -600,7 +600,7 @@ HRESULT BinaryOperatorNode::OutputHLSLForBasicTypes(__in IStringStream* pOutput)
             // we need to use all() to convert it into a boolean.
             if (_fWrapInAll)
             {
-                CHK(pOutput->WriteString("all("));
+                CHK(pOutput->WriteLiteral("all("));
             }
 
             // We might need to write children out in expanded form
@@ -631,20 +631,20 @@ HRESULT BinaryOperatorNode::OutputHLSLForBasicTypes(__in IStringStream* pOutput)
             // we need to encode that too.
             CHK(pOutput->WriteChar('('));
             CHK(GetChild(0)->OutputHLSL(pOutput));
-            CHK(pOutput->WriteString("=mul("));
+            CHK(pOutput->WriteLiteral("=mul("));
             CHK(GetChild(1)->OutputHLSL(pOutput));
             CHK(pOutput->WriteChar(','));
             CHK(GetChild(0)->OutputHLSL(pOutput));
-            CHK(pOutput->WriteString("))"));
+            CHK(pOutput->WriteLiteral("))"));
         }
         else
         {
             // Use the mul function in HLSL
-            CHK(pOutput->WriteString("mul("));
+            CHK(pOutput->WriteLiteral("mul("));
             CHK(GetChild(1)->OutputHLSL(pOutput));
-            CHK(pOutput->WriteString(","));
+            CHK(pOutput->WriteLiteral(","));
             CHK(GetChild(0)->OutputHLSL(pOutput));
-            CHK(pOutput->WriteString(")"));        
+            CHK(pOutput->WriteLiteral(")"));        
         }
     }
 
@@ -745,17 +745,23 @@ HRESULT BinaryOperatorNode::IsConstExpression(
                 {
                     CHK(EvaluateConstant<double>(value0, value1, FLOAT_TOK, pValue));
                 }
+                else if (IsComponentwiseConstant(value0, value1))
+                {
+                    CHK(EvaluateComponentwiseConstant(value0, value1, pValue));
+                }
                 else
                 {
                     // We have a constant expression, and we are expected to return a value. Since
                     // we currently do not have constant values implemented for things that are not
-                    // int or float, we cannot make this work.
+                    // made up of ints or floats, we cannot make this work.
                     //
                     // Right now you can hit this easily by initializing an int or a float to an
                     // expression that has two booleans.
                     //
                     // Our assumption is that if you hit this, you are going to be dealing
                     // with an incompatible type error anyway.
+                    CHKB(!GetParser()->IsFoldingConstants());
+
                     CHK(GetParser()->LogError(&_location, E_GLSLERROR_INCOMPATIBLETYPES, nullptr));
                     CHK(E_GLSLERROR_KNOWNERROR);            
                 }
@@ -856,6 +862,10 @@ HRESULT BinaryOperatorNode::EvaluateExpression(
         // No divide by zero and avoid integer overflow for the signed value special case.
         if (rConst == 0 || (lConst == INT_MIN && rConst == -1))
         {
+            // Expressions being folded were never required to be constant, so
+            // this is not an error in the shader - just one we cannot fold.
+            CHKB(!GetParser()->IsFoldingConstants());
+
             CHK(GetParser()->LogError(&_location, E_GLSLERROR_DIVIDEORMODBYZERO, nullptr));
             CHK(E_GLSLERROR_KNOWNERROR);
         }
@@ -872,6 +882,8 @@ HRESULT BinaryOperatorNode::EvaluateExpression(
         break;
 
     default:
+        CHKB(!GetParser()->IsFoldingConstants());
+
         CHK(GetParser()->LogError(&_location, E_GLSLERROR_INCOMPATIBLETYPES, nullptr));
         CHK(E_GLSLERROR_KNOWNERROR);
         break;
@@ -912,6 +924,117 @@ HRESULT BinaryOperatorNode::EvaluateConstant(
     CHK_RETURN;
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   IsComponentwiseConstant
+//
+//  Synopsis:   Determine if the operands are vectors or matrices (or a scalar
+//              with one of those) that have the same component type. These
+//              are calculated a component at a time.
+//
+//-----------------------------------------------------------------------------
+bool BinaryOperatorNode::IsComponentwiseConstant(
+    const ConstantValue& left,                          // Left side of expression
+    const ConstantValue& right                          // Right side of expression
+    )
+{
+    int lComponentType, rComponentType;
+    return (
+        SUCCEEDED(left.GetComponentType(&lComponentType)) &&
+        SUCCEEDED(right.GetComponentType(&rComponentType)) &&
+        lComponentType == rComponentType &&
+        lComponentType != BOOL_TOK
+        );
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   EvaluateComponentwiseConstant
+//
+//  Synopsis:   Evaluate an expression on vectors and matrices a component at
+//              a time. A scalar on either side is used with every component
+//              of the other side.
+//
+//              Multiplies involving a matrix that are not by a scalar are
+//              algebraic, and only the type is calculated for those.
+//
+//-----------------------------------------------------------------------------
+HRESULT BinaryOperatorNode::EvaluateComponentwiseConstant(
+    const ConstantValue& left,                          // Left side of expression
+    const ConstantValue& right,                         // Right side of expression
+    __out ConstantValue* pValue                         // The value being calculated
+    ) const
+{
+    CHK_START;
+
+    TSmartPointer<GLSLType> spType;
+    CHK(GetExpressionType(&spType));
+
+    int resultType;
+    CHK(spType->GetBasicType(&resultType));
+
+    int lType, rType;
+    CHK(left.GetBasicType(&lType));
+    CHK(right.GetBasicType(&rType));
+
+    // Matrix multiplies that are not by a scalar are not done a component at a time
+    const bool fAlgebraicMultiply = (
+        _pInfo->_op == STAR &&
+        (TypeHelpers::IsMatrixType(lType) || TypeHelpers::IsMatrixType(rType)) &&
+        !TypeHelpers::IsNumericScalarType(lType) &&
+        !TypeHelpers::IsNumericScalarType(rType)
+        );
+
+    const bool fArithmetic = (
+        _pInfo->_op == STAR ||
+        _pInfo->_op == SLASH ||
+        _pInfo->_op == PLUS ||
+        _pInfo->_op == DASH
+        );
+
+    int componentType;
+    if (
+        fAlgebraicMultiply ||
+        !fArithmetic ||
+        !left.HasValue() ||
+        !right.HasValue() ||
+        FAILED(TypeHelpers::GetComponentType(resultType, &componentType)) ||
+        componentType == BOOL_TOK
+        )
+    {
+        // We know what type the result is, just not what its value is
+        pValue->SetTypeOnly(resultType);
+    }
+    else
+    {
+        ConstantValue result;
+        CHK(result.InitializeComponents(resultType));
+
+        for (UINT i = 0; i < result.GetComponentCount(); i++)
+        {
+            ConstantValue lComponent, rComponent;
+            CHK(left.GetComponent(left.GetComponentCount() == 1 ? 0 : i, &lComponent));
+            CHK(right.GetComponent(right.GetComponentCount() == 1 ? 0 : i, &rComponent));
+
+            ConstantValue calcComponent;
+            if (componentType == INT_TOK)
+            {
+                CHK(EvaluateConstant<int>(lComponent, rComponent, INT_TOK, &calcComponent));
+            }
+            else
+            {
+                CHK(EvaluateConstant<double>(lComponent, rComponent, FLOAT_TOK, &calcComponent));
+            }
+
+            CHK(result.SetComponent(i, calcComponent));
+        }
+
+        (*pValue) = result;
+    }
+
+    CHK_RETURN;
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   VerifyLValue
@@ -115,6 +115,17 @@ private:
         __out ConstantValue* pValue                         // The value being calculated
         ) const;
 
+    static bool IsComponentwiseConstant(
+        const ConstantValue& left,                          // Left side of expression
+        const ConstantValue& right                          // Right side of expression
+        );
+
+    HRESULT EvaluateComponentwiseConstant(
+        const ConstantValue& left,                          // Left side of expression
+        const ConstantValue& right,                         // Right side of expression
+        __out ConstantValue* pValue                         // The value being calculated
+        ) const;
+
     HRESULT VerifyOperatorForStructTypes(__in GLSLType* pLType, __in GLSLType* pRType);
     HRESULT VerifyOperatorForBasicTypes(__in GLSLType* pLType, __in GLSLType* pRType);
 
@@ -66,7 +66,7 @@ HRESULT BreakStatementNode::Initialize(
 //-----------------------------------------------------------------------------
 HRESULT BreakStatementNode::OutputHLSL(__in IStringStream* pOutput)
 {
-    return pOutput->WriteString("break;\n");
+    return pOutput->WriteLiteral("break;\n");
 }
 
 //+----------------------------------------------------------------------------
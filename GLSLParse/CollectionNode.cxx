@@ -212,6 +212,116 @@ HRESULT CollectionNode::InsertChild(__in ParseTreeNode* pChild, UINT uIndex)
     CHK_RETURN;
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   InsertEmptyChildren
+//
+//  Synopsis:   Opens up a run of null children at the specified index, so
+//              that a caller inserting several children only shifts the
+//              children after them once. The slots are filled in with
+//              SetEmptyChild, and the ones left over are moved along with
+//              MoveEmptyChildren or taken out with RemoveEmptyChildren.
+//
+//-----------------------------------------------------------------------------
+HRESULT CollectionNode::InsertEmptyChildren(UINT uIndex, UINT cChildren)
+{
+    CHK_START;
+
+    UINT cOriginal = _aryChildren.GetCount();
+    Assert(uIndex <= cOriginal);
+
+    CHK(_aryChildren.Resize(cOriginal + cChildren));
+
+    // Swap the children after the index into the new null entries at the end,
+    // which leaves the null entries at the index.
+    for (UINT i = cOriginal; i > uIndex; i--)
+    {
+        _aryChildren[i - 1].Swap(_aryChildren[i - 1 + cChildren]);
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   MoveEmptyChildren
+//
+//  Synopsis:   Moves a run of null children later in the collection, so that
+//              it starts at uNewIndex. The children between the old and new
+//              positions shift down to fill in behind it.
+//
+//-----------------------------------------------------------------------------
+HRESULT CollectionNode::MoveEmptyChildren(UINT uIndex, UINT cChildren, UINT uNewIndex)
+{
+    CHK_START;
+
+    CHKB(uIndex <= uNewIndex);
+    CHKB(uNewIndex + cChildren <= _aryChildren.GetCount());
+
+    for (UINT i = uIndex; i < uNewIndex; i++)
+    {
+        Assert(_aryChildren[i] == nullptr);
+        _aryChildren[i].Swap(_aryChildren[i + cChildren]);
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   RemoveEmptyChildren
+//
+//  Synopsis:   Takes a run of null children out of the collection, shifting
+//              the children after it down once.
+//
+//-----------------------------------------------------------------------------
+HRESULT CollectionNode::RemoveEmptyChildren(UINT uIndex, UINT cChildren)
+{
+    CHK_START;
+
+    UINT cOriginal = _aryChildren.GetCount();
+    CHKB(uIndex + cChildren <= cOriginal);
+
+    for (UINT i = uIndex + cChildren; i < cOriginal; i++)
+    {
+        Assert(_aryChildren[i - cChildren] == nullptr);
+        _aryChildren[i - cChildren].Swap(_aryChildren[i]);
+    }
+
+    CHK(_aryChildren.Resize(cOriginal - cChildren));
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   SetEmptyChild
+//
+//  Synopsis:   Fills in a null child slot (see InsertEmptyChildren). This
+//              node takes ownership of the passed child and is responsible
+//              for deleting it.
+//
+//              This is also a mechanism where the parent of a node is set.
+//
+//-----------------------------------------------------------------------------
+HRESULT CollectionNode::SetEmptyChild(UINT uIndex, __in ParseTreeNode* pChild)
+{
+    CHK_START;
+
+    CHKB(uIndex < _aryChildren.GetCount());
+    CHKB(_aryChildren[uIndex] == nullptr);
+
+    _aryChildren[uIndex] = pChild;
+
+    pChild->SetParent(this);
+    if (pChild->IsVerified())
+    {
+        pChild->SetMovedAfterVerified();
+    }
+
+    CHK_RETURN;
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   InsertBefore
@@ -255,6 +365,43 @@ HRESULT CollectionNode::GetChildIndex(__in ParseTreeNode* pChild, __out UINT* pu
     CHK_RETURN;
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetChildIndex
+//
+//  Synopsis:   Get the index of this child in the collection, looking from
+//              uStartIndex onwards first. Callers that visit children in
+//              order pass the last index they found so that the search does
+//              not start over from the first child every time.
+//
+//-----------------------------------------------------------------------------
+HRESULT CollectionNode::GetChildIndex(__in ParseTreeNode* pChild, UINT uStartIndex, __out UINT* puIndex)
+{
+    CHK_START;
+
+    UINT cChildren = _aryChildren.GetCount();
+    UINT uStart = min(uStartIndex, cChildren);
+
+    // Look from the start index to the end, then wrap around to the children before it
+    (*puIndex) = CModernParseTreeNodeArray::NotFound;
+    for (UINT i = 0; i < cChildren; i++)
+    {
+        UINT uIndex = (uStart + i < cChildren) ? (uStart + i) : (uStart + i - cChildren);
+        if (_aryChildren[uIndex] == pChild)
+        {
+            (*puIndex) = uIndex;
+            break;
+        }
+    }
+
+    if (*puIndex == CModernParseTreeNodeArray::NotFound)
+    {
+        CHK(E_NOTFOUND);
+    }
+
+    CHK_RETURN;
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   ExtractChild
@@ -389,48 +536,6 @@ HRESULT CollectionNode::DumpTree(__in IStringStream* pOutput)
 }
 
 
-//+----------------------------------------------------------------------------
-//
-//  Function:   GatherDefinitionsOfCalledFunctions
-//
-//  Synopsis:   Recursively search for function identifier nodes. If we find
-//              any, lookup the function defintion node that defines the
-//              identifier and add it to the passed in collection.
-//
-//+----------------------------------------------------------------------------
-HRESULT CollectionNode::GatherDefinitionsOfCalledFunctions(__inout CModernArray<const FunctionDefinitionNode*>& aryCalled) const
-{
-    CHK_START;
-
-    for (UINT i = 0; i < _aryChildren.GetCount(); i++)
-    {
-        // Children can be null as placeholders
-        const ParseTreeNode* pChild = _aryChildren[i];
-        if (pChild != nullptr)
-        {
-            if (pChild->GetParseNodeType() == ParseNodeType::functionIdentifier)
-            {
-                TSmartPointer<CFunctionIdentifierInfo> spFuncInfo;
-                CHK_VERIFY(SUCCEEDED(pChild->GetAs<FunctionIdentifierNode>()->GetFunctionIdentifierInfo(&spFuncInfo)));
-
-                // Known functions are implicity defined - they have no function definition node.
-                const FunctionDefinitionNode* pCalledFunctionDefinition = spFuncInfo->UseFunctionDefinition();
-                if (pCalledFunctionDefinition != nullptr)
-                {
-                    CHK(aryCalled.Add(pCalledFunctionDefinition));
-                }
-            }
-
-            if (pChild->IsCollectionNode())
-            {
-                CHK(static_cast<const CollectionNode*>(pChild)->GatherDefinitionsOfCalledFunctions(aryCalled));
-            }
-        }
-    }
-
-    CHK_RETURN;
-}
-
 //+----------------------------------------------------------------------------
 //
 //  Function:   AssertSubtreeFullyVerified
@@ -53,8 +53,6 @@ public:
         __inout CModernParseTreeNodeArray &rgChildClones    // Clones of children
         ) { Assert(false); return E_NOTIMPL; }
 
-    HRESULT GatherDefinitionsOfCalledFunctions(__inout CModernArray<const FunctionDefinitionNode*>& aryCalled) const;
-
     // ParseTreeNode overrides
     bool IsCollectionNode() const override { return true; }
     HRESULT VerifyChildren() override;
@@ -67,6 +65,11 @@ public:
     HRESULT InsertChild(__in ParseTreeNode* pChild, UINT uIndex);
     HRESULT InsertBefore(__in ParseTreeNode* pChildToInsert, __in ParseTreeNode* pNodeInsertBefore);
     HRESULT GetChildIndex(__in ParseTreeNode* pChild, __out UINT* puIndex);
+    HRESULT GetChildIndex(__in ParseTreeNode* pChild, UINT uStartIndex, __out UINT* puIndex);
+    HRESULT InsertEmptyChildren(UINT uIndex, UINT cChildren);
+    HRESULT MoveEmptyChildren(UINT uIndex, UINT cChildren, UINT uNewIndex);
+    HRESULT RemoveEmptyChildren(UINT uIndex, UINT cChildren);
+    HRESULT SetEmptyChild(UINT uIndex, __in ParseTreeNode* pChild);
     void RemoveAllChildren() { _aryChildren.RemoveAll(); }
 
     void AssertSubtreeFullyVerified() const override;
@@ -29,6 +29,7 @@
 #include "GLSLParser.hxx"
 #include "VariableIdentifierNode.hxx"
 #include "TypeNameIdentifierInfo.hxx"
+#include "GLSLScopedSymbolIndex.hxx"
 
 MtDefine(CollectionNodeWithScope, CGLSLParser, "CollectionNodeWithScope");
 
@@ -55,7 +56,9 @@ const int CollectionNodeWithScope::s_rgFragDefaultPrecisions[GLSLPrecisionType::
 //
 //-----------------------------------------------------------------------------
 CollectionNodeWithScope::CollectionNodeWithScope() : 
-    _scopeId(-1)
+    _scopeId(-1),
+    _cOpen(0),
+    _uOpenDepth(0)
 {
     static_assert(ARRAYSIZE(_rgPrecisions) == static_cast<UINT>(GLSLPrecisionType::Count), "Precision array must be the same size as the number of enums");
     static_assert(ARRAYSIZE(_rgPrecisions) == ARRAYSIZE(s_rgVertDefaultPrecisions), "Precision array must be the same size as the default values");
@@ -105,12 +108,22 @@ HRESULT CollectionNodeWithScope::PreVerifyChildren()
 //  Function:   AddDeclaredIdentifier
 //
 //  Synopsis:   Add identifier info for an identifier that is declared in this
-//              compound statement's scope.
+//              compound statement's scope. If the scope is open, the
+//              identifier becomes visible in the scoped symbol index too.
 //
 //-----------------------------------------------------------------------------
 HRESULT CollectionNodeWithScope::AddDeclaredIdentifier(__in IIdentifierInfo* pInfo)
 {
-    return _rgIdList.Add(pInfo);
+    CHK_START;
+
+    CHK(_rgIdList.Add(pInfo));
+
+    if (IsOpen())
+    {
+        CHK(GetParser()->UseScopedSymbolIndex()->AddIdentifier(this, pInfo));
+    }
+
+    CHK_RETURN;
 }
 
 //+----------------------------------------------------------------------------
@@ -132,11 +145,28 @@ HRESULT CollectionNodeWithScope::GetIdentifierInfoList(
 
     Assert(aryFoundList.GetCount() == 0);
 
-    for (UINT i = 0; i < _rgIdList.GetCount(); i++)
+    if (IsOpen())
     {
-        if (_rgIdList[i]->GetSymbolIndex() == iSymbolIndex)
+        // The index has this scope's identifiers, so there is no need to
+        // look at the whole list
+        const CGLSLScopedSymbolIndex* pIndex = GetParser()->UseScopedSymbolIndex();
+        int iEntry = pIndex->FindFirstEntry(iSymbolIndex, _uOpenDepth);
+        if (iEntry != CGLSLScopedSymbolIndex::s_iNoEntry && pIndex->GetEntryDepth(iEntry) == _uOpenDepth)
         {
-            CHK(aryFoundList.Add(_rgIdList[i]));
+            for (; iEntry != CGLSLScopedSymbolIndex::s_iNoEntry; iEntry = pIndex->GetNextEntryInScope(iEntry))
+            {
+                CHK(aryFoundList.Add(pIndex->UseEntryInfo(iEntry)));
+            }
+        }
+    }
+    else
+    {
+        for (UINT i = 0; i < _rgIdList.GetCount(); i++)
+        {
+            if (_rgIdList[i]->GetSymbolIndex() == iSymbolIndex)
+            {
+                CHK(aryFoundList.Add(_rgIdList[i]));
+            }
         }
     }
 
@@ -162,15 +192,27 @@ bool CollectionNodeWithScope::DefinesTypeNameOrVariableIdentifier(__in Identifie
 {
     Assert(pIdentifier->GetParseNodeType() == ParseNodeType::typeNameIdentifier || pIdentifier->GetParseNodeType() == ParseNodeType::variableIdentifier);
 
-    for (UINT i = 0; i < _rgIdList.GetCount(); i++)
+    if (IsOpen())
+    {
+        const CGLSLScopedSymbolIndex* pIndex = GetParser()->UseScopedSymbolIndex();
+        int iEntry = pIndex->FindFirstEntry(pIdentifier->GetSymbolIndex(), _uOpenDepth);
+        if (iEntry != CGLSLScopedSymbolIndex::s_iNoEntry && pIndex->GetEntryDepth(iEntry) == _uOpenDepth)
+        {
+            for (; iEntry != CGLSLScopedSymbolIndex::s_iNoEntry; iEntry = pIndex->GetNextEntryInScope(iEntry))
+            {
+                if (DefinesForTypeNameOrVariable(pIndex->UseEntryInfo(iEntry)))
+                {
+                    return true;
+                }
+            }
+        }
+    }
+    else
     {
-        const IIdentifierInfo* pIdInfo = _rgIdList[i];
-        if (pIdInfo->GetSymbolIndex() == pIdentifier->GetSymbolIndex())
+        for (UINT i = 0; i < _rgIdList.GetCount(); i++)
         {
-            // Function identifiers that are for known functions should be skipped, as they
-            // are not defined for typename or variable identifiers.
-            const CFunctionIdentifierInfo* pFuncInfo = pIdInfo->AsFunction();
-            if (pFuncInfo == nullptr || !pFuncInfo->IsKnownFunction())
+            const IIdentifierInfo* pIdInfo = _rgIdList[i];
+            if (pIdInfo->GetSymbolIndex() == pIdentifier->GetSymbolIndex() && DefinesForTypeNameOrVariable(pIdInfo))
             {
                 return true;
             }
@@ -180,6 +222,21 @@ bool CollectionNodeWithScope::DefinesTypeNameOrVariableIdentifier(__in Identifie
     return false;
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   DefinesForTypeNameOrVariable
+//
+//  Synopsis:   Function identifiers that are for known functions should be
+//              skipped, as they are not defined for typename or variable
+//              identifiers. Everything else is.
+//
+//-----------------------------------------------------------------------------
+bool CollectionNodeWithScope::DefinesForTypeNameOrVariable(__in const IIdentifierInfo* pIdInfo)
+{
+    const CFunctionIdentifierInfo* pFuncInfo = pIdInfo->AsFunction();
+    return (pFuncInfo == nullptr || !pFuncInfo->IsKnownFunction());
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   GetNearestScopeInfoList
@@ -203,6 +260,13 @@ HRESULT CollectionNodeWithScope::GetNearestScopeInfoList(
 //  Synopsis:   Retrieve identifier infos for the identifiers that match the
 //              given symbol index in the nearest scope to pTreeNode.
 //
+//              Scopes that are open during verification are in the scoped
+//              symbol index. The first open scope on the way up finds the
+//              nearest open declaration with one lookup, so the open scopes
+//              after it are passed over without searching their lists. Only
+//              scopes that are not open (nodes verified after their scope
+//              was done) are searched one by one.
+//
 //-----------------------------------------------------------------------------
 HRESULT CollectionNodeWithScope::GetNearestScopeInfoList(
     __in ParseTreeNode* pTreeNode,                                              // The parse tree node to begin the search from
@@ -215,6 +279,8 @@ HRESULT CollectionNodeWithScope::GetNearestScopeInfoList(
     ParseTreeNode* pWalk = pTreeNode;
     ParseTreeNode* pScopeNode = nullptr;
     bool fFound = false;
+    const CGLSLScopedSymbolIndex* pIndex = nullptr;
+    int iIndexEntry = CGLSLScopedSymbolIndex::s_iNoEntry;
 
     // First search up the parse tree to find the nearest scope that
     // declared something equivalent.
@@ -226,7 +292,29 @@ HRESULT CollectionNodeWithScope::GetNearestScopeInfoList(
             CHK_VERIFY(pScopeNode != nullptr);
 
             CollectionNodeWithScope* pScope = static_cast<CollectionNodeWithScope*>(pScopeNode);
-            if (SUCCEEDED(pScope->GetIdentifierInfoList(iSymbolIndex, rgInfos)))
+            if (pScope->IsOpen())
+            {
+                // Look up the nearest declaration that is visible from this
+                // scope, unless the one already found is still visible
+                if (pIndex == nullptr ||
+                    (iIndexEntry != CGLSLScopedSymbolIndex::s_iNoEntry && pIndex->GetEntryDepth(iIndexEntry) > pScope->_uOpenDepth))
+                {
+                    pIndex = pScope->GetParser()->UseScopedSymbolIndex();
+                    iIndexEntry = pIndex->FindFirstEntry(iSymbolIndex, pScope->_uOpenDepth);
+                }
+
+                if (iIndexEntry != CGLSLScopedSymbolIndex::s_iNoEntry && pIndex->GetEntryDepth(iIndexEntry) == pScope->_uOpenDepth)
+                {
+                    for (int iEntry = iIndexEntry; iEntry != CGLSLScopedSymbolIndex::s_iNoEntry; iEntry = pIndex->GetNextEntryInScope(iEntry))
+                    {
+                        CHK(rgInfos.Add(pIndex->UseEntryInfo(iEntry)));
+                    }
+
+                    fFound = true;
+                    break;
+                }
+            }
+            else if (SUCCEEDED(pScope->GetIdentifierInfoList(iSymbolIndex, rgInfos)))
             {
                 fFound = true;
                 break;
@@ -54,6 +54,7 @@ public:
         ) override { (*ppActual) = this; return true; }                             
 
     HRESULT PreVerifyChildren() override;
+    CollectionNodeWithScope* UseScopeOpenedForVerification() override { return this; }
                                                                                     
     // Other methods                                                                
     void SetScopeId(int scopeId) { _scopeId = scopeId; }
@@ -88,6 +89,8 @@ public:
     void SetPrecisionForType(GLSLPrecisionType type, int precision);
     HRESULT GetPrecisionForType(GLSLPrecisionType type, __out int* pPrecision) const;
 
+    bool IsOpen() const { return _cOpen > 0; }
+
 protected:
     const CModernArray<TSmartPointer<IIdentifierInfo>>& UseIdList() const { return _rgIdList; }
 
@@ -100,9 +103,15 @@ private:
 
     void SetPrecisionsFromArray(const int rgPrecisions[GLSLPrecisionType::Count]);
 
+    static bool DefinesForTypeNameOrVariable(__in const IIdentifierInfo* pIdInfo);
+
+    friend class CGLSLScopedSymbolIndex;
+
 private:
     int _scopeId;                                                           // The scope ID for this node
     CModernArray<TSmartPointer<IIdentifierInfo>> _rgIdList;                 // The identifiers declared in this scope
+    UINT _cOpen;                                                            // Number of times the scope is open in the scoped symbol index
+    UINT _uOpenDepth;                                                       // Depth in the stack of open scopes, while open
     int _rgPrecisions[GLSLPrecisionType::Count];                            // The declared precisions for each type in this scope
     static const int s_rgVertDefaultPrecisions[GLSLPrecisionType::Count];   // Default precisions for vertex shaders
     static const int s_rgFragDefaultPrecisions[GLSLPrecisionType::Count];   // Default precisions for fragment shaders
@@ -88,7 +88,7 @@ HRESULT CompoundStatementNode::PreVerifyChildren()
 
     if (_fDefinesScope)
     {
-        if (GetParent()->GetParseNodeType() == ParseNodeType::iterationStatement)
+        if (IsLoopBody())
         {
             _fDefinesScope = false;
         }
@@ -102,6 +102,33 @@ HRESULT CompoundStatementNode::PreVerifyChildren()
     return S_OK;
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   UseScopeOpenedForVerification
+//
+//  Synopsis:   Compound statements that define a scope open it while they
+//              are verified. This is called before PreVerifyChildren, so
+//              loop bodies (which lose their scope there) are checked here.
+//
+//-----------------------------------------------------------------------------
+CollectionNodeWithScope* CompoundStatementNode::UseScopeOpenedForVerification()
+{
+    return (_fDefinesScope && !IsLoopBody()) ? this : nullptr;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   IsLoopBody
+//
+//  Synopsis:   Whether this compound statement is the body of a loop, in
+//              which case it shares the scope of the loop statement.
+//
+//-----------------------------------------------------------------------------
+bool CompoundStatementNode::IsLoopBody() const
+{
+    return (GetParent()->GetParseNodeType() == ParseNodeType::iterationStatement);
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   OutputHLSL
@@ -122,7 +149,7 @@ HRESULT CompoundStatementNode::OutputHLSL(__in IStringStream* pOutput)
     }
 
     // Wrap in braces
-    CHK(pOutput->WriteString("{\n"));
+    CHK(pOutput->WriteLiteral("{\n"));
     pOutput->IncreaseIndent();
 
     if (fEntryPoint)
@@ -143,7 +170,7 @@ HRESULT CompoundStatementNode::OutputHLSL(__in IStringStream* pOutput)
     }
 
     pOutput->DecreaseIndent();
-    CHK(pOutput->WriteString("}\n"));
+    CHK(pOutput->WriteLiteral("}\n"));
 
     CHK_RETURN;
 }
@@ -161,6 +188,6 @@ HRESULT CompoundStatementNode::GetDumpString(__in IStringStream* pOutput)
     }
     else
     {
-        return pOutput->WriteString("CompoundStatementNode (no scope)");
+        return pOutput->WriteLiteral("CompoundStatementNode (no scope)");
     }
 }
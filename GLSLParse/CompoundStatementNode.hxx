@@ -64,9 +64,14 @@ public:
         __deref_out_opt ParseTreeNode** ppActual                // Tree node that is the actual scope
         ) override { (*ppActual) = this; return _fDefinesScope; }
 
+    CollectionNodeWithScope* UseScopeOpenedForVerification() override;
+
     // For GetAs et al
     static ParseNodeType::Enum GetClassNodeType() { return ParseNodeType::compoundStatement; }
 
+private:
+    bool IsLoopBody() const;
+
 private:
     bool _fDefinesScope;                                        // Whether this node actually defines a scope
 };
@@ -26,6 +26,8 @@
 //--------------------------------------------------------------
 #include "PreComp.hxx"
 #include "ConstantValue.hxx"
+#include "GLSLTypeInfo.hxx"
+#include "TypeHelpers.hxx"
 #include "GLSL.tab.h"
 
 //+----------------------------------------------------------------------------
@@ -37,6 +39,7 @@ ConstantValue::ConstantValue()
 { 
     _type = NO_TYPE; 
     _fSet = false;
+    _cComponents = 1;
 }
 
 //+----------------------------------------------------------------------------
@@ -50,6 +53,7 @@ void ConstantValue::SetTypeOnly(int basicType)
 {
     _type = basicType;
     _fSet = false;
+    _cComponents = 1;
 }
 
 //+----------------------------------------------------------------------------
@@ -88,11 +92,11 @@ HRESULT ConstantValue::AsInt(__out int* pValue) const
     switch (_type)
     {
     case INT_TOK:
-        (*pValue) = _intValue;
+        (*pValue) = _rgIntValues[0];
         return S_OK;
 
     case FLOAT_TOK:
-        (*pValue) = static_cast<int>(_doubleValue);
+        (*pValue) = static_cast<int>(_rgDoubleValues[0]);
         return S_OK;
 
     default:
@@ -118,11 +122,11 @@ HRESULT ConstantValue::AsDouble(__out double* pValue) const
     switch (_type)
     {
     case INT_TOK:
-        (*pValue) = static_cast<double>(_intValue);
+        (*pValue) = static_cast<double>(_rgIntValues[0]);
         return S_OK;
 
     case FLOAT_TOK:
-        (*pValue) = _doubleValue;
+        (*pValue) = _rgDoubleValues[0];
         return S_OK;
 
     default:
@@ -141,8 +145,9 @@ template<>
 void ConstantValue::SetValue<int>(int val) 
 { 
     _type = INT_TOK; 
-    _intValue = val; 
+    _rgIntValues[0] = val; 
     _fSet = true;
+    _cComponents = 1;
 }
 
 //+----------------------------------------------------------------------------
@@ -156,8 +161,9 @@ template<>
 void ConstantValue::SetValue<double>(double val)
 {
     _type = FLOAT_TOK;
-    _doubleValue = val; 
+    _rgDoubleValues[0] = val; 
     _fSet = true;
+    _cComponents = 1;
 }
 
 //+----------------------------------------------------------------------------
@@ -177,7 +183,7 @@ HRESULT ConstantValue::GetValue<int>(__out int* pValue) const
         return E_FAIL;
     }
 
-    (*pValue) = _intValue;
+    (*pValue) = _rgIntValues[0];
     return S_OK;
 }
 
@@ -198,10 +204,116 @@ HRESULT ConstantValue::GetValue<double>(__out double* pValue) const
         return E_FAIL;
     }
 
-    (*pValue) = _doubleValue;
+    (*pValue) = _rgDoubleValues[0];
     return S_OK;
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   InitializeComponents
+//
+//  Synopsis:   Set the type to an int or float scalar, vector or matrix type,
+//              with every component set to zero. The components can then be
+//              filled in with SetComponent.
+//
+//-----------------------------------------------------------------------------
+HRESULT ConstantValue::InitializeComponents(int type)
+{
+    CHK_START;
+
+    int componentType;
+    CHK(TypeHelpers::GetComponentType(type, &componentType));
+    CHKB(componentType == INT_TOK || componentType == FLOAT_TOK);
+
+    const BasicGLSLTypeInfo* pInfo;
+    CHK(BasicGLSLTypeInfo::GetInfo(type, &pInfo));
+    CHKB(pInfo->_constructorComponents <= s_cMaxComponents);
+
+    _type = type;
+    _fSet = true;
+    _cComponents = pInfo->_constructorComponents;
+    ::ZeroMemory(_rgDoubleValues, sizeof(_rgDoubleValues));
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetComponentType
+//
+//  Synopsis:   Get the scalar type of the components of the value
+//
+//-----------------------------------------------------------------------------
+HRESULT ConstantValue::GetComponentType(__out int* pType) const
+{
+    if (_type == NO_TYPE)
+    {
+        return E_FAIL;
+    }
+
+    return TypeHelpers::GetComponentType(_type, pType);
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetComponent
+//
+//  Synopsis:   Get a single component of the value as a scalar value
+//
+//-----------------------------------------------------------------------------
+HRESULT ConstantValue::GetComponent(UINT uIndex, __out ConstantValue* pComponent) const
+{
+    CHK_START;
+
+    CHKB(_fSet && uIndex < _cComponents);
+
+    int componentType;
+    CHK(GetComponentType(&componentType));
+
+    if (componentType == INT_TOK)
+    {
+        pComponent->SetValue(_rgIntValues[uIndex]);
+    }
+    else
+    {
+        CHKB(componentType == FLOAT_TOK);
+        pComponent->SetValue(_rgDoubleValues[uIndex]);
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   SetComponent
+//
+//  Synopsis:   Set a single component of the value from a scalar value,
+//              converting it to the component type the way a constructor
+//              would.
+//
+//-----------------------------------------------------------------------------
+HRESULT ConstantValue::SetComponent(UINT uIndex, const ConstantValue& component)
+{
+    CHK_START;
+
+    CHKB(_fSet && uIndex < _cComponents);
+
+    int componentType;
+    CHK(GetComponentType(&componentType));
+
+    if (componentType == INT_TOK)
+    {
+        CHK(component.AsInt(&_rgIntValues[uIndex]));
+    }
+    else
+    {
+        CHKB(componentType == FLOAT_TOK);
+        CHK(component.AsDouble(&_rgDoubleValues[uIndex]));
+    }
+
+    CHK_RETURN;
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   ConstantValueLink
@@ -36,7 +36,10 @@
 //              as the initialized value of an identifier for those that have
 //              an initializer, or passed around when a constant is required.
 //
-//              Currently only int and double values are supported.
+//              Values can be int or float scalars, or vectors and matrices
+//              made up of them. Vector and matrix components are stored in
+//              the order a GLSL constructor takes them, so matrices are
+//              stored a column at a time.
 //
 //              This stores both a basic type and (optionally) a value. It is
 //              possible to have a type without a value.
@@ -49,6 +52,7 @@ public:
 
     void SetTypeOnly(int type);
     HRESULT GetBasicType(__out int* pBasicType) const;
+    bool HasValue() const { return _fSet; }
 
     template<typename T> 
     void SetValue(T val) { AssertSz(false, "Invalid template of ConstantValue::SetValue used"); }
@@ -72,13 +76,24 @@ public:
     HRESULT AsInt(__out int* pValue) const;
     HRESULT AsDouble(__out double* pValue) const;
 
+    // Vectors and matrices
+    HRESULT InitializeComponents(int type);
+    UINT GetComponentCount() const { return _cComponents; }
+    HRESULT GetComponentType(__out int* pType) const;
+    HRESULT GetComponent(UINT uIndex, __out ConstantValue* pComponent) const;
+    HRESULT SetComponent(UINT uIndex, const ConstantValue& component);
+
+public:
+    static const UINT s_cMaxComponents = 16;                        // Components in the largest type, mat4
+
 private:
     int _type;                                                      // The type stored in the struct
     bool _fSet;                                                     // Whether a value is set or not
+    UINT _cComponents;                                              // Number of components in the value, 1 for scalars
 
     union
     {
-        int _intValue;                                              // The value if this is an int
-        double _doubleValue;                                        // The value if this is a double
+        int _rgIntValues[s_cMaxComponents];                         // The values if the components are ints
+        double _rgDoubleValues[s_cMaxComponents];                   // The values if the components are doubles
     };
 };
@@ -86,5 +86,5 @@ HRESULT ContinueStatementNode::VerifySelf()
 //-----------------------------------------------------------------------------
 HRESULT ContinueStatementNode::OutputHLSL(__in IStringStream* pOutput)
 {
-    return pOutput->WriteString("continue;\n");
+    return pOutput->WriteLiteral("continue;\n");
 }
@@ -69,7 +69,7 @@ HRESULT DiscardStatementNode::Initialize(
 //-----------------------------------------------------------------------------
 HRESULT DiscardStatementNode::OutputHLSL(__in IStringStream* pOutput)
 {
-    return pOutput->WriteString("discard;\n");
+    return pOutput->WriteLiteral("discard;\n");
 }
 
 //+----------------------------------------------------------------------------
@@ -70,7 +70,7 @@ HRESULT ExpressionStatementNode::OutputHLSL(__in IStringStream* pOutput)
         CHK(GetChild(0)->OutputHLSL(pOutput));
 
         // Terminate with the semicolon
-        CHK(pOutput->WriteString(";\n"));
+        CHK(pOutput->WriteLiteral(";\n"));
     }
 
     CHK_RETURN;
@@ -75,7 +75,7 @@ HRESULT FloatConstantNode::OutputHLSL(__in IStringStream* pOutput)
 
     if (_finite(_constant) == 0)
     {
-        CHK(pOutput->WriteString("0.0"));
+        CHK(pOutput->WriteLiteral("0.0"));
     }
     else
     {
@@ -0,0 +1,248 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#include "PreComp.hxx"
+#include "FoldedConstantNode.hxx"
+#include "IStringStream.hxx"
+#include "GLSLTypeInfo.hxx"
+#include "TypeHelpers.hxx"
+#include "GLSL.tab.h"
+#include <float.h>
+
+MtDefine(FoldedConstantNode, CGLSLParser, "FoldedConstantNode");
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Constructor
+//
+//-----------------------------------------------------------------------------
+FoldedConstantNode::FoldedConstantNode()
+{
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Initialize
+//
+//-----------------------------------------------------------------------------
+HRESULT FoldedConstantNode::Initialize(
+    __in CGLSLParser* pParser,                  // The parser that owns the tree
+    const ConstantValue& value                  // The value that was calculated
+    )
+{
+    CHK_START;
+
+    // Only values we know how to write out can be folded
+    int componentType;
+    CHKB(value.HasValue());
+    CHK(value.GetComponentType(&componentType));
+    CHKB(componentType == INT_TOK || componentType == FLOAT_TOK);
+
+    ParseTreeNode::Initialize(pParser);
+
+    _value = value;
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   InitializeAsClone
+//
+//  Synopsis:   Clone the constant node
+//
+//-----------------------------------------------------------------------------
+HRESULT FoldedConstantNode::InitializeAsClone(__in ParseTreeNode* pOriginal)
+{
+    FoldedConstantNode* pOriginalConstant = pOriginal->GetAs<FoldedConstantNode>();
+
+    _value = pOriginalConstant->_value;
+
+    return S_OK;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   OutputHLSL
+//
+//  Synopsis:   Output HLSL for this node of the tree. Scalars are written as
+//              a literal, and vectors and matrices as a constructor call
+//              with a literal for each component.
+//
+//-----------------------------------------------------------------------------
+HRESULT FoldedConstantNode::OutputHLSL(__in IStringStream* pOutput)
+{
+    CHK_START;
+
+    int basicType;
+    CHK(_value.GetBasicType(&basicType));
+
+    if (basicType == INT_TOK || basicType == FLOAT_TOK)
+    {
+        double doubleValue;
+        CHK(_value.AsDouble(&doubleValue));
+
+        // Negative values are wrapped in paren for the same reason that the unary
+        // operator does it - so that 'a - -1' does not come out as 'a--1'.
+        bool fNegative = (_copysign(1.0, doubleValue) < 0.0);
+        if (fNegative)
+        {
+            CHK(pOutput->WriteChar('('));
+        }
+
+        CHK(OutputComponent(pOutput, 0));
+
+        if (fNegative)
+        {
+            CHK(pOutput->WriteChar(')'));
+        }
+    }
+    else
+    {
+        const BasicGLSLTypeInfo* pInfo;
+        CHK(BasicGLSLTypeInfo::GetInfo(basicType, &pInfo));
+
+        // The components are stored in the order that the constructor takes
+        // them, which is how the matrix constructors are translated too.
+        CHK(pOutput->WriteFormat(64, "%s(", pInfo->_pszHLSLName));
+
+        for (UINT i = 0; i < _value.GetComponentCount(); i++)
+        {
+            if (i != 0)
+            {
+                CHK(pOutput->WriteChar(','));
+            }
+
+            CHK(OutputComponent(pOutput, i));
+        }
+
+        CHK(pOutput->WriteChar(')'));
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   OutputComponent
+//
+//  Synopsis:   Write a single component of the value as a literal, in the
+//              same format that the constant nodes use.
+//
+//-----------------------------------------------------------------------------
+HRESULT FoldedConstantNode::OutputComponent(
+    __in IStringStream* pOutput,                // Stream to write output to
+    UINT uIndex                                 // Component to write
+    ) const
+{
+    CHK_START;
+
+    ConstantValue component;
+    CHK(_value.GetComponent(uIndex, &component));
+
+    int componentType;
+    CHK(_value.GetComponentType(&componentType));
+
+    if (componentType == INT_TOK)
+    {
+        int intValue;
+        CHK(component.GetValue(&intValue));
+        CHK(pOutput->WriteFormat(64, "%d", intValue));
+    }
+    else
+    {
+        double doubleValue;
+        CHK(component.GetValue(&doubleValue));
+
+        // Folding does not create values that are not finite
+        Assert(_finite(doubleValue) != 0);
+        CHK(pOutput->WriteFormat(128, "%e", doubleValue));
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   VerifySelf
+//
+//  Synopsis:   Get the type of the node. This is the type of the value.
+//
+//-----------------------------------------------------------------------------
+HRESULT FoldedConstantNode::VerifySelf()
+{
+    CHK_START;
+
+    int basicType;
+    CHK(_value.GetBasicType(&basicType));
+
+    SetBasicExpressionType(basicType);
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   IsConstExpression
+//
+//  Synopsis:   The node is always constant, with the value it was folded to.
+//
+//-----------------------------------------------------------------------------
+HRESULT FoldedConstantNode::IsConstExpression(
+    bool fIncludeIndex,                         // Whether to include loop index in the definition of a constant expression
+    __out bool* pfIsConstantExpression,         // Whether this node is a constant expression
+    __out_opt ConstantValue* pValue             // The value of the constant expression, if desired
+    ) const
+{
+    (*pfIsConstantExpression) = true;
+
+    if (pValue != nullptr)
+    {
+        (*pValue) = _value;
+    }
+
+    return S_OK;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetDumpString
+//
+//-----------------------------------------------------------------------------
+HRESULT FoldedConstantNode::GetDumpString(__in IStringStream* pOutput)
+{
+    CHK_START;
+
+    int basicType;
+    CHK(_value.GetBasicType(&basicType));
+
+    const BasicGLSLTypeInfo* pInfo;
+    CHK(BasicGLSLTypeInfo::GetInfo(basicType, &pInfo));
+
+    CHK(pOutput->WriteFormat(1024, "FoldedConstantNode Type='%s'", pInfo->_pszGLSLName));
+
+    CHK_RETURN;
+}
@@ -0,0 +1,81 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#pragma once
+
+#include "ParseTreeNode.hxx"
+#include "ConstantValue.hxx"
+
+//+-----------------------------------------------------------------------------
+//
+//  Class:      FoldedConstantNode
+//
+//  Synopsis:   Node information for the value of a constant expression that
+//              was calculated during translation. The expression it replaces
+//              can be a scalar, vector or matrix of ints or floats.
+//
+//------------------------------------------------------------------------------
+class FoldedConstantNode : public ParseTreeNode
+{
+public:
+    FoldedConstantNode();
+
+    HRESULT InitializeAsClone(__in ParseTreeNode* pOriginal) override;
+
+    HRESULT Initialize(
+        __in CGLSLParser* pParser,                  // The parser that owns the tree
+        const ConstantValue& value                  // The value that was calculated
+        );
+
+    HRESULT Initialize(
+        __in CGLSLParser* pParser                   // The parser that owns the tree
+        ) { ParseTreeNode::Initialize(pParser); return S_OK; }
+
+    // ParseTreeNode overrides
+    ParseNodeType::Enum GetParseNodeType() const override { return GetClassNodeType(); }
+    HRESULT OutputHLSL(__in IStringStream* pOutput) override;
+    HRESULT VerifySelf() override;
+    HRESULT Clone(__deref_out ParseTreeNode **ppClone) { return ParseTreeNode::CreateClone(GetParser(), this, ppClone); }
+    HRESULT GetDumpString(__in IStringStream* pOutput) override;
+
+    HRESULT IsConstExpression(
+        bool fIncludeIndex,                         // Whether to include loop index in the definition of a constant expression
+        __out bool* pfIsConstantExpression,         // Whether this node is a constant expression
+        __out_opt ConstantValue* pValue             // The value of the constant expression, if desired
+        ) const override;
+
+    // For GetAs et al
+    static ParseNodeType::Enum GetClassNodeType() { return ParseNodeType::foldedConstant; }
+
+private:
+    HRESULT OutputComponent(
+        __in IStringStream* pOutput,                // Stream to write output to
+        UINT uIndex                                 // Component to write
+        ) const;
+
+private:
+    ConstantValue _value;                           // The value of the expression that was folded
+};
@@ -77,7 +77,7 @@ HRESULT ForRestStatementNode::OutputHLSL(__in IStringStream* pOutput)
         CHK(GetChild(0)->OutputHLSL(pOutput));
     }
 
-    CHK(pOutput->WriteString(";"));
+    CHK(pOutput->WriteLiteral(";"));
 
     // Output the expression if we have it
     if (GetChild(1) != nullptr)
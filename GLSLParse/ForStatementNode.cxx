@@ -357,18 +357,18 @@ HRESULT ForStatementNode::OutputHLSL(__in IStringStream* pOutput)
     // we should do so. If not, the HLSL compiler will use flow control if available.
     if (_fRequestUnroll)
     {
-        CHK(pOutput->WriteString("[unroll] "));
+        CHK(pOutput->WriteLiteral("[unroll] "));
     }
     else
     {
         Assert(GetParser()->GetFeatureLevel() >= WebGLFeatureLevel::Level_10);
-        CHK(pOutput->WriteString("[loop] "));
+        CHK(pOutput->WriteLiteral("[loop] "));
     }
 
-    CHK(pOutput->WriteString("for ("));
+    CHK(pOutput->WriteLiteral("for ("));
     CHK(GetChild(0)->OutputHLSL(pOutput));
     CHK(GetChild(1)->OutputHLSL(pOutput));
-    CHK(pOutput->WriteString(")\n"));
+    CHK(pOutput->WriteLiteral(")\n"));
     CHK(GetChild(2)->OutputHLSL(pOutput));
 
     CHK_RETURN;
@@ -398,20 +398,18 @@ HRESULT ForStatementNode::GetDumpString(__in IStringStream* pOutput)
 template <typename T>
 UINT ForStatementNode::DetermineLoopIterations() const
 {
-    // The initializer currently can fail to extract an actual value as we do
-    // not support evaluating all constant expressions (e.g. constant ternary expression)
+    // Any of the constants can fail to have an actual value as we do not
+    // support evaluating all constant expressions (e.g. constant ternary expression)
     // If we don't know, default to a low number that will default to [unroll]
     UINT cIterations = 1;
 
     T initialValue;
-    if (SUCCEEDED(_verificationInfo.loopInitializerConstant.GetValue(&initialValue)))
+    T comparisonValue;
+    T iterationValue;
+    if (SUCCEEDED(_verificationInfo.loopInitializerConstant.GetValue(&initialValue)) &&
+        SUCCEEDED(_verificationInfo.loopComparisonConstant.GetValue(&comparisonValue)) &&
+        SUCCEEDED(_verificationInfo.loopIterationConstant.GetValue(&iterationValue)))
     {
-        T comparisonValue;
-        Release_Assert(SUCCEEDED(_verificationInfo.loopComparisonConstant.GetValue(&comparisonValue)));
-
-        T iterationValue;
-        Release_Assert(SUCCEEDED(_verificationInfo.loopIterationConstant.GetValue(&iterationValue)));
-
         if (iterationValue != 0)
         {
             // We don't keep track of the comparison and increment/decrement operators, and
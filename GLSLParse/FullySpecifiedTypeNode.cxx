@@ -149,12 +149,12 @@ HRESULT FullySpecifiedTypeNode::OutputHLSL(__in IStringStream* pOutput)
         // is declaring a variable (declaration list has identifiers).
         if (fGlobalScope)
         {
-            CHK(pOutput->WriteString("static "));
+            CHK(pOutput->WriteLiteral("static "));
         }
 
         if (_typeQual == CONST_TOK)
         {
-            CHK(pOutput->WriteString("const "));
+            CHK(pOutput->WriteLiteral("const "));
         }
     }
 
@@ -43,6 +43,8 @@
 #include "TypeNameIdentifierInfo.hxx"
 #include "TypeNameIdentifierNode.hxx"
 #include "StructGLSLType.hxx"
+#include "GLSLKnownFunctionIndex.hxx"
+#include "FunctionDefinitionNode.hxx"
 
 MtDefine(FunctionCallHeaderWithParametersNode, CGLSLParser, "FunctionCallHeaderWithParametersNode");
 
@@ -206,6 +208,11 @@ HRESULT FunctionCallHeaderWithParametersNode::VerifyNonConstructor(__in Function
     CModernArray<TSmartPointer<GLSLType>> aryArgTypes;
     CHK(GetArgumentTypes(aryArgTypes));
 
+    // Calls to known functions are resolved with a single lookup on the
+    // basic types of the arguments, which finds the overload that matching
+    // each known overload's signature in turn would have found.
+    const CGLSLKnownFunctionIndex::Match* pKnownMatch = FindKnownFunctionMatch(pFuncId->GetSymbolIndex(), aryArgTypes);
+
     bool fFoundMatch = false;
     for (UINT i = 0; i < rgInfos.GetCount(); i++)
     {
@@ -222,9 +229,24 @@ HRESULT FunctionCallHeaderWithParametersNode::VerifyNonConstructor(__in Function
             // Get the signature information from that identifier and tell it to fill in the return type -
             // if it succeeds, that means that we have found the right function. If it fails, keep looking
             // for an overload that succeeds.
-            int genType;
+            int genType = NO_TYPE;
             TSmartPointer<GLSLType> spReturnType;
-            if (SUCCEEDED(pFuncInfo->GetSignature().SignatureMatchesArgumentTypes(aryArgTypes, &genType, &spReturnType)))
+            bool fMatched = false;
+            if (pFuncInfo->IsKnownFunction())
+            {
+                if (pKnownMatch != nullptr && pKnownMatch->_function == pFuncInfo->GetKnownFunction())
+                {
+                    genType = pKnownMatch->_genType;
+                    CHK(GLSLType::CreateFromBasicTypeToken(pKnownMatch->_returnType, &spReturnType));
+                    fMatched = true;
+                }
+            }
+            else
+            {
+                fMatched = SUCCEEDED(pFuncInfo->GetSignature().SignatureMatchesArgumentTypes(aryArgTypes, &genType, &spReturnType));
+            }
+
+            if (fMatched)
             {
                 // We found a function that matched. Before finalizing the return type and function identifier
                 // info, ensure the args are valid for the found parameter qualifiers.
@@ -244,6 +266,22 @@ HRESULT FunctionCallHeaderWithParametersNode::VerifyNonConstructor(__in Function
                 // Mark the function as called
                 pFuncInfo->SetCalled();
 
+                // Add the call to the call graph. Calls outside of a function (in
+                // global initializers) are not part of it, but are remembered so that
+                // dead code elimination keeps the functions they call.
+                if (!pFuncInfo->IsKnownFunction())
+                {
+                    FunctionDefinitionNode* pCallerDefinition = GetOwningFunctionDefinition();
+                    if (pCallerDefinition != nullptr)
+                    {
+                        CHK(pCallerDefinition->UseIdentifierInfo()->AddCallee(pFuncInfo));
+                    }
+                    else
+                    {
+                        pFuncInfo->SetCalledFromGlobalScope();
+                    }
+                }
+
                 // Let the parser know what HLSL function equivalent (if any) is being called
                 GetParser()->AddHLSLFunctionUsage(pFuncInfo->GetHLSLFunction());
                 _fHasSignature = true;
@@ -264,6 +302,38 @@ HRESULT FunctionCallHeaderWithParametersNode::VerifyNonConstructor(__in Function
     CHK_RETURN;
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   FindKnownFunctionMatch
+//
+//  Synopsis:   Look up what a call with the given argument types resolves
+//              to if the function is a known function. Known functions only
+//              take basic types, so if any argument is not a basic type
+//              there is no match.
+//
+//-----------------------------------------------------------------------------
+const CGLSLKnownFunctionIndex::Match* FunctionCallHeaderWithParametersNode::FindKnownFunctionMatch(
+    int iSymbolIndex,                                                   // Symbol of the function being called
+    const CModernArray<TSmartPointer<GLSLType>>& aryArgTypes            // Types of the arguments
+    )
+{
+    if (aryArgTypes.GetCount() > CGLSLKnownFunctionIndex::s_uMaxArgCount)
+    {
+        return nullptr;
+    }
+
+    int rgArgTypes[CGLSLKnownFunctionIndex::s_uMaxArgCount];
+    for (UINT i = 0; i < aryArgTypes.GetCount(); i++)
+    {
+        if (FAILED(aryArgTypes[i]->GetBasicType(&rgArgTypes[i])))
+        {
+            return nullptr;
+        }
+    }
+
+    return CGLSLKnownFunctionIndex::Find(iSymbolIndex, rgArgTypes, aryArgTypes.GetCount());
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   VerifyStructConstructor
@@ -600,7 +670,7 @@ HRESULT FunctionCallHeaderWithParametersNode::OutputHLSL(__in IStringStream* pOu
         break;
 
     case FunctionCallType::vectorConstructorFromMatrix:
-        CHK(pOutput->WriteString("GLSLvectorFromMatrix("));
+        CHK(pOutput->WriteLiteral("GLSLvectorFromMatrix("));
         break;
 
     default:
@@ -658,7 +728,7 @@ HRESULT FunctionCallHeaderWithParametersNode::OutputHLSL(__in IStringStream* pOu
     {
         // The float constructor call in matrixConstructorFromScalar requires a closing
         // paren to be added.
-        CHK(pOutput->WriteString(")"));
+        CHK(pOutput->WriteLiteral(")"));
     }
 
     CHK_RETURN;
@@ -835,48 +905,119 @@ HRESULT FunctionCallHeaderWithParametersNode::IsConstExpression(
         // Now check if we need to calculate this value
         if (*pfIsConstantExpression && pValue != nullptr)
         {
-            // We need to grab the constant value from the argument and convert it - since we are
-            // only currently supporting integer and float constructors, and these only take a single
-            // argument, we know we only care about the first argument.
-            bool fChildConst;
-            ConstantValue childValue;
-            CHKB(GetArgumentCount() == 1);
-            CHK(GetArgumentNode(0)->IsConstExpression(fIncludeIndex, &fChildConst, &childValue));
-
-            switch (_basicConstructType)
+            CHK(EvaluateConstructor(fIncludeIndex, pValue));
+        }
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   EvaluateConstructor
+//
+//  Synopsis:   Calculate the value of a constructor call with constant
+//              arguments. Constructors of int and float scalars, vectors and
+//              matrices are calculated from the components of the arguments,
+//              converting each to the type being constructed. Only the type
+//              is known for other constructors, or when an argument does not
+//              have a value.
+//
+//-----------------------------------------------------------------------------
+HRESULT FunctionCallHeaderWithParametersNode::EvaluateConstructor(
+    bool fIncludeIndex,                                 // Whether to include loop index in the definition of a constant expression
+    __out ConstantValue* pValue                         // The value of the constructor call
+    ) const
+{
+    CHK_START;
+
+    // Until we know otherwise, the type is all we have
+    pValue->SetTypeOnly(_basicConstructType);
+
+    // Constructing a matrix from one of a different shape, or a vector from a matrix, is not
+    // calculated. Neither are bool values.
+    int constructComponentType;
+    const bool fCalculated = (
+        (_functionCallType == FunctionCallType::constructor ||
+         _functionCallType == FunctionCallType::vectorConstructorFromScalar ||
+         _functionCallType == FunctionCallType::matrixConstructorFromScalar ||
+         _functionCallType == FunctionCallType::matrixConstructorFromComponents) &&
+        SUCCEEDED(TypeHelpers::GetComponentType(_basicConstructType, &constructComponentType)) &&
+        constructComponentType != BOOL_TOK
+        );
+
+    if (fCalculated)
+    {
+        ConstantValue result;
+        CHK(result.InitializeComponents(_basicConstructType));
+
+        // Fill in the components in order from the arguments. Verification has made sure that
+        // there are enough of them - the last argument can have more than are needed.
+        UINT cComponentsSet = 0;
+        bool fAllValues = true;
+        for (UINT i = 0; fAllValues && i < GetArgumentCount() && cComponentsSet < result.GetComponentCount(); i++)
+        {
+            ParseTreeNode* pArgument = GetArgumentNode(i);
+
+            TSmartPointer<GLSLType> spArgType;
+            CHK(pArgument->GetExpressionType(&spArgType));
+
+            // Only ask arguments made of ints and floats for a value, since those are
+            // the only ones that can provide one.
+            ConstantValue argValue;
+            int basicArgType;
+            int argComponentType;
+            if (SUCCEEDED(spArgType->GetBasicType(&basicArgType)) &&
+                SUCCEEDED(TypeHelpers::GetComponentType(basicArgType, &argComponentType)) &&
+                argComponentType != BOOL_TOK)
             {
-            case INT_TOK:
-                int intValue;
-                if (SUCCEEDED(childValue.AsInt(&intValue)))
-                {
-                    pValue->SetValue(intValue);
-                }
-                else
-                {
-                    // We know it is an int, we just don't know which one
-                    pValue->SetTypeOnly(INT_TOK);
-                }
-                break;
+                bool fArgConst;
+                CHK(pArgument->IsConstExpression(fIncludeIndex, &fArgConst, &argValue));
+            }
 
-            case FLOAT_TOK:
-                double doubleValue;
-                if (SUCCEEDED(childValue.AsDouble(&doubleValue)))
-                {
-                    pValue->SetValue(doubleValue);
-                }
-                else
+            fAllValues = argValue.HasValue();
+
+            for (UINT j = 0; fAllValues && j < argValue.GetComponentCount() && cComponentsSet < result.GetComponentCount(); j++)
+            {
+                ConstantValue component;
+                CHK(argValue.GetComponent(j, &component));
+
+                switch (_functionCallType)
                 {
-                    // We know it is a float, we just don't know which one
-                    pValue->SetTypeOnly(FLOAT_TOK);
-                }
-                break;
+                case FunctionCallType::vectorConstructorFromScalar:
+                    // The scalar goes in every component
+                    for (; cComponentsSet < result.GetComponentCount(); cComponentsSet++)
+                    {
+                        CHK(result.SetComponent(cComponentsSet, component));
+                    }
+                    break;
 
-            default:
-                // We can only set the type here
-                pValue->SetTypeOnly(_basicConstructType);
-                break;
+                case FunctionCallType::matrixConstructorFromScalar:
+                    {
+                        // The scalar goes on the diagonal, and the rest stay zero
+                        const UINT uMatrixLength = TypeHelpers::GetMatrixLength(_basicConstructType);
+                        for (UINT k = 0; k < uMatrixLength; k++)
+                        {
+                            CHK(result.SetComponent(k * uMatrixLength + k, component));
+                        }
+
+                        cComponentsSet = result.GetComponentCount();
+                    }
+                    break;
+
+                default:
+                    CHK(result.SetComponent(cComponentsSet, component));
+                    cComponentsSet++;
+                    break;
+                }
             }
         }
+
+        if (fAllValues)
+        {
+            CHKB(cComponentsSet == result.GetComponentCount());
+            (*pValue) = result;
+        }
     }
 
     CHK_RETURN;
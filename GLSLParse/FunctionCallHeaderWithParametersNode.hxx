@@ -28,6 +28,7 @@
 
 #include "CollectionNode.hxx"
 #include "GLSLFunctionSignature.hxx"
+#include "GLSLKnownFunctionIndex.hxx"
 #include "GLSL.tab.h"
 
 class FunctionIdentifierNode;
@@ -110,12 +111,22 @@ private:
 
     HRESULT GetArgumentTypes(__out CModernArray<TSmartPointer<GLSLType>>& aryTypes) const;
 
+    static const CGLSLKnownFunctionIndex::Match* FindKnownFunctionMatch(
+        int iSymbolIndex,                                               // Symbol of the function being called
+        const CModernArray<TSmartPointer<GLSLType>>& aryArgTypes        // Types of the arguments
+        );
+
     HRESULT OutputFunctionCallArgument(
         __in IStringStream* pOutput,                        // Stream to write output to
         UINT iChild,                                        // Child to output
         HLSLFunctions::Enum hlslFunction                    // Known hlsl function call that the arg is participating in
         );
 
+    HRESULT EvaluateConstructor(
+        bool fIncludeIndex,                                 // Whether to include loop index in the definition of a constant expression
+        __out ConstantValue* pValue                         // The value of the constructor call
+        ) const;
+
     HRESULT GetComponentCountForConstructorArgType(
         int basicArgType,                                   // Type of the argument
         bool fForMatrixConstructor,                         // Whether this is counting for a matrix ctor or not
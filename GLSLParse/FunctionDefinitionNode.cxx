@@ -95,7 +95,7 @@ HRESULT FunctionDefinitionNode::OutputHLSL(__in IStringStream* pOutput)
     // more readable, we insert a newline after it here. This used to be
     // a part of the prototype, but prototypes are also in forward declarations
     // and they need to handle newlines in a different way.
-    CHK(pOutput->WriteString("\n"));
+    CHK(pOutput->WriteLiteral("\n"));
 
     // Convert the compound statement
     CHK(GetChild(1)->OutputHLSL(pOutput));
@@ -145,6 +145,20 @@ bool FunctionDefinitionNode::IsScopeNode(
     }
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   UseScopeOpenedForVerification
+//
+//  Synopsis:   The prototype's scope covers the whole definition (see
+//              IsScopeNode), so it is opened for the body too and not just
+//              while the prototype itself is verified.
+//
+//-----------------------------------------------------------------------------
+CollectionNodeWithScope* FunctionDefinitionNode::UseScopeOpenedForVerification()
+{
+    return GetChild(0)->GetAs<FunctionPrototypeNode>();
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   AddReturnStatement
@@ -235,6 +249,22 @@ bool FunctionDefinitionNode::IsEntryPoint()
     return pHeader->IsEntryPoint();
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   UseIdentifierInfo
+//
+//  Synopsis:   Returns the info for the function being defined. This is set
+//              once the function header has been verified.
+//
+//-----------------------------------------------------------------------------
+CFunctionIdentifierInfo* FunctionDefinitionNode::UseIdentifierInfo()
+{
+    FunctionPrototypeNode* pProto = GetChild(0)->GetAs<FunctionPrototypeNode>();
+    FunctionHeaderWithParametersNode* pHeader = pProto->GetChild(0)->GetAs<FunctionHeaderWithParametersNode>();
+
+    return pHeader->UseIdentifierInfo();
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   GetDumpString
@@ -242,5 +272,5 @@ bool FunctionDefinitionNode::IsEntryPoint()
 //-----------------------------------------------------------------------------
 HRESULT FunctionDefinitionNode::GetDumpString(__in IStringStream* pOutput)
 {
-    return pOutput->WriteString("FunctionDefinitionNode");
+    return pOutput->WriteLiteral("FunctionDefinitionNode");
 }
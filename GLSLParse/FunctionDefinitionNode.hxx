@@ -31,6 +31,7 @@
 
 class TypeQualifierNode;
 class ReturnStatementNode;
+class CFunctionIdentifierInfo;
 
 //+-----------------------------------------------------------------------------
 //
@@ -66,12 +67,15 @@ public:
         __deref_out_opt ParseTreeNode** ppActual    // Tree node that is the actual scope
         ) override;
 
+    CollectionNodeWithScope* UseScopeOpenedForVerification() override;
+
     // For GetAs et al
     static ParseNodeType::Enum GetClassNodeType() { return ParseNodeType::functionDefinition; }
 
     // Other methods
     HRESULT AddReturnStatement(ReturnStatementNode* pNode);
     bool IsEntryPoint();
+    CFunctionIdentifierInfo* UseIdentifierInfo();
 
     ParseTreeNode* GetFunctionBody() const { return GetChild(1); }
 
@@ -86,11 +86,11 @@ HRESULT FunctionHeaderNode::OutputHLSL(__in IStringStream* pOutput)
         // The entry point is defined very deliberately
         if (GetParser()->GetShaderType() == GLSLShaderType::Vertex)
         {
-            CHK(pOutput->WriteString("void main(in VSInput vsInputArg, out PSInput psInputOut"));
+            CHK(pOutput->WriteLiteral("void main(in VSInput vsInputArg, out PSInput psInputOut"));
         }
         else
         {
-            CHK(pOutput->WriteString("void main(in PSInput psInputArg, out PSOutput psOutputOut"));
+            CHK(pOutput->WriteLiteral("void main(in PSInput psInputArg, out PSOutput psOutputOut"));
         }
     }
     else
@@ -48,7 +48,11 @@ CFunctionIdentifierInfo::CFunctionIdentifierInfo() :
     _fDeclared(false),
     _fDefined(false),
     _fCalled(false),
-    _hlslFunction(HLSLFunctions::count)
+    _fCalledFromGlobalScope(false),
+    _fReachable(false),
+    _uCallDepth(0),
+    _hlslFunction(HLSLFunctions::count),
+    _knownFunction(GLSLFunctions::count)
 {
 }
 
@@ -124,6 +128,7 @@ HRESULT CFunctionIdentifierInfo::Initialize(
     CHK_START;
 
     _hlslFunction = info._hlslEnum;
+    _knownFunction = info._indexEnum;
 
     // The symbol indices start with the known symbols so we can cast like this - see the
     // CGLSLParser::Initialize function for the code that asserts this.
@@ -158,3 +163,25 @@ void CFunctionIdentifierInfo::SetDefined(__in_opt FunctionDefinitionNode* pFuncD
     _fDefined = true;
     _spFunctionDefinition = pFuncDefinition;
 }
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddCallee
+//
+//  Synopsis:   Records that the definition of this function calls another
+//              one. Together these make up the call graph of the shader,
+//              which is built as the calls are verified. A function that is
+//              called more than once only gets one edge.
+//
+//+----------------------------------------------------------------------------
+HRESULT CFunctionIdentifierInfo::AddCallee(__in CFunctionIdentifierInfo* pCallee)
+{
+    CHK_START;
+
+    if (_aryCallees.Find(pCallee) == CModernArray<CFunctionIdentifierInfo*>::NotFound)
+    {
+        CHK(_aryCallees.Add(pCallee));
+    }
+
+    CHK_RETURN;
+}
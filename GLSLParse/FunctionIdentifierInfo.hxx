@@ -79,10 +79,20 @@ public:
     const FunctionDefinitionNode* UseFunctionDefinition() const { return _spFunctionDefinition; }
     void SetCalled() { _fCalled = true; }
     bool IsCalled() const { return _fCalled; }
+    void SetCalledFromGlobalScope() { _fCalledFromGlobalScope = true; }
+    bool IsCalledFromGlobalScope() const { return _fCalledFromGlobalScope; }
+    void SetReachable() { _fReachable = true; }
+    bool IsReachable() const { return _fReachable; }
+    HRESULT AddCallee(__in CFunctionIdentifierInfo* pCallee);
+    UINT GetCalleeCount() const { return _aryCallees.GetCount(); }
+    CFunctionIdentifierInfo* UseCallee(UINT uIndex) const { return _aryCallees[uIndex]; }
+    UINT GetCallDepth() const { return _uCallDepth; }
+    void SetCallDepth(UINT uCallDepth) { _uCallDepth = uCallDepth; }
     void SetDeclared() { _fDeclared = true; }
     bool IsDeclared() const { return _fDeclared; }
     const CGLSLFunctionSignature &GetSignature() const { return _signature; }
     HLSLFunctions::Enum GetHLSLFunction() const { return _hlslFunction; }
+    GLSLFunctions::Enum GetKnownFunction() const { return _knownFunction; }
 
     bool IsKnownFunction() const { return _hlslFunction != HLSLFunctions::count; }
 
@@ -92,7 +102,13 @@ private:
     int _iSymbolIndex;                                              // The index of the original GLSL name in the symbol table
     CGLSLFunctionSignature _signature;                              // The signature
     HLSLFunctions::Enum _hlslFunction;                              // The HLSL function that maps to this identifier
+    GLSLFunctions::Enum _knownFunction;                             // The known function this identifier is for, if any
     bool _fDeclared;                                                // Whether the function has a forward declaration
     bool _fDefined;                                                 // Whether the function has a definition
     bool _fCalled;                                                  // Whether the function is called anywhere in the shader
+    bool _fCalledFromGlobalScope;                                   // Whether the function is called from a global initializer
+    bool _fReachable;                                               // Whether the function can be called from the entry point, once dead code elimination has run
+    CModernArray<CFunctionIdentifierInfo*> _aryCallees;             // Functions called from the definition of this one, each listed once. Not
+                                                                    // referenced because calls can be recursive; the infos all live in the root scope.
+    UINT _uCallDepth;                                               // Length of the longest call chain starting here, once it has been computed
 };
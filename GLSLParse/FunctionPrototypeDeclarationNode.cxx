@@ -117,7 +117,7 @@ HRESULT FunctionPrototypeDeclarationNode::OutputHLSL(__in IStringStream* pOutput
     CHK(GetChild(0)->OutputHLSL(pOutput));
 
     // Terminate with a semicolon
-    CHK(pOutput->WriteString(";\n"));
+    CHK(pOutput->WriteLiteral(";\n"));
 
     CHK_RETURN;
 }
@@ -129,5 +129,5 @@ HRESULT FunctionPrototypeDeclarationNode::OutputHLSL(__in IStringStream* pOutput
 //-----------------------------------------------------------------------------
 HRESULT FunctionPrototypeDeclarationNode::GetDumpString(__in IStringStream* pOutput)
 {
-    return pOutput->WriteString("FunctionPrototypeDeclarationNode");
+    return pOutput->WriteLiteral("FunctionPrototypeDeclarationNode");
 }
@@ -105,7 +105,7 @@ HRESULT FunctionPrototypeNode::OutputHLSL(__in IStringStream* pOutput)
     // Function prototypes end with a closing right paren. The forward
     // declaration node will output a semicolon and the function definition will
     // output a newline appropriately after this.
-    CHK(pOutput->WriteString(")"));
+    CHK(pOutput->WriteLiteral(")"));
 
     CHK_RETURN;
 }
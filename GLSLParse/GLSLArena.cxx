@@ -0,0 +1,221 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#include "PreComp.hxx"
+#include "GLSLArena.hxx"
+#include "RefCounted.hxx"
+
+// The arena that allocations on this thread come from, if any
+static __declspec(thread) CGLSLArena* s_pCurrentArena = nullptr;
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Constructor
+//
+//-----------------------------------------------------------------------------
+CGLSLArena::CGLSLArena() :
+    _pChunks(nullptr),
+    _pNext(nullptr),
+    _pLimit(nullptr),
+    _uAllocationCount(0),
+    _uLiveObjectCount(0),
+    _uChunkCount(0),
+    _cbAllocated(0),
+    _cbReserved(0)
+{
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Destructor
+//
+//  Synopsis:   Frees all of the chunks in one pass. The owner has already
+//              released its references on the objects, so anything still
+//              alive here is only referenced by other objects in the arena
+//              and its memory can go with the chunks.
+//
+//-----------------------------------------------------------------------------
+CGLSLArena::~CGLSLArena()
+{
+    ChunkHeader* pChunk = _pChunks;
+    while (pChunk != nullptr)
+    {
+        ChunkHeader* pNextChunk = pChunk->_pNext;
+        delete [] reinterpret_cast<BYTE*>(pChunk);
+        pChunk = pNextChunk;
+    }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetCurrent
+//
+//  Synopsis:   Returns the arena for the current thread, if there is one.
+//
+//-----------------------------------------------------------------------------
+CGLSLArena* CGLSLArena::GetCurrent()
+{
+    return s_pCurrentArena;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   SetCurrent
+//
+//  Synopsis:   Sets the arena for the current thread. Used by CGLSLArenaScope.
+//
+//-----------------------------------------------------------------------------
+void CGLSLArena::SetCurrent(
+    __in_opt CGLSLArena* pArena                                 // Arena to make current
+    )
+{
+    s_pCurrentArena = pArena;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AllocateChunk
+//
+//  Synopsis:   Allocates a chunk with room for cbSize bytes and links it into
+//              the chunk list. Returns the start of the usable space.
+//
+//-----------------------------------------------------------------------------
+BYTE* CGLSLArena::AllocateChunk(
+    size_t cbSize                                               // Usable size of the chunk
+    )
+{
+    static_assert(sizeof(ChunkHeader) <= s_cbAlignment, "Chunk header must fit in the alignment padding");
+
+    BYTE* pChunk = new BYTE[s_cbAlignment + cbSize];
+    CHK_POINTER_ALLOC(pChunk);
+
+    ChunkHeader* pHeader = reinterpret_cast<ChunkHeader*>(pChunk);
+    pHeader->_pNext = _pChunks;
+    _pChunks = pHeader;
+    _uChunkCount++;
+    _cbReserved += s_cbAlignment + cbSize;
+
+    return pChunk + s_cbAlignment;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Allocate
+//
+//  Synopsis:   Carves an aligned block out of the current chunk, starting a
+//              new chunk when it is full. Large blocks get a chunk of their
+//              own so they do not waste the rest of the current chunk.
+//
+//-----------------------------------------------------------------------------
+void* CGLSLArena::Allocate(
+    size_t cbSize                                               // Size of the block
+    )
+{
+    cbSize = AlignSize(cbSize);
+    _cbAllocated += cbSize;
+    _uAllocationCount++;
+    _uLiveObjectCount++;
+
+    if (cbSize >= s_cbLargeAllocation)
+    {
+        return AllocateChunk(cbSize);
+    }
+
+    if (static_cast<size_t>(_pLimit - _pNext) < cbSize)
+    {
+        _pNext = AllocateChunk(s_cbChunkSize);
+        _pLimit = _pNext + s_cbChunkSize;
+    }
+
+    BYTE* pBlock = _pNext;
+    _pNext += cbSize;
+
+    return pBlock;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AllocateObject
+//
+//  Synopsis:   Allocates memory for an object from the current arena, or from
+//              the heap when there is no current arena. The block is preceded
+//              by a header recording where it came from.
+//
+//-----------------------------------------------------------------------------
+void* CGLSLArena::AllocateObject(
+    size_t cbSize                                               // Size of the object
+    )
+{
+    static_assert(sizeof(AllocationHeader) <= s_cbAlignment, "Allocation header must fit in the alignment padding");
+
+    CGLSLArena* pArena = s_pCurrentArena;
+
+    BYTE* pBlock;
+    if (pArena != nullptr)
+    {
+        pBlock = static_cast<BYTE*>(pArena->Allocate(s_cbAlignment + cbSize));
+    }
+    else
+    {
+        pBlock = new BYTE[s_cbAlignment + cbSize];
+        CHK_POINTER_ALLOC(pBlock);
+    }
+
+    reinterpret_cast<AllocationHeader*>(pBlock)->_pArena = pArena;
+
+    return pBlock + s_cbAlignment;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   FreeObject
+//
+//  Synopsis:   Frees memory allocated by AllocateObject. Arena memory is not
+//              reused, so freeing an arena object only updates the count of
+//              live objects; the memory comes back when the arena's chunks
+//              are freed.
+//
+//-----------------------------------------------------------------------------
+void CGLSLArena::FreeObject(
+    __in_opt void* pv                                           // Object memory to free
+    )
+{
+    if (pv != nullptr)
+    {
+        BYTE* pBlock = static_cast<BYTE*>(pv) - s_cbAlignment;
+        CGLSLArena* pArena = reinterpret_cast<AllocationHeader*>(pBlock)->_pArena;
+
+        if (pArena != nullptr)
+        {
+            Assert(pArena->_uLiveObjectCount > 0);
+            pArena->_uLiveObjectCount--;
+        }
+        else
+        {
+            delete [] pBlock;
+        }
+    }
+}
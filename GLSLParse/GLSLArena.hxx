@@ -0,0 +1,143 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#pragma once
+
+//+-----------------------------------------------------------------------------
+//
+//  Class:      CGLSLArena
+//
+//  Synopsis:   Bump allocator that owns the memory for the parse tree nodes
+//              created during one translation.
+//
+//              Nodes are carved out of large chunks, so creating them does
+//              not go to the heap. Freeing a node only returns its memory to
+//              the arena, and the chunks are freed together when the arena
+//              goes away. The owner of the arena (the parser) has to release
+//              every reference it holds on the tree before the arena, since
+//              nodes do not keep the arena alive. Anything that outlives the
+//              translation, like the identifier infos and types handed to
+//              the converted shader, is allocated from the heap instead.
+//
+//              Allocations only come from an arena while a CGLSLArenaScope
+//              for it is active on the current thread; otherwise they fall
+//              back to the heap.
+//
+//------------------------------------------------------------------------------
+class CGLSLArena : public IUnknown
+{
+public:
+    static void* AllocateObject(size_t cbSize);
+    static void FreeObject(__in_opt void* pv);
+
+    static CGLSLArena* GetCurrent();
+
+    UINT GetAllocationCount() const { return _uAllocationCount; }
+    UINT GetLiveObjectCount() const { return _uLiveObjectCount; }
+    UINT GetChunkCount() const { return _uChunkCount; }
+    size_t GetBytesAllocated() const { return _cbAllocated; }
+    size_t GetBytesReserved() const { return _cbReserved; }
+
+protected:
+    CGLSLArena();
+    ~CGLSLArena();
+
+    HRESULT Initialize() { return S_OK; }
+
+private:
+    void* Allocate(size_t cbSize);
+    BYTE* AllocateChunk(size_t cbSize);
+
+    static size_t AlignSize(size_t cbSize) { return (cbSize + s_cbAlignment - 1) & ~(s_cbAlignment - 1); }
+
+    friend class CGLSLArenaScope;
+    static void SetCurrent(__in_opt CGLSLArena* pArena);
+
+private:
+    struct ChunkHeader
+    {
+        ChunkHeader* _pNext;                                                // Next chunk in the list
+    };
+
+    struct AllocationHeader
+    {
+        CGLSLArena* _pArena;                                                // Arena the object came from, or null for the heap
+    };
+
+    static const size_t s_cbAlignment = MEMORY_ALLOCATION_ALIGNMENT;        // Alignment of every allocation
+    static const size_t s_cbChunkSize = 64 * 1024;                          // Size of a regular chunk
+    static const size_t s_cbLargeAllocation = s_cbChunkSize / 4;            // Allocations at least this big get their own chunk
+
+    ChunkHeader* _pChunks;                                                  // All chunks owned by the arena
+    BYTE* _pNext;                                                           // Next free byte in the current chunk
+    BYTE* _pLimit;                                                          // End of the current chunk
+    UINT _uAllocationCount;                                                 // Number of blocks handed out to objects
+    UINT _uLiveObjectCount;                                                 // Number of blocks handed out and not yet freed
+    UINT _uChunkCount;                                                      // Number of chunks allocated
+    size_t _cbAllocated;                                                    // Number of bytes handed out to objects
+    size_t _cbReserved;                                                     // Number of bytes held in chunks, including headers and unused space
+};
+
+//+-----------------------------------------------------------------------------
+//
+//  Class:      CGLSLArenaScope
+//
+//  Synopsis:   Makes an arena the current one for the thread for the lifetime
+//              of the scope, restoring the previous arena afterwards.
+//
+//------------------------------------------------------------------------------
+class CGLSLArenaScope
+{
+public:
+    CGLSLArenaScope(__in_opt CGLSLArena* pArena) : _pPrevious(CGLSLArena::GetCurrent())
+    {
+        CGLSLArena::SetCurrent(pArena);
+    }
+
+    ~CGLSLArenaScope()
+    {
+        CGLSLArena::SetCurrent(_pPrevious);
+    }
+
+private:
+    CGLSLArena* _pPrevious;                                                 // Arena that was current before this scope
+};
+
+//+-----------------------------------------------------------------------------
+//
+//  Class:      CGLSLArenaObject
+//
+//  Synopsis:   Base for classes whose instances should be allocated from the
+//              current arena. Only parse tree nodes should derive from this,
+//              since their memory goes away with the arena.
+//
+//------------------------------------------------------------------------------
+class CGLSLArenaObject
+{
+public:
+    static void* operator new(size_t cbSize) { return CGLSLArena::AllocateObject(cbSize); }
+    static void operator delete(void* pv) { CGLSLArena::FreeObject(pv); }
+};
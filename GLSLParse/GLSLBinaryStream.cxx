@@ -0,0 +1,264 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#include "PreComp.hxx"
+#include "GLSLBinaryStream.hxx"
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   WriteUInt
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLBinaryWriter::WriteUInt(UINT uValue)
+{
+    BYTE rgBytes[sizeof(UINT)];
+    for (UINT i = 0; i < sizeof(UINT); i++)
+    {
+        rgBytes[i] = static_cast<BYTE>(uValue >> (8 * i));
+    }
+
+    return WriteBytes(rgBytes, sizeof(rgBytes));
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   WriteUInt64
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLBinaryWriter::WriteUInt64(UINT64 uValue)
+{
+    CHK_START;
+
+    CHK(WriteUInt(static_cast<UINT>(uValue)));
+    CHK(WriteUInt(static_cast<UINT>(uValue >> 32)));
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   WriteBytes
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLBinaryWriter::WriteBytes(
+    __in_bcount(cbSize) const void* pData,                      // Bytes to write
+    UINT cbSize                                                 // Number of bytes
+    )
+{
+    CHK_START;
+
+    UINT uOldSize = _aryData.GetCount();
+    UINT uNewSize = uOldSize + cbSize;
+    CHKB_HR(uNewSize >= uOldSize, E_OUTOFMEMORY);
+
+    CHK(_aryData.Resize(uNewSize));
+    if (cbSize > 0)
+    {
+        ::memcpy(_aryData.GetData() + uOldSize, pData, cbSize);
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   WriteString
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLBinaryWriter::WriteString(__in_z_opt const char* pszValue)
+{
+    return WriteString(pszValue, (pszValue != nullptr) ? static_cast<UINT>(::strlen(pszValue)) : 0);
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   WriteString
+//
+//  Synopsis:   Writes the length, the characters and a null terminator.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLBinaryWriter::WriteString(
+    __in_ecount_opt(cchValue) const char* pchValue,             // Characters to write, or null
+    UINT cchValue                                               // Number of characters
+    )
+{
+    CHK_START;
+
+    if (pchValue == nullptr)
+    {
+        CHK(WriteUInt(s_uNullString));
+    }
+    else
+    {
+        CHKB(cchValue != s_uNullString);
+
+        CHK(WriteUInt(cchValue));
+        CHK(WriteBytes(pchValue, cchValue));
+
+        const BYTE nullTerminator = 0;
+        CHK(WriteBytes(&nullTerminator, sizeof(nullTerminator)));
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Constructor
+//
+//-----------------------------------------------------------------------------
+CGLSLBinaryReader::CGLSLBinaryReader(
+    __in_bcount(cbSize) const BYTE* pData,                      // Data to read
+    UINT cbSize                                                 // Size of the data
+    ) :
+    _pCurrent(pData),
+    _pEnd(pData + cbSize)
+{
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   ReadBytes
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLBinaryReader::ReadBytes(
+    UINT cbSize,                                                // Number of bytes to read
+    __deref_out_bcount(cbSize) const BYTE** ppData              // Pointer to the bytes in the buffer
+    )
+{
+    CHK_START;
+
+    CHKB_HR(static_cast<UINT>(_pEnd - _pCurrent) >= cbSize, E_GLSL_INVALIDDATA);
+
+    (*ppData) = _pCurrent;
+    _pCurrent += cbSize;
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   ReadUInt
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLBinaryReader::ReadUInt(__out UINT* puValue)
+{
+    CHK_START;
+
+    const BYTE* pBytes;
+    CHK(ReadBytes(sizeof(UINT), &pBytes));
+
+    UINT uValue = 0;
+    for (UINT i = 0; i < sizeof(UINT); i++)
+    {
+        uValue |= static_cast<UINT>(pBytes[i]) << (8 * i);
+    }
+
+    (*puValue) = uValue;
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   ReadInt
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLBinaryReader::ReadInt(__out int* piValue)
+{
+    CHK_START;
+
+    UINT uValue;
+    CHK(ReadUInt(&uValue));
+
+    (*piValue) = static_cast<int>(uValue);
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   ReadUInt64
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLBinaryReader::ReadUInt64(__out UINT64* puValue)
+{
+    CHK_START;
+
+    UINT uLow;
+    UINT uHigh;
+    CHK(ReadUInt(&uLow));
+    CHK(ReadUInt(&uHigh));
+
+    (*puValue) = (static_cast<UINT64>(uHigh) << 32) | uLow;
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   ReadString
+//
+//  Synopsis:   Reads a string written by CGLSLBinaryWriter::WriteString. The
+//              returned pointer points into the buffer and is only valid
+//              while the buffer is.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLBinaryReader::ReadString(
+    __deref_out_z_opt const char** ppszValue,                   // Pointer to the string in the buffer, or null
+    __out_opt UINT* pcchValue                                   // Length of the string
+    )
+{
+    CHK_START;
+
+    UINT cchValue;
+    CHK(ReadUInt(&cchValue));
+
+    const char* pszValue = nullptr;
+    if (cchValue != CGLSLBinaryWriter::s_uNullString)
+    {
+        // Read the terminator along with the characters and make sure it is there
+        CHKB_HR(cchValue < UINT_MAX - 1, E_GLSL_INVALIDDATA);
+
+        const BYTE* pBytes;
+        CHK(ReadBytes(cchValue + 1, &pBytes));
+        CHKB_HR(pBytes[cchValue] == 0, E_GLSL_INVALIDDATA);
+
+        pszValue = reinterpret_cast<const char*>(pBytes);
+    }
+    else
+    {
+        cchValue = 0;
+    }
+
+    (*ppszValue) = pszValue;
+    if (pcchValue != nullptr)
+    {
+        (*pcchValue) = cchValue;
+    }
+
+    CHK_RETURN;
+}
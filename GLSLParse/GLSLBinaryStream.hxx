@@ -0,0 +1,113 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#pragma once
+
+#include <foundation/collections.hxx>
+
+//+-----------------------------------------------------------------------------
+//
+//  Class:      CGLSLBinaryWriter
+//
+//  Synopsis:   Appends little endian values and strings to a growable byte
+//              buffer. The counterpart of CGLSLBinaryReader.
+//
+//              Strings are written as a length, the characters and a null
+//              terminator, so that a reader can hand out pointers into the
+//              buffer instead of copying. A null string is written with a
+//              length of s_uNullString.
+//
+//------------------------------------------------------------------------------
+class CGLSLBinaryWriter
+{
+public:
+    HRESULT WriteUInt(UINT uValue);
+    HRESULT WriteInt(int iValue) { return WriteUInt(static_cast<UINT>(iValue)); }
+    HRESULT WriteUInt64(UINT64 uValue);
+
+    HRESULT WriteBytes(
+        __in_bcount(cbSize) const void* pData,                              // Bytes to write
+        UINT cbSize                                                         // Number of bytes
+        );
+
+    HRESULT WriteString(__in_z_opt const char* pszValue);
+
+    HRESULT WriteString(
+        __in_ecount_opt(cchValue) const char* pchValue,                     // Characters to write, or null
+        UINT cchValue                                                       // Number of characters
+        );
+
+    const BYTE* GetData() const { return _aryData.GetData(); }
+    UINT GetSize() const { return _aryData.GetCount(); }
+
+    static const UINT s_uNullString = UINT_MAX;                             // Length written for a null string
+
+private:
+    CModernArray<BYTE> _aryData;                                            // Data written so far
+};
+
+//+-----------------------------------------------------------------------------
+//
+//  Class:      CGLSLBinaryReader
+//
+//  Synopsis:   Reads values written by CGLSLBinaryWriter from a buffer that the
+//              caller keeps alive, such as a mapped view of a file.
+//
+//              Every read is bounds checked, and reads past the end fail
+//              with E_GLSL_INVALIDDATA, so truncated or corrupt data is
+//              rejected instead of read out of bounds.
+//
+//------------------------------------------------------------------------------
+class CGLSLBinaryReader
+{
+public:
+    CGLSLBinaryReader(
+        __in_bcount(cbSize) const BYTE* pData,                              // Data to read
+        UINT cbSize                                                         // Size of the data
+        );
+
+    HRESULT ReadUInt(__out UINT* puValue);
+    HRESULT ReadInt(__out int* piValue);
+    HRESULT ReadUInt64(__out UINT64* puValue);
+
+    HRESULT ReadBytes(
+        UINT cbSize,                                                        // Number of bytes to read
+        __deref_out_bcount(cbSize) const BYTE** ppData                      // Pointer to the bytes in the buffer
+        );
+
+    HRESULT ReadString(
+        __deref_out_z_opt const char** ppszValue,                           // Pointer to the string in the buffer, or null
+        __out_opt UINT* pcchValue = nullptr                                 // Length of the string
+        );
+
+    bool IsAtEnd() const { return _pCurrent == _pEnd; }
+
+private:
+    const BYTE* _pCurrent;                                                  // Next byte to read
+    const BYTE* _pEnd;                                                      // End of the data
+};
+
+#define E_GLSL_INVALIDDATA HRESULT_FROM_WIN32(ERROR_INVALID_DATA)
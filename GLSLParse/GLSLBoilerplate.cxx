@@ -0,0 +1,783 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#include "PreComp.hxx"
+#include "GLSLBoilerplate.hxx"
+#include "GLSLParser.hxx"
+#include "WebGLConstants.hxx"
+
+//+----------------------------------------------------------------------------
+//
+//  Struct:     TextureFunctionInfo
+//
+//  Synopsis:   Struct used by AddTextureFunctions to store a table of
+//              functions.
+//
+//-----------------------------------------------------------------------------
+struct TextureFunctionInfo
+{
+    FeatureUsedFlags::Enum _enum;
+    bool _fBias;
+    bool _fLod;
+    const char* _pszName;
+    const char* _pszTextureType;
+    const char* _pszCoordType;
+    const char* _pszSampleFragFunction;
+    const char* _pszSampleExpression;
+};
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Write
+//
+//  Synopsis:   Write one section of boilerplate for a shader. The gl_Max*
+//              constants that start the globals come from the feature level
+//              and are formatted in a single call; everything else is copied
+//              from the segments laid out for the shader type.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLBoilerplate::Write(
+    GLSLShaderType::Enum shaderType,                            // Type of shader being translated
+    WebGLFeatureLevel glFeatureLevel,                           // Feature level being translated for
+    UINT uFeaturesUsed,                                         // FeatureUsedFlags of the shader
+    Section section,                                            // Which boilerplate to write
+    __in IStringStream* pOutput                                 // Where to write the code
+    )
+{
+    CHK_START;
+
+    const SegmentTable& table = GetSegmentTable(shaderType);
+    AssertSz((uFeaturesUsed & table._uUnsupportedFeatures) == 0, "Shader uses a texture function that is not available to its shader type");
+
+    if (section == Section::Globals)
+    {
+        const WebGLFeatureLevelData& data = WebGLFeatureLevelData::GetData(glFeatureLevel);
+
+        CHK(pOutput->WriteFormat(
+            512,
+            "static const int gl_MaxVertexAttribs = %d;\n"
+            "static const int gl_MaxVertexUniformVectors = %d;\n"
+            "static const int gl_MaxVaryingVectors = %d;\n"
+            "static const int gl_MaxVertexTextureImageUnits = %d;\n"
+            "static const int gl_MaxCombinedTextureImageUnits = %d;\n"
+            "static const int gl_MaxTextureImageUnits = %d;\n"
+            "static const int gl_MaxFragmentUniformVectors = %d;\n",
+            WEBGL_MAX_VERTEX_ATTRIBUTES,
+            data._uVertexUniformVectors,
+            data._uVaryingVectors,
+            data._uVertexSamplerCount,
+            data._uTotalSamplerCount,
+            data._uFragmentSamplerCount,
+            data._uFragmentUniformVectors
+            ));
+    }
+
+    const LevelCondition skipLevel = (glFeatureLevel >= WebGLFeatureLevel::Level_10) ? LevelCondition::Below10 : LevelCondition::AtLeast10;
+
+    const UINT uSection = static_cast<UINT>(section);
+    for (UINT i = table._rgFirstSegment[uSection]; i < table._rgFirstSegment[uSection + 1]; i++)
+    {
+        const Segment& segment = table._rgSegments[i];
+        if ((segment._uAnyFeatures == 0 || (uFeaturesUsed & segment._uAnyFeatures) != 0) && segment._level != skipLevel)
+        {
+            CHK(pOutput->WriteBuffer(&table._rgchText[segment._uOffset], segment._cchText));
+        }
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetSegmentTable
+//
+//  Synopsis:   Get the process-wide segments for a shader type. They are laid
+//              out on first use (the static locals make that thread safe)
+//              and never change afterwards, so they can be read without
+//              locking.
+//
+//-----------------------------------------------------------------------------
+const CGLSLBoilerplate::SegmentTable& CGLSLBoilerplate::GetSegmentTable(GLSLShaderType::Enum shaderType)
+{
+    if (shaderType == GLSLShaderType::Vertex)
+    {
+        static const SegmentTable s_vertexTable(GLSLShaderType::Vertex);
+        return s_vertexTable;
+    }
+    else
+    {
+        static const SegmentTable s_fragmentTable(GLSLShaderType::Fragment);
+        return s_fragmentTable;
+    }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   SegmentTable constructor
+//
+//  Synopsis:   Lay out every section for the shader type, in the order the
+//              text appears in the translated shader.
+//
+//-----------------------------------------------------------------------------
+CGLSLBoilerplate::SegmentTable::SegmentTable(GLSLShaderType::Enum shaderType) :
+    _cchText(0),
+    _cSegments(0),
+    _uSectionStart(0),
+    _uUnsupportedFeatures(0)
+{
+    BeginSection(Section::Globals);
+    AddGlobals(shaderType);
+
+    BeginSection(Section::EntryPointBegin);
+    AddEntryPointBegin(shaderType);
+
+    BeginSection(Section::EntryPointEnd);
+    AddEntryPointEnd(shaderType);
+
+    _rgFirstSegment[static_cast<UINT>(Section::Count)] = _cSegments;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   BeginSection
+//
+//  Synopsis:   Start adding the segments for the next section. Segments are
+//              never merged across sections.
+//
+//-----------------------------------------------------------------------------
+void CGLSLBoilerplate::SegmentTable::BeginSection(Section section)
+{
+    _rgFirstSegment[static_cast<UINT>(section)] = _cSegments;
+    _uSectionStart = _cSegments;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddText
+//
+//  Synopsis:   Add literal text to the section being laid out.
+//
+//-----------------------------------------------------------------------------
+void CGLSLBoilerplate::SegmentTable::AddText(
+    UINT uAnyFeatures,                                          // Features that the text needs, if any
+    LevelCondition level,                                       // Feature levels that the text is for
+    __in_z const char* pszText                                  // Text to add
+    )
+{
+    size_t cchText;
+    if (SUCCEEDED(::StringCchLengthA(pszText, s_cchMaxText, &cchText)) &&
+        SUCCEEDED(::StringCchCopyNA(&_rgchText[_cchText], s_cchMaxText - _cchText, pszText, cchText)))
+    {
+        AddSegment(uAnyFeatures, level, static_cast<UINT>(cchText));
+    }
+    else
+    {
+        AssertSz(false, "Boilerplate table is too small for its text");
+    }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddFormattedText
+//
+//  Synopsis:   printf-style version of AddText, for text that is written for
+//              every feature level.
+//
+//-----------------------------------------------------------------------------
+void CGLSLBoilerplate::SegmentTable::AddFormattedText(
+    UINT uAnyFeatures,                                          // Features that the text needs, if any
+    __in_z const char* pszFormat,                               // printf-style format for the text
+    ...
+    )
+{
+    va_list args;
+    va_start(args, pszFormat);
+
+    char* pszDest = &_rgchText[_cchText];
+    size_t cchText;
+    if (SUCCEEDED(::StringCchVPrintfA(pszDest, s_cchMaxText - _cchText, pszFormat, args)) &&
+        SUCCEEDED(::StringCchLengthA(pszDest, s_cchMaxText - _cchText, &cchText)))
+    {
+        AddSegment(uAnyFeatures, LevelCondition::Any, static_cast<UINT>(cchText));
+    }
+    else
+    {
+        AssertSz(false, "Boilerplate table is too small for its text");
+    }
+
+    va_end(args);
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddSegment
+//
+//  Synopsis:   Account for text that was just added at the end of _rgchText.
+//              If the last segment of the section has the same guard, the
+//              text simply extends it, since the two runs are adjacent.
+//
+//-----------------------------------------------------------------------------
+void CGLSLBoilerplate::SegmentTable::AddSegment(
+    UINT uAnyFeatures,                                          // Features that the text needs, if any
+    LevelCondition level,                                       // Feature levels that the text is for
+    UINT cchText                                                // Length of the text just added to _rgchText
+    )
+{
+    if (_cSegments > _uSectionStart)
+    {
+        Segment& last = _rgSegments[_cSegments - 1];
+        if (last._uAnyFeatures == uAnyFeatures && last._level == level)
+        {
+            Assert(last._uOffset + last._cchText == _cchText);
+
+            last._cchText += cchText;
+            _cchText += cchText;
+            return;
+        }
+    }
+
+    Assert(_cSegments < s_uMaxSegmentCount);
+    if (_cSegments < s_uMaxSegmentCount)
+    {
+        Segment& segment = _rgSegments[_cSegments];
+        segment._uAnyFeatures = uAnyFeatures;
+        segment._level = level;
+        segment._uOffset = _cchText;
+        segment._cchText = cchText;
+
+        _cSegments++;
+        _cchText += cchText;
+    }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddGlobals
+//
+//  Synopsis:   Lay out the text that is inserted right after the input and
+//              output structure definitions, following the gl_Max*
+//              constants.
+//
+//-----------------------------------------------------------------------------
+void CGLSLBoilerplate::SegmentTable::AddGlobals(GLSLShaderType::Enum shaderType)
+{
+    AddText(FeatureUsedFlags::None, LevelCondition::Any, "static const int gl_MaxDrawBuffers = 1;\n");
+
+    // Both shaders have the PS input - it is the output of the vertex shader
+    AddText(FeatureUsedFlags::None, LevelCondition::Any, "static PSInput psInput;\n");
+
+    if (shaderType == GLSLShaderType::Vertex)
+    {
+        // Vertex shader has VS input structure
+        AddText(FeatureUsedFlags::None, LevelCondition::Any, "static VSInput vsInput;\n");
+
+        // We need to declare a variable that represents the flipped position
+        AddText(FeatureUsedFlags::None, LevelCondition::Any, "static float4 flippedPosition = float4(0.0, 0.0, 0.0, 1.0);\n");
+
+        // We need to declare a global that is used by both the point size and frag coord code
+        // It contains the viewport width/2 and height/2 in x and y, respectively,
+        // and viewportX + width/2 and viewportY + height/2 in z and w, respectively
+        // (see CDXRenderTarget3D::PrepareConstantBufferData of emulation variables).
+        AddText(FeatureUsedFlags::None, LevelCondition::Any, "float4 viewportHalfDim;\n");
+
+        AddText(FeatureUsedFlags::glPointSize, LevelCondition::Any, "static float gl_PointSize = 0.0;\n");
+        AddText(
+            FeatureUsedFlags::glPointSize,
+            LevelCondition::Any,
+            "float2 AdjustPositionByPointSize(in float4 pos, in VSInput vsInput)\n"
+            "{\n"
+            // According to the spec, negative values for point size are undefined.  We'll
+            // play it safe and turn negative values to 1.0
+            "float pointSize = max(gl_PointSize, 1.0);\n"
+
+            // According to the spec, point rasterization needs to produce a fragment
+            // for each framebuffer pixels whose center lies inside the square who's side
+            // is equal to gl_PointSize.
+            // The units of point size are in drawingBuffer pixels: [0, viewportSize]. The position 
+            // is in homogeneous coordinates [-w, w]. In distance terms, that gives [0,2*w].
+            // To linearly interpolate between the two, we solve for the equation of a line
+            // y - y1 = ((y2-y1)/(x2-x1))*(x - x1)
+            // y - 0 = (2*w/viewportSize)*(x-0)
+            // y = (2*w/viewportSize)*(x)
+            // Here, y is the length of the square we need to render.  Since the passed in point (pos)
+            // lies in the center of the square, we need to offset the point by gl_PointSize / 2.  
+            // Plugging in gl_PointSize/2 as x (above), we get y = gl_PointSize*w/viewportSize.  Y is now 
+            // the distance we need to move the point left or right of the center. We assign this value to
+            // distanceFactor in the code below.
+            // vsInput.instanceInput has values of -1 or 1, depending on which corner of the square we're
+            // on.  If we multiply the it by the distanceFactor*pointSize, this will move the vertex in the 
+            // correct direction.  If the web developer elects to draw with triangles instead of points, 
+            // the render target will ensure that instanceInfo is filled with zeros.  Hence, the vertex
+            // will not move at all since (pos + (0 * ABunchOfStuff)) equals pos.
+            // Also, remember that viewportHalfDim.xy have half the size values, so multiply those by
+            // two in the calculation below.
+            "float2 distanceFactor = float2(pos.w / (viewportHalfDim.x *2), pos.w / (viewportHalfDim.y *2));\n"
+            "return float2(pos.xy + (vsInput.instanceInfo.xy * distanceFactor * pointSize));\n"
+            "}\n"
+            );
+    }
+
+    // Declare the depth range variable that is set by the constant buffer setup
+    AddText(FeatureUsedFlags::glFragCoord | FeatureUsedFlags::glDepthRange, LevelCondition::Any, "float4 depthRange;\n");
+
+    if (shaderType == GLSLShaderType::Fragment)
+    {
+        // Fragment shader has PS output structure
+        AddText(FeatureUsedFlags::None, LevelCondition::Any, "static PSOutput psOutput;\n");
+
+        // Declare the fragment coordinate variable - this needs to be a global
+        AddText(FeatureUsedFlags::glFragCoord, LevelCondition::Any, "static float4 gl_FragCoord;\n");
+
+        // Declare the front facing variable - this needs to be a global
+        AddText(FeatureUsedFlags::glFrontFacing, LevelCondition::Any, "static bool gl_FrontFacing;\n");
+
+        // The gl_PointCoord variable is written to at the beginning of the pixel shader. 
+        AddText(FeatureUsedFlags::glPointCoord, LevelCondition::Any, "static float2 gl_PointCoord = float2(0.0, 1.0);\n");
+
+        AddText(FeatureUsedFlags::glFragCoord, LevelCondition::Any, "float4 viewportHalfDim;\n");
+    }
+
+    // Other things (like intrinsic function simulators) go here
+    AddText(
+        FeatureUsedFlags::GLSLsign,
+        LevelCondition::Any,
+        "float GLSLsign(float x) { return float(sign(x)); }\n"
+        "float2 GLSLsign(float2 x) { return float2(sign(x)); }\n"
+        "float3 GLSLsign(float3 x) { return float3(sign(x)); }\n"
+        "float4 GLSLsign(float4 x) { return float4(sign(x)); }\n"
+        );
+
+    AddText(
+        FeatureUsedFlags::GLSLmod,
+        LevelCondition::Any,
+        "float GLSLmod(float x, float y) { return (x - y * floor(x / y)); }\n"
+        "float2 GLSLmod(float2 x, float2 y) { return (x - y * floor(x / y)); }\n"
+        "float3 GLSLmod(float3 x, float3 y) { return (x - y * floor(x / y)); }\n"
+        "float4 GLSLmod(float4 x, float4 y) { return (x - y * floor(x / y)); }\n"
+        );
+
+    AddText(
+        FeatureUsedFlags::GLSLmatrixCompMult,
+        LevelCondition::Any,
+        "float2x2 GLSLmatrixCompMult(float2x2 x, float2x2 y) { return x * y; }\n"
+        "float3x3 GLSLmatrixCompMult(float3x3 x, float3x3 y) { return x * y; }\n"
+        "float4x4 GLSLmatrixCompMult(float4x4 x, float4x4 y) { return x * y; }\n"
+        );
+
+    AddText(
+        FeatureUsedFlags::GLSLlessThan,
+        LevelCondition::Any,
+        "bool2 GLSLlessThan(float2 x, float2 y) { return x < y; }\n"
+        "bool3 GLSLlessThan(float3 x, float3 y) { return x < y; }\n"
+        "bool4 GLSLlessThan(float4 x, float4 y) { return x < y; }\n"
+        "bool2 GLSLlessThan(int2 x, int2 y) { return x < y; }\n"
+        "bool3 GLSLlessThan(int3 x, int3 y) { return x < y; }\n"
+        "bool4 GLSLlessThan(int4 x, int4 y) { return x < y; }\n"
+        );
+
+    AddText(
+        FeatureUsedFlags::GLSLlessThanEqual,
+        LevelCondition::Any,
+        "bool2 GLSLlessThanEqual(float2 x, float2 y) { return x <= y; }\n"
+        "bool3 GLSLlessThanEqual(float3 x, float3 y) { return x <= y; }\n"
+        "bool4 GLSLlessThanEqual(float4 x, float4 y) { return x <= y; }\n"
+        "bool2 GLSLlessThanEqual(int2 x, int2 y) { return x <= y; }\n"
+        "bool3 GLSLlessThanEqual(int3 x, int3 y) { return x <= y; }\n"
+        "bool4 GLSLlessThanEqual(int4 x, int4 y) { return x <= y; }\n"
+        );
+
+    AddText(
+        FeatureUsedFlags::GLSLgreaterThan,
+        LevelCondition::Any,
+        "bool2 GLSLgreaterThan(float2 x, float2 y) { return x > y; }\n"
+        "bool3 GLSLgreaterThan(float3 x, float3 y) { return x > y; }\n"
+        "bool4 GLSLgreaterThan(float4 x, float4 y) { return x > y; }\n"
+        "bool2 GLSLgreaterThan(int2 x, int2 y) { return x > y; }\n"
+        "bool3 GLSLgreaterThan(int3 x, int3 y) { return x > y; }\n"
+        "bool4 GLSLgreaterThan(int4 x, int4 y) { return x > y; }\n"
+        );
+
+    AddText(
+        FeatureUsedFlags::GLSLgreaterThanEqual,
+        LevelCondition::Any,
+        "bool2 GLSLgreaterThanEqual(float2 x, float2 y) { return x >= y; }\n"
+        "bool3 GLSLgreaterThanEqual(float3 x, float3 y) { return x >= y; }\n"
+        "bool4 GLSLgreaterThanEqual(float4 x, float4 y) { return x >= y; }\n"
+        "bool2 GLSLgreaterThanEqual(int2 x, int2 y) { return x >= y; }\n"
+        "bool3 GLSLgreaterThanEqual(int3 x, int3 y) { return x >= y; }\n"
+        "bool4 GLSLgreaterThanEqual(int4 x, int4 y) { return x >= y; }\n"
+        );
+
+    AddText(
+        FeatureUsedFlags::GLSLequal,
+        LevelCondition::Any,
+        "bool2 GLSLequal(float2 x, float2 y) { return x == y; }\n"
+        "bool3 GLSLequal(float3 x, float3 y) { return x == y; }\n"
+        "bool4 GLSLequal(float4 x, float4 y) { return x == y; }\n"
+        "bool2 GLSLequal(int2 x, int2 y) { return x == y; }\n"
+        "bool3 GLSLequal(int3 x, int3 y) { return x == y; }\n"
+        "bool4 GLSLequal(int4 x, int4 y) { return x == y; }\n"
+        "bool2 GLSLequal(bool2 x, bool2 y) { return x == y; }\n"
+        "bool3 GLSLequal(bool3 x, bool3 y) { return x == y; }\n"
+        "bool4 GLSLequal(bool4 x, bool4 y) { return x == y; }\n"
+        );
+
+    AddText(
+        FeatureUsedFlags::GLSLnotEqual,
+        LevelCondition::Any,
+        "bool2 GLSLnotEqual(float2 x, float2 y) { return x != y; }\n"
+        "bool3 GLSLnotEqual(float3 x, float3 y) { return x != y; }\n"
+        "bool4 GLSLnotEqual(float4 x, float4 y) { return x != y; }\n"
+        "bool2 GLSLnotEqual(int2 x, int2 y) { return x != y; }\n"
+        "bool3 GLSLnotEqual(int3 x, int3 y) { return x != y; }\n"
+        "bool4 GLSLnotEqual(int4 x, int4 y) { return x != y; }\n"
+        "bool2 GLSLnotEqual(bool2 x, bool2 y) { return x != y; }\n"
+        "bool3 GLSLnotEqual(bool3 x, bool3 y) { return x != y; }\n"
+        "bool4 GLSLnotEqual(bool4 x, bool4 y) { return x != y; }\n"
+        );
+
+    AddText(
+        FeatureUsedFlags::GLSLnot,
+        LevelCondition::Any,
+        "bool2 GLSLnot(bool2 x) { return !x; }\n"
+        "bool3 GLSLnot(bool3 x) { return !x; }\n"
+        "bool4 GLSLnot(bool4 x) { return !x; }\n"
+        );
+
+    AddTextureFunctions(shaderType);
+
+    AddText(
+        FeatureUsedFlags::GLSLmatrixFromScalar,
+        LevelCondition::Any,
+        "float2x2 GLSLmatrix2FromScalar(float x) { return float2x2(x, 0, 0, x); }\n"
+        "float3x3 GLSLmatrix3FromScalar(float x) { return float3x3(x, 0, 0, 0, x, 0, 0, 0, x); }\n"
+        "float4x4 GLSLmatrix4FromScalar(float x) { return float4x4(x, 0, 0, 0, 0, x, 0, 0, 0, 0, x, 0, 0, 0, 0, x); }\n"
+        );
+
+    AddText(
+        FeatureUsedFlags::GLSLmatrixFromMatrix,
+        LevelCondition::Any,
+        // Create 2x2
+        "float2x2 GLSLmatrix2FromMatrix3(float3x3 x) { return float2x2(x[0].xy, x[1].xy); }\n"
+        "float2x2 GLSLmatrix2FromMatrix4(float4x4 x) { return float2x2(x[0].xy, x[1].xy); }\n"
+
+        // Create 3x3
+        "float3x3 GLSLmatrix3FromMatrix2(float2x2 x) { return float3x3(x[0], 0, x[1], 0, 0, 0, 1); }\n"
+        "float3x3 GLSLmatrix3FromMatrix4(float4x4 x) { return float3x3(x[0].xyz, x[1].xyz, x[2].xyz); }\n"
+
+        // Create 4x4
+        "float4x4 GLSLmatrix4FromMatrix2(float2x2 x) { return float4x4(x[0].xy, 0, 0, x[1].xy, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1); }\n"
+        "float4x4 GLSLmatrix4FromMatrix3(float3x3 x) { return float4x4(x[0].xyz, 0, x[1].xyz, 0, x[2].xyz, 0, 0, 0, 0, 1); }\n"
+        );
+
+    AddText(
+        FeatureUsedFlags::GLSLvectorFromMatrix,
+        LevelCondition::Any,
+        "float4 GLSLvectorFromMatrix(float2x2 x) { return float4(x[0], x[1]); }\n"
+        );
+
+    AddText(
+        FeatureUsedFlags::GLSLfwidth,
+        LevelCondition::Any,
+        "float GLSLfwidth(float x) { return abs(ddx(x)) + abs(ddy(x)); }\n"
+        "float2 GLSLfwidth(float2 x) { return abs(ddx(x)) + abs(ddy(x)); }\n"
+        "float3 GLSLfwidth(float3 x) { return abs(ddx(x)) + abs(ddy(x)); }\n"
+        "float4 GLSLfwidth(float4 x) { return abs(ddx(x)) + abs(ddy(x)); }\n"
+        );
+
+    // The gl_DepthRangeParameters struct is available regardless of whether or not
+    // the gl_DepthRange variable/glDepthRange feature is used. Always output this struct definition.
+    AddText(
+        FeatureUsedFlags::None,
+        LevelCondition::Any,
+        "struct gl_DepthRangeParameters\n"
+        "{\n"
+        "float near;\n"
+        "float far;\n"
+        "float diff;\n"
+        "};\n"
+        );
+
+    // Output the gl_DepthRange variable if it is used in this shader.
+    AddText(FeatureUsedFlags::glDepthRange, LevelCondition::Any, "static gl_DepthRangeParameters gl_DepthRange;\n");
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddTextureFunctions
+//
+//  Synopsis:   Lay out the texture function wrappers, each guarded by its
+//              feature used code. All of the functions look very similar,
+//              they just vary argument counts and types.
+//
+//              Bias versions are only available to fragment shaders and lod
+//              versions only to vertex shaders; the others are recorded as
+//              unsupported for the shader type.
+//
+//-----------------------------------------------------------------------------
+void CGLSLBoilerplate::SegmentTable::AddTextureFunctions(GLSLShaderType::Enum shaderType)
+{
+    static const TextureFunctionInfo rgFunctionInfo[] = {
+            /* name                                     bias    lod     functionname                texture coord       hlsl frag       expr */
+        {   FeatureUsedFlags::GLSLtexture2D,            false,  false,  "GLSLtexture2D",            "2D",   "float2",   "Sample",       "coord" },
+        {   FeatureUsedFlags::GLSLtexture2DBias,        true,   false,  "GLSLtexture2DBias",        "2D",   "float2",   "SampleBias",   "coord" },
+        {   FeatureUsedFlags::GLSLtexture2DLod,         false,  true,   "GLSLtexture2DLod",         "2D",   "float2",   nullptr,        "coord" },
+        {   FeatureUsedFlags::GLSLtexture2DProj,        false,  false,  "GLSLtexture2DProj",        "2D",   "float3",   "Sample",       "coord.xy / coord.z" },
+        {   FeatureUsedFlags::GLSLtexture2DProj_1,      false,  false,  "GLSLtexture2DProj",        "2D",   "float4",   "Sample",       "coord.xy / coord.w" },
+        {   FeatureUsedFlags::GLSLtexture2DProjBias,    true,   false,  "GLSLtexture2DProjBias",    "2D",   "float3",   "SampleBias",   "coord.xy / coord.z" },
+        {   FeatureUsedFlags::GLSLtexture2DProjBias_1,  true,   false,  "GLSLtexture2DProjBias",    "2D",   "float4",   "SampleBias",   "coord.xy / coord.w" },
+        {   FeatureUsedFlags::GLSLtexture2DProjLod,     false,  true,   "GLSLtexture2DProjLod",     "2D",   "float3",   nullptr,        "coord.xy / coord.z" },
+        {   FeatureUsedFlags::GLSLtexture2DProjLod_1,   false,  true,   "GLSLtexture2DProjLod",     "2D",   "float4",   nullptr,        "coord.xy / coord.w" },
+        {   FeatureUsedFlags::GLSLtextureCube,          false,  false,  "GLSLtextureCube",          "Cube", "float3",   "Sample",       "coord" },
+        {   FeatureUsedFlags::GLSLtextureCubeBias,      true,   false,  "GLSLtextureCubeBias",      "Cube", "float3",   "SampleBias",   "coord" },
+        {   FeatureUsedFlags::GLSLtextureCubeLod,       false,  true,   "GLSLtextureCubeLod",       "Cube", "float3",   nullptr,        "coord" },
+    };
+
+    for (UINT i = 0; i < ARRAYSIZE(rgFunctionInfo); i++)
+    {
+        const TextureFunctionInfo& info = rgFunctionInfo[i];
+
+        if (info._fBias)
+        {
+            AssertSz(!info._fLod, "Bias and Lod cannot be combined with texture functions");
+
+            if (shaderType == GLSLShaderType::Fragment)
+            {
+                AddFormattedText(
+                    info._enum,
+                    "float4 %s(SamplerState s, Texture%s<float4> t, %s coord, float bias) { return t.%s(s, %s, bias); }\n",
+                    info._pszName,
+                    info._pszTextureType,
+                    info._pszCoordType,
+                    info._pszSampleFragFunction,
+                    info._pszSampleExpression
+                    );
+            }
+            else
+            {
+                // Vertex shaders should not request bias version of functions
+                _uUnsupportedFeatures |= info._enum;
+            }
+        }
+        else if (info._fLod)
+        {
+            if (shaderType == GLSLShaderType::Vertex)
+            {
+                AddFormattedText(
+                    info._enum,
+                    "float4 %s(SamplerState s, Texture%s<float4> t, %s coord, float lod) { return t.SampleLevel(s, %s, lod); }\n",
+                    info._pszName,
+                    info._pszTextureType,
+                    info._pszCoordType,
+                    info._pszSampleExpression
+                    );
+            }
+            else
+            {
+                // Fragment shaders should not request lod version of functions
+                _uUnsupportedFeatures |= info._enum;
+            }
+        }
+        else
+        {
+            if (shaderType == GLSLShaderType::Vertex)
+            {
+                AddFormattedText(
+                    info._enum,
+                    "float4 %s(SamplerState s, Texture%s<float4> t, %s coord) { return t.SampleLevel(s, %s, 0.0); }\n",
+                    info._pszName,
+                    info._pszTextureType,
+                    info._pszCoordType,
+                    info._pszSampleExpression
+                    );
+            }
+            else
+            {
+                AddFormattedText(
+                    info._enum,
+                    "float4 %s(SamplerState s, Texture%s<float4> t, %s coord) { return t.%s(s, %s); }\n",
+                    info._pszName,
+                    info._pszTextureType,
+                    info._pszCoordType,
+                    info._pszSampleFragFunction,
+                    info._pszSampleExpression
+                    );
+            }
+        }
+    }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddEntryPointBegin
+//
+//  Synopsis:   Lay out the code that we have at the beginning of each entry
+//              point.
+//
+//-----------------------------------------------------------------------------
+void CGLSLBoilerplate::SegmentTable::AddEntryPointBegin(GLSLShaderType::Enum shaderType)
+{
+    if (shaderType == GLSLShaderType::Vertex)
+    {
+        AddText(FeatureUsedFlags::None, LevelCondition::Any, "vsInput = vsInputArg;\n");
+    }
+
+    if (shaderType == GLSLShaderType::Fragment)
+    {
+        AddText(FeatureUsedFlags::None, LevelCondition::Any, "psInput = psInputArg;\n");
+
+        // Store the inverse w value, we'll use it a few times in calculations below.
+        AddText(FeatureUsedFlags::glFragCoord, LevelCondition::Any, "float wInverse = 1.0 / psInput.fragCoord.w;\n");
+
+        // In feature level 10+ (real shader model 4) we can just use SV_Position's calculation of the x and y
+        // frag coord values. Since everything in the pixel shader is 'right side up' (i.e. we've executed the
+        // y-flip upon vertex shader output, which will be undone with a transform on the canvas image),
+        // we do not have to adjust for y-flipping.
+        AddText(FeatureUsedFlags::glFragCoord, LevelCondition::AtLeast10, "gl_FragCoord.xy = psInput.position.xy;\n");
+
+        // In feature levels < 10 we must calculate this ourselves. Window coordinates in WebGL are defined as
+        //
+        //      (xw, yx) = (px/2 * xd + ox, py/2 * yd + oy)
+        //
+        // where px is viewport width, py is viewport height, ox is viewport x origin (x offset + width/2), and 
+        // oy is viewport y origin (y offset + height/2).
+        // Also, xd and yd are normalized device coordinates which are given by
+        //
+        //      (xd, yd) = (xc / wc, yc / wc)
+        //
+        // where xc and yc are clip coordinates. Clip coordinates are the coordinates output from the vertex shader.
+        // To derive xd and yd, we must perform the perspective divide by multiplying by wInverse.
+        //
+        // The emulation variable sets viewportHalfDim x and y to px and py, respectively
+        // and z and w to ox and oy, respectively. Use these to calculate the fragcoord.
+        AddText(
+            FeatureUsedFlags::glFragCoord,
+            LevelCondition::Below10,
+            "gl_FragCoord.x = viewportHalfDim.x * (psInput.fragCoord.x * wInverse) + viewportHalfDim.z;\n"
+            "gl_FragCoord.y = viewportHalfDim.y * (psInput.fragCoord.y * wInverse) + viewportHalfDim.w;\n"
+            );
+
+        // gl_FragCoord corresponds to window coordinates, so we calculate the z value using
+        // the equation given in the OpenGL ES spec; namely
+        //
+        //      zw = (((far - near) / 2) * zd) + ((near + far) / 2)
+        //
+        // The depthRange constants are set by the render target prior to drawing as the following:
+        //      depthRange.x = (far - near) / 2
+        //      depthRange.y = (near + far) / 2
+        //      depthRange.z = near
+        //      depthRange.w = far
+        // These were chosen to minimize the number of instructions in the pixel shader and are constant
+        // for a given draw pass (see DXRenderTarget3D.cxx). With the values in depthRange, the equation reduces to
+        //
+        //      zw = (depthRange.x * zd) + depthRange.y
+        //
+        // where zd is the z-value after perspective divide (i.e. input.z / input.w).
+        //
+        // gl_FragCoord.w is just the inverse of the w value at the given pixel.
+        AddText(
+            FeatureUsedFlags::glFragCoord,
+            LevelCondition::Any,
+            "gl_FragCoord.z = (depthRange.x * psInput.fragCoord.z * wInverse) + depthRange.y;\n"
+            "gl_FragCoord.w = wInverse;\n"
+            );
+
+        AddText(FeatureUsedFlags::glFrontFacing, LevelCondition::Any, "gl_FrontFacing = psInput.frontFacing;\n");
+
+        // We need to make sure that the fragment color is cleared on entry, because GLSL specs that it is zeroed and
+        // HLSL requires that it be touched.
+        AddText(FeatureUsedFlags::None, LevelCondition::Any, "psOutput.fragColor[0] = float4(0.0, 0.0, 0.0, 0.0);\n");
+
+        // If we are using gl_PointCoord, make sure to initialize it.  CGLSLIOStructInfo::OutputHLSL is responsible for 
+        // ensuring that ReadPointCoordFromPSInput is present and either returns a default value or grabs its from PSInput.
+        AddText(FeatureUsedFlags::glPointCoord, LevelCondition::Any, "gl_PointCoord = ReadPointCoordFromPSInput(psInput);\n");
+    }
+
+    AddText(
+        FeatureUsedFlags::glDepthRange,
+        LevelCondition::Any,
+        "gl_DepthRange.near = depthRange.z;\n"
+        "gl_DepthRange.far = depthRange.w;\n"
+        "gl_DepthRange.diff = depthRange.x * 2.0;\n"
+        );
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddEntryPointEnd
+//
+//  Synopsis:   Lay out the code we have at the end of each entry point.
+//
+//-----------------------------------------------------------------------------
+void CGLSLBoilerplate::SegmentTable::AddEntryPointEnd(GLSLShaderType::Enum shaderType)
+{
+    if (shaderType == GLSLShaderType::Vertex)
+    {
+        // If we're using gl_PointSize, we need to adjust the position by the point size.  
+        // AdjustPositionByPointSize is a helper method responsible for doing that.  
+        // Similarly, we need to pass down the point coord information in psInput.pointCoord.
+        // The pixel shader can choose to ignore it if it chooses.  
+        AddText(
+            FeatureUsedFlags::glPointSize,
+            LevelCondition::Any,
+            "flippedPosition.xy = AdjustPositionByPointSize(flippedPosition, vsInput);\n"
+            "WritePointCoordToPSInput(psInput, vsInput.instanceInfo.zw);\n"
+            );
+
+        // WebGL needs content rendered upside down relative to D3D because the texture
+        // coordinates are upside down relative to D3D. Reads / writes to gl_Position
+        // have been directed into a flipped version of the variable, so output the
+        // real thing now.
+        AddText(FeatureUsedFlags::None, LevelCondition::Any, "psInput.position.xw = flippedPosition.xw;\n");
+        AddText(FeatureUsedFlags::None, LevelCondition::Any, "psInput.position.y = -flippedPosition.y;\n");
+
+        // Scale the psInput.position.z value from [-w, w] to [0, w]. Anything outside
+        // [0, w] will be clipped at the rasterizer stage.
+        AddText(FeatureUsedFlags::None, LevelCondition::Any, "psInput.position.z = (flippedPosition.z + flippedPosition.w) / 2;\n");
+
+        // Before we return from a vertex shader, we have to calculate the fragment
+        // coordinate for the pixel shader. Since we can have multiple return
+        // points we need to put this code in all of them.
+        //
+        // We must calculate the frag coord from the flipped position, in order
+        // for it to report self-consistent results.
+        //
+        // We call out to a function to calculate this, because we might decide
+        // to noop this operation if the program has no gl_FragCoord usage. We
+        // cannot know that yet, so we call a function here and in GLSLIOStructInfo
+        // we generate the function that is actually called.
+        AddText(FeatureUsedFlags::None, LevelCondition::Any, "WriteFragCoordToPSInput(psInput, flippedPosition);\n");
+
+        // Return the appropriate struct
+        AddText(FeatureUsedFlags::None, LevelCondition::Any, "psInputOut = psInput;\n");
+    }
+
+    if (shaderType == GLSLShaderType::Fragment)
+    {
+        // Return the appropriate struct
+        AddText(FeatureUsedFlags::None, LevelCondition::Any, "psOutputOut = psOutput;\n");
+    }
+}
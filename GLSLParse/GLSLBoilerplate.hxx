@@ -0,0 +1,158 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#pragma once
+
+#include "GLSLShaderType.hxx"
+#include "IStringStream.hxx"
+#include "WebGLFeatureLevel.hxx"
+
+//+-----------------------------------------------------------------------------
+//
+//  Class:      CGLSLBoilerplate
+//
+//  Synopsis:   The HLSL that every translated shader carries along with the
+//              translated code: the gl_Max* constants, the global variables
+//              that stand in for GLSL special variables, the helper
+//              functions that emulate GLSL built-ins and the code at the
+//              start and end of the entry point.
+//
+//              The text only depends on the shader type, the feature level
+//              and which features the shader uses. It is laid out once per
+//              process for each shader type as a list of segments. Each
+//              segment is guarded by the features and feature level that it
+//              needs, and neighbouring segments with the same guard share one
+//              run of text. Writing a section is then a copy of each segment
+//              whose guard holds.
+//
+//------------------------------------------------------------------------------
+class CGLSLBoilerplate
+{
+public:
+    //+-------------------------------------------------------------------------
+    //
+    //  Enum:       Section
+    //
+    //  Synopsis:   Where in the translated shader a piece of boilerplate goes.
+    //
+    //--------------------------------------------------------------------------
+    enum class Section
+    {
+        Globals,                                                            // After the IO structs, before any shader code
+        EntryPointBegin,                                                    // Start of the entry point
+        EntryPointEnd,                                                      // Every return from the entry point
+        Count
+    };
+
+    static HRESULT Write(
+        GLSLShaderType::Enum shaderType,                                    // Type of shader being translated
+        WebGLFeatureLevel glFeatureLevel,                                   // Feature level being translated for
+        UINT uFeaturesUsed,                                                 // FeatureUsedFlags of the shader
+        Section section,                                                    // Which boilerplate to write
+        __in IStringStream* pOutput                                         // Where to write the code
+        );
+
+private:
+    //+-------------------------------------------------------------------------
+    //
+    //  Enum:       LevelCondition
+    //
+    //  Synopsis:   Which feature levels a segment is written for.
+    //
+    //--------------------------------------------------------------------------
+    enum class LevelCondition
+    {
+        Any,
+        Below10,
+        AtLeast10
+    };
+
+    //+-------------------------------------------------------------------------
+    //
+    //  Struct:     Segment
+    //
+    //  Synopsis:   A run of boilerplate text and the guard for writing it.
+    //
+    //--------------------------------------------------------------------------
+    struct Segment
+    {
+        UINT _uAnyFeatures;                                                 // Written if any of these features is used, or always if none
+        LevelCondition _level;                                              // Feature levels the text is written for
+        UINT _uOffset;                                                      // Start of the text in the table
+        UINT _cchText;                                                      // Length of the text
+    };
+
+    //+-------------------------------------------------------------------------
+    //
+    //  Struct:     SegmentTable
+    //
+    //  Synopsis:   Immutable segments of every section for one shader type,
+    //              shared by the process.
+    //
+    //--------------------------------------------------------------------------
+    struct SegmentTable
+    {
+        SegmentTable(GLSLShaderType::Enum shaderType);
+
+        void BeginSection(Section section);
+
+        void AddText(
+            UINT uAnyFeatures,                                              // Features that the text needs, if any
+            LevelCondition level,                                           // Feature levels that the text is for
+            __in_z const char* pszText                                      // Text to add
+            );
+
+        void AddFormattedText(
+            UINT uAnyFeatures,                                              // Features that the text needs, if any
+            __in_z const char* pszFormat,                                   // printf-style format for the text
+            ...
+            );
+
+        void AddGlobals(GLSLShaderType::Enum shaderType);
+        void AddTextureFunctions(GLSLShaderType::Enum shaderType);
+        void AddEntryPointBegin(GLSLShaderType::Enum shaderType);
+        void AddEntryPointEnd(GLSLShaderType::Enum shaderType);
+
+        void AddSegment(
+            UINT uAnyFeatures,                                              // Features that the text needs, if any
+            LevelCondition level,                                           // Feature levels that the text is for
+            UINT cchText                                                    // Length of the text just added to _rgchText
+            );
+
+        static const UINT s_cchMaxText = 16384;                             // Room for the text of every section
+        static const UINT s_uMaxSegmentCount = 128;                         // Room for the segments of every section
+
+        char _rgchText[s_cchMaxText];                                       // Text of all of the segments
+        UINT _cchText;                                                      // Amount of _rgchText used
+        Segment _rgSegments[s_uMaxSegmentCount];                            // Segments of all of the sections, in order
+        UINT _cSegments;                                                    // Number of segments added
+        UINT _rgFirstSegment[static_cast<UINT>(Section::Count) + 1];        // Index of the first segment of each section
+        UINT _uSectionStart;                                                // Index of the first segment of the section being added
+        UINT _uUnsupportedFeatures;                                         // Features this shader type should never use
+    };
+
+    static const SegmentTable& GetSegmentTable(GLSLShaderType::Enum shaderType);
+};
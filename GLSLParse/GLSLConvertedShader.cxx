@@ -59,13 +59,13 @@ HRESULT CGLSLConvertedShader::GetConvertedCodeWithParsedStructInfo(
 
     spszCode.SetInitialSize(512);
 
-    // ExtractString will append to existing contents of spszCode, hence __inout.
+    // TakeString will append to existing contents of spszCode, hence __inout.
     if (_spVaryingStructInfo != nullptr)
     {
         TSmartPointer<CMemoryStream> spVaryingStream;
         CHK(RefCounted<CMemoryStream>::Create(/*out*/spVaryingStream));
         CHK(_spVaryingStructInfo->OutputHLSL(/*pOtherInfo*/nullptr, spVaryingStream));
-        CHK(spVaryingStream->ExtractString(spszCode));
+        CHK(spVaryingStream->TakeString(spszCode));
     }
 
     CHK(AppendConvertedCode(spszCode));
@@ -119,7 +119,7 @@ HRESULT CGLSLConvertedShader::GetLog(__deref_out BSTR* pbstrLog)
     {
         CHK(RefCounted<CMemoryStream>::Create(/*out*/spLogStream));
 
-        CHK(spLogStream->WriteString("Shader compilation errors\n"));
+        CHK(spLogStream->WriteLiteral("Shader compilation errors\n"));
 
         for (UINT i = 0; i < cErrors; i++)
         {
@@ -131,7 +131,7 @@ HRESULT CGLSLConvertedShader::GetLog(__deref_out BSTR* pbstrLog)
     CSmartBstr bstrLog;
     if (spLogStream != nullptr)
     {
-        CHK(spLogStream->ExtractString(spConvertedLog));
+        CHK(spLogStream->TakeString(spConvertedLog));
         bstrLog.SetAnsi(spConvertedLog);
     }
     else
@@ -150,18 +150,41 @@ HRESULT CGLSLConvertedShader::GetLog(__deref_out BSTR* pbstrLog)
 //
 //  Synopsis:   Returns approximate dynamic memory occupied by the converted 
 //              shader so that the F12 memory profiler can report it as memory
-//              cost of a WebGLShader
+//              cost of a WebGLShader, and the translation cache can charge
+//              its entries for it. Everything the shader keeps alive is
+//              counted: the HLSL buffer, the identifier table with its
+//              symbols and infos, the varying info, the errors and the stats.
 //-----------------------------------------------------------------------------
 UINT CGLSLConvertedShader::GetMemorySize() const
 {
-    UINT cbMemorySize = 0;
+    UINT cbMemorySize = sizeof(*this);
+
     if (_spStreamConverted != nullptr)
     {        
-        if (_spStreamConverted->GetSize(&cbMemorySize) != S_OK)
-        {
-            cbMemorySize = 0;
-        }
+        cbMemorySize += _spStreamConverted->GetMemorySize();
+    }
+
+    if (_spIdTable != nullptr)
+    {
+        cbMemorySize += _spIdTable->GetMemorySize();
+    }
+
+    if (_spVaryingStructInfo != nullptr)
+    {
+        cbMemorySize += _spVaryingStructInfo->GetMemorySize();
+    }
+
+    cbMemorySize += _rgErrors.GetCapacity() * sizeof(TSmartPointer<CGLSLError>);
+    for (UINT i = 0; i < _rgErrors.GetCount(); i++)
+    {
+        cbMemorySize += _rgErrors[i]->GetMemorySize();
     }
+
+    if (_spStats != nullptr)
+    {
+        cbMemorySize += _spStats->GetMemorySize();
+    }
+
     return cbMemorySize;
 }
 
@@ -182,7 +205,7 @@ HRESULT CGLSLConvertedShader::AddError(
     CHK_START;
 
     TSmartPointer<CGLSLError> spNewError;
-    CHK(RefCounted<CGLSLError>::Create(line, column, hrCode, pszData, /*out*/spNewError));
+    CHK(RefCounted<CGLSLError, MultiThreadedRefCount>::Create(line, column, hrCode, pszData, /*out*/spNewError));
     CHK(_rgErrors.Add(spNewError));
 
     CHK_RETURN;
@@ -302,12 +325,12 @@ HRESULT CGLSLConvertedShader::LinkVaryingStructEntries(
         CHK(RefCounted<CMemoryStream>::Create(/*out*/spVaryingStream));
 
         CHK(spLinkedVertexInfo->OutputHLSL(pConvertedFragment->UseParsedVaryingInfo(), spVaryingStream));
-        CHK(spVaryingStream->ExtractString(spszVertexHLSLPrologue));
+        CHK(spVaryingStream->TakeString(spszVertexHLSLPrologue));
 
-        // Re-use the stream for the fragment varying struct prologue, but begin writing at the beginning again.
-        CHK(spVaryingStream->SeekToStart());
+        // Re-use the stream for the fragment varying struct prologue. Taking the vertex prologue
+        // left it empty, so this starts writing at the beginning again.
         CHK(pConvertedFragment->UseParsedVaryingInfo()->OutputHLSL(spLinkedVertexInfo, spVaryingStream));
-        CHK(spVaryingStream->ExtractString(spszFragmentHLSLPrologue));
+        CHK(spVaryingStream->TakeString(spszFragmentHLSLPrologue));
     }
 
     CHK_RETURN;
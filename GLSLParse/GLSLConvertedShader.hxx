@@ -31,6 +31,7 @@
 #include "GLSLError.hxx"
 #include "IErrorSink.hxx"
 #include "GLSLIOStructInfo.hxx"
+#include "GLSLTranslationStats.hxx"
 
 //+-----------------------------------------------------------------------------
 //
@@ -40,6 +41,10 @@
 //              conversion this contains the generated HLSL, the identifier
 //              table and any error information.
 //
+//              The shader and everything it holds on to are created with
+//              MultiThreadedRefCount, because GLSLTranslateBatch hands
+//              shaders translated on pool threads to the calling thread.
+//
 //------------------------------------------------------------------------------
 class CGLSLConvertedShader : public IErrorSink
 {
@@ -77,6 +82,14 @@ public:
 
     UINT GetMemorySize() const;
 
+    HRESULT AppendError(__in CGLSLError* pError) { return _rgErrors.Add(pError); }
+    const CGLSLIOStructInfo* UseParsedVaryingInfo() const { return _spVaryingStructInfo; }
+    CMemoryStream* UseConvertedStream() const { return _spStreamConverted; }
+
+    // Stats are only present when the translation was run with GLSLTranslateOptions::EnableStats
+    void SetStats(__in CGLSLTranslationStats* pStats) { _spStats = pStats; }
+    const CGLSLTranslationStats* UseStats() const { return _spStats; }
+
     struct LinkingErrorRecord
     {
         enum ErrorType
@@ -104,12 +117,10 @@ public:
 protected:
     HRESULT Initialize();
 
-private:
-    const CGLSLIOStructInfo* UseParsedVaryingInfo() const { return _spVaryingStructInfo; }
-
 private:
     CModernArray<TSmartPointer<CGLSLError>> _rgErrors;              // Errors found in parsing
     TSmartPointer<CMemoryStream> _spStreamConverted;                // The converted shader HLSL code
     TSmartPointer<CGLSLIOStructInfo> _spVaryingStructInfo;          // HLSL code for the VS output / PS input, as originally parsed
     TSmartPointer<CGLSLIdentifierTable> _spIdTable;                 // The identifier table
+    TSmartPointer<CGLSLTranslationStats> _spStats;                  // Metrics for the translation, if they were asked for
 };
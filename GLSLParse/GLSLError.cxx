@@ -27,6 +27,7 @@
 #include "PreComp.hxx"
 #include "GLSLError.hxx"
 #include "MemoryStream.hxx"
+#include "GLSLBinaryStream.hxx"
 #include "GLSL.tab.h"
 
 //+----------------------------------------------------------------------------
@@ -135,6 +136,7 @@ const GLSLErrorInfo CGLSLError::s_errorInfo[] = {
     { E_GLSLERROR_PRECISIONSPECIFIEDFORSTRUCT,      0, "Struct types cannot have a precision qualifier specified" },
     { E_GLSLERROR_PRECISIONNOTALLOWEDFORTYPE,       1, "Precision qualifier not allowed to be specified for type '%s'" },
     { E_GLSLERROR_CANNOTUNROLLLOOP,                 0, "Loop is too dynamic for this hardware" },
+    { E_GLSLERROR_PREMAXEXPANSION,                  1, "Macro expansion exceeds the maximum %s" },
 };
 
 //+----------------------------------------------------------------------------
@@ -196,6 +198,51 @@ HRESULT CGLSLError::Initialize(
     CHK_RETURN;
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   Initialize
+//
+//  Synopsis:   Init an error that was written with Serialize. The text was
+//              already formatted, so it is restored as is.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLError::Initialize(
+    __inout CGLSLBinaryReader* pReader  // Reader positioned at data written by Serialize
+    )
+{
+    CHK_START;
+
+    int hrCode;
+    const char* pszText;
+    CHK(pReader->ReadInt(&hrCode));
+    CHK(pReader->ReadInt(&_line));
+    CHK(pReader->ReadInt(&_column));
+    CHK(pReader->ReadString(&pszText));
+    CHKB_HR(pszText != nullptr, E_GLSL_INVALIDDATA);
+
+    _hrCode = static_cast<HRESULT>(hrCode);
+    CHK(_text.Set(pszText));
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Serialize
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLError::Serialize(__inout CGLSLBinaryWriter* pWriter) const
+{
+    CHK_START;
+
+    CHK(pWriter->WriteInt(static_cast<int>(_hrCode)));
+    CHK(pWriter->WriteInt(_line));
+    CHK(pWriter->WriteInt(_column));
+    CHK(pWriter->WriteString(_text));
+
+    CHK_RETURN;
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   WriteLong
@@ -27,6 +27,8 @@
 #pragma once
 
 class CMemoryStream;
+class CGLSLBinaryWriter;
+class CGLSLBinaryReader;
 
 const int E_GLSLERROR_KNOWNERROR = MAKE_HRESULT(SEVERITY_ERROR, FACILITY_ITF,                       1);    // Used to communicate that a known error occured
 const int E_GLSLERROR_INTERNALERROR = MAKE_HRESULT(SEVERITY_ERROR, FACILITY_ITF,                    2);    // Code for errors not covered by anything else
@@ -127,6 +129,7 @@ const int E_GLSLERROR_CTOR_REQUIRES_ARGUMENTS = MAKE_HRESULT(SEVERITY_ERROR, FAC
 const int E_GLSLERROR_PRECISIONSPECIFIEDFORSTRUCT = MAKE_HRESULT(SEVERITY_ERROR, FACILITY_ITF,      97);   // Struct types cannot have precision qualifiers specified
 const int E_GLSLERROR_PRECISIONNOTALLOWEDFORTYPE = MAKE_HRESULT(SEVERITY_ERROR, FACILITY_ITF,       98);   // Certain basic types cannot have precision qualifiers specified
 const int E_GLSLERROR_CANNOTUNROLLLOOP = MAKE_HRESULT(SEVERITY_ERROR, FACILITY_ITF,                 99);   // Loops that cannot have termination determined or are too complex for D3D9 hardware
+const int E_GLSLERROR_PREMAXEXPANSION = MAKE_HRESULT(SEVERITY_ERROR, FACILITY_ITF,                  100);  // Macro expansion exceeds a preprocessor limit
 
 struct GLSLErrorInfo
 {
@@ -150,8 +153,10 @@ public:
     int GetLine() const { return _line; }
     int GetColumn() const { return _column; }
     const char* GetText() const { return _text; }
+    UINT GetMemorySize() const { return sizeof(*this) + static_cast<UINT>(::strlen(_text)) + 1; }
 
     HRESULT WriteLog(__in CMemoryStream *pLogStream);
+    HRESULT Serialize(__inout CGLSLBinaryWriter* pWriter) const;
 
 protected:
     CGLSLError() {}
@@ -167,6 +172,10 @@ protected:
         HRESULT hrCode                  // The error code for the error
         );
 
+    HRESULT Initialize(
+        __inout CGLSLBinaryReader* pReader  // Reader positioned at data written by Serialize
+        );
+
 private:
     HRESULT _hrCode;                    // The error code that we log for this error
     int _line;                          // The line the error occurred on
@@ -29,8 +29,9 @@
 #include "MemoryStream.hxx"
 #include "GLSLParser.hxx"
 #include "RefCounted.hxx"
+#include "GLSLBinaryStream.hxx"
 
-UINT CGLSLIOStructInfo::s_uNotFound = static_cast<UINT>(-1);
+const UINT CGLSLIOStructInfo::s_uNotFound = static_cast<UINT>(-1);
 
 //+----------------------------------------------------------------------------
 //
@@ -61,6 +62,126 @@ HRESULT CGLSLIOStructInfo::Initialize(
     return S_OK;
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   Initialize
+//
+//  Synopsis:   Init struct info that was written with Serialize, when
+//              restoring a translated shader.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLIOStructInfo::Initialize(
+    __inout CGLSLBinaryReader* pReader,                                     // Reader positioned at data written by Serialize
+    __in CGLSLSymbolTable* pSymbolTable,                                    // Symbol table
+    const CModernArray<TSmartPointer<CVariableIdentifierInfo>>& aryVariables   // Restored variables that entries refer to by index
+    )
+{
+    CHK_START;
+
+    UINT uStructType;
+    UINT uShaderType;
+    CHK(pReader->ReadUInt(&uStructType));
+    CHK(pReader->ReadUInt(&_uFeatureUsedFlags));
+    CHK(pReader->ReadUInt(&uShaderType));
+
+    CHKB_HR(uStructType > static_cast<UINT>(IOStructType::Undefined) && uStructType <= static_cast<UINT>(IOStructType::Output), E_GLSL_INVALIDDATA);
+    CHKB_HR(uShaderType == static_cast<UINT>(GLSLShaderType::Vertex) || uShaderType == static_cast<UINT>(GLSLShaderType::Fragment), E_GLSL_INVALIDDATA);
+
+    _structType = static_cast<IOStructType::Enum>(uStructType);
+    _shaderType = static_cast<GLSLShaderType::Enum>(uShaderType);
+    _spSymbolTable = pSymbolTable;
+
+    UINT uEntryCount;
+    CHK(pReader->ReadUInt(&uEntryCount));
+    for (UINT i = 0; i < uEntryCount; i++)
+    {
+        UINT uVariable;
+        const char* pszHLSLText;
+        const char* pszUnusedText;
+        CHK(pReader->ReadUInt(&uVariable));
+        CHK(pReader->ReadString(&pszHLSLText));
+        CHK(pReader->ReadString(&pszUnusedText));
+
+        CHKB_HR(uVariable < aryVariables.GetCount(), E_GLSL_INVALIDDATA);
+        CHKB_HR(pszHLSLText != nullptr && pszUnusedText != nullptr, E_GLSL_INVALIDDATA);
+
+        // The unused text is used as a format string, so only accept what the
+        // translator would have produced.
+        CHKB_HR(IsValidUnusedFormat(pszUnusedText), E_GLSL_INVALIDDATA);
+
+        TSmartPointer<StructInfoEntry> spNewEntry;
+        CHK(RefCounted<StructInfoEntry, MultiThreadedRefCount>::Create(/*out*/spNewEntry));
+
+        spNewEntry->_spInfo = aryVariables[uVariable];
+        CHK(spNewEntry->_hlslText.Set(pszHLSLText));
+        CHK(spNewEntry->_unusedText.Set(pszUnusedText));
+        CHK(AppendEntry(spNewEntry));
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Serialize
+//
+//  Synopsis:   Writes the struct info. Entries refer to their variable by its
+//              index in the array of serialized variables, which the caller
+//              has already looked up for each entry.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLIOStructInfo::Serialize(
+    const CModernArray<UINT>& aryEntryRecords,                              // Serialized variable index for each entry
+    __inout CGLSLBinaryWriter* pWriter                                      // Where to write the info
+    ) const
+{
+    CHK_START;
+
+    CHK(pWriter->WriteUInt(static_cast<UINT>(_structType)));
+    CHK(pWriter->WriteUInt(_uFeatureUsedFlags));
+    CHK(pWriter->WriteUInt(static_cast<UINT>(_shaderType)));
+
+    CHK(pWriter->WriteUInt(_aryEntries.GetCount()));
+    for (UINT i = 0; i < _aryEntries.GetCount(); i++)
+    {
+        CHKB(i < aryEntryRecords.GetCount());
+
+        CHK(pWriter->WriteUInt(aryEntryRecords[i]));
+        CHK(pWriter->WriteString(_aryEntries[i]->_hlslText));
+        CHK(pWriter->WriteString(_aryEntries[i]->_unusedText));
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   IsValidUnusedFormat
+//
+//  Synopsis:   The unused text of an entry has a %d for the name and one for
+//              the semantic, and no other format specifiers.
+//
+//-----------------------------------------------------------------------------
+bool CGLSLIOStructInfo::IsValidUnusedFormat(__in_z LPCSTR pszFormat)
+{
+    UINT uSpecifierCount = 0;
+    for (const char* pch = pszFormat; *pch != '\0'; pch++)
+    {
+        if (*pch == '%')
+        {
+            if (pch[1] != 'd')
+            {
+                return false;
+            }
+
+            uSpecifierCount++;
+            pch++;
+        }
+    }
+
+    return (uSpecifierCount <= 2);
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   IsFeatureUsed
@@ -129,12 +250,12 @@ HRESULT CGLSLIOStructInfo::OutputHLSL(
     {
     case IOStructType::Output:
         CHK(pOutput->WriteIndent());
-        CHK(pOutput->WriteString("float4 fragColor[1] : SV_Target;\n"));
+        CHK(pOutput->WriteLiteral("float4 fragColor[1] : SV_Target;\n"));
 
         if (pFragmentInfo->IsFeatureUsed(FeatureUsedFlags::glFragDepth))
         {
             CHK(pOutput->WriteIndent());
-            CHK(pOutput->WriteString("float fragDepth : SV_Depth;\n"));
+            CHK(pOutput->WriteLiteral("float fragDepth : SV_Depth;\n"));
         }
         break;
 
@@ -144,7 +265,7 @@ HRESULT CGLSLIOStructInfo::OutputHLSL(
             if (pFragmentInfo->IsFeatureUsed(FeatureUsedFlags::glFragCoord))
             {                
                 CHK(pOutput->WriteIndent());
-                CHK(pOutput->WriteString("float4 fragCoord : FragCoord;\n"));
+                CHK(pOutput->WriteLiteral("float4 fragCoord : FragCoord;\n"));
             }
             
             if (pVertexInfo->IsFeatureUsed(FeatureUsedFlags::glPointSize) && pFragmentInfo->IsFeatureUsed(FeatureUsedFlags::glPointCoord))
@@ -153,7 +274,7 @@ HRESULT CGLSLIOStructInfo::OutputHLSL(
                 // fragment shader. Similarly, we will not emit the varying if the developer does
                 // not gl_PointSize in the vertex shader. 
                 CHK(pOutput->WriteIndent());
-                CHK(pOutput->WriteString("float2 pointCoord: PointCoord;\n"));
+                CHK(pOutput->WriteLiteral("float2 pointCoord: PointCoord;\n"));
                 fPointCoordIsInVarying = true;
             }
         }
@@ -165,7 +286,7 @@ HRESULT CGLSLIOStructInfo::OutputHLSL(
             // If we're using gl_PointSize, add instance information to the input struct.  
             // The context will query for the presence of this and it in as appropriate.  
             CHK(pOutput->WriteIndent());
-            CHK(pOutput->WriteString("float4 instanceInfo : InstanceInfo;\n"));                 
+            CHK(pOutput->WriteLiteral("float4 instanceInfo : InstanceInfo;\n"));                 
         }
         break;
 
@@ -219,19 +340,19 @@ HRESULT CGLSLIOStructInfo::OutputHLSL(
     {
         // The pixel shader input has SV_Position in it - make sure it is there
         CHK(pOutput->WriteIndent());
-        CHK(pOutput->WriteString("float4 position : SV_Position;\n"));
+        CHK(pOutput->WriteLiteral("float4 position : SV_Position;\n"));
 
         if (IsFeatureUsed(FeatureUsedFlags::glFrontFacing))
         {
             // If there is usage of front facing, then spit it out here
             CHK(pOutput->WriteIndent());
-            CHK(pOutput->WriteString("bool frontFacing : SV_IsFrontFace;\n"));
+            CHK(pOutput->WriteLiteral("bool frontFacing : SV_IsFrontFace;\n"));
         }
     }
 
     // Write the footer of the input struct
     pOutput->DecreaseIndent();
-    CHK(pOutput->WriteString("};\n"));
+    CHK(pOutput->WriteLiteral("};\n"));
 
     if (_structType == IOStructType::Varying && fWriteEmulationVariables)
     {
@@ -301,30 +422,70 @@ HRESULT CGLSLIOStructInfo::OutputHLSL(
 //
 //  Function:   GetInfo
 //
-//  Synopsis:   Search the info list for the entry with the given name in the
-//              GLSL code.
+//  Synopsis:   Find the entry with the given name in the GLSL code. The name
+//              is hashed by the symbol table and the entry for the symbol is
+//              indexed, so matching up the entries of two structs is linear
+//              in the number of entries.
 //
 //-----------------------------------------------------------------------------
 UINT CGLSLIOStructInfo::GetInfo(__in_z LPCSTR pszVSGLSLName) const
 {
-    for (UINT i = 0; i < _aryEntries.GetCount(); i++)
+    int iSymbolIndex;
+    if (FAILED(_spSymbolTable->LookupSymbolIndex(pszVSGLSLName, &iSymbolIndex)))
     {
-        LPCSTR pszGLSLName = _spSymbolTable->NameFromIndex(_aryEntries[i]->_spInfo->GetSymbolIndex());
+        // Names that are not even symbols in this shader cannot be entries
+        return s_uNotFound;
+    }
 
-        // See if this entry has the same name
-        if (::strcmp(pszGLSLName, pszVSGLSLName) == 0)
-        {
-            return i;
-        }
+    if (iSymbolIndex < 0 || static_cast<UINT>(iSymbolIndex) >= _aryEntryBySymbol.GetCount() || _aryEntryBySymbol[iSymbolIndex] == 0)
+    {
+        return s_uNotFound;
     }
 
-    return s_uNotFound;
+    return _aryEntryBySymbol[iSymbolIndex] - 1;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AppendEntry
+//
+//  Synopsis:   Adds an entry to the end of the struct and indexes it by the
+//              symbol of its variable. If more than one entry has the same
+//              symbol, the first one is found.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLIOStructInfo::AppendEntry(
+    __in StructInfoEntry* pEntry                    // Entry to add
+    )
+{
+    CHK_START;
+
+    int iSymbolIndex = pEntry->_spInfo->GetSymbolIndex();
+    CHKB(iSymbolIndex >= 0);
+
+    UINT uSymbolIndex = static_cast<UINT>(iSymbolIndex);
+    if (uSymbolIndex >= _aryEntryBySymbol.GetCount())
+    {
+        CHK(_aryEntryBySymbol.EnsureSize(uSymbolIndex + 1));
+    }
+
+    CHK(_aryEntries.Add(pEntry));
+
+    if (_aryEntryBySymbol[uSymbolIndex] == 0)
+    {
+        _aryEntryBySymbol[uSymbolIndex] = _aryEntries.GetCount();
+    }
+
+    CHK_RETURN;
 }
 
 //+----------------------------------------------------------------------------
 //
 //  Function:   AddEntry
 //
+//  Synopsis:   The text of both streams is moved into the new entry, which
+//              leaves them empty for the next one.
+//
 //-----------------------------------------------------------------------------
 HRESULT CGLSLIOStructInfo::AddEntry(
     __in CVariableIdentifierInfo* pInfo,            // Identifier info for the entry
@@ -335,13 +496,13 @@ HRESULT CGLSLIOStructInfo::AddEntry(
     CHK_START;
 
     TSmartPointer<StructInfoEntry> spNewEntry;
-    CHK(RefCounted<StructInfoEntry>::Create(/*out*/spNewEntry));
+    CHK(RefCounted<StructInfoEntry, MultiThreadedRefCount>::Create(/*out*/spNewEntry));
     
     spNewEntry->_spInfo = pInfo;
 
-    CHK(pHLSLStream->ExtractString(spNewEntry->_hlslText));
-    CHK(pUnusedStream->ExtractString(spNewEntry->_unusedText));
-    CHK(_aryEntries.Add(spNewEntry));
+    CHK(pHLSLStream->TakeString(spNewEntry->_hlslText));
+    CHK(pUnusedStream->TakeString(spNewEntry->_unusedText));
+    CHK(AppendEntry(spNewEntry));
 
     CHK_RETURN;
 }
@@ -400,7 +561,7 @@ HRESULT CGLSLIOStructInfo::ComputeLinkedVertexStructInfo(
     // Make a copy the vertex struct info (minus the entries for now). The
     // entries will be filled in the loop below.
     TSmartPointer<CGLSLIOStructInfo> spVertexInfoLinked;
-    CHK(RefCounted<CGLSLIOStructInfo>::Create(
+    CHK(RefCounted<CGLSLIOStructInfo, MultiThreadedRefCount>::Create(
         pVertexInfo->_structType,
         pVertexInfo->_uFeatureUsedFlags,
         pVertexInfo->_spSymbolTable,
@@ -440,7 +601,7 @@ HRESULT CGLSLIOStructInfo::ComputeLinkedVertexStructInfo(
 
         if (fAddToComputedEntries)
         {
-            CHK(spVertexInfoLinked->_aryEntries.Add(spEntry.GetRawPointer()));
+            CHK(spVertexInfoLinked->AppendEntry(spEntry));
         }
     }
     
@@ -448,3 +609,29 @@ HRESULT CGLSLIOStructInfo::ComputeLinkedVertexStructInfo(
 
     CHK_RETURN;
 }
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetMemorySize
+//
+//  Synopsis:   Returns the approximate memory retained by the struct info.
+//              The variables and the symbol table belong to the identifier
+//              table and are counted there.
+//
+//-----------------------------------------------------------------------------
+UINT CGLSLIOStructInfo::GetMemorySize() const
+{
+    UINT cbMemorySize = sizeof(*this);
+
+    cbMemorySize += _aryEntries.GetCapacity() * sizeof(TSmartPointer<StructInfoEntry>);
+    cbMemorySize += _aryEntryBySymbol.GetCapacity() * sizeof(UINT);
+
+    for (UINT i = 0; i < _aryEntries.GetCount(); i++)
+    {
+        cbMemorySize += sizeof(StructInfoEntry);
+        cbMemorySize += static_cast<UINT>(_aryEntries[i]->_hlslText.GetLength()) + 1;
+        cbMemorySize += static_cast<UINT>(_aryEntries[i]->_unusedText.GetLength()) + 1;
+    }
+
+    return cbMemorySize;
+}
@@ -36,6 +36,9 @@ namespace FeatureUsedFlags
     enum Enum : UINT;
 }
 
+class CGLSLBinaryWriter;
+class CGLSLBinaryReader;
+
 //+-----------------------------------------------------------------------------
 //
 //  Class:      CGLSLIOStructInfo
@@ -62,6 +65,15 @@ public:
     bool IsFeatureUsed(FeatureUsedFlags::Enum feature) const;
 
     UINT GetVaryingVectorCount() const;
+    UINT GetMemorySize() const;
+
+    UINT GetEntryCount() const { return _aryEntries.GetCount(); }
+    CVariableIdentifierInfo* UseEntryVariable(UINT uIndex) const { return _aryEntries[uIndex]->_spInfo; }
+
+    HRESULT Serialize(
+        const CModernArray<UINT>& aryEntryRecords,                              // Serialized variable index for each entry
+        __inout CGLSLBinaryWriter* pWriter                                      // Where to write the info
+        ) const;
 
     static HRESULT ComputeLinkedVertexStructInfo(
         __in const CGLSLIOStructInfo* pVertexInfo,              // Vertex info to compute from
@@ -79,8 +91,15 @@ protected:
         GLSLShaderType::Enum shaderType                         // Our shader type
         );
 
+    HRESULT Initialize(
+        __inout CGLSLBinaryReader* pReader,                                     // Reader positioned at data written by Serialize
+        __in CGLSLSymbolTable* pSymbolTable,                                    // Symbol table
+        const CModernArray<TSmartPointer<CVariableIdentifierInfo>>& aryVariables   // Restored variables that entries refer to by index
+        );
+
 private:
     UINT GetInfo(__in_z LPCSTR pszGLSLName) const;
+    static bool IsValidUnusedFormat(__in_z LPCSTR pszFormat);
 
 private:
     //+-----------------------------------------------------------------------------
@@ -103,12 +122,15 @@ private:
         HRESULT Initialize() { return S_OK; }
     };
 
+    HRESULT AppendEntry(__in StructInfoEntry* pEntry);
+
 private:
     TSmartPointer<CGLSLSymbolTable> _spSymbolTable;             // The symbol table
     CModernArray<TSmartPointer<StructInfoEntry>> _aryEntries;   // Collection of entries
+    CModernArray<UINT> _aryEntryBySymbol;                       // One more than the index of the entry for each symbol index, or zero
     IOStructType::Enum _structType;                             // What type of IO the struct represents
     UINT _uFeatureUsedFlags;                                    // Flags for features being used
     GLSLShaderType::Enum _shaderType;                           // Our shader type
 
-    static UINT s_uNotFound;                                    // For GetInfo to return
+    static const UINT s_uNotFound;                              // For GetInfo to return
 };
@@ -109,10 +109,10 @@ HRESULT CGLSLIdentifierTable::Initialize(
         {
             // Alloc and init the new info
             TSmartPointer<CVariableIdentifierInfo> spNewInfo;
-            CHK(RefCounted<CVariableIdentifierInfo>::Create(known, pParser, /*out*/spNewInfo));
+            CHK(RefCounted<CVariableIdentifierInfo, MultiThreadedRefCount>::Create(known, pParser, /*out*/spNewInfo));
 
             // Add it to the list of all variable identifiers
-            CHK(_aryVarList.Add(spNewInfo));
+            CHK(AddToVariableList(spNewInfo));
 
             // Make sure that it is in the collection of root scope identifiers
             CHK(pRootScope->AddDeclaredIdentifier(spNewInfo));
@@ -122,6 +122,98 @@ HRESULT CGLSLIdentifierTable::Initialize(
     CHK_RETURN;
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   Initialize
+//
+//  Synopsis:   Init an empty table without a parse tree, for restoring a
+//              translated shader. The infos are added with AddVariableInfo
+//              and AddTypeNameInfo.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLIdentifierTable::Initialize(
+    __in CGLSLSymbolTable* pSymbolTable                         // Symbol table the identifiers refer to
+    )
+{
+    _spSymbolTable = pSymbolTable;
+
+    return S_OK;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddVariableInfo
+//
+//  Synopsis:   Adds an existing info to the list of variable identifiers.
+//              There is no scope to add it to, so this is only for tables
+//              that were created without a parser.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLIdentifierTable::AddVariableInfo(
+    __in CVariableIdentifierInfo* pInfo                         // Info to add
+    )
+{
+    return AddToVariableList(pInfo);
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddToVariableList
+//
+//  Synopsis:   Adds an info to the list of variable identifiers and to the
+//              chain of variables for its symbol, which is what lookups by
+//              name walk instead of the whole list.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLIdentifierTable::AddToVariableList(
+    __in CVariableIdentifierInfo* pInfo                         // Info to add
+    )
+{
+    CHK_START;
+
+    int iSymbolIndex = pInfo->GetSymbolIndex();
+    CHKB(iSymbolIndex >= 0);
+
+    UINT uSymbolIndex = static_cast<UINT>(iSymbolIndex);
+    if (uSymbolIndex >= _aryVarChainBySymbol.GetCount())
+    {
+        CHK(_aryVarChainBySymbol.EnsureSize(uSymbolIndex + 1));
+    }
+
+    CHK(_aryVarList.Add(pInfo));
+    CHK(_aryNextVarWithSymbol.Add(0));
+
+    UINT uVarRef = _aryVarList.GetCount();
+    VariableChain& chain = _aryVarChainBySymbol[uSymbolIndex];
+    if (chain._uLast == 0)
+    {
+        chain._uFirst = uVarRef;
+    }
+    else
+    {
+        _aryNextVarWithSymbol[chain._uLast - 1] = uVarRef;
+    }
+
+    chain._uLast = uVarRef;
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddTypeNameInfo
+//
+//  Synopsis:   Adds an existing info to the list of typename identifiers,
+//              which keeps it alive for the struct type that points at it.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLIdentifierTable::AddTypeNameInfo(
+    __in CTypeNameIdentifierInfo* pInfo                         // Info to add
+    )
+{
+    return _aryTypeList.Add(pInfo);
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   AddVariableIdentifier
@@ -161,7 +253,7 @@ HRESULT CGLSLIdentifierTable::AddVariableIdentifier(
 
     // Alloc and init the new info
     TSmartPointer<CVariableIdentifierInfo> spNewInfo;
-    CHK(RefCounted<CVariableIdentifierInfo>::Create(
+    CHK(RefCounted<CVariableIdentifierInfo, MultiThreadedRefCount>::Create(
         pIdentifier,
         pType,
         typeQualifier,
@@ -172,7 +264,7 @@ HRESULT CGLSLIdentifierTable::AddVariableIdentifier(
         ));
 
     // Add to list of all variable identifiers
-    CHK(_aryVarList.Add(spNewInfo));
+    CHK(AddToVariableList(spNewInfo));
 
     // Add to the list of identifiers for the scope it is in
     CHK(pScope->AddDeclaredIdentifier(spNewInfo));
@@ -325,7 +417,7 @@ HRESULT CGLSLIdentifierTable::AddTypeNameIdentifier(
 
     // Alloc and init the new info
     TSmartPointer<CTypeNameIdentifierInfo> spNewInfo;
-    CHK(RefCounted<CTypeNameIdentifierInfo>::Create(pIdentifier, pType, /*out*/spNewInfo));
+    CHK(RefCounted<CTypeNameIdentifierInfo, MultiThreadedRefCount>::Create(pIdentifier, pType, /*out*/spNewInfo));
 
     // Add to list of all typename identifiers. We do this to keep the typename info alive
     // after we've completed translation as we'll need it during shared uniform verification.
@@ -354,6 +446,10 @@ HRESULT CGLSLIdentifierTable::AddTypeNameIdentifier(
 //              This is designed to be called from the WebGL code to allow
 //              translation between the GLSL name and HLSL name.
 //
+//              The name is hashed by the symbol table, and only the variables
+//              with that symbol are checked for the qualifier, so that
+//              linking does not scan every variable for every varying.
+//
 //-----------------------------------------------------------------------------
 HRESULT CGLSLIdentifierTable::GetVariableInfoFromString(
     __in_z const char* pszString,                                   // The variable name to get info about
@@ -370,14 +466,16 @@ HRESULT CGLSLIdentifierTable::GetVariableInfoFromString(
     int parserQualifier = GLSLQualifier::ToParserType(typeQualifier);
 
     bool fFound = false;
-    UINT i;
-    for (i = 0; i < _aryVarList.GetCount(); i++)
+    if (index >= 0 && static_cast<UINT>(index) < _aryVarChainBySymbol.GetCount())
     {
-        if (_aryVarList[i]->GetSymbolIndex() == index && _aryVarList[i]->GetTypeQualifier() == parserQualifier)
+        for (UINT uVarRef = _aryVarChainBySymbol[index]._uFirst; uVarRef != 0; uVarRef = _aryNextVarWithSymbol[uVarRef - 1])
         {
-            _aryVarList[i].CopyTo(ppInfo);
-            fFound = true;
-            break;
+            if (_aryVarList[uVarRef - 1]->GetTypeQualifier() == parserQualifier)
+            {
+                _aryVarList[uVarRef - 1].CopyTo(ppInfo);
+                fFound = true;
+                break;
+            }
         }
     }
 
@@ -452,3 +550,38 @@ const char* CGLSLIdentifierTable::GetNameForSymbolIndex(int iSymbolIndex) const
 {
     return _spSymbolTable->NameFromIndex(iSymbolIndex);
 }
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetMemorySize
+//
+//  Synopsis:   Returns the approximate memory retained by the table, the
+//              symbol table and the infos it holds.
+//
+//-----------------------------------------------------------------------------
+UINT CGLSLIdentifierTable::GetMemorySize() const
+{
+    UINT cbMemorySize = sizeof(*this);
+
+    if (_spSymbolTable != nullptr)
+    {
+        cbMemorySize += _spSymbolTable->GetMemorySize();
+    }
+
+    cbMemorySize += _aryVarList.GetCapacity() * sizeof(TSmartPointer<CVariableIdentifierInfo>);
+    cbMemorySize += _aryVarChainBySymbol.GetCapacity() * sizeof(VariableChain);
+    cbMemorySize += _aryNextVarWithSymbol.GetCapacity() * sizeof(UINT);
+    cbMemorySize += _aryTypeList.GetCapacity() * sizeof(TSmartPointer<CTypeNameIdentifierInfo>);
+
+    for (UINT i = 0; i < _aryVarList.GetCount(); i++)
+    {
+        cbMemorySize += _aryVarList[i]->GetMemorySize();
+    }
+
+    for (UINT i = 0; i < _aryTypeList.GetCount(); i++)
+    {
+        cbMemorySize += _aryTypeList[i]->GetMemorySize();
+    }
+
+    return cbMemorySize;
+}
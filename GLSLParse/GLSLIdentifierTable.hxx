@@ -101,13 +101,47 @@ public:
 
     const char* GetNameForSymbolIndex(int iSymbolIndex) const;
 
+    CGLSLSymbolTable* UseSymbolTable() const { return _spSymbolTable; }
+    UINT GetVariableCount() const { return _aryVarList.GetCount(); }
+    CVariableIdentifierInfo* UseVariableInfo(UINT uIndex) const { return _aryVarList[uIndex]; }
+    UINT GetTypeNameCount() const { return _aryTypeList.GetCount(); }
+    CTypeNameIdentifierInfo* UseTypeNameInfo(UINT uIndex) const { return _aryTypeList[uIndex]; }
+    UINT GetMemorySize() const;
+
+    HRESULT AddVariableInfo(__in CVariableIdentifierInfo* pInfo);
+    HRESULT AddTypeNameInfo(__in CTypeNameIdentifierInfo* pInfo);
+
 protected:
     HRESULT Initialize(
         __in CGLSLParser* pParser                                       // The parser that owns the table
         );
 
+    HRESULT Initialize(
+        __in CGLSLSymbolTable* pSymbolTable                             // Symbol table the identifiers refer to
+        );
+
+private:
+    HRESULT AddToVariableList(__in CVariableIdentifierInfo* pInfo);
+
 private:
+    //+-------------------------------------------------------------------------
+    //
+    //  Struct:     VariableChain
+    //
+    //  Synopsis:   The variables that share a symbol, in the order that they
+    //              were added. Indices are one more than the index into
+    //              _aryVarList, so that zero means there are none.
+    //
+    //--------------------------------------------------------------------------
+    struct VariableChain
+    {
+        UINT _uFirst;                                                   // First variable with the symbol
+        UINT _uLast;                                                    // Last variable with the symbol
+    };
+
     TSmartPointer<CGLSLSymbolTable> _spSymbolTable;                     // The symbol table
     CModernArray<TSmartPointer<CVariableIdentifierInfo>> _aryVarList;   // The current list of variable identifiers
+    CModernArray<VariableChain> _aryVarChainBySymbol;                   // Variables for each symbol index
+    CModernArray<UINT> _aryNextVarWithSymbol;                           // Next variable with the same symbol, for each variable
     CModernArray<TSmartPointer<CTypeNameIdentifierInfo>> _aryTypeList;  // The current list of typename identifiers
 };
@@ -0,0 +1,358 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#include "PreComp.hxx"
+#include "GLSLKnownFunctionIndex.hxx"
+#include "GLSL.tab.h"
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Find
+//
+//  Synopsis:   Find what a call to a known function with the given argument
+//              types resolves to. Returns null if no known function with
+//              that symbol accepts the arguments.
+//
+//-----------------------------------------------------------------------------
+const CGLSLKnownFunctionIndex::Match* CGLSLKnownFunctionIndex::Find(
+    int iSymbolIndex,                                           // Symbol of the function being called
+    __in_ecount(uArgCount) const int* pArgTypes,                // Basic types of the arguments
+    UINT uArgCount                                              // Number of arguments
+    )
+{
+    if (uArgCount > s_uMaxArgCount)
+    {
+        return nullptr;
+    }
+
+    UINT uBucket;
+    const Entry* pEntry = GetEntryTable().Find(iSymbolIndex, pArgTypes, uArgCount, &uBucket);
+
+    return (pEntry != nullptr) ? &pEntry->_match : nullptr;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetEntryTable
+//
+//  Synopsis:   Get the process-wide entry table. It is built on first use
+//              (the static local makes that thread safe) and never changes
+//              afterwards, so it can be read without locking.
+//
+//-----------------------------------------------------------------------------
+const CGLSLKnownFunctionIndex::EntryTable& CGLSLKnownFunctionIndex::GetEntryTable()
+{
+    static const EntryTable s_entryTable;
+
+    return s_entryTable;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   HashKey
+//
+//  Synopsis:   Hash a function symbol together with its argument types.
+//
+//-----------------------------------------------------------------------------
+UINT CGLSLKnownFunctionIndex::HashKey(
+    int iSymbolIndex,                                           // Symbol of the function
+    __in_ecount(uArgCount) const int* pArgTypes,                // Basic types of the arguments
+    UINT uArgCount                                              // Number of arguments
+    )
+{
+    UINT uHash = static_cast<UINT>(iSymbolIndex) * 0x9E3779B1;
+    for (UINT i = 0; i < uArgCount; i++)
+    {
+        uHash = (uHash ^ static_cast<UINT>(pArgTypes[i])) * 0x01000193;
+    }
+
+    uHash ^= uArgCount;
+
+    return uHash ^ (uHash >> 16);
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   EntryTable constructor
+//
+//  Synopsis:   Add an entry for every argument type list that each known
+//              function accepts. These are the same lists that
+//              CGLSLFunctionSignature::SignatureMatchesArgumentTypes accepts
+//              for the signature built from the function's info.
+//
+//              The table is sized at compile time so building it cannot
+//              fail.
+//
+//-----------------------------------------------------------------------------
+CGLSLKnownFunctionIndex::EntryTable::EntryTable() :
+    _cEntries(0)
+{
+    static_assert(s_uBucketCount >= 2 * s_uMaxEntryCount, "Known function buckets must keep the load factor at or below one half");
+    static_assert(s_uMaxArgCount == ARRAYSIZE(GLSLFunctionInfo::s_info[0]._rgArgTypes), "Entries must hold as many arguments as a known function can take");
+
+    for (UINT i = 0; i < s_uBucketCount; i++)
+    {
+        _rgBuckets[i] = s_iEmptyBucket;
+    }
+
+    for (int i = 0; i < GLSLFunctions::count; i++)
+    {
+        GLSLFunctions::Enum known = static_cast<GLSLFunctions::Enum>(i);
+        const GLSLFunctionInfo &info = GLSLKnownSymbols::GetKnownInfo<GLSLFunctionInfo>(known);
+
+        // Functions without an HLSL equivalent (main) are declared by the
+        // shader, so calls to them are resolved against the shader's signature
+        if (info._hlslEnum == HLSLFunctions::count)
+        {
+            continue;
+        }
+
+        switch (info._sigType)
+        {
+        case GLSLSignatureType::Normal:
+            AddGenTypeEntries(info);
+            break;
+
+        case GLSLSignatureType::CompareFloatVector:
+        case GLSLSignatureType::CompareIntVector:
+        case GLSLSignatureType::CompareBoolVector:
+            AddCompareVectorEntries(info);
+            break;
+
+        case GLSLSignatureType::TestBoolVector:
+            AddTestVectorEntries(info);
+            break;
+
+        default:
+            AssertSz(false, "Unexpected signature type for a known function");
+            break;
+        }
+    }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddGenTypeEntries
+//
+//  Synopsis:   Add the argument types for a function that lists its
+//              argument types. If any of them is gentype, the function
+//              accepts each valid gentype in its place (the same one for
+//              all of them), and a gentype return type becomes that type.
+//
+//-----------------------------------------------------------------------------
+void CGLSLKnownFunctionIndex::EntryTable::AddGenTypeEntries(const GLSLFunctionInfo& info)
+{
+    bool fHasGenTypeArg = false;
+    for (int i = 0; i < info._numArgs; i++)
+    {
+        fHasGenTypeArg = fHasGenTypeArg || (info._rgArgTypes[i] == GENTYPE);
+    }
+
+    if (!fHasGenTypeArg)
+    {
+        // A gentype return type with no gentype argument to infer it from
+        // never matches
+        if (info._type != GENTYPE)
+        {
+            AddEntry(info, info._rgArgTypes, static_cast<UINT>(info._numArgs), NO_TYPE, info._type);
+        }
+
+        return;
+    }
+
+    // These are the types that TypeHelpers::IsValidGenType allows
+    const int rgGenTypes[] = { FLOAT_TOK, VEC2, VEC3, VEC4 };
+    static_assert(ARRAYSIZE(rgGenTypes) <= s_uMaxEntriesPerFunction, "Too many entries for one function");
+
+    for (UINT uGenType = 0; uGenType < ARRAYSIZE(rgGenTypes); uGenType++)
+    {
+        int genType = rgGenTypes[uGenType];
+
+        int rgArgTypes[s_uMaxArgCount];
+        for (int i = 0; i < info._numArgs; i++)
+        {
+            rgArgTypes[i] = (info._rgArgTypes[i] == GENTYPE) ? genType : info._rgArgTypes[i];
+        }
+
+        AddEntry(info, rgArgTypes, static_cast<UINT>(info._numArgs), genType, (info._type == GENTYPE) ? genType : info._type);
+    }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddCompareVectorEntries
+//
+//  Synopsis:   Add the argument types for a vector relational function,
+//              which takes two vectors of the same size and component type
+//              and returns a boolean vector of that size.
+//
+//-----------------------------------------------------------------------------
+void CGLSLKnownFunctionIndex::EntryTable::AddCompareVectorEntries(const GLSLFunctionInfo& info)
+{
+    const int rgFloatVectors[] = { VEC2, VEC3, VEC4 };
+    const int rgIntVectors[] = { IVEC2_TOK, IVEC3_TOK, IVEC4_TOK };
+    const int rgBoolVectors[] = { BVEC2_TOK, BVEC3_TOK, BVEC4_TOK };
+    static_assert(ARRAYSIZE(rgBoolVectors) <= s_uMaxEntriesPerFunction, "Too many entries for one function");
+
+    const int* pVectors;
+    switch (info._sigType)
+    {
+    case GLSLSignatureType::CompareFloatVector:
+        pVectors = rgFloatVectors;
+        break;
+
+    case GLSLSignatureType::CompareIntVector:
+        pVectors = rgIntVectors;
+        break;
+
+    default:
+        Assert(info._sigType == GLSLSignatureType::CompareBoolVector);
+        pVectors = rgBoolVectors;
+        break;
+    }
+
+    for (UINT i = 0; i < ARRAYSIZE(rgBoolVectors); i++)
+    {
+        int rgArgTypes[] = { pVectors[i], pVectors[i] };
+        AddEntry(info, rgArgTypes, ARRAYSIZE(rgArgTypes), NO_TYPE, rgBoolVectors[i]);
+    }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddTestVectorEntries
+//
+//  Synopsis:   Add the argument types for a vector test function, which
+//              takes one argument with boolean components and returns a
+//              boolean.
+//
+//-----------------------------------------------------------------------------
+void CGLSLKnownFunctionIndex::EntryTable::AddTestVectorEntries(const GLSLFunctionInfo& info)
+{
+    const int rgBoolTypes[] = { BOOL_TOK, BVEC2_TOK, BVEC3_TOK, BVEC4_TOK };
+    static_assert(ARRAYSIZE(rgBoolTypes) <= s_uMaxEntriesPerFunction, "Too many entries for one function");
+
+    for (UINT i = 0; i < ARRAYSIZE(rgBoolTypes); i++)
+    {
+        AddEntry(info, &rgBoolTypes[i], 1, NO_TYPE, BOOL_TOK);
+    }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddEntry
+//
+//  Synopsis:   Add one argument type list for an overload. If an earlier
+//              overload already accepts the same arguments, the call keeps
+//              resolving to that one, which is the overload that matching
+//              the overloads in order would have picked.
+//
+//-----------------------------------------------------------------------------
+void CGLSLKnownFunctionIndex::EntryTable::AddEntry(
+    const GLSLFunctionInfo& info,                               // Overload that accepts the arguments
+    __in_ecount(uArgCount) const int* pArgTypes,                // Basic types of the arguments
+    UINT uArgCount,                                             // Number of arguments
+    int genType,                                                // What gentype stands for, or NO_TYPE
+    int returnType                                              // Basic type that the call returns
+    )
+{
+    Assert(uArgCount <= s_uMaxArgCount);
+
+    int iSymbolIndex = static_cast<int>(info._symbolEnum);
+
+    UINT uBucket;
+    const Entry* pExisting = Find(iSymbolIndex, pArgTypes, uArgCount, &uBucket);
+    if (pExisting != nullptr)
+    {
+        // Known functions are added to a shader depending on their flags, so
+        // if overloads that overlap had different flags, the first one might
+        // be missing from a shader where the second one is there.
+        AssertSz(GLSLFunctionInfo::s_info[pExisting->_match._function]._uFlags == info._uFlags, "Overlapping known function overloads must have the same flags");
+        return;
+    }
+
+    Assert(_cEntries < s_uMaxEntryCount);
+    if (_cEntries < s_uMaxEntryCount)
+    {
+        Entry& entry = _rgEntries[_cEntries];
+        entry._iSymbolIndex = iSymbolIndex;
+        entry._uArgCount = uArgCount;
+        for (UINT i = 0; i < s_uMaxArgCount; i++)
+        {
+            entry._rgArgTypes[i] = (i < uArgCount) ? pArgTypes[i] : NO_TYPE;
+        }
+
+        entry._match._function = info._indexEnum;
+        entry._match._genType = genType;
+        entry._match._returnType = returnType;
+
+        _rgBuckets[uBucket] = static_cast<int>(_cEntries);
+        _cEntries++;
+    }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Find
+//
+//  Synopsis:   Find the entry for a function symbol and its argument types.
+//              If there isn't one, the bucket it would go in is returned.
+//
+//-----------------------------------------------------------------------------
+const CGLSLKnownFunctionIndex::Entry* CGLSLKnownFunctionIndex::EntryTable::Find(
+    int iSymbolIndex,                                           // Symbol of the function being called
+    __in_ecount(uArgCount) const int* pArgTypes,                // Basic types of the arguments
+    UINT uArgCount,                                             // Number of arguments
+    __out UINT* puBucket                                        // Bucket holding the entry, or first empty bucket
+    ) const
+{
+    const UINT uMask = s_uBucketCount - 1;
+    UINT uBucket = HashKey(iSymbolIndex, pArgTypes, uArgCount) & uMask;
+
+    while (_rgBuckets[uBucket] != s_iEmptyBucket)
+    {
+        const Entry& entry = _rgEntries[_rgBuckets[uBucket]];
+        if (entry._iSymbolIndex == iSymbolIndex && entry._uArgCount == uArgCount)
+        {
+            bool fArgsMatch = true;
+            for (UINT i = 0; i < uArgCount && fArgsMatch; i++)
+            {
+                fArgsMatch = (entry._rgArgTypes[i] == pArgTypes[i]);
+            }
+
+            if (fArgsMatch)
+            {
+                (*puBucket) = uBucket;
+                return &entry;
+            }
+        }
+
+        uBucket = (uBucket + 1) & uMask;
+    }
+
+    (*puBucket) = uBucket;
+    return nullptr;
+}
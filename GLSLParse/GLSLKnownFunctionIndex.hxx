@@ -0,0 +1,136 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#pragma once
+
+#include "KnownSymbols.hxx"
+
+//+-----------------------------------------------------------------------------
+//
+//  Class:      CGLSLKnownFunctionIndex
+//
+//  Synopsis:   Resolves a call to a built-in function from the function's
+//              symbol and the basic types of its arguments, giving the
+//              overload that is called along with its gentype and return
+//              type.
+//
+//              Every argument type list that a known function accepts is
+//              worked out once per process from GLSLFunctionInfo::s_info, so
+//              resolving a call is a single hash lookup instead of matching
+//              the arguments against the signature of each overload.
+//
+//------------------------------------------------------------------------------
+class CGLSLKnownFunctionIndex
+{
+public:
+    //+-------------------------------------------------------------------------
+    //
+    //  Struct:     Match
+    //
+    //  Synopsis:   What a call to a known function resolves to.
+    //
+    //--------------------------------------------------------------------------
+    struct Match
+    {
+        GLSLFunctions::Enum _function;                                      // Overload that is called
+        int _genType;                                                       // What gentype stands for in the call, or NO_TYPE
+        int _returnType;                                                    // Basic type that the call returns
+    };
+
+    static const Match* Find(
+        int iSymbolIndex,                                                   // Symbol of the function being called
+        __in_ecount(uArgCount) const int* pArgTypes,                        // Basic types of the arguments
+        UINT uArgCount                                                      // Number of arguments
+        );
+
+    static const UINT s_uMaxArgCount = 4;                                   // Most arguments any known function takes
+
+private:
+    //+-------------------------------------------------------------------------
+    //
+    //  Struct:     Entry
+    //
+    //  Synopsis:   One argument type list accepted by one overload.
+    //
+    //--------------------------------------------------------------------------
+    struct Entry
+    {
+        int _iSymbolIndex;                                                  // Symbol of the function
+        UINT _uArgCount;                                                    // Number of arguments
+        int _rgArgTypes[s_uMaxArgCount];                                    // Basic types of the arguments
+        Match _match;                                                       // What the call resolves to
+    };
+
+    //+-------------------------------------------------------------------------
+    //
+    //  Struct:     EntryTable
+    //
+    //  Synopsis:   Immutable hash table of entries for every known function,
+    //              shared by the process.
+    //
+    //--------------------------------------------------------------------------
+    struct EntryTable
+    {
+        EntryTable();
+
+        void AddEntry(
+            const GLSLFunctionInfo& info,                                   // Overload that accepts the arguments
+            __in_ecount(uArgCount) const int* pArgTypes,                    // Basic types of the arguments
+            UINT uArgCount,                                                 // Number of arguments
+            int genType,                                                    // What gentype stands for, or NO_TYPE
+            int returnType                                                  // Basic type that the call returns
+            );
+
+        void AddGenTypeEntries(const GLSLFunctionInfo& info);
+        void AddCompareVectorEntries(const GLSLFunctionInfo& info);
+        void AddTestVectorEntries(const GLSLFunctionInfo& info);
+
+        const Entry* Find(
+            int iSymbolIndex,                                               // Symbol of the function being called
+            __in_ecount(uArgCount) const int* pArgTypes,                    // Basic types of the arguments
+            UINT uArgCount,                                                 // Number of arguments
+            __out UINT* puBucket                                            // Bucket holding the entry, or first empty bucket
+            ) const;
+
+        static const UINT s_uMaxEntriesPerFunction = 4;                     // Gentypes, or vector lengths, that one overload can take
+        static const UINT s_uMaxEntryCount = GLSLFunctions::count * s_uMaxEntriesPerFunction;
+        static const UINT s_uBucketCount = 1024;                            // Must be a power of 2
+
+        Entry _rgEntries[s_uMaxEntryCount];                                 // Entries added so far
+        UINT _cEntries;                                                     // Number of entries added
+        int _rgBuckets[s_uBucketCount];                                     // Hash buckets holding indices into _rgEntries
+    };
+
+    static const EntryTable& GetEntryTable();
+
+    static UINT HashKey(
+        int iSymbolIndex,                                                   // Symbol of the function
+        __in_ecount(uArgCount) const int* pArgTypes,                        // Basic types of the arguments
+        UINT uArgCount                                                      // Number of arguments
+        );
+
+    static const int s_iEmptyBucket = -1;                                   // Marker for an unused bucket
+};
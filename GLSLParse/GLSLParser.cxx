@@ -26,6 +26,7 @@
 //--------------------------------------------------------------
 #include "PreComp.hxx"
 #include "GLSLParser.hxx"
+#include "GLSLBoilerplate.hxx"
 #include "IStringStream.hxx"
 #include "RefCounted.hxx"
 #include "ParseTree.hxx"
@@ -43,6 +44,9 @@
 #include "StructGLSLType.hxx"
 #include "TypeNameIdentifierInfo.hxx"
 #include "ArrayGLSLType.hxx"
+#include "SimpleStack.hxx"
+#include "TypeHelpers.hxx"
+#include <float.h>
 
 #pragma warning(disable:28718)
 #include "lex.GLSL.h"
@@ -50,7 +54,6 @@
 #pragma warning(default:28718)
 
 const UINT CGLSLParser::s_uMaxShaderSize = 131072;              // Maximum size of input to GLSL parser
-const char* CGLSLParser::s_pszMaxShaderSizeString = "131072";   // Max size as string
 const YYLTYPE CGLSLParser::s_nullLocation = {0};                // Placeholder location for generated parse tree nodes
 
 //+----------------------------------------------------------------------------
@@ -70,7 +73,10 @@ CGLSLParser::CGLSLParser() :
     _fWriteBoilerPlate(true),
     _uFeaturesUsed(0),
     _glFeatureLevel(WebGLFeatureLevel::Level_9_1),
-    _fHasNonConstGlobalInitializers(false)
+    _fHasNonConstGlobalInitializers(false),
+    _fEliminateDeadCode(false),
+    _fFoldConstants(false),
+    _fFoldingConstants(false)
 {
 }
 
@@ -90,9 +96,24 @@ HRESULT CGLSLParser::Initialize(
 {
     CHK_START;
 
+    // The nodes of the tree come out of the arena, which frees their memory
+    // a chunk at a time when the parser goes away.
+    CHK(RefCounted<CGLSLArena>::Create(/*out*/_spArena));
+    CGLSLArenaScope arenaScope(_spArena);
+
+    // Types asked for during the translation are shared through the type table,
+    // so that equal types are the same object.
+    CHK(RefCounted<CGLSLTypeTable>::Create(/*out*/_spTypeTable));
+    CGLSLTypeTableScope typeTableScope(_spTypeTable);
+
+    // Identifiers are resolved through this while their scope is being verified
+    CHK(RefCounted<CGLSLScopedSymbolIndex>::Create(/*out*/_spScopedSymbolIndex));
+
     _shaderType = shaderType;
     _fWriteInputs = (uOptions & GLSLTranslateOptions::DisableWriteInputs) == 0;
     _fWriteBoilerPlate = (uOptions & GLSLTranslateOptions::DisableBoilerPlate) == 0;
+    _fEliminateDeadCode = (uOptions & GLSLTranslateOptions::EliminateDeadCode) != 0;
+    _fFoldConstants = (uOptions & GLSLTranslateOptions::FoldConstants) != 0;
 
     if ((uOptions & GLSLTranslateOptions::ForceFeatureLevel9) != 0)
     {
@@ -103,60 +124,111 @@ HRESULT CGLSLParser::Initialize(
         _glFeatureLevel = glFeatureLevel;
     }
 
-    CHK(RefCounted<CGLSLSymbolTable>::Create(/*out*/_spSymbolTable));
-
-    // Seed the symbol table with the known symbols so that the number of known symbols in
+    // Layer the symbol table on top of the known symbols so that the number of known symbols in
     // the table is known. This is used to make the output of the variables more predictable.
+    // The known symbols are shared across translations, so this does not copy them.
+    CHK(RefCounted<CGLSLSymbolTable, MultiThreadedRefCount>::Create(true, /*out*/_spSymbolTable));
+
+#if DBG
     for (int i = 0; i < GLSLSymbols::count; i++)
     {
         GLSLSymbols::Enum known = static_cast<GLSLSymbols::Enum>(i);
         const GLSLSymbolInfo &info = GLSLKnownSymbols::GetKnownInfo<GLSLSymbolInfo>(known);
 
         int symbolIndex;
-        CHK(_spSymbolTable->EnsureSymbolIndex(info._pGLSLName, &symbolIndex));
+        CHK(_spSymbolTable->LookupSymbolIndex(info._pGLSLName, &symbolIndex));
 
         // Make sure that casting GLSL function enums to int gives its index, because we
         // have code that makes use of this fact to do fast comparisons.
         Assert(static_cast<int>(known) == symbolIndex);
     }
+#endif
 
     // Create the object we will ultimately return back
-    CHK(RefCounted<CGLSLConvertedShader>::Create(/*out*/_spConverted));
+    CHK(RefCounted<CGLSLConvertedShader, MultiThreadedRefCount>::Create(/*out*/_spConverted));
+
+    // Stats are only gathered when asked for; without them the phase timers do nothing
+    if ((uOptions & GLSLTranslateOptions::EnableStats) != 0)
+    {
+        CHK(RefCounted<CGLSLTranslationStats, MultiThreadedRefCount>::Create(/*out*/_spStats));
+        _spConverted->SetStats(_spStats);
+    }
 
     // We need to convert to Ansi for our parser to work
     TSmartPointer<CMemoryStream> spConvertedInput;
-    CHK(CGLSLUnicodeConverter::ConvertToAscii(bstrInput, &spConvertedInput));
+    {
+        CGLSLTranslationPhaseTimer timer(_spStats, GLSLTranslationPhase::ConvertInput);
+        CHK(CGLSLUnicodeConverter::ConvertToAscii(bstrInput, &spConvertedInput));
+    }
+
+    if (_spStats != nullptr)
+    {
+        UINT uInputSize;
+        CHK(spConvertedInput->GetSize(&uInputSize));
+        _spStats->SetInputSize(uInputSize);
+    }
 
     // Preprocess the input - first make an input object from the converted input
     TSmartPointer<CGLSLStreamParserInput> spPreprocessInput;
     CHK(RefCounted<CGLSLStreamParserInput>::Create(spConvertedInput, /*out*/spPreprocessInput));
 
-    // Run the preprocessor
+    // Run the preprocessor, which stops as soon as its output goes over the
+    // maximum size we are willing to parse
     TSmartPointer<CMemoryStream> spPreprocessed;
-    if (SUCCEEDED(::GLSLPreprocess(spPreprocessInput, _spConverted, uOptions, shaderType, &spPreprocessed, &_spLineMap, &_spExtensionState)))
+    HRESULT hrPreprocess;
+    UINT uExpansionCount = 0;
     {
-        UINT uSize;
-        CHK(spPreprocessed->GetSize(&uSize));
+        CGLSLTranslationPhaseTimer timer(_spStats, GLSLTranslationPhase::Preprocess);
+        hrPreprocess = ::GLSLPreprocess(spPreprocessInput, _spConverted, uOptions, shaderType, s_uMaxShaderSize, &spPreprocessed, &_spLineMap, &_spExtensionState, &uExpansionCount);
+    }
 
-        if (uSize > s_uMaxShaderSize)
+    if (SUCCEEDED(hrPreprocess))
+    {
+        if (_spStats != nullptr)
         {
-            CHK(LogError(nullptr, E_GLSLERROR_SHADERTOOLONG, s_pszMaxShaderSizeString));
+            UINT uPreprocessedSize;
+            CHK(spPreprocessed->GetSize(&uPreprocessedSize));
+            _spStats->SetPreprocessedSize(uPreprocessedSize);
+            _spStats->SetMacroExpansionCount(uExpansionCount);
         }
-        else
-        {
-            // Make an input object from the preprocessor output
-            CHK(RefCounted<CGLSLStreamParserInput>::Create(spPreprocessed, /*out*/_spInput));
 
-            // Before we start, check the line map so that a #line on the first line will have the right effect
-            _spLineMap->AdjustLogicalLine(_realLine, &_logicalLine);
+        // Make an input object from the preprocessor output
+        CHK(RefCounted<CGLSLStreamParserInput>::Create(spPreprocessed, /*out*/_spInput));
 
-            // Kick off the parser
-            yyscan_t scanner;
-            GLSLlex_init(&scanner);
-            GLSLset_extra(this, scanner);
+        // Before we start, check the line map so that a #line on the first line will have the right effect
+        _spLineMap->AdjustLogicalLine(_realLine, &_logicalLine);
+
+        // Kick off the parser. The scanner runs in place over the preprocessor
+        // output when it can, rather than copying it into its own buffer.
+        CGLSLTranslationPhaseTimer timer(_spStats, GLSLTranslationPhase::Parse);
+
+        yyscan_t scanner;
+        GLSLlex_init(&scanner);
+        GLSLset_extra(this, scanner);
+
+        char* pScanBuffer;
+        UINT uScanBufferSize;
+        bool fScanBufferRefused = false;
+        if (SUCCEEDED(_spInput->GetScanBuffer(&pScanBuffer, &uScanBufferSize)))
+        {
+            // flex only refuses a buffer that is missing its two null
+            // terminators, which means the input broke its contract
+            if (GLSL_scan_buffer(pScanBuffer, uScanBufferSize, scanner) == nullptr)
+            {
+                Assert(false);
+                _spInput->ReleaseScanBuffer();
+                fScanBufferRefused = true;
+            }
+        }
+
+        if (!fScanBufferRefused)
+        {
             GLSLparse(scanner);
-            GLSLlex_destroy(scanner);
         }
+
+        GLSLlex_destroy(scanner);
+
+        CHKB(!fScanBufferRefused);
     }
     else
     {
@@ -251,49 +323,76 @@ HRESULT CGLSLParser::TranslateTree(
     CHKB(_spRootNode != nullptr);
 
     TSmartPointer<CMemoryStream> spConvertedStream;
-    CHK(RefCounted<CMemoryStream>::Create(/*out*/spConvertedStream));
+    CHK(RefCounted<CMemoryStream, MultiThreadedRefCount>::Create(/*out*/spConvertedStream));
 
     // Initialize the identifier table
-    CHK(RefCounted<CGLSLIdentifierTable>::Create(this, /*out*/_spIdTable));
+    CHK(RefCounted<CGLSLIdentifierTable, MultiThreadedRefCount>::Create(this, /*out*/_spIdTable));
 
     // Give it to the converted shader
     _spConverted->SetIdentifierTable(_spIdTable);
 
     // Do the type verification pass
-    CHK(_spRootNode->VerifyNode());
+    {
+        CGLSLTranslationPhaseTimer timer(_spStats, GLSLTranslationPhase::Verify);
+        CHK(_spRootNode->VerifyNode());
+    }
 
     // Verify the inputs
-    CHK(VerifyInputs());
+    {
+        CGLSLTranslationPhaseTimer timer(_spStats, GLSLTranslationPhase::VerifyInputs);
+        CHK(VerifyInputs());
+    }
 
     // Now that everything has passed verification, we do various transformations. The order
     // of these is important, because some of them transform stuff done in previous stages.
     // For example, we move short-circuit initializer expressions before ensuring short-cirtuiting
     // is respected and thus don't have to worry about doing so in the global scope.
-    if (_fHasNonConstGlobalInitializers)
     {
-        CHK(TranslateGlobalDeclarations());
-    }
+        CGLSLTranslationPhaseTimer timer(_spStats, GLSLTranslationPhase::Transform);
 
-    CHK(TranslateStructDeclarations());
-    CHK(TranslateShortCircuitExpressions());
+        // Dead code goes first so that none of the other transformations spend
+        // time on it, and so the global initializer function only sees what is kept.
+        if (_fEliminateDeadCode)
+        {
+            CHK(EliminateDeadCode());
+        }
 
-    // Translate the samplers
-    CHK(TranslateSamplers());
+        // Folding comes before the short circuit translation, so that it does not
+        // hoist things out of expressions that are going to become a literal.
+        if (_fFoldConstants)
+        {
+            CHK(FoldConstants());
+        }
 
-    if (fWriteInputs)
-    {
-        // Output the HLSL inputs
-        CHK(TranslateInputs(spConvertedStream));
+        if (_fHasNonConstGlobalInitializers)
+        {
+            CHK(TranslateGlobalDeclarations());
+        }
+
+        CHK(TranslateStructDeclarations());
+        CHK(TranslateShortCircuitExpressions());
+
+        // Translate the samplers
+        CHK(TranslateSamplers());
     }
 
+    {
+        CGLSLTranslationPhaseTimer timer(_spStats, GLSLTranslationPhase::Output);
+
+        if (fWriteInputs)
+        {
+            // Output the HLSL inputs
+            CHK(TranslateInputs(spConvertedStream));
+        }
+
 #if DBG
-    // Translation has been completed. At this point all nodes in the tree must be verified
-    _spRootNode->AssertSubtreeFullyVerified();
+        // Translation has been completed. At this point all nodes in the tree must be verified
+        _spRootNode->AssertSubtreeFullyVerified();
 #endif
-    
 
-    // Start at the root and work down...
-    CHK(_spRootNode->OutputHLSL(spConvertedStream));
+        // Start at the root and work down...
+        CHK(_spRootNode->OutputHLSL(spConvertedStream));
+    }
 
     (*ppConverted) = spConvertedStream.Extract();
 
@@ -515,6 +614,9 @@ HRESULT CGLSLParser::Translate(
 {
     CHK_START;
 
+    CGLSLArenaScope arenaScope(_spArena);
+    CGLSLTypeTableScope typeTableScope(_spTypeTable);
+
     // If no errors were found until now, then try to do conversion to HLSL
     TSmartPointer<CMemoryStream> spConvertedStream;
     if (!_fErrors)
@@ -546,11 +648,48 @@ HRESULT CGLSLParser::Translate(
         }
     }
 
+    if (_spStats != nullptr)
+    {
+        CHK(RecordStats(spConvertedStream));
+    }
+
     _spConverted.CopyTo(ppConvertedShader);
 
     CHK_RETURN;
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   RecordStats
+//
+//  Synopsis:   Fill in the stats that are taken from the end state of the
+//              translation rather than timed as it goes.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLParser::RecordStats(
+    __in_opt CMemoryStream* pConvertedStream                    // Converted HLSL, if translation got that far
+    )
+{
+    CHK_START;
+
+    if (pConvertedStream != nullptr)
+    {
+        UINT uOutputSize;
+        CHK(pConvertedStream->GetSize(&uOutputSize));
+        _spStats->SetOutputSize(uOutputSize);
+    }
+
+    _spStats->SetSymbolCount(_spSymbolTable->GetCount());
+    _spStats->RecordArena(_spArena);
+
+    if (_spRootNode != nullptr)
+    {
+        CHK(_spStats->CountNodes(_spRootNode));
+    }
+
+    CHK_RETURN;
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   AddDeclaratorList
@@ -918,15 +1057,27 @@ HRESULT CGLSLParser::CreateSelectionFromParts(
 //              function is the ternary is in a global declaration since we
 //              cannot execute code directly.
 //
+//              The expressions are in execution order, so the ones that share
+//              a statement list are moved in front of statements in order.
+//              The index of the last insertion point is remembered so that
+//              finding the next one does not search the list from the start,
+//              and a gap of empty children is carried along the list so that
+//              the statements after it are not shifted for every insertion.
+//
 //+----------------------------------------------------------------------------
 HRESULT CGLSLParser::TranslateShortCircuitExpressions()
 {
     CHK_START;
 
-    while (_aryShortCircuitExprs.GetCount() > 0)
+    CollectionNode* pLastInsertionParent = nullptr;
+    UINT uLastInsertionIndex = 0;
+    StatementGap gap = { nullptr, 0, 0, 0 };
+
+    // The list is walked by index rather than removing from the front, and is
+    // cleared once every expression has been translated.
+    for (UINT uExpr = 0; uExpr < _aryShortCircuitExprs.GetCount(); uExpr++)
     {
-        TSmartPointer<ParseTreeNode> spCondExpr = _aryShortCircuitExprs[0];
-        _aryShortCircuitExprs.RemoveAt(0);
+        TSmartPointer<ParseTreeNode> spCondExpr = _aryShortCircuitExprs[uExpr];
 
         // This array will hold every expression that occurs 'before' (i.e. must be executed
         // prior to) the current short circuit expression. This is in reverse order to simplify
@@ -947,7 +1098,14 @@ HRESULT CGLSLParser::TranslateShortCircuitExpressions()
                 // short circuit expression we're concerned with. We want to have the gathered
                 // ordered expressions execute before the branch of the short circuit expression
                 // so that they executed before it.
-                CHK(MoveExpressionsToInsertionPoint(pParent, pChild, aryOrderedExpressionsToMove));
+                UINT uChildIndex;
+                UINT uStartIndex = (pParent == pLastInsertionParent) ? uLastInsertionIndex : 0;
+                CHK_VERIFY(SUCCEEDED(pParent->GetChildIndex(pChild, uStartIndex, &uChildIndex)));
+
+                CHK(MoveExpressionsToInsertionPoint(pParent, pChild, &uChildIndex, aryOrderedExpressionsToMove, &gap));
+
+                pLastInsertionParent = pParent;
+                uLastInsertionIndex = uChildIndex;
 
                 // Once the expressions have successfully been moved, we're done with this 
                 break;
@@ -966,7 +1124,7 @@ HRESULT CGLSLParser::TranslateShortCircuitExpressions()
                 // we will actually split the declaration into multiple statements.
                 if (pParent->GetParseNodeType() == ParseNodeType::initDeclaratorList)
                 {
-                    CHK(FixupDeclarationForShortCircuiting(pParent->GetAs<InitDeclaratorListNode>(), pChild));
+                    CHK(FixupDeclarationForShortCircuiting(pParent->GetAs<InitDeclaratorListNode>(), pChild, &gap));
                 }
                 else
                 {
@@ -980,6 +1138,9 @@ HRESULT CGLSLParser::TranslateShortCircuitExpressions()
         }
     }
 
+    CHK(CloseStatementGap(&gap));
+    _aryShortCircuitExprs.RemoveAll();
+
     CHK_RETURN;
 }
 
@@ -1138,8 +1299,17 @@ HRESULT CGLSLParser::GenerateNoArgsFunctionPrototype(
 //              The ternary and the ordered expression before it (b = 2) can then
 //              be moved to just befor the 'int c' declaration.
 //
+//              Splitting inserts into the statement list directly, so pGap is
+//              closed first. Declarations that are not split leave it open,
+//              so that a run of declarations like 'float t = c ? a : b;' does
+//              not shift the rest of the list for each one.
+//
 //+----------------------------------------------------------------------------
-HRESULT CGLSLParser::FixupDeclarationForShortCircuiting(__in InitDeclaratorListNode* pInitDeclList, __in ParseTreeNode* pChild)
+HRESULT CGLSLParser::FixupDeclarationForShortCircuiting(
+    __in InitDeclaratorListNode* pInitDeclList,                         // Declaration with a short circuit expression
+    __in ParseTreeNode* pChild,                                         // Entry of the declaration that holds the expression
+    __inout StatementGap* pGap                                          // Empty children left over from the last insertion
+    )
 {
     CHK_START;
 
@@ -1159,6 +1329,7 @@ HRESULT CGLSLParser::FixupDeclarationForShortCircuiting(__in InitDeclaratorListN
         // and one with the remaining, beginning with the entry containing the short ciruit expression.
         // This will allow us to inject an if/else statement between the two declarations to ensure
         // we don't re-order execution of the code.
+        CHK(CloseStatementGap(pGap));
 
         // Both declarations must have the same type - clone it from the original
         FullySpecifiedTypeNode* pOriginalFullType = pInitDeclList->GetFullySpecifiedTypeNode();
@@ -1205,16 +1376,37 @@ HRESULT CGLSLParser::FixupDeclarationForShortCircuiting(__in InitDeclaratorListN
 //              short cirtuit expressions so that the expressions are executed
 //              in order and just before the child branch executes.
 //
+//              The generated statements fill in the empty children of pGap,
+//              which is moved or grown to sit just before the insertion point.
+//
 //+----------------------------------------------------------------------------
 HRESULT CGLSLParser::MoveExpressionsToInsertionPoint(
     __in CollectionNode* pStatementInsertionParent,                     // Found parent to insert to  
     __in ParseTreeNode* pStatementInsertionChild,                       // Child branch walked up to pParent
-    const CModernArray<TSmartPointer<ParseTreeNode>>& aryOrderedExpressionsToMove   // List of nodes to move
+    __inout UINT* puChildIndex,                                         // Index of pStatementInsertionChild in pStatementInsertionParent, updated for the inserted statements
+    const CModernArray<TSmartPointer<ParseTreeNode>>& aryOrderedExpressionsToMove,  // List of nodes to move
+    __inout StatementGap* pGap                                          // Empty children left over from the last insertion
     )
 {
     CHK_START;
 
     Assert(IsValidExpressionInsertionPoint(pStatementInsertionParent));
+    Assert(pStatementInsertionParent->GetChild(*puChildIndex) == pStatementInsertionChild);
+
+    // Each expression becomes a placeholder declaration and a statement, except
+    // for void expressions which are moved as an expression statement on their own.
+    UINT cStatementsToInsert = 0;
+    for (UINT i = 0; i < aryOrderedExpressionsToMove.GetCount(); i++)
+    {
+        TSmartPointer<GLSLType> spExprType;
+        CHK_VERIFY(SUCCEEDED(aryOrderedExpressionsToMove[i]->GetExpressionType(&spExprType)));
+
+        cStatementsToInsert += spExprType->IsTypeOrArrayOfType(VOID_TOK) ? 1 : 2;
+    }
+
+    // The statements fill in the empty children in order from the start of the gap
+    CHK(OpenStatementGap(pStatementInsertionParent, puChildIndex, cStatementsToInsert, pGap));
+    UINT uInsertIndex = pGap->_uStart;
 
     for (UINT i = aryOrderedExpressionsToMove.GetCount(); i > 0; i--)
     {
@@ -1235,7 +1427,7 @@ HRESULT CGLSLParser::MoveExpressionsToInsertionPoint(
             AssertSz(spInitDeclaratorListNode->GetIdentifierCount() == 1, "We should not generate multiple placeholder variables...");
 
             // Insert it first into the proper insertion location as described by the declaration parent/child pair.
-            CHK(pStatementInsertionParent->InsertBefore(spInitDeclaratorListNode, pStatementInsertionChild));
+            CHK(pStatementInsertionParent->SetEmptyChild(uInsertIndex++, spInitDeclaratorListNode));
 
             // Now that it is attached, it can be verified which will allow subsequent code to see the declared variable.
             CHK_VERIFY(SUCCEEDED(spInitDeclaratorListNode->VerifyNode()));
@@ -1246,7 +1438,9 @@ HRESULT CGLSLParser::MoveExpressionsToInsertionPoint(
             UINT uOriginalExpressionIndex;
             CollectionNode* pExprParentOriginal = spExpr->GetParent();
             CHK_VERIFY(SUCCEEDED(pExprParentOriginal->GetChildIndex(spExpr, &uOriginalExpressionIndex)));
-            CHK_VERIFY(SUCCEEDED(pExprParentOriginal->ExtractChild(spExpr)));
+
+            TSmartPointer<ParseTreeNode> spExtracted;
+            CHK_VERIFY(SUCCEEDED(pExprParentOriginal->ExtractChild(uOriginalExpressionIndex, &spExtracted)));
 
             // Now that it has been extracted, we can convert it into something that can 
             // be moved to the insertion point
@@ -1254,7 +1448,7 @@ HRESULT CGLSLParser::MoveExpressionsToInsertionPoint(
             CHK(ConvertExpressionToStatement(spExpr, pPlaceholderVariable, &spStatementToInsert));
 
             // Insert the converted statement in the location specified by pStatementInsertionParent/Child
-            CHK(pStatementInsertionParent->InsertBefore(spStatementToInsert, pStatementInsertionChild));
+            CHK(pStatementInsertionParent->SetEmptyChild(uInsertIndex++, spStatementToInsert));
             CHK_VERIFY(SUCCEEDED(spStatementToInsert->VerifyNode()));
 
             // Now put the identifier that holds the resultant value back into the original location
@@ -1278,11 +1472,91 @@ HRESULT CGLSLParser::MoveExpressionsToInsertionPoint(
             CHK(RefCounted<ExpressionStatementNode>::Create(this, spExpr, /*out*/spExprStmt));
 
             // Insert the converted statement as a child of the parent statement list.
-            CHK(pStatementInsertionParent->InsertBefore(spExprStmt, pStatementInsertionChild));
+            CHK(pStatementInsertionParent->SetEmptyChild(uInsertIndex++, spExprStmt));
             CHK_VERIFY(SUCCEEDED(spExprStmt->VerifyNode()));
         }
     }
 
+    pGap->_uStart = uInsertIndex;
+    pGap->_cEmpty -= cStatementsToInsert;
+    pGap->_cFilled += cStatementsToInsert;
+    Assert(pStatementInsertionParent->GetChild(pGap->_uStart + pGap->_cEmpty) == pStatementInsertionChild);
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   OpenStatementGap
+//
+//  Synopsis:   Makes sure there are at least cStatements empty children just
+//              before the child at *puChildIndex. A gap already open further
+//              up the same statement list is moved down to the child, which
+//              only shifts the statements in between. When the gap is too
+//              small it is grown by at least what has been filled in so far,
+//              so a list with many insertions is only shifted a few times.
+//
+//+----------------------------------------------------------------------------
+HRESULT CGLSLParser::OpenStatementGap(
+    __in CollectionNode* pStatementList,                                // Statement list to insert into
+    __inout UINT* puChildIndex,                                         // Index of the child to insert before, updated if children are added before it
+    UINT cStatements,                                                   // Number of statements that will be inserted
+    __inout StatementGap* pGap                                          // Gap to move or open just before the child
+    )
+{
+    CHK_START;
+
+    if (pGap->_pStatementList != pStatementList || *puChildIndex < pGap->_uStart + pGap->_cEmpty)
+    {
+        // The gap can only move forward through a list. Any children it leaves
+        // behind come after the child, so closing it does not change the index.
+        CHK(CloseStatementGap(pGap));
+
+        pGap->_pStatementList = pStatementList;
+        pGap->_uStart = *puChildIndex;
+    }
+    else
+    {
+        UINT uNewStart = *puChildIndex - pGap->_cEmpty;
+        CHK(pStatementList->MoveEmptyChildren(pGap->_uStart, pGap->_cEmpty, uNewStart));
+        pGap->_uStart = uNewStart;
+    }
+
+    if (pGap->_cEmpty < cStatements)
+    {
+        UINT cGrow = max(cStatements - pGap->_cEmpty, pGap->_cFilled + cStatements);
+        CHK(pStatementList->InsertEmptyChildren(*puChildIndex, cGrow));
+
+        pGap->_cEmpty += cGrow;
+        (*puChildIndex) += cGrow;
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   CloseStatementGap
+//
+//  Synopsis:   Takes any empty children left in the gap out of its statement
+//              list. Must be called before anything else inserts into the
+//              list, and before the tree is output.
+//
+//+----------------------------------------------------------------------------
+HRESULT CGLSLParser::CloseStatementGap(__inout StatementGap* pGap)
+{
+    CHK_START;
+
+    if (pGap->_pStatementList != nullptr && pGap->_cEmpty > 0)
+    {
+        CHK(pGap->_pStatementList->RemoveEmptyChildren(pGap->_uStart, pGap->_cEmpty));
+    }
+
+    pGap->_pStatementList = nullptr;
+    pGap->_uStart = 0;
+    pGap->_cEmpty = 0;
+    pGap->_cFilled = 0;
+
     CHK_RETURN;
 }
 
@@ -1316,6 +1590,402 @@ HRESULT CGLSLParser::ConvertExpressionToStatement(
     CHK_RETURN;
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   EliminateDeadCode
+//
+//  Synopsis:   Removes the parts of the shader that can never run, so that
+//              the HLSL compiler does not have to process them. Shaders often
+//              paste a large common library of functions and constants in,
+//              only some of which gets used.
+//
+//              Function definitions and prototypes are removed for functions
+//              the entry point cannot reach through the call graph, along
+//              with global variables that are never used. Uniforms, attributes
+//              and varyings are always kept so that the reflection information
+//              for the shader does not change.
+//
+//+----------------------------------------------------------------------------
+HRESULT CGLSLParser::EliminateDeadCode()
+{
+    CHK_START;
+
+    // Reachability is measured from the entry point, so there is nothing to do without one
+    TSmartPointer<FunctionDefinitionNode> spEntryPoint;
+    CHK(DetermineEntryPoint(&spEntryPoint));
+    if (spEntryPoint != nullptr)
+    {
+        CHK(MarkReachableFunctions(spEntryPoint->UseIdentifierInfo()));
+
+        // Function definitions, prototypes and global declarations are all children
+        // of the root. Walk backwards so that removing a child does not shift the
+        // ones that are still to be looked at.
+        for (UINT i = _spRootNode->GetChildCount(); i > 0; i--)
+        {
+            ParseTreeNode* pChild = _spRootNode->GetChild(i - 1);
+
+            bool fRemove = false;
+            switch (pChild->GetParseNodeType())
+            {
+            case ParseNodeType::functionDefinition:
+                fRemove = !pChild->GetAs<FunctionDefinitionNode>()->UseIdentifierInfo()->IsReachable();
+                break;
+
+            case ParseNodeType::functionPrototypeDeclaration:
+                {
+                    FunctionPrototypeNode* pFuncProto = pChild->GetAs<FunctionPrototypeDeclarationNode>()->GetChild(0)->GetAs<FunctionPrototypeNode>();
+                    FunctionHeaderWithParametersNode* pHeaderWithParam = pFuncProto->GetChild(0)->GetAs<FunctionHeaderWithParametersNode>();
+                    fRemove = !pHeaderWithParam->UseIdentifierInfo()->IsReachable();
+                }
+                break;
+
+            case ParseNodeType::initDeclaratorList:
+                fRemove = IsRemovableGlobalDeclaration(pChild->GetAs<InitDeclaratorListNode>());
+                break;
+            }
+
+            if (fRemove)
+            {
+                TSmartPointer<ParseTreeNode> spRemoved;
+                CHK(_spRootNode->ExtractChild(i - 1, &spRemoved));
+            }
+        }
+
+        // The transformations that follow work from these lists; anything that was
+        // just removed will not be output, so it does not need to be transformed.
+        for (UINT i = _aryDeclarations.GetCount(); i > 0; i--)
+        {
+            if (!IsAttachedToRoot(_aryDeclarations[i - 1]))
+            {
+                CHK(_aryDeclarations.RemoveAt(i - 1));
+            }
+        }
+
+        for (UINT i = _aryShortCircuitExprs.GetCount(); i > 0; i--)
+        {
+            if (!IsAttachedToRoot(_aryShortCircuitExprs[i - 1]))
+            {
+                CHK(_aryShortCircuitExprs.RemoveAt(i - 1));
+            }
+        }
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   MarkReachableFunctions
+//
+//  Synopsis:   Walks the call graph built during verification, marking every
+//              function that can be called once the shader starts running.
+//              That is the entry point and anything called from a global
+//              initializer, as well as everything those call in turn.
+//
+//+----------------------------------------------------------------------------
+HRESULT CGLSLParser::MarkReachableFunctions(__in CFunctionIdentifierInfo* pEntryPointInfo)
+{
+    CHK_START;
+
+    CSimpleStack<CFunctionIdentifierInfo*> pendingStack;
+
+    pEntryPointInfo->SetReachable();
+    CHK(pendingStack.Push(pEntryPointInfo));
+
+    // Functions are only declared in the global scope
+    for (UINT i = 0; i < _spRootNode->GetIdentifierCount(); i++)
+    {
+        CFunctionIdentifierInfo* pFuncInfo = _spRootNode->UseIdentifier(i)->AsFunction();
+        if (pFuncInfo != nullptr && pFuncInfo->IsCalledFromGlobalScope() && !pFuncInfo->IsReachable())
+        {
+            pFuncInfo->SetReachable();
+            CHK(pendingStack.Push(pFuncInfo));
+        }
+    }
+
+    while (!pendingStack.IsEmpty())
+    {
+        CFunctionIdentifierInfo* pFuncInfo;
+        CHK(pendingStack.Pop(/*out*/pFuncInfo));
+
+        for (UINT i = 0; i < pFuncInfo->GetCalleeCount(); i++)
+        {
+            CFunctionIdentifierInfo* pCallee = pFuncInfo->UseCallee(i);
+            if (!pCallee->IsReachable())
+            {
+                pCallee->SetReachable();
+                CHK(pendingStack.Push(pCallee));
+            }
+        }
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   IsRemovableGlobalDeclaration
+//
+//  Synopsis:   Determines whether a global declaration can be left out of
+//              the output because nothing uses what it declares.
+//
+//              Declarations that make up the interface of the shader, or
+//              that declare a struct type along with the variables, are
+//              never removable. Neither are ones with initializers that are
+//              not constant, since those can call functions with side effects.
+//
+//+----------------------------------------------------------------------------
+bool CGLSLParser::IsRemovableGlobalDeclaration(__in InitDeclaratorListNode* pInitDeclList)
+{
+    const int qualifier = pInitDeclList->GetTypeQualifier();
+    bool fRemovable = (qualifier == NO_QUALIFIER || qualifier == CONST_TOK);
+
+    if (fRemovable && pInitDeclList->GetTypeSpecifierDescendant()->GetChild(0)->GetParseNodeType() == ParseNodeType::structSpecifier)
+    {
+        fRemovable = false;
+    }
+
+    for (UINT i = 0; fRemovable && i < pInitDeclList->GetIdentifierCount(); i++)
+    {
+        TSmartPointer<CVariableIdentifierInfo> spInfo;
+        fRemovable = SUCCEEDED(pInitDeclList->GetIdentifier(i)->GetVariableIdentifierInfo(&spInfo)) && !spInfo->IsUsed();
+
+        InitDeclaratorListEntryNode* pEntry = pInitDeclList->GetEntry(i);
+        if (fRemovable && pEntry->GetDeclarationType() == DeclarationType::initialized)
+        {
+            bool fConstInitializer;
+            fRemovable = SUCCEEDED(pEntry->GetInitializerNode()->IsConstExpression(/*fIncludeIndex*/false, &fConstInitializer, nullptr)) && fConstInitializer;
+        }
+    }
+
+    return fRemovable;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   IsAttachedToRoot
+//
+//  Synopsis:   Determines whether the node is still part of the tree, by
+//              walking up its parents to see if they lead to the root.
+//
+//+----------------------------------------------------------------------------
+bool CGLSLParser::IsAttachedToRoot(__in const ParseTreeNode* pNode) const
+{
+    while (pNode->GetParent() != nullptr)
+    {
+        pNode = pNode->GetParent();
+    }
+
+    return (pNode == _spRootNode);
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   FoldConstants
+//
+//  Synopsis:   Replaces constant expressions with the value they calculate
+//              to, so that the HLSL compiler gets literals instead of
+//              arithmetic on literals and const variables. Shaders use these
+//              a lot to make tuning values readable.
+//
+//              The tree is walked from the top, so that the largest constant
+//              expression is the one that gets replaced. Expressions that are
+//              not constant are walked into to look for ones that are.
+//
+//+----------------------------------------------------------------------------
+HRESULT CGLSLParser::FoldConstants()
+{
+    CHK_START;
+
+    CSimpleStack<ParseTreeNode*> pendingStack;
+    CHK(pendingStack.Push(_spRootNode));
+
+    while (!pendingStack.IsEmpty())
+    {
+        ParseTreeNode* pNode;
+        CHK(pendingStack.Pop(/*out*/pNode));
+
+        bool fFoldable;
+        ConstantValue value;
+        CHK(GetFoldedValue(pNode, &fFoldable, &value));
+
+        if (fFoldable)
+        {
+            TSmartPointer<FoldedConstantNode> spFolded;
+            CHK(RefCounted<FoldedConstantNode>::Create(this, value, /*out*/spFolded));
+
+            // Put the value where the expression was
+            CollectionNode* pParent = pNode->GetParent();
+
+            UINT uIndex;
+            CHK_VERIFY(SUCCEEDED(pParent->GetChildIndex(pNode, &uIndex)));
+
+            TSmartPointer<ParseTreeNode> spExpression;
+            CHK(pParent->ExtractChild(uIndex, &spExpression));
+            CHK(pParent->InsertChild(spFolded, uIndex));
+            CHK_VERIFY(SUCCEEDED(spFolded->VerifyNode()));
+        }
+        else if (pNode->IsCollectionNode())
+        {
+            // The second child of a field selection is the name of the field, which is
+            // not an expression in its own right.
+            CollectionNode* pCollection = pNode->AsCollection();
+            const UINT cChildren = (pNode->GetParseNodeType() == ParseNodeType::fieldSelection) ? 1 : pCollection->GetChildCount();
+            for (UINT i = 0; i < cChildren; i++)
+            {
+                ParseTreeNode* pChild = pCollection->GetChild(i);
+                if (pChild != nullptr)
+                {
+                    CHK(pendingStack.Push(pChild));
+                }
+            }
+        }
+    }
+
+    // Short circuit expressions are never folded themselves, but they might have been
+    // part of a larger expression that was.
+    for (UINT i = _aryShortCircuitExprs.GetCount(); i > 0; i--)
+    {
+        if (!IsAttachedToRoot(_aryShortCircuitExprs[i - 1]))
+        {
+            CHK(_aryShortCircuitExprs.RemoveAt(i - 1));
+        }
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetFoldedValue
+//
+//  Synopsis:   Determines whether the given node is an expression that can
+//              be replaced with its value, and calculates that value.
+//
+//              Only int and float scalars, vectors and matrices are folded.
+//              Literals and declarations are left alone, as are expressions
+//              whose value cannot be written as a literal.
+//
+//+----------------------------------------------------------------------------
+HRESULT CGLSLParser::GetFoldedValue(
+    __in ParseTreeNode* pNode,                                          // Node to try to fold
+    __out bool* pfFoldable,                                             // Whether the node can be replaced with its value
+    __out ConstantValue* pValue                                         // The value to replace it with
+    )
+{
+    CHK_START;
+
+    (*pfFoldable) = false;
+
+    // Literals are leaves, so the only leaf worth folding is a read of a const variable. The
+    // header of a function call is not folded apart from the call it is part of.
+    const ParseNodeType::Enum nodeType = pNode->GetParseNodeType();
+    bool fCandidate = (
+        pNode->IsVerified() &&
+        nodeType != ParseNodeType::functionCallHeaderWithParameters &&
+        nodeType != ParseNodeType::expressionList
+        );
+
+    if (fCandidate && !pNode->IsCollectionNode())
+    {
+        fCandidate = (nodeType == ParseNodeType::variableIdentifier && !pNode->GetAs<VariableIdentifierNode>()->IsDeclarationIdentifier());
+    }
+
+    TSmartPointer<GLSLType> spType;
+    int basicType;
+    int componentType;
+    if (fCandidate &&
+        SUCCEEDED(pNode->GetExpressionType(&spType)) &&
+        SUCCEEDED(spType->GetBasicType(&basicType)) &&
+        SUCCEEDED(TypeHelpers::GetComponentType(basicType, &componentType)) &&
+        componentType != BOOL_TOK)
+    {
+        bool fConstant = false;
+
+        // Failing to evaluate something that is not required to be constant is not an error
+        // in the shader, so the nodes do not log one while this is set.
+        _fFoldingConstants = true;
+        HRESULT hrEvaluate = pNode->IsConstExpression(/*fIncludeIndex*/false, &fConstant, pValue);
+        _fFoldingConstants = false;
+
+        if (hrEvaluate == E_OUTOFMEMORY)
+        {
+            CHK(hrEvaluate);
+        }
+
+        (*pfFoldable) = SUCCEEDED(hrEvaluate) && fConstant && pValue->HasValue();
+
+        // Values that overflowed are left for the HLSL compiler to deal with
+        for (UINT i = 0; (*pfFoldable) && componentType == FLOAT_TOK && i < pValue->GetComponentCount(); i++)
+        {
+            ConstantValue component;
+            double doubleValue;
+            CHK(pValue->GetComponent(i, &component));
+            CHK(component.GetValue(&doubleValue));
+
+            (*pfFoldable) = (_finite(doubleValue) != 0);
+        }
+
+        // The value of a comma separated list is its last expression, but the ones before it
+        // still need to run.
+        if (*pfFoldable)
+        {
+            bool fContainsSequence;
+            CHK(ContainsSequenceExpression(pNode, &fContainsSequence));
+
+            (*pfFoldable) = !fContainsSequence;
+        }
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   ContainsSequenceExpression
+//
+//  Synopsis:   Determines whether there is a comma separated expression list
+//              anywhere in the given expression.
+//
+//+----------------------------------------------------------------------------
+HRESULT CGLSLParser::ContainsSequenceExpression(
+    __in ParseTreeNode* pNode,                                          // Root of the expression to look through
+    __out bool* pfContains                                              // Whether it has a comma separated expression list
+    )
+{
+    CHK_START;
+
+    (*pfContains) = false;
+
+    CSimpleStack<ParseTreeNode*> pendingStack;
+    CHK(pendingStack.Push(pNode));
+
+    while (!(*pfContains) && !pendingStack.IsEmpty())
+    {
+        ParseTreeNode* pCurrent;
+        CHK(pendingStack.Pop(/*out*/pCurrent));
+
+        if (pCurrent->GetParseNodeType() == ParseNodeType::expressionList)
+        {
+            (*pfContains) = true;
+        }
+        else if (pCurrent->IsCollectionNode())
+        {
+            CollectionNode* pCollection = pCurrent->AsCollection();
+            for (UINT i = 0; i < pCollection->GetChildCount(); i++)
+            {
+                ParseTreeNode* pChild = pCollection->GetChild(i);
+                if (pChild != nullptr)
+                {
+                    CHK(pendingStack.Push(pChild));
+                }
+            }
+        }
+    }
+
+    CHK_RETURN;
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   TranslateStructDeclarations
@@ -1710,7 +2380,7 @@ HRESULT CGLSLParser::DumpTree()
 
     CMutableString<char> spDump;
 
-    CHK(spStream->ExtractString(spDump));
+    CHK(spStream->TakeString(spDump));
 
 #ifdef DBG
     ::OutputDebugStringA(spDump);
@@ -1767,404 +2437,7 @@ HRESULT CGLSLParser::OnOutputHLSL(__in IStringStream* pOutput)
 
     if (GetWriteBoilerPlate())
     {
-        const WebGLFeatureLevelData& data = WebGLFeatureLevelData::GetData(_glFeatureLevel);
-
-        // Constants
-        CHK(pOutput->WriteFormat(128, "static const int gl_MaxVertexAttribs = %d;\n", WEBGL_MAX_VERTEX_ATTRIBUTES));
-        CHK(pOutput->WriteFormat(128, "static const int gl_MaxVertexUniformVectors = %d;\n", data._uVertexUniformVectors));
-        CHK(pOutput->WriteFormat(128, "static const int gl_MaxVaryingVectors = %d;\n", data._uVaryingVectors));
-        CHK(pOutput->WriteFormat(128, "static const int gl_MaxVertexTextureImageUnits = %d;\n", data._uVertexSamplerCount));
-        CHK(pOutput->WriteFormat(128, "static const int gl_MaxCombinedTextureImageUnits = %d;\n", data._uTotalSamplerCount));
-        CHK(pOutput->WriteFormat(128, "static const int gl_MaxTextureImageUnits = %d;\n", data._uFragmentSamplerCount));
-        CHK(pOutput->WriteFormat(128, "static const int gl_MaxFragmentUniformVectors = %d;\n", data._uFragmentUniformVectors));
-        CHK(pOutput->WriteString("static const int gl_MaxDrawBuffers = 1;\n"));
-
-        // Both shaders have the PS input - it is the output of the vertex shader
-        CHK(pOutput->WriteString("static PSInput psInput;\n"));
-
-        if (GetShaderType() == GLSLShaderType::Vertex)
-        {
-            // Vertex shader has VS input structure
-            CHK(pOutput->WriteString("static VSInput vsInput;\n"));
-
-            // We need to declare a variable that represents the flipped position
-            CHK(pOutput->WriteString("static float4 flippedPosition = float4(0.0, 0.0, 0.0, 1.0);\n"));
-
-            // We need to declare a global that is used by both the point size and frag coord code
-            // It contains the viewport width/2 and height/2 in x and y, respectively,
-            // and viewportX + width/2 and viewportY + height/2 in z and w, respectively
-            // (see CDXRenderTarget3D::PrepareConstantBufferData of emulation variables).
-            CHK(pOutput->WriteString("float4 viewportHalfDim;\n"));
-
-            if (IsFeatureUsed(FeatureUsedFlags::glPointSize))
-            {                    
-                CHK(pOutput->WriteString("static float gl_PointSize = 0.0;\n"));
-                CHK(pOutput->WriteString(
-                    "float2 AdjustPositionByPointSize(in float4 pos, in VSInput vsInput)\n"
-                    "{\n"
-                    // According to the spec, negative values for point size are undefined.  We'll
-                    // play it safe and turn negative values to 1.0
-                    "float pointSize = max(gl_PointSize, 1.0);\n"
-
-                    // According to the spec, point rasterization needs to produce a fragment
-                    // for each framebuffer pixels whose center lies inside the square who's side
-                    // is equal to gl_PointSize.
-                    // The units of point size are in drawingBuffer pixels: [0, viewportSize]. The position 
-                    // is in homogeneous coordinates [-w, w]. In distance terms, that gives [0,2*w].
-                    // To linearly interpolate between the two, we solve for the equation of a line
-                    // y - y1 = ((y2-y1)/(x2-x1))*(x - x1)
-                    // y - 0 = (2*w/viewportSize)*(x-0)
-                    // y = (2*w/viewportSize)*(x)
-                    // Here, y is the length of the square we need to render.  Since the passed in point (pos)
-                    // lies in the center of the square, we need to offset the point by gl_PointSize / 2.  
-                    // Plugging in gl_PointSize/2 as x (above), we get y = gl_PointSize*w/viewportSize.  Y is now 
-                    // the distance we need to move the point left or right of the center. We assign this value to
-                    // distanceFactor in the code below.
-                    // vsInput.instanceInput has values of -1 or 1, depending on which corner of the square we're
-                    // on.  If we multiply the it by the distanceFactor*pointSize, this will move the vertex in the 
-                    // correct direction.  If the web developer elects to draw with triangles instead of points, 
-                    // the render target will ensure that instanceInfo is filled with zeros.  Hence, the vertex
-                    // will not move at all since (pos + (0 * ABunchOfStuff)) equals pos.
-                    // Also, remember that viewportHalfDim.xy have half the size values, so multiply those by
-                    // two in the calculation below.
-                    "float2 distanceFactor = float2(pos.w / (viewportHalfDim.x *2), pos.w / (viewportHalfDim.y *2));\n"
-                    "return float2(pos.xy + (vsInput.instanceInfo.xy * distanceFactor * pointSize));\n"
-                    "}\n"
-                    ));
-            }
-        }
-
-        if (IsFeatureUsed(FeatureUsedFlags::glFragCoord) || IsFeatureUsed(FeatureUsedFlags::glDepthRange))
-        {
-            // Declare the depth range variable that is set by the constant buffer setup
-            CHK(pOutput->WriteString("float4 depthRange;\n"));
-        }
-
-        if (GetShaderType() == GLSLShaderType::Fragment)
-        {
-            // Fragment shader has PS output structure
-            CHK(pOutput->WriteString("static PSOutput psOutput;\n"));
-
-            if (IsFeatureUsed(FeatureUsedFlags::glFragCoord))
-            {                    
-                // Declare the fragment coordinate variable - this needs to be a global
-                CHK(pOutput->WriteString("static float4 gl_FragCoord;\n"));
-            }
-
-            if (IsFeatureUsed(FeatureUsedFlags::glFrontFacing))
-            {
-                // Declare the front facing variable - this needs to be a global
-                CHK(pOutput->WriteString("static bool gl_FrontFacing;\n"));
-            }
-
-            // The gl_PointCoord variable is written to at the beginning of the pixel shader. 
-            if (IsFeatureUsed(FeatureUsedFlags::glPointCoord))
-            {
-                CHK(pOutput->WriteString("static float2 gl_PointCoord = float2(0.0, 1.0);\n"));
-            }
-
-            if (IsFeatureUsed(FeatureUsedFlags::glFragCoord))
-            {
-                CHK(pOutput->WriteString("float4 viewportHalfDim;\n"));
-            }
-        }
-
-        // Other things (like intrinsic function simulators) go here
-        if (IsFeatureUsed(FeatureUsedFlags::GLSLsign))
-        {
-            CHK(pOutput->WriteString("float GLSLsign(float x) { return float(sign(x)); }\n"));
-            CHK(pOutput->WriteString("float2 GLSLsign(float2 x) { return float2(sign(x)); }\n"));
-            CHK(pOutput->WriteString("float3 GLSLsign(float3 x) { return float3(sign(x)); }\n"));
-            CHK(pOutput->WriteString("float4 GLSLsign(float4 x) { return float4(sign(x)); }\n"));
-        }
-
-        if (IsFeatureUsed(FeatureUsedFlags::GLSLmod))
-        {
-            CHK(pOutput->WriteString("float GLSLmod(float x, float y) { return (x - y * floor(x / y)); }\n"));
-            CHK(pOutput->WriteString("float2 GLSLmod(float2 x, float2 y) { return (x - y * floor(x / y)); }\n"));
-            CHK(pOutput->WriteString("float3 GLSLmod(float3 x, float3 y) { return (x - y * floor(x / y)); }\n"));
-            CHK(pOutput->WriteString("float4 GLSLmod(float4 x, float4 y) { return (x - y * floor(x / y)); }\n"));
-        }
-
-        if (IsFeatureUsed(FeatureUsedFlags::GLSLmatrixCompMult))
-        {
-            CHK(pOutput->WriteString("float2x2 GLSLmatrixCompMult(float2x2 x, float2x2 y) { return x * y; }\n"));
-            CHK(pOutput->WriteString("float3x3 GLSLmatrixCompMult(float3x3 x, float3x3 y) { return x * y; }\n"));
-            CHK(pOutput->WriteString("float4x4 GLSLmatrixCompMult(float4x4 x, float4x4 y) { return x * y; }\n"));
-        }
-
-        if (IsFeatureUsed(FeatureUsedFlags::GLSLlessThan))
-        {
-            CHK(pOutput->WriteString("bool2 GLSLlessThan(float2 x, float2 y) { return x < y; }\n"));
-            CHK(pOutput->WriteString("bool3 GLSLlessThan(float3 x, float3 y) { return x < y; }\n"));
-            CHK(pOutput->WriteString("bool4 GLSLlessThan(float4 x, float4 y) { return x < y; }\n"));
-            CHK(pOutput->WriteString("bool2 GLSLlessThan(int2 x, int2 y) { return x < y; }\n"));
-            CHK(pOutput->WriteString("bool3 GLSLlessThan(int3 x, int3 y) { return x < y; }\n"));
-            CHK(pOutput->WriteString("bool4 GLSLlessThan(int4 x, int4 y) { return x < y; }\n"));
-        }
-
-        if (IsFeatureUsed(FeatureUsedFlags::GLSLlessThanEqual))
-        {
-            CHK(pOutput->WriteString("bool2 GLSLlessThanEqual(float2 x, float2 y) { return x <= y; }\n"));
-            CHK(pOutput->WriteString("bool3 GLSLlessThanEqual(float3 x, float3 y) { return x <= y; }\n"));
-            CHK(pOutput->WriteString("bool4 GLSLlessThanEqual(float4 x, float4 y) { return x <= y; }\n"));
-            CHK(pOutput->WriteString("bool2 GLSLlessThanEqual(int2 x, int2 y) { return x <= y; }\n"));
-            CHK(pOutput->WriteString("bool3 GLSLlessThanEqual(int3 x, int3 y) { return x <= y; }\n"));
-            CHK(pOutput->WriteString("bool4 GLSLlessThanEqual(int4 x, int4 y) { return x <= y; }\n"));
-        }
-
-        if (IsFeatureUsed(FeatureUsedFlags::GLSLgreaterThan))
-        {
-            CHK(pOutput->WriteString("bool2 GLSLgreaterThan(float2 x, float2 y) { return x > y; }\n"));
-            CHK(pOutput->WriteString("bool3 GLSLgreaterThan(float3 x, float3 y) { return x > y; }\n"));
-            CHK(pOutput->WriteString("bool4 GLSLgreaterThan(float4 x, float4 y) { return x > y; }\n"));
-            CHK(pOutput->WriteString("bool2 GLSLgreaterThan(int2 x, int2 y) { return x > y; }\n"));
-            CHK(pOutput->WriteString("bool3 GLSLgreaterThan(int3 x, int3 y) { return x > y; }\n"));
-            CHK(pOutput->WriteString("bool4 GLSLgreaterThan(int4 x, int4 y) { return x > y; }\n"));
-        }
-
-        if (IsFeatureUsed(FeatureUsedFlags::GLSLgreaterThanEqual))
-        {
-            CHK(pOutput->WriteString("bool2 GLSLgreaterThanEqual(float2 x, float2 y) { return x >= y; }\n"));
-            CHK(pOutput->WriteString("bool3 GLSLgreaterThanEqual(float3 x, float3 y) { return x >= y; }\n"));
-            CHK(pOutput->WriteString("bool4 GLSLgreaterThanEqual(float4 x, float4 y) { return x >= y; }\n"));
-            CHK(pOutput->WriteString("bool2 GLSLgreaterThanEqual(int2 x, int2 y) { return x >= y; }\n"));
-            CHK(pOutput->WriteString("bool3 GLSLgreaterThanEqual(int3 x, int3 y) { return x >= y; }\n"));
-            CHK(pOutput->WriteString("bool4 GLSLgreaterThanEqual(int4 x, int4 y) { return x >= y; }\n"));
-        }
-
-        if (IsFeatureUsed(FeatureUsedFlags::GLSLequal))
-        {
-            CHK(pOutput->WriteString("bool2 GLSLequal(float2 x, float2 y) { return x == y; }\n"));
-            CHK(pOutput->WriteString("bool3 GLSLequal(float3 x, float3 y) { return x == y; }\n"));
-            CHK(pOutput->WriteString("bool4 GLSLequal(float4 x, float4 y) { return x == y; }\n"));
-            CHK(pOutput->WriteString("bool2 GLSLequal(int2 x, int2 y) { return x == y; }\n"));
-            CHK(pOutput->WriteString("bool3 GLSLequal(int3 x, int3 y) { return x == y; }\n"));
-            CHK(pOutput->WriteString("bool4 GLSLequal(int4 x, int4 y) { return x == y; }\n"));
-            CHK(pOutput->WriteString("bool2 GLSLequal(bool2 x, bool2 y) { return x == y; }\n"));
-            CHK(pOutput->WriteString("bool3 GLSLequal(bool3 x, bool3 y) { return x == y; }\n"));
-            CHK(pOutput->WriteString("bool4 GLSLequal(bool4 x, bool4 y) { return x == y; }\n"));
-        }
-
-        if (IsFeatureUsed(FeatureUsedFlags::GLSLnotEqual))
-        {
-            CHK(pOutput->WriteString("bool2 GLSLnotEqual(float2 x, float2 y) { return x != y; }\n"));
-            CHK(pOutput->WriteString("bool3 GLSLnotEqual(float3 x, float3 y) { return x != y; }\n"));
-            CHK(pOutput->WriteString("bool4 GLSLnotEqual(float4 x, float4 y) { return x != y; }\n"));
-            CHK(pOutput->WriteString("bool2 GLSLnotEqual(int2 x, int2 y) { return x != y; }\n"));
-            CHK(pOutput->WriteString("bool3 GLSLnotEqual(int3 x, int3 y) { return x != y; }\n"));
-            CHK(pOutput->WriteString("bool4 GLSLnotEqual(int4 x, int4 y) { return x != y; }\n"));
-            CHK(pOutput->WriteString("bool2 GLSLnotEqual(bool2 x, bool2 y) { return x != y; }\n"));
-            CHK(pOutput->WriteString("bool3 GLSLnotEqual(bool3 x, bool3 y) { return x != y; }\n"));
-            CHK(pOutput->WriteString("bool4 GLSLnotEqual(bool4 x, bool4 y) { return x != y; }\n"));
-        }
-
-        if (IsFeatureUsed(FeatureUsedFlags::GLSLnot))
-        {
-            CHK(pOutput->WriteString("bool2 GLSLnot(bool2 x) { return !x; }\n"));
-            CHK(pOutput->WriteString("bool3 GLSLnot(bool3 x) { return !x; }\n"));
-            CHK(pOutput->WriteString("bool4 GLSLnot(bool4 x) { return !x; }\n"));
-        }
-
-        CHK(WriteTextureFunction(FeatureUsedFlags::GLSLtexture2D, pOutput));
-        CHK(WriteTextureFunction(FeatureUsedFlags::GLSLtexture2DBias, pOutput));
-        CHK(WriteTextureFunction(FeatureUsedFlags::GLSLtexture2DLod, pOutput));
-        CHK(WriteTextureFunction(FeatureUsedFlags::GLSLtexture2DProj, pOutput));
-        CHK(WriteTextureFunction(FeatureUsedFlags::GLSLtexture2DProj_1, pOutput));
-        CHK(WriteTextureFunction(FeatureUsedFlags::GLSLtexture2DProjBias, pOutput));
-        CHK(WriteTextureFunction(FeatureUsedFlags::GLSLtexture2DProjBias_1, pOutput));
-        CHK(WriteTextureFunction(FeatureUsedFlags::GLSLtexture2DProjLod, pOutput));
-        CHK(WriteTextureFunction(FeatureUsedFlags::GLSLtexture2DProjLod_1, pOutput));
-        CHK(WriteTextureFunction(FeatureUsedFlags::GLSLtextureCube, pOutput));
-        CHK(WriteTextureFunction(FeatureUsedFlags::GLSLtextureCubeBias, pOutput));
-        CHK(WriteTextureFunction(FeatureUsedFlags::GLSLtextureCubeLod, pOutput));
-
-        if (IsFeatureUsed(FeatureUsedFlags::GLSLmatrixFromScalar))
-        {
-            CHK(pOutput->WriteString("float2x2 GLSLmatrix2FromScalar(float x) { return float2x2(x, 0, 0, x); }\n"));
-            CHK(pOutput->WriteString("float3x3 GLSLmatrix3FromScalar(float x) { return float3x3(x, 0, 0, 0, x, 0, 0, 0, x); }\n"));
-            CHK(pOutput->WriteString("float4x4 GLSLmatrix4FromScalar(float x) { return float4x4(x, 0, 0, 0, 0, x, 0, 0, 0, 0, x, 0, 0, 0, 0, x); }\n"));
-        }
-
-        if (IsFeatureUsed(FeatureUsedFlags::GLSLmatrixFromMatrix))
-        {
-            // Create 2x2
-            CHK(pOutput->WriteString("float2x2 GLSLmatrix2FromMatrix3(float3x3 x) { return float2x2(x[0].xy, x[1].xy); }\n"));
-            CHK(pOutput->WriteString("float2x2 GLSLmatrix2FromMatrix4(float4x4 x) { return float2x2(x[0].xy, x[1].xy); }\n"));
-
-            // Create 3x3
-            CHK(pOutput->WriteString("float3x3 GLSLmatrix3FromMatrix2(float2x2 x) { return float3x3(x[0], 0, x[1], 0, 0, 0, 1); }\n"));
-            CHK(pOutput->WriteString("float3x3 GLSLmatrix3FromMatrix4(float4x4 x) { return float3x3(x[0].xyz, x[1].xyz, x[2].xyz); }\n"));
-
-            // Create 4x4
-            CHK(pOutput->WriteString("float4x4 GLSLmatrix4FromMatrix2(float2x2 x) { return float4x4(x[0].xy, 0, 0, x[1].xy, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1); }\n"));
-            CHK(pOutput->WriteString("float4x4 GLSLmatrix4FromMatrix3(float3x3 x) { return float4x4(x[0].xyz, 0, x[1].xyz, 0, x[2].xyz, 0, 0, 0, 0, 1); }\n"));
-        }                                                                                             
-
-        if (IsFeatureUsed(FeatureUsedFlags::GLSLvectorFromMatrix))
-        {
-            CHK(pOutput->WriteString("float4 GLSLvectorFromMatrix(float2x2 x) { return float4(x[0], x[1]); }\n"));
-        }
-
-        if (IsFeatureUsed(FeatureUsedFlags::GLSLfwidth))
-        {
-            CHK(pOutput->WriteString("float GLSLfwidth(float x) { return abs(ddx(x)) + abs(ddy(x)); }\n"));
-            CHK(pOutput->WriteString("float2 GLSLfwidth(float2 x) { return abs(ddx(x)) + abs(ddy(x)); }\n"));
-            CHK(pOutput->WriteString("float3 GLSLfwidth(float3 x) { return abs(ddx(x)) + abs(ddy(x)); }\n"));
-            CHK(pOutput->WriteString("float4 GLSLfwidth(float4 x) { return abs(ddx(x)) + abs(ddy(x)); }\n"));
-        }
-
-        // The gl_DepthRangeParameters struct is available regardless of whether or not
-        // the gl_DepthRange variable/glDepthRange feature is used. Always output this struct definition.
-        CHK(pOutput->WriteString(
-            "struct gl_DepthRangeParameters\n"
-            "{\n"
-            "float near;\n"
-            "float far;\n"
-            "float diff;\n"
-            "};\n"
-            ));
-
-        if (IsFeatureUsed(FeatureUsedFlags::glDepthRange))
-        {
-            // Output the gl_DepthRange variable if it is used in this shader.
-            CHK(pOutput->WriteString(
-                "static gl_DepthRangeParameters gl_DepthRange;\n"
-                ));
-        }
-    }
-
-    CHK_RETURN;
-}
-
-//+----------------------------------------------------------------------------
-//
-//  Struct:     TextureFunctionInfo
-//
-//  Synopsis:   Struct used by WriteTextureFunction to store a table of
-//              functions.
-//
-//-----------------------------------------------------------------------------
-struct TextureFunctionInfo
-{
-    FeatureUsedFlags::Enum _enum;
-    bool _fBias;
-    bool _fLod;
-    const char* _pszName;
-    const char* _pszTextureType;
-    const char* _pszCoordType;
-    const char* _pszSampleFragFunction;
-    const char* _pszSampleExpression;
-};
-
-//+----------------------------------------------------------------------------
-//
-//  Member:     WriteTextureFunction
-//
-//  Synopsis:   Write out the given texture function from the feature used
-//              enum code. All of the functions look very similar, they just
-//              vary argument counts and types.
-//
-//              This function takes care of outputting the function 
-//              conditionally.
-//
-//-----------------------------------------------------------------------------
-HRESULT CGLSLParser::WriteTextureFunction(
-    FeatureUsedFlags::Enum featureUsed,                         // Feature used code for function
-    __in IStringStream* pOutput                                 // Where to write the code
-    )
-{
-    CHK_START;
-
-    static const TextureFunctionInfo rgFunctionInfo[] = {
-            /* name                                     bias    lod     functionname                texture coord       hlsl frag       expr */
-        {   FeatureUsedFlags::GLSLtexture2D,            false,  false,  "GLSLtexture2D",            "2D",   "float2",   "Sample",       "coord" },
-        {   FeatureUsedFlags::GLSLtexture2DBias,        true,   false,  "GLSLtexture2DBias",        "2D",   "float2",   "SampleBias",   "coord" },
-        {   FeatureUsedFlags::GLSLtexture2DLod,         false,  true,   "GLSLtexture2DLod",         "2D",   "float2",   nullptr,        "coord" },
-        {   FeatureUsedFlags::GLSLtexture2DProj,        false,  false,  "GLSLtexture2DProj",        "2D",   "float3",   "Sample",       "coord.xy / coord.z" },
-        {   FeatureUsedFlags::GLSLtexture2DProj_1,      false,  false,  "GLSLtexture2DProj",        "2D",   "float4",   "Sample",       "coord.xy / coord.w" },
-        {   FeatureUsedFlags::GLSLtexture2DProjBias,    true,   false,  "GLSLtexture2DProjBias",    "2D",   "float3",   "SampleBias",   "coord.xy / coord.z" },
-        {   FeatureUsedFlags::GLSLtexture2DProjBias_1,  true,   false,  "GLSLtexture2DProjBias",    "2D",   "float4",   "SampleBias",   "coord.xy / coord.w" },
-        {   FeatureUsedFlags::GLSLtexture2DProjLod,     false,  true,   "GLSLtexture2DProjLod",     "2D",   "float3",   nullptr,        "coord.xy / coord.z" },
-        {   FeatureUsedFlags::GLSLtexture2DProjLod_1,   false,  true,   "GLSLtexture2DProjLod",     "2D",   "float4",   nullptr,        "coord.xy / coord.w" },
-        {   FeatureUsedFlags::GLSLtextureCube,          false,  false,  "GLSLtextureCube",          "Cube", "float3",   "Sample",       "coord" },
-        {   FeatureUsedFlags::GLSLtextureCubeBias,      true,   false,  "GLSLtextureCubeBias",      "Cube", "float3",   "SampleBias",   "coord" },
-        {   FeatureUsedFlags::GLSLtextureCubeLod,       false,  true,   "GLSLtextureCubeLod",       "Cube", "float3",   nullptr,        "coord" },
-    };
-
-    if (IsFeatureUsed(featureUsed))
-    {
-        for (UINT i = 0; i < ARRAYSIZE(rgFunctionInfo); i++)
-        {
-            if (rgFunctionInfo[i]._enum == featureUsed)
-            {
-                if (rgFunctionInfo[i]._fBias)
-                {
-                    AssertSz(!rgFunctionInfo[i]._fLod, "Bias and Lod cannot be combined with texture functions");
-
-                    if (_shaderType == GLSLShaderType::Fragment)
-                    {
-                        CHK(pOutput->WriteFormat(
-                            256,
-                            "float4 %s(SamplerState s, Texture%s<float4> t, %s coord, float bias) { return t.%s(s, %s, bias); }\n",
-                            rgFunctionInfo[i]._pszName,
-                            rgFunctionInfo[i]._pszTextureType,
-                            rgFunctionInfo[i]._pszCoordType,
-                            rgFunctionInfo[i]._pszSampleFragFunction,
-                            rgFunctionInfo[i]._pszSampleExpression
-                            ));
-                    }
-                    else
-                    {
-                        AssertSz(false, "Vertex shaders should not request bias version of functions");
-                    }
-                }
-                else if (rgFunctionInfo[i]._fLod)
-                {
-                    if (_shaderType == GLSLShaderType::Vertex)
-                    {
-                        CHK(pOutput->WriteFormat(
-                            256,
-                            "float4 %s(SamplerState s, Texture%s<float4> t, %s coord, float lod) { return t.SampleLevel(s, %s, lod); }\n",
-                            rgFunctionInfo[i]._pszName,
-                            rgFunctionInfo[i]._pszTextureType,
-                            rgFunctionInfo[i]._pszCoordType,
-                            rgFunctionInfo[i]._pszSampleExpression
-                            ));
-                    }
-                    else
-                    {
-                        AssertSz(false, "Fragment shaders should not request lod version of functions");
-                    }
-                }
-                else
-                {
-                    if (_shaderType == GLSLShaderType::Vertex)
-                    {
-                        CHK(pOutput->WriteFormat(
-                            256,
-                            "float4 %s(SamplerState s, Texture%s<float4> t, %s coord) { return t.SampleLevel(s, %s, 0.0); }\n",
-                            rgFunctionInfo[i]._pszName,
-                            rgFunctionInfo[i]._pszTextureType,
-                            rgFunctionInfo[i]._pszCoordType,
-                            rgFunctionInfo[i]._pszSampleExpression
-                            ));
-                    }
-                    else
-                    {
-                        CHK(pOutput->WriteFormat(
-                            256,
-                            "float4 %s(SamplerState s, Texture%s<float4> t, %s coord) { return t.%s(s, %s); }\n",
-                            rgFunctionInfo[i]._pszName,
-                            rgFunctionInfo[i]._pszTextureType,
-                            rgFunctionInfo[i]._pszCoordType,
-                            rgFunctionInfo[i]._pszSampleFragFunction,
-                            rgFunctionInfo[i]._pszSampleExpression
-                            ));
-                    }
-                }
-            }
-        }
+        CHK(CGLSLBoilerplate::Write(_shaderType, _glFeatureLevel, _uFeaturesUsed, CGLSLBoilerplate::Section::Globals, pOutput));
     }
 
     CHK_RETURN;
@@ -2186,95 +2459,7 @@ HRESULT CGLSLParser::WriteEntryPointBegin(
 
     if (GetWriteBoilerPlate())
     {
-        if (GetShaderType() == GLSLShaderType::Vertex)
-        {
-            CHK(pOutput->WriteString("vsInput = vsInputArg;\n"));
-        }
-
-        if (GetShaderType() == GLSLShaderType::Fragment)
-        {
-            CHK(pOutput->WriteString("psInput = psInputArg;\n"));
-
-            if (IsFeatureUsed(FeatureUsedFlags::glFragCoord))
-            {
-                // Store the inverse w value, we'll use it a few times in calculations below.
-                CHK(pOutput->WriteString("float wInverse = 1.0 / psInput.fragCoord.w;\n"));
-                if (_glFeatureLevel >= WebGLFeatureLevel::Level_10)
-                {
-                    // In feature level 10+ (real shader model 4) we can just use SV_Position's calculation of the x and y
-                    // frag coord values. Since everything in the pixel shader is 'right side up' (i.e. we've executed the
-                    // y-flip upon vertex shader output, which will be undone with a transform on the canvas image),
-                    // we do not have to adjust for y-flipping.
-                    CHK(pOutput->WriteString("gl_FragCoord.xy = psInput.position.xy;\n"));
-                }
-                else
-                {
-                    // In feature levels < 10 we must calculate this ourselves. Window coordinates in WebGL are defined as
-                    //
-                    //      (xw, yx) = (px/2 * xd + ox, py/2 * yd + oy)
-                    //
-                    // where px is viewport width, py is viewport height, ox is viewport x origin (x offset + width/2), and 
-                    // oy is viewport y origin (y offset + height/2).
-                    // Also, xd and yd are normalized device coordinates which are given by
-                    //
-                    //      (xd, yd) = (xc / wc, yc / wc)
-                    //
-                    // where xc and yc are clip coordinates. Clip coordinates are the coordinates output from the vertex shader.
-                    // To derive xd and yd, we must perform the perspective divide by multiplying by wInverse.
-                    //
-                    // The emulation variable sets viewportHalfDim x and y to px and py, respectively
-                    // and z and w to ox and oy, respectively. Use these to calculate the fragcoord.
-                    CHK(pOutput->WriteString("gl_FragCoord.x = viewportHalfDim.x * (psInput.fragCoord.x * wInverse) + viewportHalfDim.z;\n"));
-                    CHK(pOutput->WriteString("gl_FragCoord.y = viewportHalfDim.y * (psInput.fragCoord.y * wInverse) + viewportHalfDim.w;\n"));
-                }
-
-                // gl_FragCoord corresponds to window coordinates, so we calculate the z value using
-                // the equation given in the OpenGL ES spec; namely
-                //
-                //      zw = (((far - near) / 2) * zd) + ((near + far) / 2)
-                //
-                // The depthRange constants are set by the render target prior to drawing as the following:
-                //      depthRange.x = (far - near) / 2
-                //      depthRange.y = (near + far) / 2
-                //      depthRange.z = near
-                //      depthRange.w = far
-                // These were chosen to minimize the number of instructions in the pixel shader and are constant
-                // for a given draw pass (see DXRenderTarget3D.cxx). With the values in depthRange, the equation reduces to
-                //
-                //      zw = (depthRange.x * zd) + depthRange.y
-                //
-                // where zd is the z-value after perspective divide (i.e. input.z / input.w).
-                CHK(pOutput->WriteString("gl_FragCoord.z = (depthRange.x * psInput.fragCoord.z * wInverse) + depthRange.y;\n"));
-
-                // gl_FragCoord.w is just the inverse of the w value at the given pixel.
-                CHK(pOutput->WriteString("gl_FragCoord.w = wInverse;\n"));
-            }
-
-            if (IsFeatureUsed(FeatureUsedFlags::glFrontFacing))
-            {
-                CHK(pOutput->WriteString("gl_FrontFacing = psInput.frontFacing;\n"));
-            }
-            
-            // We need to make sure that the fragment color is cleared on entry, because GLSL specs that it is zeroed and
-            // HLSL requires that it be touched.
-            CHK(pOutput->WriteString("psOutput.fragColor[0] = float4(0.0, 0.0, 0.0, 0.0);\n"));
-
-            // If we are using gl_PointCoord, make sure to initialize it.  CGLSLIOStructInfo::OutputHLSL is responsible for 
-            // ensuring that ReadPointCoordFromPSInput is present and either returns a default value or grabs its from PSInput.
-            if (IsFeatureUsed(FeatureUsedFlags::glPointCoord))
-            {
-                CHK(pOutput->WriteString("gl_PointCoord = ReadPointCoordFromPSInput(psInput);\n"));
-            }
-        }
-
-        if (IsFeatureUsed(FeatureUsedFlags::glDepthRange))
-        {
-            CHK(pOutput->WriteString(
-                "gl_DepthRange.near = depthRange.z;\n"
-                "gl_DepthRange.far = depthRange.w;\n"
-                "gl_DepthRange.diff = depthRange.x * 2.0;\n"
-                ));
-        }
+        CHK(CGLSLBoilerplate::Write(_shaderType, _glFeatureLevel, _uFeaturesUsed, CGLSLBoilerplate::Section::EntryPointBegin, pOutput));
     }
 
     CHK_RETURN;
@@ -2295,54 +2480,7 @@ HRESULT CGLSLParser::WriteEntryPointEnd(
 
     if (GetWriteBoilerPlate())
     {
-        if (GetShaderType() == GLSLShaderType::Vertex)
-        {
-            if (IsFeatureUsed(FeatureUsedFlags::glPointSize))
-            {
-                // If we're using gl_PointSize, we need to adjust the position by the point size.  
-                // AdjustPositionByPointSize is a helper method responsible for doing that.  
-                // Similarly, we need to pass down the point coord information in psInput.pointCoord.
-                // The pixel shader can choose to ignore it if it chooses.  
-                CHK(pOutput->WriteString(
-                    "flippedPosition.xy = AdjustPositionByPointSize(flippedPosition, vsInput);\n"
-                    "WritePointCoordToPSInput(psInput, vsInput.instanceInfo.zw);\n"
-                    ));
-            }
-
-            // WebGL needs content rendered upside down relative to D3D because the texture
-            // coordinates are upside down relative to D3D. Reads / writes to gl_Position
-            // have been directed into a flipped version of the variable, so output the
-            // real thing now.
-            CHK(pOutput->WriteString("psInput.position.xw = flippedPosition.xw;\n"));
-
-            CHK(pOutput->WriteString("psInput.position.y = -flippedPosition.y;\n"));
-
-            // Scale the psInput.position.z value from [-w, w] to [0, w]. Anything outside
-            // [0, w] will be clipped at the rasterizer stage.
-            CHK(pOutput->WriteString("psInput.position.z = (flippedPosition.z + flippedPosition.w) / 2;\n"));
-
-            // Before we return from a vertex shader, we have to calculate the fragment
-            // coordinate for the pixel shader. Since we can have multiple return
-            // points we need to put this code in all of them.
-            //
-            // We must calculate the frag coord from the flipped position, in order
-            // for it to report self-consistent results.
-            //
-            // We call out to a function to calculate this, because we might decide
-            // to noop this operation if the program has no gl_FragCoord usage. We
-            // cannot know that yet, so we call a function here and in GLSLIOStructInfo
-            // we generate the function that is actually called.
-            CHK(pOutput->WriteString("WriteFragCoordToPSInput(psInput, flippedPosition);\n"));
-
-            // Return the appropriate struct
-            CHK(pOutput->WriteString("psInputOut = psInput;\n"));
-        }
-
-        if (GetShaderType() == GLSLShaderType::Fragment)
-        {
-            // Return the appropriate struct
-            CHK(pOutput->WriteString("psOutputOut = psOutput;\n"));
-        }
+        CHK(CGLSLBoilerplate::Write(_shaderType, _glFeatureLevel, _uFeaturesUsed, CGLSLBoilerplate::Section::EntryPointEnd, pOutput));
     }
 
     CHK_RETURN;
@@ -29,12 +29,16 @@
 class CGLSLParser;
 
 #include "ParseTreeNode.hxx"
+#include "GLSLArena.hxx"
+#include "GLSLTypeTable.hxx"
+#include "GLSLScopedSymbolIndex.hxx"
 #include "GLSLSymbolTable.hxx"
 #include "GLSLIdentifierTable.hxx"
 #include "GLSLShaderType.hxx"
 #include "GLSLTranslateOptions.hxx"
 #include "GLSLError.hxx"
 #include "GLSLConvertedShader.hxx"
+#include "GLSLTranslationStats.hxx"
 #include "IParserInput.hxx"
 #include "TextNode.hxx"
 #include "IStringStream.hxx"
@@ -52,6 +56,7 @@ class VariableIdentifierNode;
 class CompoundStatementNode;
 class FunctionPrototypeDeclarationNode;
 class FunctionPrototypeNode;
+class CFunctionIdentifierInfo;
 
 //+-----------------------------------------------------------------------------
 //
@@ -160,10 +165,13 @@ public:
     bool GetWriteInputs() const { return _fWriteInputs; }
     bool GetWriteBoilerPlate() const { return _fWriteBoilerPlate; }
     WebGLFeatureLevel GetFeatureLevel() const { return _glFeatureLevel; }
+    bool IsFoldingConstants() const { return _fFoldingConstants; }
 
     CGLSLSymbolTable* UseSymbolTable() { return _spSymbolTable; }
     CGLSLIdentifierTable* UseIdentifierTable() { return _spIdTable; }
     CGLSLExtensionState* UseExtensionState() { return _spExtensionState; }
+    CGLSLTypeTable* UseTypeTable() { return _spTypeTable; }
+    CGLSLScopedSymbolIndex* UseScopedSymbolIndex() { return _spScopedSymbolIndex; }
     ParseTreeNode* UseRootNode() { return _spRootNode; }
     IParserInput* UseInput() { return _spInput; }
 
@@ -211,6 +219,23 @@ private:
         const FunctionDefinitionNode* pEntryPoint,                          // The entry point function definition where the function call statement should be added
         int iFunctionIdent                                                  // The identifier of the function to call
         );
+    HRESULT EliminateDeadCode();
+    HRESULT MarkReachableFunctions(__in CFunctionIdentifierInfo* pEntryPointInfo);
+    bool IsRemovableGlobalDeclaration(__in InitDeclaratorListNode* pInitDeclList);
+    bool IsAttachedToRoot(__in const ParseTreeNode* pNode) const;
+    HRESULT FoldConstants();
+
+    HRESULT GetFoldedValue(
+        __in ParseTreeNode* pNode,                                          // Node to try to fold
+        __out bool* pfFoldable,                                             // Whether the node can be replaced with its value
+        __out ConstantValue* pValue                                         // The value to replace it with
+        );
+
+    static HRESULT ContainsSequenceExpression(
+        __in ParseTreeNode* pNode,                                          // Root of the expression to look through
+        __out bool* pfContains                                              // Whether it has a comma separated expression list
+        );
+
     HRESULT TranslateStructDeclarations();
     HRESULT TranslateShortCircuitExpressions();
     HRESULT TranslateSamplers();
@@ -222,13 +247,12 @@ private:
         __deref_out CMemoryStream** ppConverted                             // Stream with converted HLSL
         );
 
-    bool IsFeatureUsed(FeatureUsedFlags::Enum feature) const { return IsFeatureUsed(_uFeaturesUsed, feature); }
-
-    HRESULT WriteTextureFunction(
-        FeatureUsedFlags::Enum featureUsed,                                 // Feature used code for function
-        __in IStringStream* pOutput                                         // Where to write the code
+    HRESULT RecordStats(
+        __in_opt CMemoryStream* pConvertedStream                            // Converted HLSL, if translation got that far
         );
 
+    bool IsFeatureUsed(FeatureUsedFlags::Enum feature) const { return IsFeatureUsed(_uFeaturesUsed, feature); }
+
     virtual HRESULT DumpTree();
 
     static bool IsValidExpressionInsertionPoint(__in CollectionNode* pParent);
@@ -245,14 +269,47 @@ private:
         __deref_out FunctionPrototypeNode** ppFunctionPrototype             // Created prototype
         );
 
-    HRESULT FixupDeclarationForShortCircuiting(__in InitDeclaratorListNode* pInitDeclList, __in ParseTreeNode* pChild);
+    //+----------------------------------------------------------------------------
+    //
+    //  Struct:     StatementGap
+    //
+    //  Synopsis:   A run of empty children kept open in a statement list while
+    //              short circuit expressions are translated. Statements moved
+    //              in front of later statements in the same list fill it in,
+    //              so the rest of the list is not shifted for every insertion.
+    //
+    //-----------------------------------------------------------------------------
+    struct StatementGap
+    {
+        CollectionNode* _pStatementList;                                    // Statement list the gap is in, or null when there is no gap
+        UINT _uStart;                                                       // Index of the first empty child
+        UINT _cEmpty;                                                       // Number of empty children
+        UINT _cFilled;                                                      // Number of children filled in since the gap was opened
+    };
+
+    HRESULT FixupDeclarationForShortCircuiting(
+        __in InitDeclaratorListNode* pInitDeclList,                         // Declaration with a short circuit expression
+        __in ParseTreeNode* pChild,                                         // Entry of the declaration that holds the expression
+        __inout StatementGap* pGap                                          // Empty children left over from the last insertion
+        );
 
     HRESULT MoveExpressionsToInsertionPoint(
         __in CollectionNode* pParent,                                       // Found parent to insert to  
         __in ParseTreeNode* pChild,                                         // Child branch walked up to pParent
-        const CModernArray<TSmartPointer<ParseTreeNode>>& aryOrderedExpressionsToMove   // List of nodes to move
+        __inout UINT* puChildIndex,                                         // Index of pChild in pParent, updated for the inserted statements
+        const CModernArray<TSmartPointer<ParseTreeNode>>& aryOrderedExpressionsToMove,  // List of nodes to move
+        __inout StatementGap* pGap                                          // Empty children left over from the last insertion
+        );
+
+    static HRESULT OpenStatementGap(
+        __in CollectionNode* pStatementList,                                // Statement list to insert into
+        __inout UINT* puChildIndex,                                         // Index of the child to insert before, updated if children are added before it
+        UINT cStatements,                                                   // Number of statements that will be inserted
+        __inout StatementGap* pGap                                          // Gap to move or open just before the child
         );
 
+    static HRESULT CloseStatementGap(__inout StatementGap* pGap);
+
     HRESULT ConvertExpressionToStatement(
         __in ParseTreeNode* pExpr,                                          // Expression node to convert
         __in VariableIdentifierNode* pPlaceholderVariable,                  // Variable used to assign the result of the expression into
@@ -300,15 +357,22 @@ private:
     bool _fErrors;                                                          // Whether errors are found
 
     // Input / output
+    TSmartPointer<CGLSLArena> _spArena;                                     // Arena for the nodes of this translation. Declared ahead of every member that can hold nodes, so it is destroyed after them
+    TSmartPointer<CGLSLTypeTable> _spTypeTable;                             // Shared types for this translation
+    TSmartPointer<CGLSLScopedSymbolIndex> _spScopedSymbolIndex;             // Declarations in the scopes open during verification
     TSmartPointer<IParserInput> _spInput;                                   // The input to the parser
     TSmartPointer<CGLSLLineMap> _spLineMap;                                 // The line map from the preprocessor
     TSmartPointer<CGLSLExtensionState> _spExtensionState;                   // Extension state from the preprocessor
     TSmartPointer<CGLSLConvertedShader> _spConverted;                       // The converted shader
+    TSmartPointer<CGLSLTranslationStats> _spStats;                          // Stats for the translation, if they were asked for
 
     // Options
     bool _fWriteInputs;                                                     // Whether to write HLSL inputs into conversion
     bool _fWriteBoilerPlate;                                                // Whether to output boilerplate code such as function wrappers and special variable calculation
     bool _fHasNonConstGlobalInitializers;                                   // Whether there are one or more non-const initializer expressions for global declarations
+    bool _fEliminateDeadCode;                                               // Whether to drop functions and globals the entry point cannot reach before outputting
+    bool _fFoldConstants;                                                   // Whether to replace constant expressions with their values before outputting
+    bool _fFoldingConstants;                                                // Set while constant expressions are being evaluated for folding
 
     // Translation
     TSmartPointer<TranslationUnitCollectionNode> _spRootNode;               // The root node of the parse tree
@@ -324,6 +388,5 @@ private:
     WebGLFeatureLevel _glFeatureLevel;                                      // Feature level we're translating for
 
     static const UINT s_uMaxShaderSize;                                     // Maximum size of input to GLSL parser
-    static const char* s_pszMaxShaderSizeString;                            // Max size as string
     static const YYLTYPE s_nullLocation;                                    // Placeholder location for generated parse tree nodes
 };
@@ -79,12 +79,13 @@ void GLSLRecordNewline(__in CGLSLParser* pParser)
 //  Function:   GLSLInput
 //
 //  Synopsis:   Global function called for pulling input into the parser. Used
-//              instead of a stdin stream by the tokenizer.
+//              instead of a stdin stream by the tokenizer, which asks for up
+//              to max_size characters at a time.
 //
 //-----------------------------------------------------------------------------
-int GLSLInput(__in CGLSLParser* pOutput, __out_ecount(1) char* buf, int /*max_size*/)
+int GLSLInput(__in CGLSLParser* pOutput, __out_ecount_part(max_size, return) char* buf, int max_size)
 {
-    return pOutput->UseInput()->PullInput(buf);
+    return pOutput->UseInput()->PullInput(buf, max_size);
 }
 
 //+----------------------------------------------------------------------------
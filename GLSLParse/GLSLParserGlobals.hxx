@@ -28,7 +28,7 @@
 
 // Defined in GLSLParser.cxx, used to avoid including GLSLParser.hxx in flex output
 HRESULT GLSLEnsureSymbolIndex(__in CGLSLParser* pParser, __in_z char* pSymbol, __out int *pIndex);
-int GLSLInput(__in CGLSLParser* pOutput, __out_ecount(1) char* buf, int max_size);
+int GLSLInput(__in CGLSLParser* pOutput, __out_ecount_part(max_size, return) char* buf, int max_size);
 void GLSLUpdateLocation(__in CGLSLParser* pParser, __in YYLTYPE* pLocation, int lineNo, int tokenLength);
 void GLSLRecordNewline(__in CGLSLParser* pParser);
 
@@ -34,8 +34,7 @@
 //  Function:   Constructor
 //
 //-----------------------------------------------------------------------------
-CGLSLPreExpandBuffer::CGLSLPreExpandBuffer() :
-    _stringBuffer(16)
+CGLSLPreExpandBuffer::CGLSLPreExpandBuffer()
 {
 }
 
@@ -61,12 +60,64 @@ HRESULT CGLSLPreExpandBuffer::Initialize(
 
 //+----------------------------------------------------------------------------
 //
-//  Function:   WriteString
+//  Function:   Reserve
 //
-//  Synopsis:   Called from the parser as part of building the buffer.
+//  Synopsis:   Make room for the given amount of expanded text, plus the
+//              null chars that GetScanBuffer adds. Definitions know the
+//              size of their expansion up front, so this is the only
+//              allocation the buffer makes.
 //
 //-----------------------------------------------------------------------------
-HRESULT CGLSLPreExpandBuffer::WriteString(__in_z const char* pszString)
+HRESULT CGLSLPreExpandBuffer::Reserve(UINT cchText)
 {
-    return _stringBuffer.Append(pszString);
+    CHK_START;
+
+    CHKB(cchText <= UINT_MAX - 2 - _aryBuffer.GetCount());
+    CHK(_aryBuffer.EnsureCapacity(_aryBuffer.GetCount() + cchText + 2));
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   WriteBuffer
+//
+//  Synopsis:   Called from the definition as part of building the buffer.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLPreExpandBuffer::WriteBuffer(__in_ecount(cchText) const char* pText, UINT cchText)
+{
+    CHK_START;
+
+    if (cchText != 0)
+    {
+        CHK(_aryBuffer.AddArray(pText, cchText));
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetScanBuffer
+//
+//  Synopsis:   Terminate the buffer the way the scanner needs it to be able
+//              to scan it in place, and return it. This is called once, when
+//              the buffer is pushed onto the scanner.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLPreExpandBuffer::GetScanBuffer(
+    __deref_out_ecount(*puSize) char** ppBuffer,        // The buffer to scan, ending in two null chars
+    __out UINT* puSize                                  // Size of the buffer including the null chars
+    )
+{
+    CHK_START;
+
+    CHK(_aryBuffer.Add('\0'));
+    CHK(_aryBuffer.Add('\0'));
+
+    (*ppBuffer) = _aryBuffer.GetData();
+    (*puSize) = _aryBuffer.GetCount();
+
+    CHK_RETURN;
 }
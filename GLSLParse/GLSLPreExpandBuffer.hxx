@@ -38,7 +38,8 @@ class CGLSLPreParamList;
 //  Class:      CGLSLPreExpandBuffer
 //
 //  Synopsis:   Class that encapsulates a buffer used to store an expanded
-//              macro.
+//              macro. The scanner runs over the buffer in place, so it is
+//              kept alive for as long as the scanner is using it.
 //
 //------------------------------------------------------------------------------
 class CGLSLPreExpandBuffer : public IUnknown
@@ -46,9 +47,13 @@ class CGLSLPreExpandBuffer : public IUnknown
 public:
     CGLSLPreExpandBuffer();
 
-    const char* GetBufferString() { return _stringBuffer; }
+    HRESULT Reserve(UINT cchText);
+    HRESULT WriteBuffer(__in_ecount(cchText) const char* pText, UINT cchText);
 
-    HRESULT WriteString(__in_z const char *pszString);
+    HRESULT GetScanBuffer(
+        __deref_out_ecount(*puSize) char** ppBuffer,   // The buffer to scan, ending in two null chars
+        __out UINT* puSize                              // Size of the buffer including the null chars
+        );
 
 protected:
     HRESULT Initialize(
@@ -58,5 +63,5 @@ protected:
         );
 
 private:
-    CMutableString<char> _stringBuffer;             // The buffer we expand into
+    CModernArray<char> _aryBuffer;                  // The buffer we expand into
 };
@@ -39,7 +39,9 @@
 //-----------------------------------------------------------------------------
 CGLSLPreMacroDefinition::CGLSLPreMacroDefinition() :
     _idSymbol(-1),
-    _fFinalized(false)
+    _fExpansionValid(false),
+    _fFinalized(false),
+    _uActiveExpansions(0)
 {
 }
 
@@ -108,6 +110,7 @@ HRESULT CGLSLPreMacroDefinition::AddToken(__in_z const char* pszToken)
     if (!fFound)
     {
         CHK(_rgTokenList.Add(pszToken));
+        _fExpansionValid = false;
     }
 
     CHK_RETURN;
@@ -142,6 +145,7 @@ HRESULT CGLSLPreMacroDefinition::AddParamToken(UINT uParamIndex)
     szTokenString[1] = static_cast<char>(uParamIndex + 1);
 
     CHK(_rgTokenList.Add(szTokenString));
+    _fExpansionValid = false;
 
     CHK_RETURN;
 }
@@ -167,6 +171,7 @@ HRESULT CGLSLPreMacroDefinition::SetToNumber(int value)
     CMutableString<char> numString;
     CHK(numString.Format(64, "%d", value));
     CHK(_rgTokenList.Add(numString));
+    _fExpansionValid = false;
 
     CHK_RETURN;
 }
@@ -209,27 +214,87 @@ HRESULT CGLSLPreMacroDefinition::Expand(
         }
     }
 
-    // Go through the stream and either output or replace each thing
-    for (UINT i = 0; i < _rgTokenList.GetCount(); i++)
+    CHK(EnsureExpansionText());
+
+    // Work out the size of the expansion so that the buffer is allocated once
+    UINT cchExpansion = static_cast<UINT>(_strExpansion.GetLength());
+    for (UINT i = 0; i < _aryParamReferences.GetCount(); i++)
     {
-        if (_rgTokenList[i].GetLength() == 2 && _rgTokenList[i][0] == '@')
-        {
-            // Time to substitute a parameter
-            UINT uParamIndex = static_cast<UINT>(_rgTokenList[i][1]) - 1;
+        UINT cchParam = static_cast<UINT>(pParams->GetParameter(_aryParamReferences[i]._uParamIndex).GetLength());
+        CHKB(cchParam <= UINT_MAX - cchExpansion);
+        cchExpansion += cchParam;
+    }
 
-            CHK(pBuffer->WriteString(pParams->GetParameter(uParamIndex)));
-        }
-        else
-        {
-            // This id token was not redefined, so just spit it out
-            CHK(pBuffer->WriteString(_rgTokenList[i]));
-        }
+    CHK(_pPreParser->AddExpansionSize(cchExpansion, pLocation));
+    CHK(pBuffer->Reserve(cchExpansion));
+
+    // Copy the text between the parameter references, and the arguments in
+    // place of them
+    const char* pszExpansion = _strExpansion;
+    UINT uCopied = 0;
+    for (UINT i = 0; i < _aryParamReferences.GetCount(); i++)
+    {
+        const ParamReference& reference = _aryParamReferences[i];
+        const CMutableString<char>& strParam = pParams->GetParameter(reference._uParamIndex);
+
+        CHK(pBuffer->WriteBuffer(pszExpansion + uCopied, reference._uOffset - uCopied));
+        CHK(pBuffer->WriteBuffer(strParam, static_cast<UINT>(strParam.GetLength())));
+        uCopied = reference._uOffset;
+    }
+
+    CHK(pBuffer->WriteBuffer(pszExpansion + uCopied, static_cast<UINT>(_strExpansion.GetLength()) - uCopied));
+
+    CHK_RETURN;
+}
+
+//+-----------------------------------------------------------------------------
+//
+//  Function:   EnsureExpansionText
+//
+//  Synopsis:   Join the token list into the text that Expand copies from.
+//
+//              Tokens are separated by a space, but there is no space after
+//              the last one. Parameter tokens are left out of the text and
+//              their position is recorded instead, so that expanding the
+//              macro is a copy of the text with the arguments in between.
+//
+//              This is done once for each definition rather than for every
+//              expansion of it.
+//
+//------------------------------------------------------------------------------
+HRESULT CGLSLPreMacroDefinition::EnsureExpansionText()
+{
+    CHK_START;
+
+    if (!_fExpansionValid)
+    {
+        CHK(_strExpansion.Set(""));
+        _aryParamReferences.RemoveAll();
 
-        // Space between tokens, but not after them
-        if (i != _rgTokenList.GetCount() - 1)
+        for (UINT i = 0; i < _rgTokenList.GetCount(); i++)
         {
-            CHK(pBuffer->WriteString(" "));
+            if (_rgTokenList[i].GetLength() == 2 && _rgTokenList[i][0] == '@')
+            {
+                ParamReference reference;
+                reference._uOffset = static_cast<UINT>(_strExpansion.GetLength());
+                reference._uParamIndex = static_cast<UINT>(_rgTokenList[i][1]) - 1;
+
+                Assert(_spParameters != nullptr && reference._uParamIndex < _spParameters->GetCount());
+                CHK(_aryParamReferences.Add(reference));
+            }
+            else
+            {
+                CHK(_strExpansion.Append(_rgTokenList[i]));
+            }
+
+            // Space between tokens, but not after them
+            if (i != _rgTokenList.GetCount() - 1)
+            {
+                CHK(_strExpansion.Append(" ", 1));
+            }
         }
+
+        _fExpansionValid = true;
     }
 
     CHK_RETURN;
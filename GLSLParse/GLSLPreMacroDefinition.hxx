@@ -64,16 +64,31 @@ public:
     bool IsEqual(__in const CGLSLPreMacroDefinition* pOther) const;
     void Finalize() { _fFinalized = true; }
     bool IsFinalized() const { return _fFinalized; }
+    void BeginExpansion() { _uActiveExpansions++; }
+    void EndExpansion() { Assert(_uActiveExpansions > 0); _uActiveExpansions--; }
+    bool IsExpanding() const { return _uActiveExpansions != 0; }
 
 protected:
     HRESULT Initialize(__in CGLSLPreParser* pPreParser);
 
 private:
+    HRESULT EnsureExpansionText();
+
+    struct ParamReference
+    {
+        UINT _uOffset;                                                      // Offset in _strExpansion that the argument goes at
+        UINT _uParamIndex;                                                  // Index of the parameter
+    };
+
     CGLSLPreParser* _pPreParser;                                            // The preparser that owns this definition
     int _idSymbol;                                                          // Symbol table index of identifier being defined
     CMutableStringModernArray _rgTokenList;                                 // The collected parameters
     TSmartPointer<CGLSLPreParamList> _spParameters;                         // The parameters on the definition
+    CMutableString<char> _strExpansion;                                     // Tokens joined with spaces, with parameter tokens left out
+    CModernArray<ParamReference> _aryParamReferences;                       // Where the arguments go in _strExpansion, in order
+    bool _fExpansionValid;                                                  // Flag to indicate that _strExpansion matches the token list
     bool _fFinalized;                                                       // Flag to indicate that the definition is finalized
+    UINT _uActiveExpansions;                                                // Number of expand buffers for this definition on the preparser buffer stack
 
     static const UINT MAX_PARAM = 64;                                       // Maximum number of allowed parameters
 };
@@ -83,14 +83,48 @@ HRESULT CGLSLPreMacroDefinitionCollection::GetDefinition(
     return E_INVALIDARG;
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   FinalizeDefinition
+//
+//  Synopsis:   Finalize the given definition and make it the one that
+//              FindDefinition returns for its identifier.
+//
+//              The identifier index must have been set on the definition,
+//              and any previous finalized definition for the same identifier
+//              must have been removed.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLPreMacroDefinitionCollection::FinalizeDefinition(
+    int defIndex                                                        // The definition index
+    )
+{
+    CHK_START;
+
+    TSmartPointer<CGLSLPreMacroDefinition> spDefinition;
+    CHK(GetDefinition(defIndex, &spDefinition));
+
+    int token = spDefinition->GetIdentifierIndex();
+    CHKB(token >= 0);
+
+    UINT uSymbol = static_cast<UINT>(token);
+    CHK(_rgDefinitionBySymbol.EnsureSize(uSymbol + 1));
+    Assert(_rgDefinitionBySymbol[uSymbol] == 0);
+
+    spDefinition->Finalize();
+    _rgDefinitionBySymbol[uSymbol] = defIndex + 1;
+
+    CHK_RETURN;
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   FindDefinition
 //
-//  Synopsis:   Search definitions for the corresponding value.
+//  Synopsis:   Find the finalized definition for the given identifier.
 //
-//              The definition must not have been removed (which would make it
-//              nullptr) and it must be finalized.
+//              Finalized definitions are tracked per symbol index, so this
+//              does not need to look at the definition list at all.
 //
 //-----------------------------------------------------------------------------
 HRESULT CGLSLPreMacroDefinitionCollection::FindDefinition(
@@ -99,27 +133,30 @@ HRESULT CGLSLPreMacroDefinitionCollection::FindDefinition(
     __deref_out_opt CGLSLPreMacroDefinition** ppValue                   // What the definition of this define is (what replaces the token)
     )
 {
-    for (UINT i = 0; i < _rgDefinitions.GetCount(); i++)
+    if (token < 0 || static_cast<UINT>(token) >= _rgDefinitionBySymbol.GetCount())
     {
-        if (_rgDefinitions[i] != nullptr && 
-            _rgDefinitions[i]->GetIdentifierIndex() == token && 
-            _rgDefinitions[i]->IsFinalized())
-        {
-            if (pDefIndex != nullptr)
-            {
-                (*pDefIndex) = static_cast<int>(i);
-            }
+        return E_INVALIDARG;
+    }
 
-            if (ppValue != nullptr)
-            {
-                _rgDefinitions[i].CopyTo(ppValue);
-            }
+    int defIndex = _rgDefinitionBySymbol[static_cast<UINT>(token)] - 1;
+    if (defIndex == -1)
+    {
+        return E_INVALIDARG;
+    }
 
-            return S_OK;
-        }
+    Assert(_rgDefinitions[defIndex] != nullptr && _rgDefinitions[defIndex]->IsFinalized());
+
+    if (pDefIndex != nullptr)
+    {
+        (*pDefIndex) = defIndex;
     }
 
-    return E_INVALIDARG;
+    if (ppValue != nullptr)
+    {
+        _rgDefinitions[defIndex].CopyTo(ppValue);
+    }
+
+    return S_OK;
 }
 
 //+----------------------------------------------------------------------------
@@ -140,6 +177,17 @@ void CGLSLPreMacroDefinitionCollection::RemoveDefinitionFromIndex(
     int defIndex                                                        // Index of definition to remove
     )
 {
+    CGLSLPreMacroDefinition* pDefinition = _rgDefinitions[defIndex];
+    if (pDefinition != nullptr && pDefinition->IsFinalized())
+    {
+        // Stop tracking it if it is the current definition for its identifier
+        UINT uSymbol = static_cast<UINT>(pDefinition->GetIdentifierIndex());
+        if (uSymbol < _rgDefinitionBySymbol.GetCount() && _rgDefinitionBySymbol[uSymbol] == defIndex + 1)
+        {
+            _rgDefinitionBySymbol[uSymbol] = 0;
+        }
+    }
+
     _rgDefinitions[defIndex].Release();
 }
 
@@ -46,6 +46,10 @@ public:
         __deref_out_opt CGLSLPreMacroDefinition** ppDefinition              // The definition
         );
 
+    HRESULT FinalizeDefinition(
+        int defIndex                                                        // The definition index
+        );
+
     HRESULT GetDefinition(
         int defIndex,                                                       // The definition index
         __deref_out CGLSLPreMacroDefinition** ppDefinition                  // The definition
@@ -67,4 +71,5 @@ public:
 
 private:
     CModernArray<TSmartPointer<CGLSLPreMacroDefinition>> _rgDefinitions;    // The list of definitions
+    CModernArray<int> _rgDefinitionBySymbol;                                // Definition index + 1 of the finalized definition for each symbol, 0 if none
 };
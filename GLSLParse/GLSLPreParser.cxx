@@ -48,6 +48,10 @@ CGLSLPreParser::CGLSLPreParser() :
     _logicalFile(0),
     _column(1),
     _fErrors(false),
+    _uOutputSize(0),
+    _uMaxOutputSize(UINT_MAX),
+    _uExpansionCount(0),
+    _uExpansionSize(0),
     _commentCondition(INITIAL),
     _lineSymbol(-1),
     _fProcessedStatement(false),
@@ -66,13 +70,15 @@ HRESULT CGLSLPreParser::Initialize(
     __in IParserInput* pInput,                                          // Input to preprocess
     __in IErrorSink* pErrorSink,                                        // Where to store errors if you have them
     UINT uOptions,                                                      // Translation options
-    GLSLShaderType::Enum shaderType                                     // Type of shader
+    GLSLShaderType::Enum shaderType,                                    // Type of shader
+    UINT uMaxOutputSize                                                 // Size that the output may not exceed
     )
 {
     CHK_START;
 
     _spInput = pInput;
     _spErrorSink = pErrorSink;
+    _uMaxOutputSize = uMaxOutputSize;
 
     // Set up the symbol table
     CHK(RefCounted<CGLSLSymbolTable>::Create(/*out*/_spSymbolTable));
@@ -132,10 +138,30 @@ HRESULT CGLSLPreParser::Initialize(
     // Initialize our allow stack to the initial state, which is passing code through
     _conditionState._fAllowOutput = true;
 
-    // Create and kick off the scanner
+    // Create and kick off the scanner. If the input is held in a single buffer
+    // then the scanner runs over it in place, otherwise it pulls the input.
     GLSLPrelex_init(&_scanner);
     GLSLPreset_extra(this, _scanner);
-    GLSLPreparse(_scanner); 
+
+    char* pScanBuffer;
+    UINT uScanBufferSize;
+    bool fScanBufferRefused = false;
+    if (SUCCEEDED(_spInput->GetScanBuffer(&pScanBuffer, &uScanBufferSize)))
+    {
+        // flex only refuses a buffer that is missing its two null
+        // terminators, which means the input broke its contract
+        if (GLSLPre_scan_buffer(pScanBuffer, uScanBufferSize, _scanner) == nullptr)
+        {
+            Assert(false);
+            _spInput->ReleaseScanBuffer();
+            fScanBufferRefused = true;
+        }
+    }
+
+    if (!fScanBufferRefused)
+    {
+        GLSLPreparse(_scanner); 
+    }
 
     // If we have more than one buffer left, then we should delete it. The macro
     // expansion did not unroll naturally and the extra created buffers should be
@@ -147,6 +173,7 @@ HRESULT CGLSLPreParser::Initialize(
     _scanner = nullptr;
 
     // No errors allowed
+    CHKB(!fScanBufferRefused);
     CHKB(!_fErrors);
 
     CHK_RETURN;
@@ -245,7 +272,7 @@ HRESULT CGLSLPreParser::ProcessTextToken(
     {
         if (_paramStack.Size() == 0)
         {
-            CHK(_spOutput->WriteString(pszText));
+            CHK(WriteOutput(pszText, static_cast<UINT>(length)));
         }
         else
         {
@@ -281,6 +308,93 @@ HRESULT CGLSLPreParser::EnsureSymbolIndex(
     CHK_RETURN;
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   WriteOutput
+//
+//  Synopsis:   Write text to the output, enforcing the output size limit as
+//              we go. This stops a shader (or a macro that expands without
+//              bound) as soon as it goes over, rather than after the whole
+//              output has been built.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLPreParser::WriteOutput(
+    __in_ecount(length) const char* pszText,                            // Text to write
+    UINT length                                                         // Length of text
+    )
+{
+    CHK_START;
+
+    if (length > _uMaxOutputSize - _uOutputSize)
+    {
+        char szMaxSize[16];
+        CHK(::StringCchPrintfA(szMaxSize, ARRAYSIZE(szMaxSize), "%u", _uMaxOutputSize));
+
+        // The limit applies to the shader as a whole, so there is no location
+        YYLTYPE nullLocation = {0};
+        CHK(LogError(&nullLocation, E_GLSLERROR_SHADERTOOLONG, szMaxSize));
+        CHK(E_GLSLERROR_KNOWNERROR);
+    }
+
+    CHK(_spOutput->WriteBuffer(pszText, length));
+    _uOutputSize += length;
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddExpansionSize
+//
+//  Synopsis:   Called by a definition before it expands, with the length of
+//              the text it expands to. Arguments are expanded before they
+//              are substituted, so nested macro calls can grow the expansion
+//              exponentially; this fails before the text is built once the
+//              total goes over the limit.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLPreParser::AddExpansionSize(
+    UINT cchExpansion,                                                  // Length of the text a macro is about to expand to
+    __in YYLTYPE* pLocation                                             // Location of macro being expanded
+    )
+{
+    CHK_START;
+
+    if (cchExpansion > MAX_EXPANSION_SIZE - _uExpansionSize)
+    {
+        CHK(LogExpansionLimit("total size in bytes", MAX_EXPANSION_SIZE, pLocation));
+    }
+
+    _uExpansionSize += cchExpansion;
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   LogExpansionLimit
+//
+//  Synopsis:   Log that macro expansion went over one of its limits, and
+//              fail so that preprocessing stops.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLPreParser::LogExpansionLimit(
+    __in_z const char* pszLimit,                                        // Description of the limit that was exceeded
+    UINT uLimit,                                                        // Value of the limit
+    __in YYLTYPE* pLocation                                             // Location of macro being expanded
+    )
+{
+    CHK_START;
+
+    char szLimit[64];
+    CHK(::StringCchPrintfA(szLimit, ARRAYSIZE(szLimit), "%s of %u", pszLimit, uLimit));
+
+    CHK(LogError(pLocation, E_GLSLERROR_PREMAXEXPANSION, szLimit));
+    CHK(E_GLSLERROR_KNOWNERROR);
+
+    CHK_RETURN;
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   VerifyTokenLength
@@ -337,15 +451,12 @@ HRESULT CGLSLPreParser::GetMacroDefinition(
         CHK(spDefinition->SetToNumber((identifierIndex == _lineSymbol) ? _logicalLine : _logicalFile));
     }
 
-    // If this definition is the one we are expanding, then pretend we could
-    // not find it. We need to check all the way up the chain because if you
-    // are two definitions deep, neither should expand themselves.
-    for (UINT i = 0; i < _bufferStack.Size(); i++)
+    // If this definition is one we are expanding, then pretend we could
+    // not find it. This covers the whole buffer stack because if you are
+    // two definitions deep, neither should expand themselves.
+    if (spDefinition->IsExpanding())
     {
-        if (_bufferStack.ItemRef(i)._spDefinition->GetIdentifierIndex() == symIndex)
-        {
-            CHK(E_INVALIDARG);
-        }
+        CHK(E_INVALIDARG);
     }
 
     (*ppDefinition) = spDefinition.Extract();
@@ -366,7 +477,7 @@ HRESULT CGLSLPreParser::PreProcessNewline()
 {
     CHK_START;
 
-    CHK(_spOutput->WriteChar('\n'));
+    CHK(WriteOutput("\n", 1));
 
     // Reset column counter and increment line counter
     _realLine++;
@@ -443,7 +554,7 @@ HRESULT CGLSLPreParser::PreProcessCommentText(int length)
         {
             for (int i = 0; i < length; i++)
             {
-                CHK(_spOutput->WriteChar(' '));
+                CHK(WriteOutput(" ", 1));
             }
         }
     }
@@ -715,7 +826,7 @@ HRESULT CGLSLPreParser::PreDefine(
             if (defIndex == -1)
             {
                 // Create a definition to set the token on
-                CHK(_rgDefinitions.CreateAndAddDefinition(this, /*index*/nullptr, &spDefinition));
+                CHK(_rgDefinitions.CreateAndAddDefinition(this, &defIndex, &spDefinition));
 
                 // Make sure that at least a space is used in this case
                 CHK(spDefinition->AddToken(" "));
@@ -760,7 +871,7 @@ HRESULT CGLSLPreParser::PreDefine(
         }
 
         // Now we can finalize what we have
-        spDefinition->Finalize();
+        CHK(_rgDefinitions.FinalizeDefinition(defIndex));
 
         // Make sure the macro name is legal
         if (FAILED(VerifyMacroName(iToken)))
@@ -853,14 +964,15 @@ HRESULT CGLSLPreParser::AddDefinition(
 {
     CHK_START;
 
+    int defIndex;
     TSmartPointer<CGLSLPreMacroDefinition> spDefinition;
-    CHK(_rgDefinitions.CreateAndAddDefinition(this, nullptr, &spDefinition));
+    CHK(_rgDefinitions.CreateAndAddDefinition(this, &defIndex, &spDefinition));
     CHK(spDefinition->AddToken(pszValue));
 
     int token;
     CHK(_spSymbolTable->EnsureSymbolIndex(pszToken, &token));
     spDefinition->SetIdentifierIndex(token);
-    spDefinition->Finalize();
+    CHK(_rgDefinitions.FinalizeDefinition(defIndex));
 
     if (pSymbolIndex != nullptr)
     {
@@ -939,6 +1051,21 @@ HRESULT CGLSLPreParser::PushBufferState(
     TSmartPointer<CGLSLPreMacroDefinition> spPopDefinition;
     TSmartPointer<CGLSLPreParamList> spParamList;
 
+    // Bound how deeply and how often macros expand. Expansions can nest and
+    // repeat without producing any output, so the output size limit alone
+    // does not stop a shader from making the preprocessor do unbounded work.
+    if (_bufferStack.Size() >= MAX_EXPANSION_DEPTH)
+    {
+        CHK(LogExpansionLimit("nesting depth", MAX_EXPANSION_DEPTH, pLocation));
+    }
+
+    if (_uExpansionCount >= MAX_EXPANSION_COUNT)
+    {
+        CHK(LogExpansionLimit("number of expansions", MAX_EXPANSION_COUNT, pLocation));
+    }
+
+    _uExpansionCount++;
+
     // If we don't have a definition, it is because we are closing off the parameter
     // list. We need to pop the parameter list off and get the definition from there
     if (pDefinition == nullptr)
@@ -951,7 +1078,14 @@ HRESULT CGLSLPreParser::PushBufferState(
     TSmartPointer<CGLSLPreExpandBuffer> spNewBuffer;
     CHK(RefCounted<CGLSLPreExpandBuffer>::Create(pLocation, pDefinition, spParamList, /*out*/spNewBuffer));
 
-    YY_BUFFER_STATE newState = GLSLPre_scan_string(spNewBuffer->GetBufferString(), _scanner);
+    // Scan the expansion in place - the buffer is held by the stack entry
+    // until it is popped, which deletes the scanner state first
+    char* pScanBuffer;
+    UINT uScanBufferSize;
+    CHK(spNewBuffer->GetScanBuffer(&pScanBuffer, &uScanBufferSize));
+
+    YY_BUFFER_STATE newState = GLSLPre_scan_buffer(pScanBuffer, uScanBufferSize, _scanner);
+    CHKB(newState != nullptr);
 
     // Set up the new state
     BufferState newEntry;
@@ -960,8 +1094,10 @@ HRESULT CGLSLPreParser::PushBufferState(
     newEntry._spBuffer = spNewBuffer;
     newEntry._spDefinition = pDefinition;
 
-    // Push it onto the stack
+    // Push it onto the stack, and mark the definition as being expanded
+    // until the buffer is popped
     CHK(_bufferStack.Push(newEntry));
+    pDefinition->BeginExpansion();
 
     CHK_RETURN;
 }
@@ -980,6 +1116,8 @@ HRESULT CGLSLPreParser::PopBufferState()
     BufferState popState;
     CHK(_bufferStack.Pop(/*out*/popState));
 
+    popState._spDefinition->EndExpansion();
+
     GLSLPre_delete_buffer(static_cast<YY_BUFFER_STATE>(popState._newState), _scanner);
     GLSLPre_switch_to_buffer(static_cast<YY_BUFFER_STATE>(popState._oldState), _scanner); 
 
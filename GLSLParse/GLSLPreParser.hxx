@@ -60,7 +60,8 @@ public:
         __in IParserInput* pInput,                                          // Input to preprocess
         __in IErrorSink* pErrorSink,                                        // Where to store errors if you have them
         UINT uOptions,                                                      // Translation options
-        GLSLShaderType::Enum shaderType                                     // Type of shader
+        GLSLShaderType::Enum shaderType,                                    // Type of shader
+        UINT uMaxOutputSize                                                 // Size that the output may not exceed
         );
 
     // Functions called from the generated parser stack
@@ -120,6 +121,7 @@ public:
     IParserInput* UseInput() { return _spInput; }
     CMemoryStream* UseOutput() { return _spOutput; }
     CGLSLLineMap* UseLineMap() { return _spLineMap; }
+    UINT GetExpansionCount() const { return _uExpansionCount; }
     CGLSLExtensionState* UseExtensionState() const { return _spExtensionState; }
 
     HRESULT EnsureSymbolIndex(
@@ -134,6 +136,11 @@ public:
         __in YYLTYPE* pLocation                                             // Location of text
         );
 
+    HRESULT AddExpansionSize(
+        UINT cchExpansion,                                                  // Length of the text a macro is about to expand to
+        __in YYLTYPE* pLocation                                             // Location of macro being expanded
+        );
+
     HRESULT ProcessTextToken(
         __in_z char* pszText,                                               // Token to process
         int length,                                                         // Length of token
@@ -196,6 +203,11 @@ public:
 private:
     HRESULT PreIfImpl(bool fVal);
 
+    HRESULT WriteOutput(
+        __in_ecount(length) const char* pszText,                            // Text to write
+        UINT length                                                         // Length of text
+        );
+
     HRESULT AddDefinition(
         __in_z const char* pszToken,                                        // Macro identifier
         __in_z const char* pszValue,                                        // First token in macro value
@@ -204,6 +216,12 @@ private:
 
     HRESULT VerifyMacroName(int iToken);
 
+    HRESULT LogExpansionLimit(
+        __in_z const char* pszLimit,                                        // Description of the limit that was exceeded
+        UINT uLimit,                                                        // Value of the limit
+        __in YYLTYPE* pLocation                                             // Location of macro being expanded
+        );
+
 private:
     struct BufferState
     {
@@ -246,6 +264,10 @@ private:
 
     TSmartPointer<IParserInput> _spInput;                                   // Input string
     TSmartPointer<CMemoryStream> _spOutput;                                 // Output stream
+    UINT _uOutputSize;                                                      // Number of characters written to the output
+    UINT _uMaxOutputSize;                                                   // Size that the output may not exceed
+    UINT _uExpansionCount;                                                  // Number of macro expansions so far
+    UINT _uExpansionSize;                                                   // Total length of macro expansions so far
 
     ConditionState _conditionState;                                         // Current condition state
     int _commentCondition;                                                  // Condition in lexer for C comment to return to when comment ends
@@ -259,6 +281,10 @@ private:
     TSmartPointer<CGLSLExtensionState> _spExtensionState;                   // Extension state
     bool _fProcessedStatement;                                              // Flag to indicate if a statement has been processed
     bool _fNonWhitespaceOnLine;                                             // Flag to indicate that a line has processed non-whitespace as text on the current line
+
+    static const UINT MAX_EXPANSION_DEPTH = 128;                            // Maximum number of macro expansions nested inside each other
+    static const UINT MAX_EXPANSION_COUNT = 65536;                          // Maximum number of macro expansions for a shader
+    static const UINT MAX_EXPANSION_SIZE = 4 * 1024 * 1024;                 // Maximum total length of macro expansions for a shader
 };
 
 int GLSLPreparse(__in void* YYPARSE_PARAM);
@@ -40,12 +40,13 @@ class CGLSLPreParser;              // Forward define for lexer header to compile
 //  Function:   GLSLPreInput
 //
 //  Synopsis:   Global function called for pulling input into the parser. Used
-//              instead of a stdin stream by the tokenizer.
+//              instead of a stdin stream by the tokenizer, which asks for up
+//              to max_size characters at a time.
 //
 //-----------------------------------------------------------------------------
-int GLSLPreInput(__in CGLSLPreParser* pParser, __out_ecount(1) char* buf, int /*max_size*/)
+int GLSLPreInput(__in CGLSLPreParser* pParser, __out_ecount_part(max_size, return) char* buf, int max_size)
 {
-    return pParser->UseInput()->PullInput(buf);
+    return pParser->UseInput()->PullInput(buf, max_size);
 }
 
 //+-----------------------------------------------------------------------------
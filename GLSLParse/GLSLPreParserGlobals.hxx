@@ -27,7 +27,7 @@
 #pragma once
 
 // Defined in GLSLPreParser.cxx, used to avoid including PreParser.hxx in flex output
-int GLSLPreInput(__in CGLSLPreParser* pOutput, __out_ecount(1) char* buf, int max_size);
+int GLSLPreInput(__in CGLSLPreParser* pOutput, __out_ecount_part(max_size, return) char* buf, int max_size);
 void GLSLPreUpdateLocation(__in CGLSLPreParser* pParser, __in YYLTYPE* pLocation, int lineNo, int tokenLength);
 
 // Input handling
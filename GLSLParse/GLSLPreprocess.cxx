@@ -45,12 +45,36 @@ HRESULT GLSLPreprocess(
     __deref_out CGLSLLineMap** ppLineMap,                       // Line map from preprocessor
     __deref_out CGLSLExtensionState** ppExtensionState          // Extension state from preprocessor
     )
+{
+    return GLSLPreprocess(pInput, pErrorSink, uOptions, shaderType, UINT_MAX, ppOutput, ppLineMap, ppExtensionState);
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GLSLPreProcess
+//
+//  Synopsis:   Preprocess with a limit on the size of the output. The limit
+//              is checked as the output is written, and going over it is
+//              logged as E_GLSLERROR_SHADERTOOLONG.
+//
+//-----------------------------------------------------------------------------
+HRESULT GLSLPreprocess(
+    __in IParserInput* pInput,                                  // Input to preprocessor
+    __in IErrorSink* pErrorSink,                                // Where to store errors if you have them
+    UINT uOptions,                                              // Translation options
+    GLSLShaderType::Enum shaderType,                            // Type of shader
+    UINT uMaxOutputSize,                                        // Size that the output may not exceed
+    __deref_out CMemoryStream** ppOutput,                       // Preprocessed output
+    __deref_out CGLSLLineMap** ppLineMap,                       // Line map from preprocessor
+    __deref_out CGLSLExtensionState** ppExtensionState,         // Extension state from preprocessor
+    __out_opt UINT* puExpansionCount                            // Number of macro expansions the preprocessor did
+    )
 {
     CHK_START;
 
     CGLSLPreParser parser;
     
-    CHK(parser.Initialize(pInput, pErrorSink, uOptions, shaderType));
+    CHK(parser.Initialize(pInput, pErrorSink, uOptions, shaderType, uMaxOutputSize));
 
     (*ppOutput) = parser.UseOutput();
     (*ppOutput)->AddRef();
@@ -61,5 +85,10 @@ HRESULT GLSLPreprocess(
     (*ppExtensionState) = parser.UseExtensionState();
     (*ppExtensionState)->AddRef();
 
+    if (puExpansionCount != nullptr)
+    {
+        (*puExpansionCount) = parser.GetExpansionCount();
+    }
+
     CHK_RETURN;
 }
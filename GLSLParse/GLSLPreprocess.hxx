@@ -44,3 +44,15 @@ HRESULT GLSLPreprocess(
     __deref_out CGLSLLineMap** ppLineMap,                       // Line map from preprocessor
     __deref_out CGLSLExtensionState** ppExtensionState          // Extension state from preprocessor
     );
+
+HRESULT GLSLPreprocess(
+    __in IParserInput* pInput,                                  // Input to preprocessor
+    __in IErrorSink* pErrorSink,                                // Where to store errors if you have them
+    UINT uOptions,                                              // Translation options
+    GLSLShaderType::Enum shaderType,                            // Type of shader
+    UINT uMaxOutputSize,                                        // Size that the output may not exceed
+    __deref_out CMemoryStream** ppOutput,                       // Preprocessed output
+    __deref_out CGLSLLineMap** ppLineMap,                       // Line map from preprocessor
+    __deref_out CGLSLExtensionState** ppExtensionState,         // Extension state from preprocessor
+    __out_opt UINT* puExpansionCount = nullptr                  // Number of macro expansions the preprocessor did
+    );
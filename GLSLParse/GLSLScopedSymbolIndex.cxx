@@ -0,0 +1,269 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#include "PreComp.hxx"
+#include "GLSLScopedSymbolIndex.hxx"
+#include "CollectionNodeWithScope.hxx"
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Constructor
+//
+//-----------------------------------------------------------------------------
+CGLSLScopedSymbolIndex::CGLSLScopedSymbolIndex() :
+    _iFreeEntry(s_iNoEntry),
+    _uOpenScopeCount(0)
+{
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   OpenScope
+//
+//  Synopsis:   Opens a scope at the top of the stack of open scopes and adds
+//              the identifiers already declared in it (for example the
+//              known symbols in the global scope) to the index.
+//
+//              A scope can be opened again while it is open, which only
+//              counts the extra open; function definitions open their
+//              prototype's scope before the prototype node opens it itself.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLScopedSymbolIndex::OpenScope(
+    __in CollectionNodeWithScope* pScope                        // Scope to open
+    )
+{
+    CHK_START;
+
+    pScope->_cOpen++;
+
+    if (pScope->_cOpen == 1)
+    {
+        pScope->_uOpenDepth = _uOpenScopeCount;
+        _uOpenScopeCount++;
+
+        for (UINT i = 0; i < pScope->GetIdentifierCount(); i++)
+        {
+            CHK(AddIdentifier(pScope, pScope->UseIdentifier(i)));
+        }
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   CloseScope
+//
+//  Synopsis:   Closes a scope opened by OpenScope. When the last open is
+//              closed, the scope's identifiers leave the index. Scopes are
+//              closed in the reverse order they were opened, so they are
+//              always the deepest open scope and their entries are at the
+//              front of the lists.
+//
+//-----------------------------------------------------------------------------
+void CGLSLScopedSymbolIndex::CloseScope(
+    __in CollectionNodeWithScope* pScope                        // Scope to close
+    )
+{
+    Assert(pScope->_cOpen > 0);
+
+    pScope->_cOpen--;
+    if (pScope->_cOpen == 0)
+    {
+        Assert(pScope->_uOpenDepth + 1 == _uOpenScopeCount);
+
+        for (UINT i = pScope->GetIdentifierCount(); i > 0; i--)
+        {
+            PopIdentifier(pScope->UseIdentifier(i - 1), pScope->_uOpenDepth);
+        }
+
+        _uOpenScopeCount--;
+    }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddIdentifier
+//
+//  Synopsis:   Adds an identifier declared in an open scope. The entry goes
+//              after the entries of deeper scopes, which are only there when
+//              something is declared in an outer scope while inner ones are
+//              open (like a function name, which goes in the global scope
+//              while its parameters are being verified).
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLScopedSymbolIndex::AddIdentifier(
+    __in CollectionNodeWithScope* pScope,                       // Open scope the identifier is declared in
+    __in IIdentifierInfo* pInfo                                 // Declared identifier
+    )
+{
+    CHK_START;
+
+    Assert(pScope->_cOpen > 0);
+
+    int iSymbolIndex = pInfo->GetSymbolIndex();
+    CHKB(iSymbolIndex >= 0);
+
+    UINT uSymbolIndex = static_cast<UINT>(iSymbolIndex);
+    if (uSymbolIndex >= _aryFirstEntry.GetCount())
+    {
+        UINT uOldCount = _aryFirstEntry.GetCount();
+        CHK(_aryFirstEntry.Resize(uSymbolIndex + 1));
+        for (UINT i = uOldCount; i < _aryFirstEntry.GetCount(); i++)
+        {
+            _aryFirstEntry[i] = s_iNoEntry;
+        }
+    }
+
+    int iEntry;
+    CHK(AllocateEntry(&iEntry));
+
+    Entry& entry = _aryEntries[iEntry];
+    entry._pInfo = pInfo;
+    entry._uDepth = pScope->_uOpenDepth;
+
+    // Skip entries in deeper scopes. Entries in the same scope stay in the
+    // order they were declared, so the new one goes after them too.
+    int* piLink = &_aryFirstEntry[uSymbolIndex];
+    while (*piLink != s_iNoEntry && _aryEntries[*piLink]._uDepth >= entry._uDepth)
+    {
+        piLink = &_aryEntries[*piLink]._iNext;
+    }
+
+    entry._iNext = *piLink;
+    (*piLink) = iEntry;
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   PopIdentifier
+//
+//  Synopsis:   Removes the entry for an identifier in the deepest open scope.
+//              Its symbol has no entries in deeper scopes, so the entry is
+//              among the first for the symbol.
+//
+//-----------------------------------------------------------------------------
+void CGLSLScopedSymbolIndex::PopIdentifier(
+    __in IIdentifierInfo* pInfo,                                // Identifier to remove
+    UINT uDepth                                                 // Depth of the scope it is declared in
+    )
+{
+    int* piLink = &_aryFirstEntry[pInfo->GetSymbolIndex()];
+    while (*piLink != s_iNoEntry && _aryEntries[*piLink]._pInfo != pInfo)
+    {
+        Assert(_aryEntries[*piLink]._uDepth == uDepth);
+        piLink = &_aryEntries[*piLink]._iNext;
+    }
+
+    Assert(*piLink != s_iNoEntry);
+    if (*piLink != s_iNoEntry)
+    {
+        int iEntry = *piLink;
+        (*piLink) = _aryEntries[iEntry]._iNext;
+
+        _aryEntries[iEntry]._pInfo = nullptr;
+        _aryEntries[iEntry]._iNext = _iFreeEntry;
+        _iFreeEntry = iEntry;
+    }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AllocateEntry
+//
+//  Synopsis:   Takes an entry from the free list, or grows the pool.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLScopedSymbolIndex::AllocateEntry(
+    __out int* piEntry                                          // Unused entry
+    )
+{
+    CHK_START;
+
+    if (_iFreeEntry != s_iNoEntry)
+    {
+        (*piEntry) = _iFreeEntry;
+        _iFreeEntry = _aryEntries[_iFreeEntry]._iNext;
+    }
+    else
+    {
+        Entry newEntry = { nullptr, 0, s_iNoEntry };
+        CHK(_aryEntries.Add(newEntry));
+        (*piEntry) = static_cast<int>(_aryEntries.GetCount() - 1);
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   FindFirstEntry
+//
+//  Synopsis:   Finds the first entry for a symbol in the deepest open scope
+//              that declares it, ignoring scopes deeper than uMaxDepth.
+//              Returns s_iNoEntry if no such scope declares the symbol.
+//
+//-----------------------------------------------------------------------------
+int CGLSLScopedSymbolIndex::FindFirstEntry(
+    int iSymbolIndex,                                           // Symbol to look for
+    UINT uMaxDepth                                              // Deepest scope to consider
+    ) const
+{
+    if (iSymbolIndex < 0 || static_cast<UINT>(iSymbolIndex) >= _aryFirstEntry.GetCount())
+    {
+        return s_iNoEntry;
+    }
+
+    int iEntry = _aryFirstEntry[iSymbolIndex];
+    while (iEntry != s_iNoEntry && _aryEntries[iEntry]._uDepth > uMaxDepth)
+    {
+        iEntry = _aryEntries[iEntry]._iNext;
+    }
+
+    return iEntry;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetNextEntryInScope
+//
+//  Synopsis:   Returns the next entry for the same symbol in the same scope
+//              as the given entry, or s_iNoEntry if there are no more.
+//
+//-----------------------------------------------------------------------------
+int CGLSLScopedSymbolIndex::GetNextEntryInScope(int iEntry) const
+{
+    int iNext = _aryEntries[iEntry]._iNext;
+    if (iNext != s_iNoEntry && _aryEntries[iNext]._uDepth != _aryEntries[iEntry]._uDepth)
+    {
+        iNext = s_iNoEntry;
+    }
+
+    return iNext;
+}
@@ -0,0 +1,108 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#pragma once
+
+#include <foundation/collections.hxx>
+
+interface IIdentifierInfo;
+class CollectionNodeWithScope;
+
+//+-----------------------------------------------------------------------------
+//
+//  Class:      CGLSLScopedSymbolIndex
+//
+//  Synopsis:   Maps each symbol index to the identifiers declared for it in
+//              the scopes that are currently open during verification, so
+//              that name resolution does not have to walk up the tree and
+//              scan the identifier list of every scope on the way.
+//
+//              A scope is open while the node that owns it is being verified
+//              (for a function definition, that is the whole definition and
+//              not just its prototype). Open scopes form a stack, and each
+//              gets its depth in the stack when it is opened. For each symbol
+//              the index keeps a list of entries ordered from the deepest
+//              scope to the shallowest, so the innermost declaration is found
+//              at the front of the list.
+//
+//              Scopes that are not open are not in the index; lookups against
+//              them have to go back to the scope's own identifier list.
+//
+//------------------------------------------------------------------------------
+class CGLSLScopedSymbolIndex : public IUnknown
+{
+public:
+    HRESULT OpenScope(__in CollectionNodeWithScope* pScope);
+    void CloseScope(__in CollectionNodeWithScope* pScope);
+
+    HRESULT AddIdentifier(
+        __in CollectionNodeWithScope* pScope,                               // Open scope the identifier is declared in
+        __in IIdentifierInfo* pInfo                                         // Declared identifier
+        );
+
+    int FindFirstEntry(
+        int iSymbolIndex,                                                   // Symbol to look for
+        UINT uMaxDepth                                                      // Deepest scope to consider
+        ) const;
+
+    int GetNextEntryInScope(int iEntry) const;
+    IIdentifierInfo* UseEntryInfo(int iEntry) const { return _aryEntries[iEntry]._pInfo; }
+    UINT GetEntryDepth(int iEntry) const { return _aryEntries[iEntry]._uDepth; }
+
+    UINT GetOpenScopeCount() const { return _uOpenScopeCount; }
+
+    static const int s_iNoEntry = -1;                                       // Marks the end of an entry list
+
+protected:
+    CGLSLScopedSymbolIndex();
+
+    HRESULT Initialize() { return S_OK; }
+
+private:
+    HRESULT AllocateEntry(__out int* piEntry);
+    void PopIdentifier(__in IIdentifierInfo* pInfo, UINT uDepth);
+
+private:
+    //+-------------------------------------------------------------------------
+    //
+    //  Struct:     Entry
+    //
+    //  Synopsis:   One identifier in one open scope, linked into the list
+    //              for its symbol (or into the free list).
+    //
+    //--------------------------------------------------------------------------
+    struct Entry
+    {
+        IIdentifierInfo* _pInfo;                                            // Declared identifier, kept alive by its scope
+        UINT _uDepth;                                                       // Depth of the scope it is declared in
+        int _iNext;                                                         // Next entry in a shallower or the same scope
+    };
+
+    CModernArray<int> _aryFirstEntry;                                       // First entry for each symbol index
+    CModernArray<Entry> _aryEntries;                                        // Pool of entries
+    int _iFreeEntry;                                                        // First unused entry in the pool
+    UINT _uOpenScopeCount;                                                  // Number of scopes currently open
+};
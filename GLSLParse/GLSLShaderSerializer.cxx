@@ -0,0 +1,686 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#include "PreComp.hxx"
+#include "GLSLShaderSerializer.hxx"
+#include "GLSLConvertedShader.hxx"
+#include "GLSLIdentifierTable.hxx"
+#include "GLSLSymbolTable.hxx"
+#include "GLSLBinaryStream.hxx"
+#include "GLSLTypeInfo.hxx"
+#include "VariableIdentifierInfo.hxx"
+#include "TypeNameIdentifierInfo.hxx"
+#include "StructGLSLType.hxx"
+#include "MemoryStream.hxx"
+#include "RefCounted.hxx"
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Constructor
+//
+//-----------------------------------------------------------------------------
+CGLSLShaderSerializer::CGLSLShaderSerializer() :
+    _pWriter(nullptr),
+    _pReader(nullptr)
+{
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Serialize
+//
+//  Synopsis:   Writes the header, the errors, the HLSL if translation
+//              succeeded, the identifier table and the varying struct info.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLShaderSerializer::Serialize(
+    __in const CGLSLConvertedShader* pShader,                   // Shader to write
+    __inout CGLSLBinaryWriter* pWriter                          // Where to write the shader
+    )
+{
+    CHK_START;
+
+    CGLSLShaderSerializer serializer;
+    serializer._pWriter = pWriter;
+
+    // Symbol indices are only meaningful with the same set of known symbols
+    CHK(pWriter->WriteUInt(s_uMagic));
+    CHK(pWriter->WriteUInt(s_uVersion));
+    CHK(pWriter->WriteUInt(static_cast<UINT>(GLSLSymbols::count)));
+
+    CHK(pWriter->WriteUInt(pShader->GetErrorCount()));
+    for (UINT i = 0; i < pShader->GetErrorCount(); i++)
+    {
+        CHK(pShader->UseError(i)->Serialize(pWriter));
+    }
+
+    bool fSucceeded = pShader->TranslationSucceeded();
+    CHK(pWriter->WriteUInt(fSucceeded ? 1 : 0));
+    if (fSucceeded)
+    {
+        UINT cchCode;
+        CMutableString<char> spszCode;
+        CHK(pShader->UseConvertedStream()->GetSize(&cchCode));
+        CHK(pShader->UseConvertedStream()->ExtractString(spszCode));
+        CHK(pWriter->WriteString(spszCode, cchCode));
+    }
+
+    const CGLSLIOStructInfo* pVaryingInfo = fSucceeded ? pShader->UseParsedVaryingInfo() : nullptr;
+    CGLSLIdentifierTable* pIdTable = pShader->UseIdentifierTable();
+    CHKB(pVaryingInfo == nullptr || pIdTable != nullptr);
+
+    CHK(pWriter->WriteUInt((pIdTable != nullptr) ? 1 : 0));
+    if (pIdTable != nullptr)
+    {
+        CHK(serializer.WriteIdentifierTable(pIdTable));
+
+        // The varying entries are written last so that they can refer to any
+        // variable that was written before them.
+        CHK(pWriter->WriteUInt((pVaryingInfo != nullptr) ? 1 : 0));
+        if (pVaryingInfo != nullptr)
+        {
+            CModernArray<UINT> aryEntryRecords;
+            for (UINT i = 0; i < pVaryingInfo->GetEntryCount(); i++)
+            {
+                UINT uRecord = serializer.FindVariableRecord(pVaryingInfo->UseEntryVariable(i));
+                CHKB(uRecord != serializer._aryVariables.NotFound);
+                CHK(aryEntryRecords.Add(uRecord));
+            }
+
+            CHK(pVaryingInfo->Serialize(aryEntryRecords, pWriter));
+        }
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Deserialize
+//
+//  Synopsis:   Restores a shader written by Serialize. The data must have
+//              been written by a translator with the same format version and
+//              known symbols, and must be consumed completely.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLShaderSerializer::Deserialize(
+    __inout CGLSLBinaryReader* pReader,                         // Reader positioned at data written by Serialize
+    __deref_out CGLSLConvertedShader** ppShader                 // Restored shader
+    )
+{
+    CHK_START;
+
+    CGLSLShaderSerializer serializer;
+    serializer._pReader = pReader;
+
+    UINT uMagic;
+    UINT uVersion;
+    UINT uKnownSymbolCount;
+    CHK(pReader->ReadUInt(&uMagic));
+    CHK(pReader->ReadUInt(&uVersion));
+    CHK(pReader->ReadUInt(&uKnownSymbolCount));
+    CHKB_HR(uMagic == s_uMagic && uVersion == s_uVersion && uKnownSymbolCount == static_cast<UINT>(GLSLSymbols::count), E_GLSL_INVALIDDATA);
+
+    TSmartPointer<CGLSLConvertedShader> spShader;
+    CHK(RefCounted<CGLSLConvertedShader, MultiThreadedRefCount>::Create(/*out*/spShader));
+
+    UINT uErrorCount;
+    CHK(pReader->ReadUInt(&uErrorCount));
+    for (UINT i = 0; i < uErrorCount; i++)
+    {
+        TSmartPointer<CGLSLError> spError;
+        CHK(RefCounted<CGLSLError, MultiThreadedRefCount>::Create(pReader, /*out*/spError));
+        CHK(spShader->AppendError(spError));
+    }
+
+    // A shader with converted code never has errors
+    UINT uSucceeded;
+    CHK(pReader->ReadUInt(&uSucceeded));
+    CHKB_HR(uSucceeded == 0 || (uSucceeded == 1 && uErrorCount == 0), E_GLSL_INVALIDDATA);
+
+    const char* pszCode = nullptr;
+    UINT cchCode = 0;
+    if (uSucceeded == 1)
+    {
+        CHK(pReader->ReadString(&pszCode, &cchCode));
+    }
+
+    UINT uHasIdTable;
+    CHK(pReader->ReadUInt(&uHasIdTable));
+    CHKB_HR(uHasIdTable <= 1, E_GLSL_INVALIDDATA);
+
+    TSmartPointer<CGLSLIOStructInfo> spVaryingInfo;
+    if (uHasIdTable == 1)
+    {
+        TSmartPointer<CGLSLIdentifierTable> spIdTable;
+        CHK(serializer.ReadIdentifierTable(&spIdTable));
+        spShader->SetIdentifierTable(spIdTable);
+
+        UINT uHasVaryingInfo;
+        CHK(pReader->ReadUInt(&uHasVaryingInfo));
+        CHKB_HR(uHasVaryingInfo == 0 || (uHasVaryingInfo == 1 && uSucceeded == 1), E_GLSL_INVALIDDATA);
+
+        if (uHasVaryingInfo == 1)
+        {
+            CHK(RefCounted<CGLSLIOStructInfo, MultiThreadedRefCount>::Create(pReader, serializer._spSymbolTable, serializer._aryVariables, /*out*/spVaryingInfo));
+        }
+    }
+
+    CHKB_HR(pReader->IsAtEnd(), E_GLSL_INVALIDDATA);
+
+    if (uSucceeded == 1)
+    {
+        TSmartPointer<CMemoryStream> spConvertedStream;
+        CHK(RefCounted<CMemoryStream, MultiThreadedRefCount>::Create(/*out*/spConvertedStream));
+
+        // There are valid translations that result in no output
+        if (pszCode != nullptr && cchCode > 0)
+        {
+            CHK(spConvertedStream->WriteBuffer(pszCode, cchCode));
+        }
+
+        spShader->SetConverterOutput(spConvertedStream, spVaryingInfo);
+    }
+
+    (*ppShader) = spShader.Extract();
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   WriteIdentifierTable
+//
+//  Synopsis:   Writes the symbols that the shader added to the symbol table,
+//              then the records for every variable and struct type reachable
+//              from the table, then which variables are in the table's list.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLShaderSerializer::WriteIdentifierTable(
+    __in const CGLSLIdentifierTable* pIdTable                   // Table to write
+    )
+{
+    CHK_START;
+
+    // The known symbols are implied, so only the local ones are written, in
+    // index order so that restoring them gives the same indices.
+    CGLSLSymbolTable* pSymbolTable = pIdTable->UseSymbolTable();
+    UINT uSymbolCount = pSymbolTable->GetCount();
+    CHKB(uSymbolCount >= static_cast<UINT>(GLSLSymbols::count));
+
+    CHK(_pWriter->WriteUInt(uSymbolCount - GLSLSymbols::count));
+    for (UINT i = GLSLSymbols::count; i < uSymbolCount; i++)
+    {
+        CHK(_pWriter->WriteString(pSymbolTable->NameFromIndex(static_cast<int>(i))));
+    }
+
+    for (UINT i = 0; i < pIdTable->GetVariableCount(); i++)
+    {
+        CHK(WriteVariable(pIdTable->UseVariableInfo(i)));
+    }
+
+    // Struct types that no variable uses still need their typename
+    for (UINT i = 0; i < pIdTable->GetTypeNameCount(); i++)
+    {
+        TSmartPointer<GLSLType> spType;
+        CHK(pIdTable->UseTypeNameInfo(i)->GetType(&spType));
+        CHK(WriteStruct(spType->AsStructType()));
+    }
+
+    CHK(_pWriter->WriteUInt(EndOfRecords));
+
+    CHK(_pWriter->WriteUInt(pIdTable->GetVariableCount()));
+    for (UINT i = 0; i < pIdTable->GetVariableCount(); i++)
+    {
+        CHK(_pWriter->WriteUInt(FindVariableRecord(pIdTable->UseVariableInfo(i))));
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   WriteVariable
+//
+//  Synopsis:   Writes the record for a variable after the records for the
+//              struct types it depends on, unless it was already written.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLShaderSerializer::WriteVariable(
+    __in CVariableIdentifierInfo* pInfo                         // Variable to write
+    )
+{
+    CHK_START;
+
+    if (FindVariableRecord(pInfo) == _aryVariables.NotFound)
+    {
+        CHK(WriteTypeDependencies(pInfo->UseType()));
+
+        CHK(_pWriter->WriteUInt(VariableRecord));
+        CHK(WriteTypeReference(pInfo->UseType()));
+        CHK(pInfo->Serialize(_pWriter));
+
+        CHK(AddVariableRecord(pInfo));
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddVariableRecord
+//
+//  Synopsis:   Adds a written variable to the records and chains it to the
+//              other records with the same symbol index, so that finding the
+//              record for a variable only walks variables with its name.
+//              Variables without a symbol index are not chained.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLShaderSerializer::AddVariableRecord(
+    __in CVariableIdentifierInfo* pInfo                         // Variable that was written
+    )
+{
+    CHK_START;
+
+    int iSymbolIndex = pInfo->GetSymbolIndex();
+    UINT uPrevious = 0;
+    if (iSymbolIndex >= 0)
+    {
+        UINT uSymbolIndex = static_cast<UINT>(iSymbolIndex);
+        if (uSymbolIndex >= _aryLastVariableBySymbol.GetCount())
+        {
+            CHK(_aryLastVariableBySymbol.EnsureSize(uSymbolIndex + 1));
+        }
+
+        uPrevious = _aryLastVariableBySymbol[uSymbolIndex];
+    }
+
+    CHK(_aryVariables.Add(pInfo));
+    CHK(_aryPreviousVariableWithSymbol.Add(uPrevious));
+
+    if (iSymbolIndex >= 0)
+    {
+        _aryLastVariableBySymbol[iSymbolIndex] = _aryVariables.GetCount();
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   FindVariableRecord
+//
+//  Synopsis:   Returns the record index of a written variable, or NotFound
+//              if it has not been written yet.
+//
+//-----------------------------------------------------------------------------
+UINT CGLSLShaderSerializer::FindVariableRecord(
+    __in const CVariableIdentifierInfo* pInfo                   // Variable to look for
+    ) const
+{
+    int iSymbolIndex = pInfo->GetSymbolIndex();
+    if (iSymbolIndex < 0)
+    {
+        return _aryVariables.Find(const_cast<CVariableIdentifierInfo*>(pInfo));
+    }
+
+    if (static_cast<UINT>(iSymbolIndex) < _aryLastVariableBySymbol.GetCount())
+    {
+        for (UINT uRecord = _aryLastVariableBySymbol[iSymbolIndex]; uRecord != 0; uRecord = _aryPreviousVariableWithSymbol[uRecord - 1])
+        {
+            if (_aryVariables[uRecord - 1] == pInfo)
+            {
+                return uRecord - 1;
+            }
+        }
+    }
+
+    return _aryVariables.NotFound;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   WriteStruct
+//
+//  Synopsis:   Writes the record for a struct type after the records for its
+//              fields, unless it was already written. Nesting of struct
+//              types is limited, which bounds the recursion.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLShaderSerializer::WriteStruct(
+    __in StructGLSLType* pStructType                            // Struct type to write
+    )
+{
+    CHK_START;
+
+    if (_aryStructs.Find(pStructType) == _aryStructs.NotFound)
+    {
+        for (UINT i = 0; i < pStructType->GetFieldCount(); i++)
+        {
+            CHK(WriteVariable(pStructType->UseField(i)));
+        }
+
+        CHK(_pWriter->WriteUInt(StructRecord));
+        CHK(_pWriter->WriteUInt(pStructType->GetFieldCount()));
+        for (UINT i = 0; i < pStructType->GetFieldCount(); i++)
+        {
+            CHK(_pWriter->WriteUInt(FindVariableRecord(pStructType->UseField(i))));
+        }
+
+        CHK(_pWriter->WriteUInt(pStructType->IsConstructorUsed() ? 1 : 0));
+        CHK(_pWriter->WriteUInt(pStructType->IsEqualsOperatorUsed() ? 1 : 0));
+
+        const CTypeNameIdentifierInfo* pTypeNameInfo = pStructType->UseTypeNameInfo();
+        CHK(_pWriter->WriteUInt((pTypeNameInfo != nullptr) ? 1 : 0));
+        if (pTypeNameInfo != nullptr)
+        {
+            CHK(pTypeNameInfo->Serialize(_pWriter));
+        }
+
+        CHK(_aryStructs.Add(pStructType));
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   WriteTypeDependencies
+//
+//  Synopsis:   Writes the records for the struct type that a type is or is
+//              an array of, if any.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLShaderSerializer::WriteTypeDependencies(
+    __in GLSLType* pType                                        // Type to write dependencies of
+    )
+{
+    CHK_START;
+
+    if (pType->IsArrayType())
+    {
+        TSmartPointer<GLSLType> spElementType;
+        CHK(pType->GetArrayElementType(&spElementType));
+        CHK(WriteTypeDependencies(spElementType));
+    }
+    else if (pType->IsStructType())
+    {
+        CHK(WriteStruct(pType->AsStructType()));
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   WriteTypeReference
+//
+//  Synopsis:   Writes a type. Struct types are written as the index of their
+//              record, so their records must have been written already.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLShaderSerializer::WriteTypeReference(
+    __in GLSLType* pType                                        // Type to write
+    )
+{
+    CHK_START;
+
+    if (pType->IsBasicType())
+    {
+        int basicType;
+        CHK(pType->GetBasicType(&basicType));
+        CHK(_pWriter->WriteUInt(BasicTypeReference));
+        CHK(_pWriter->WriteInt(basicType));
+    }
+    else if (pType->IsArrayType())
+    {
+        int arraySize;
+        TSmartPointer<GLSLType> spElementType;
+        CHK(pType->GetArraySize(&arraySize));
+        CHK(pType->GetArrayElementType(&spElementType));
+        CHK(_pWriter->WriteUInt(ArrayTypeReference));
+        CHK(_pWriter->WriteInt(arraySize));
+        CHK(WriteTypeReference(spElementType));
+    }
+    else
+    {
+        UINT uStruct = _aryStructs.Find(pType->AsStructType());
+        CHKB(uStruct != _aryStructs.NotFound);
+
+        CHK(_pWriter->WriteUInt(StructTypeReference));
+        CHK(_pWriter->WriteUInt(uStruct));
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   ReadIdentifierTable
+//
+//  Synopsis:   Restores the symbol table and the identifier table written by
+//              WriteIdentifierTable.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLShaderSerializer::ReadIdentifierTable(
+    __deref_out CGLSLIdentifierTable** ppIdTable                // Restored table
+    )
+{
+    CHK_START;
+
+    CHK(RefCounted<CGLSLSymbolTable, MultiThreadedRefCount>::Create(true, /*out*/_spSymbolTable));
+
+    UINT uLocalSymbolCount;
+    CHK(_pReader->ReadUInt(&uLocalSymbolCount));
+    for (UINT i = 0; i < uLocalSymbolCount; i++)
+    {
+        const char* pszSymbol;
+        CHK(_pReader->ReadString(&pszSymbol));
+        CHKB_HR(pszSymbol != nullptr, E_GLSL_INVALIDDATA);
+
+        // A symbol that is known or repeated would not get the next index
+        int index;
+        CHK(_spSymbolTable->EnsureSymbolIndex(pszSymbol, &index));
+        CHKB_HR(index == static_cast<int>(GLSLSymbols::count + i), E_GLSL_INVALIDDATA);
+    }
+
+    CHK(RefCounted<CGLSLIdentifierTable, MultiThreadedRefCount>::Create(static_cast<CGLSLSymbolTable*>(_spSymbolTable), /*out*/_spIdTable));
+
+    for (;;)
+    {
+        UINT uTag;
+        CHK(_pReader->ReadUInt(&uTag));
+
+        if (uTag == EndOfRecords)
+        {
+            break;
+        }
+        else if (uTag == VariableRecord)
+        {
+            CHK(ReadVariable());
+        }
+        else
+        {
+            CHKB_HR(uTag == StructRecord, E_GLSL_INVALIDDATA);
+            CHK(ReadStruct());
+        }
+    }
+
+    UINT uVariableCount;
+    CHK(_pReader->ReadUInt(&uVariableCount));
+    for (UINT i = 0; i < uVariableCount; i++)
+    {
+        UINT uVariable;
+        CHK(_pReader->ReadUInt(&uVariable));
+        CHKB_HR(uVariable < _aryVariables.GetCount(), E_GLSL_INVALIDDATA);
+
+        CHK(_spIdTable->AddVariableInfo(_aryVariables[uVariable]));
+    }
+
+    _spIdTable.CopyTo(ppIdTable);
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   ReadVariable
+//
+//  Synopsis:   Restores a variable record.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLShaderSerializer::ReadVariable()
+{
+    CHK_START;
+
+    TSmartPointer<GLSLType> spType;
+    CHK(ReadTypeReference(/*fAllowArray*/true, &spType));
+
+    TSmartPointer<CVariableIdentifierInfo> spInfo;
+    CHK(RefCounted<CVariableIdentifierInfo, MultiThreadedRefCount>::Create(_pReader, static_cast<GLSLType*>(spType), /*out*/spInfo));
+
+    // Names are looked up by symbol index, so it has to be in the table
+    CHKB_HR(spInfo->GetSymbolIndex() >= 0 && static_cast<UINT>(spInfo->GetSymbolIndex()) < _spSymbolTable->GetCount(), E_GLSL_INVALIDDATA);
+
+    CHK(_aryVariables.Add(spInfo));
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   ReadStruct
+//
+//  Synopsis:   Restores a struct type record along with its typename. Struct
+//              types are created the same way the parser creates them, so
+//              the nesting limit is enforced again here.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLShaderSerializer::ReadStruct()
+{
+    CHK_START;
+
+    UINT uFieldCount;
+    CHK(_pReader->ReadUInt(&uFieldCount));
+    CHKB_HR(uFieldCount > 0 && uFieldCount <= _aryVariables.GetCount(), E_GLSL_INVALIDDATA);
+
+    CModernArray<TSmartPointer<IIdentifierInfo>> aryFields;
+    for (UINT i = 0; i < uFieldCount; i++)
+    {
+        UINT uVariable;
+        CHK(_pReader->ReadUInt(&uVariable));
+        CHKB_HR(uVariable < _aryVariables.GetCount(), E_GLSL_INVALIDDATA);
+
+        TSmartPointer<IIdentifierInfo> spField = static_cast<CVariableIdentifierInfo*>(_aryVariables[uVariable]);
+        CHK(aryFields.Add(spField));
+    }
+
+    UINT uConstructorUsed;
+    UINT uEqualsOperatorUsed;
+    UINT uHasTypeName;
+    CHK(_pReader->ReadUInt(&uConstructorUsed));
+    CHK(_pReader->ReadUInt(&uEqualsOperatorUsed));
+    CHK(_pReader->ReadUInt(&uHasTypeName));
+
+    TSmartPointer<StructGLSLType> spStructType;
+    CHK(GLSLType::CreateStructTypeFromIdentifierInfoAry(aryFields, &spStructType));
+
+    if (uConstructorUsed != 0)
+    {
+        spStructType->SetConstructorUsed();
+    }
+
+    if (uEqualsOperatorUsed != 0)
+    {
+        spStructType->SetEqualsOperatorUsed();
+    }
+
+    if (uHasTypeName != 0)
+    {
+        TSmartPointer<CTypeNameIdentifierInfo> spTypeNameInfo;
+        CHK(RefCounted<CTypeNameIdentifierInfo, MultiThreadedRefCount>::Create(_pReader, static_cast<GLSLType*>(spStructType), /*out*/spTypeNameInfo));
+        CHKB_HR(spTypeNameInfo->GetSymbolIndex() >= 0 && static_cast<UINT>(spTypeNameInfo->GetSymbolIndex()) < _spSymbolTable->GetCount(), E_GLSL_INVALIDDATA);
+
+        // The identifier table keeps the typename alive for the pointer that
+        // the struct type has back to it.
+        spStructType->FinalizeTypeWithTypeInfo(spTypeNameInfo);
+        CHK(_spIdTable->AddTypeNameInfo(spTypeNameInfo));
+    }
+
+    CHK(_aryStructs.Add(spStructType));
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   ReadTypeReference
+//
+//  Synopsis:   Restores a type written by WriteTypeReference. GLSL ES has no
+//              arrays of arrays, so an array element cannot be an array.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLShaderSerializer::ReadTypeReference(
+    bool fAllowArray,                                           // Whether an array type may appear here
+    __deref_out GLSLType** ppType                               // Type that was referred to
+    )
+{
+    CHK_START;
+
+    UINT uTag;
+    CHK(_pReader->ReadUInt(&uTag));
+
+    if (uTag == BasicTypeReference)
+    {
+        int basicType;
+        CHK(_pReader->ReadInt(&basicType));
+        CHKB_HR(BasicGLSLTypeInfo::IsKnownType(basicType), E_GLSL_INVALIDDATA);
+
+        CHK(GLSLType::CreateFromBasicTypeToken(basicType, ppType));
+    }
+    else if (uTag == ArrayTypeReference)
+    {
+        int arraySize;
+        CHK(_pReader->ReadInt(&arraySize));
+        CHKB_HR(fAllowArray && arraySize > 0, E_GLSL_INVALIDDATA);
+
+        TSmartPointer<GLSLType> spElementType;
+        CHK(ReadTypeReference(/*fAllowArray*/false, &spElementType));
+        CHK(GLSLType::CreateFromType(spElementType, arraySize, ppType));
+    }
+    else
+    {
+        UINT uStruct;
+        CHKB_HR(uTag == StructTypeReference, E_GLSL_INVALIDDATA);
+        CHK(_pReader->ReadUInt(&uStruct));
+        CHKB_HR(uStruct < _aryStructs.GetCount(), E_GLSL_INVALIDDATA);
+
+        TSmartPointer<GLSLType> spType = static_cast<StructGLSLType*>(_aryStructs[uStruct]);
+        spType.CopyTo(ppType);
+    }
+
+    CHK_RETURN;
+}
@@ -0,0 +1,133 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#pragma once
+
+#include <foundation/collections.hxx>
+
+class CGLSLConvertedShader;
+class CGLSLIdentifierTable;
+class CGLSLSymbolTable;
+class CGLSLBinaryWriter;
+class CGLSLBinaryReader;
+class CVariableIdentifierInfo;
+class GLSLType;
+class StructGLSLType;
+
+//+-----------------------------------------------------------------------------
+//
+//  Class:      CGLSLShaderSerializer
+//
+//  Synopsis:   Writes a converted shader to a flat binary format and restores
+//              it, so that translations can be persisted across processes.
+//
+//              Everything that consumers of a converted shader use is kept:
+//              the errors, the HLSL, the variable and typename identifiers
+//              with their types, and the varying struct info used for
+//              linking. The parse tree is not kept.
+//
+//              Types are shared between identifiers and struct types refer
+//              to their field identifiers, so identifiers and struct types
+//              are written as one stream of records in dependency order, and
+//              later records refer to earlier ones by index. Restoring
+//              validates every index, count and enum, so that corrupt data
+//              fails with E_GLSL_INVALIDDATA instead of producing a shader
+//              that points outside of its tables.
+//
+//------------------------------------------------------------------------------
+class CGLSLShaderSerializer
+{
+public:
+    static HRESULT Serialize(
+        __in const CGLSLConvertedShader* pShader,                           // Shader to write
+        __inout CGLSLBinaryWriter* pWriter                                  // Where to write the shader
+        );
+
+    static HRESULT Deserialize(
+        __inout CGLSLBinaryReader* pReader,                                 // Reader positioned at data written by Serialize
+        __deref_out CGLSLConvertedShader** ppShader                         // Restored shader
+        );
+
+private:
+    CGLSLShaderSerializer();
+
+    HRESULT WriteIdentifierTable(__in const CGLSLIdentifierTable* pIdTable);
+    HRESULT WriteVariable(__in CVariableIdentifierInfo* pInfo);
+    HRESULT AddVariableRecord(__in CVariableIdentifierInfo* pInfo);
+    UINT FindVariableRecord(__in const CVariableIdentifierInfo* pInfo) const;
+    HRESULT WriteStruct(__in StructGLSLType* pStructType);
+    HRESULT WriteTypeDependencies(__in GLSLType* pType);
+    HRESULT WriteTypeReference(__in const GLSLType* pType);
+
+    HRESULT ReadIdentifierTable(__deref_out CGLSLIdentifierTable** ppIdTable);
+    HRESULT ReadVariable();
+    HRESULT ReadStruct();
+    HRESULT ReadTypeReference(
+        bool fAllowArray,                                                   // Whether an array type may appear here
+        __deref_out GLSLType** ppType                                       // Type that was referred to
+        );
+
+private:
+    //+-------------------------------------------------------------------------
+    //
+    //  Enum:       RecordTag
+    //
+    //  Synopsis:   Identifies the records in the identifier stream.
+    //
+    //--------------------------------------------------------------------------
+    enum RecordTag : UINT
+    {
+        EndOfRecords = 0,
+        VariableRecord = 1,
+        StructRecord = 2,
+    };
+
+    //+-------------------------------------------------------------------------
+    //
+    //  Enum:       TypeTag
+    //
+    //  Synopsis:   Identifies the kind of type in a type reference.
+    //
+    //--------------------------------------------------------------------------
+    enum TypeTag : UINT
+    {
+        BasicTypeReference = 1,
+        ArrayTypeReference = 2,
+        StructTypeReference = 3,
+    };
+
+    static const UINT s_uMagic = 0x48534C47;                                // 'GLSH'
+    static const UINT s_uVersion = 1;                                       // Bump when the format or the parser tokens change
+
+    CGLSLBinaryWriter* _pWriter;                                            // Writer when serializing
+    CGLSLBinaryReader* _pReader;                                            // Reader when deserializing
+    TSmartPointer<CGLSLSymbolTable> _spSymbolTable;                         // Symbol table being restored
+    TSmartPointer<CGLSLIdentifierTable> _spIdTable;                         // Identifier table being restored
+    CModernArray<TSmartPointer<CVariableIdentifierInfo>> _aryVariables;    // Variables written or read so far, by record index
+    CModernArray<TSmartPointer<StructGLSLType>> _aryStructs;               // Struct types written or read so far, by record index
+    CModernArray<UINT> _aryLastVariableBySymbol;                            // One-based index of the last variable record written for each symbol index
+    CModernArray<UINT> _aryPreviousVariableWithSymbol;                      // One-based index of the previous variable record with the same symbol
+};
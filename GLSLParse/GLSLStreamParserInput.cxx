@@ -32,10 +32,24 @@
 //  Function:   Constructor
 //
 //-----------------------------------------------------------------------------
-CGLSLStreamParserInput::CGLSLStreamParserInput()
+CGLSLStreamParserInput::CGLSLStreamParserInput() :
+    _fLocked(false)
 {
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   Destructor
+//
+//-----------------------------------------------------------------------------
+CGLSLStreamParserInput::~CGLSLStreamParserInput()
+{
+    if (_fLocked)
+    {
+        _spInput->UnlockScanBuffer();
+    }
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   Initialize
@@ -59,17 +73,59 @@ HRESULT CGLSLStreamParserInput::Initialize(__in CMemoryStream* pInput)
 //
 //  Function:   PullInput
 //
-//  Synopsis:   Method called by tokenizer to get more input.
+//  Synopsis:   Method called by tokenizer to get more input. Reads as much
+//              of the stream as fits in the buffer with a single call.
 //
 //-----------------------------------------------------------------------------
-int CGLSLStreamParserInput::PullInput(__out_ecount(1) char* buf)
+int CGLSLStreamParserInput::PullInput(__out_ecount_part(maxSize, return) char* buf, int maxSize)
 {
-    if (SUCCEEDED(_spInput->ReadChar(buf)))
+    UINT uRead;
+    if (maxSize > 0 && SUCCEEDED(_spInput->Read(buf, static_cast<UINT>(maxSize), &uRead)))
     {
-        return 1;
+        return static_cast<int>(uRead);
     }
     else
     {
         return 0; // YY_NULL
     }
 }
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetScanBuffer
+//
+//  Synopsis:   Hand the stream memory to the scanner to be scanned in place.
+//              It stays locked until this input goes away.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLStreamParserInput::GetScanBuffer(
+    __deref_out_ecount(*puSize) char** ppBuffer,                // Buffer ending in two null characters
+    __out UINT* puSize                                          // Size of the buffer, including both nulls
+    )
+{
+    CHK_START;
+
+    CHKB(!_fLocked);
+
+    CHK(_spInput->LockScanBuffer(ppBuffer, puSize));
+    _fLocked = true;
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   ReleaseScanBuffer
+//
+//  Synopsis:   Unlock the stream memory handed out by GetScanBuffer when the
+//              scanner could not use it.
+//
+//-----------------------------------------------------------------------------
+void CGLSLStreamParserInput::ReleaseScanBuffer()
+{
+    if (_fLocked)
+    {
+        _spInput->UnlockScanBuffer();
+        _fLocked = false;
+    }
+}
@@ -41,12 +41,21 @@ class CGLSLStreamParserInput : public IParserInput
 {
 public:
     CGLSLStreamParserInput();
+    ~CGLSLStreamParserInput();
 
     HRESULT Initialize(__in CMemoryStream* pInput);
 
     // IParserInput implementation
-    int PullInput(__out_ecount(1) char* buf) override;
+    int PullInput(__out_ecount_part(maxSize, return) char* buf, int maxSize) override;
+
+    HRESULT GetScanBuffer(
+        __deref_out_ecount(*puSize) char** ppBuffer,                // Buffer ending in two null characters
+        __out UINT* puSize                                          // Size of the buffer, including both nulls
+        ) override;
+
+    void ReleaseScanBuffer() override;
 
 private:
     TSmartPointer<CMemoryStream> _spInput;                          // Input stream
+    bool _fLocked;                                                  // Whether the stream memory is locked for scanning
 };
@@ -34,6 +34,7 @@
 //-----------------------------------------------------------------------------
 CGLSLStringParserInput::CGLSLStringParserInput() : 
     _uReadPos(0),
+    _pszInput(nullptr),
     _uInputSize(0)
 {
 }
@@ -42,15 +43,49 @@ CGLSLStringParserInput::CGLSLStringParserInput() :
 //
 //  Function:   Initialize
 //
-//  Synopsis:   Initialize from the given string.
+//  Synopsis:   Initialize from a copy of the given string.
 //
 //-----------------------------------------------------------------------------
 HRESULT CGLSLStringParserInput::Initialize(__in_ecount(uInputSize + 1) char* pszInput, UINT uInputSize)
+{
+    return Initialize(pszInput, uInputSize, true);
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Initialize
+//
+//  Synopsis:   Initialize from the given string, either copying it or
+//              referencing the caller's buffer. A referenced buffer must
+//              already end in the two nulls that in place scanning needs;
+//              a copy gets them added.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLStringParserInput::Initialize(
+    __in_ecount(uInputSize + 2) char* pszInput,                 // Input, followed by two null characters if not copied
+    UINT uInputSize,                                            // Length of the input, not including the nulls
+    bool fCopyInput                                             // Whether to copy the input or reference it
+    )
 {
     CHK_START;
 
-    CHK(_spInput.New(uInputSize + 1));
-    CHK(::StringCchCopyA(_spInput, uInputSize + 1, pszInput));
+    CHKB(uInputSize <= UINT_MAX - 2);
+
+    if (fCopyInput)
+    {
+        CHK(_spInputCopy.New(uInputSize + 2));
+        ::memcpy(_spInputCopy, pszInput, uInputSize);
+        _spInputCopy[uInputSize] = '\0';
+        _spInputCopy[uInputSize + 1] = '\0';
+
+        _pszInput = _spInputCopy;
+    }
+    else
+    {
+        CHKB(pszInput[uInputSize] == '\0' && pszInput[uInputSize + 1] == '\0');
+
+        _pszInput = pszInput;
+    }
 
     _uInputSize = uInputSize;
 
@@ -61,19 +96,58 @@ HRESULT CGLSLStringParserInput::Initialize(__in_ecount(uInputSize + 1) char* psz
 //
 //  Function:   PullInput
 //
-//  Synopsis:   Method called by tokenizer to get more input.
+//  Synopsis:   Method called by tokenizer to get more input. Copies as much
+//              of the remaining string as fits in the buffer.
 //
 //-----------------------------------------------------------------------------
-int CGLSLStringParserInput::PullInput(__out_ecount(1) char* buf)
+int CGLSLStringParserInput::PullInput(__out_ecount_part(maxSize, return) char* buf, int maxSize)
 {
-    if (_uReadPos < _uInputSize)
+    Assert(_uReadPos <= _uInputSize);
+
+    if (maxSize <= 0)
     {
-        buf[0] = _spInput[_uReadPos];
-        _uReadPos++;
-        return 1;
+        return 0; // YY_NULL
     }
-    else
+
+    UINT uToCopy = min(_uInputSize - _uReadPos, static_cast<UINT>(maxSize));
+    if (uToCopy != 0)
     {
-        return 0; // YY_NULL
+        ::memcpy(buf, _pszInput + _uReadPos, uToCopy);
+        _uReadPos += uToCopy;
     }
+
+    // 0 is YY_NULL when the string is exhausted
+    return static_cast<int>(uToCopy);
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetScanBuffer
+//
+//  Synopsis:   Hand our string to the scanner to be scanned in place.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLStringParserInput::GetScanBuffer(
+    __deref_out_ecount(*puSize) char** ppBuffer,                // Buffer ending in two null characters
+    __out UINT* puSize                                          // Size of the buffer, including both nulls
+    )
+{
+    // Scanning in place and pulling input do not mix
+    Assert(_uReadPos == 0);
+
+    (*ppBuffer) = _pszInput;
+    (*puSize) = _uInputSize + 2;
+
+    return S_OK;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   ReleaseScanBuffer
+//
+//  Synopsis:   Nothing is held while our string is being scanned.
+//
+//-----------------------------------------------------------------------------
+void CGLSLStringParserInput::ReleaseScanBuffer()
+{
 }
@@ -35,6 +35,10 @@
 //  Synopsis:   This class encapsulates the logic for pulling input into the
 //              Bison / Flex code from a given ASCII string.
 //
+//              By default the string is copied. Callers that own a buffer
+//              that outlives the input and ends in two null characters can
+//              have it referenced instead, so it is scanned without a copy.
+//
 //------------------------------------------------------------------------------
 class CGLSLStringParserInput : public IParserInput
 {
@@ -43,12 +47,26 @@ public:
 
     HRESULT Initialize(__in_ecount(uInputSize + 1) char* pszInput, UINT uInputSize);
 
+    HRESULT Initialize(
+        __in_ecount(uInputSize + 2) char* pszInput,                 // Input, followed by two null characters if not copied
+        UINT uInputSize,                                            // Length of the input, not including the nulls
+        bool fCopyInput                                             // Whether to copy the input or reference it
+        );
+
     // IParserInput implementation
-    int PullInput(__out_ecount(1) char* buf) override;
+    int PullInput(__out_ecount_part(maxSize, return) char* buf, int maxSize) override;
+
+    HRESULT GetScanBuffer(
+        __deref_out_ecount(*puSize) char** ppBuffer,                // Buffer ending in two null characters
+        __out UINT* puSize                                          // Size of the buffer, including both nulls
+        ) override;
+
+    void ReleaseScanBuffer() override;
 
 private:
     // Bison / flex integration
     UINT _uReadPos;                                                 // Our read position
-    TSmartArray<char> _spInput;                                     // Our input string
+    TSmartArray<char> _spInputCopy;                                 // Our copy of the input, if we made one
+    char* _pszInput;                                                // Our input string, followed by two nulls
     UINT _uInputSize;                                               // Length of the input
 };
@@ -31,17 +31,49 @@
 //
 //  Function:   Initialize
 //
-//  Synopsis:   Initialize the acceleration structure used for lookup.
+//  Synopsis:   Initialize an empty table that does not include the known
+//              symbols.
 //
 //-----------------------------------------------------------------------------
 HRESULT CGLSLSymbolTable::Initialize()
 {
-    for (int i = 0; i < 128; i++)
+    return Initialize(false);
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Initialize
+//
+//  Synopsis:   Initialize the hash buckets used for lookup. When the known
+//              symbols are included, the shared known symbol table is
+//              consulted first and symbols added here are numbered after it,
+//              so that casting a GLSLSymbols enum to int gives its index.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLSymbolTable::Initialize(
+    bool fIncludeKnownSymbols               // Whether indices start after the known symbols
+    )
+{
+    CHK_START;
+
+    if (fIncludeKnownSymbols)
     {
-        _rgSymbolExists[i] = false;
+        _pKnownSymbols = &GetKnownSymbolTable();
+        _iFirstLocalIndex = GLSLSymbols::count;
+    }
+    else
+    {
+        _pKnownSymbols = nullptr;
+        _iFirstLocalIndex = 0;
     }
 
-    return S_OK;
+    CHK(_aryBuckets.Resize(s_uInitialBucketCount));
+    for (UINT i = 0; i < _aryBuckets.GetCount(); i++)
+    {
+        _aryBuckets[i] = s_iEmptyBucket;
+    }
+
+    CHK_RETURN;
 }
 
 //+----------------------------------------------------------------------------
@@ -59,14 +91,45 @@ HRESULT CGLSLSymbolTable::EnsureSymbolIndex(
 {
     CHK_START;
 
-    // If we did not find it, then add it
-    if (FAILED(LookupSymbolIndex(pszSymbol, pIndex)))
+    CHKB(pszSymbol[0] >= 0 && pszSymbol[0] < 128);
+
+    UINT uLength;
+    UINT uHash = ComputeHash(pszSymbol, &uLength);
+
+    UINT uBucket;
+    if (_pKnownSymbols != nullptr && _pKnownSymbols->Find(pszSymbol, uHash, uLength, pIndex))
     {
-        CHKB(pszSymbol[0] >= 0 && pszSymbol[0] < 128);
+        // Known symbols are never added to this table
+    }
+    else if (FindBucket(pszSymbol, uHash, uLength, &uBucket))
+    {
+        (*pIndex) = _iFirstLocalIndex + _aryBuckets[uBucket];
+    }
+    else
+    {
+        // If we did not find it, then add it. The bucket we got back is the
+        // first empty one in the probe sequence, which is where it belongs.
+        SymbolHashInfo hashInfo = { uHash, uLength };
+
+        // The symbol list and the hash info are parallel arrays, so make room
+        // in both before adding to either to keep them in step.
+        CHK(_rgSymbolList.EnsureCapacityForNextElement());
+        CHK(_aryHashInfo.EnsureCapacityForNextElement());
 
         CHK(_rgSymbolList.Add(pszSymbol));
-        _rgSymbolExists[pszSymbol[0]] = true;
-        (*pIndex) = static_cast<int>(_rgSymbolList.GetCount() - 1);
+        CHK(_aryHashInfo.Add(hashInfo));
+
+        int newIndex = static_cast<int>(_rgSymbolList.GetCount() - 1);
+        _aryBuckets[uBucket] = newIndex;
+        newIndex += _iFirstLocalIndex;
+
+        // Keep the load factor at or below one half so probe sequences stay short
+        if (_rgSymbolList.GetCount() * 2 > _aryBuckets.GetCount())
+        {
+            CHK(GrowBuckets());
+        }
+
+        (*pIndex) = newIndex;
     }
 
     CHK_RETURN;
@@ -76,7 +139,7 @@ HRESULT CGLSLSymbolTable::EnsureSymbolIndex(
 //
 //  Function:   LookupSymbolIndex
 //
-//  Synopsis:   Look up or add a symbol to the symbol table. Do not call with
+//  Synopsis:   Look up a symbol in the symbol table. Do not call with
 //              strings that have characters outside of ASCII 0-127.
 //
 //-----------------------------------------------------------------------------
@@ -89,24 +152,215 @@ HRESULT CGLSLSymbolTable::LookupSymbolIndex(
 
     CHKB(pszSymbol[0] >= 0 && pszSymbol[0] < 128);
 
-    bool fFound = false;
+    UINT uLength;
+    UINT uHash = ComputeHash(pszSymbol, &uLength);
+
+    if (_pKnownSymbols == nullptr || !_pKnownSymbols->Find(pszSymbol, uHash, uLength, pIndex))
+    {
+        UINT uBucket;
+        CHKB_HR(FindBucket(pszSymbol, uHash, uLength, &uBucket), E_INVALIDARG);
+
+        (*pIndex) = _iFirstLocalIndex + _aryBuckets[uBucket];
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   ComputeHash
+//
+//  Synopsis:   FNV-1a hash of the symbol, computing the length along the way
+//              so that callers do not need a separate strlen.
+//
+//-----------------------------------------------------------------------------
+UINT CGLSLSymbolTable::ComputeHash(
+    __in_z const char* pszSymbol,           // Symbol to hash
+    __out UINT* puLength                    // Length of the symbol
+    )
+{
+    UINT uHash = 2166136261U;
+
+    const char* pszCurrent = pszSymbol;
+    while (*pszCurrent != '\0')
+    {
+        uHash ^= static_cast<unsigned char>(*pszCurrent);
+        uHash *= 16777619U;
+        pszCurrent++;
+    }
+
+    (*puLength) = static_cast<UINT>(pszCurrent - pszSymbol);
+
+    return uHash;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetKnownSymbolTable
+//
+//  Synopsis:   Get the process-wide known symbol table. It is built on first
+//              use (the static local makes that thread safe) and never
+//              changes afterwards, so it can be read without locking.
+//
+//-----------------------------------------------------------------------------
+const CGLSLSymbolTable::KnownSymbolTable& CGLSLSymbolTable::GetKnownSymbolTable()
+{
+    static const KnownSymbolTable s_knownSymbols;
+
+    return s_knownSymbols;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   KnownSymbolTable constructor
+//
+//  Synopsis:   Hash every GLSLSymbols entry into the fixed bucket array. The
+//              table is sized at compile time so building it cannot fail.
+//
+//-----------------------------------------------------------------------------
+CGLSLSymbolTable::KnownSymbolTable::KnownSymbolTable()
+{
+    static_assert(s_uBucketCount >= 2 * GLSLSymbols::count, "Known symbol buckets must keep the load factor at or below one half");
+
+    for (UINT i = 0; i < s_uBucketCount; i++)
+    {
+        _rgBuckets[i] = s_iEmptyBucket;
+    }
+
+    const UINT uMask = s_uBucketCount - 1;
+    for (int i = 0; i < GLSLSymbols::count; i++)
+    {
+        GLSLSymbols::Enum known = static_cast<GLSLSymbols::Enum>(i);
+        const GLSLSymbolInfo &info = GLSLKnownSymbols::GetKnownInfo<GLSLSymbolInfo>(known);
+
+        _rgHashInfo[i]._uHash = ComputeHash(info._pGLSLName, &_rgHashInfo[i]._uLength);
+
+        UINT uBucket = _rgHashInfo[i]._uHash & uMask;
+        while (_rgBuckets[uBucket] != s_iEmptyBucket)
+        {
+            // Every known symbol must be distinct for the enum to be its index
+            Assert(::strcmp(GLSLSymbolInfo::s_info[_rgBuckets[uBucket]]._pGLSLName, info._pGLSLName) != 0);
+
+            uBucket = (uBucket + 1) & uMask;
+        }
 
-    // We first check if there are any symbols that start with the same char
-    if (_rgSymbolExists[pszSymbol[0]])
+        _rgBuckets[uBucket] = i;
+    }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   KnownSymbolTable::Find
+//
+//  Synopsis:   Look up a symbol in the known symbol table, returning its
+//              GLSLSymbols value as the index.
+//
+//-----------------------------------------------------------------------------
+bool CGLSLSymbolTable::KnownSymbolTable::Find(
+    __in_z const char* pszSymbol,           // Symbol to find
+    UINT uHash,                             // Hash of the symbol
+    UINT uLength,                           // Length of the symbol
+    __out int* pIndex                       // Index of the known symbol
+    ) const
+{
+    const UINT uMask = s_uBucketCount - 1;
+
+    UINT uBucket = uHash & uMask;
+    for (;;)
     {
-        // Now search everything
-        for (UINT i = 0; i < _rgSymbolList.GetCount(); i++)
+        int index = _rgBuckets[uBucket];
+        if (index == s_iEmptyBucket)
         {
-            if (::strcmp(_rgSymbolList[i], pszSymbol) == 0)
-            {
-                (*pIndex) = static_cast<int>(i);
-                fFound = true;
-                break;
-            }
+            return false;
         }
+
+        if (_rgHashInfo[index]._uHash == uHash &&
+            _rgHashInfo[index]._uLength == uLength &&
+            ::memcmp(GLSLSymbolInfo::s_info[index]._pGLSLName, pszSymbol, uLength) == 0)
+        {
+            (*pIndex) = index;
+            return true;
+        }
+
+        uBucket = (uBucket + 1) & uMask;
     }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   FindBucket
+//
+//  Synopsis:   Walk the probe sequence for the given symbol. Returns true and
+//              the bucket holding the symbol if it is in the table, or false
+//              and the first empty bucket in the sequence if it is not.
+//
+//-----------------------------------------------------------------------------
+bool CGLSLSymbolTable::FindBucket(
+    __in_z const char* pszSymbol,           // Symbol to find
+    UINT uHash,                             // Hash of the symbol
+    UINT uLength,                           // Length of the symbol
+    __out UINT* puBucket                    // Bucket holding the symbol, or first empty bucket
+    ) const
+{
+    // Bucket count is a power of 2, and the load factor is kept below one so
+    // there is always an empty bucket to terminate the probe.
+    const UINT uMask = _aryBuckets.GetCount() - 1;
 
-    CHKB_HR(fFound, E_INVALIDARG);
+    UINT uBucket = uHash & uMask;
+    for (;;)
+    {
+        int index = _aryBuckets[uBucket];
+        if (index == s_iEmptyBucket)
+        {
+            (*puBucket) = uBucket;
+            return false;
+        }
+
+        const SymbolHashInfo& hashInfo = _aryHashInfo[index];
+        if (hashInfo._uHash == uHash &&
+            hashInfo._uLength == uLength &&
+            ::memcmp(_rgSymbolList[index], pszSymbol, uLength) == 0)
+        {
+            (*puBucket) = uBucket;
+            return true;
+        }
+
+        uBucket = (uBucket + 1) & uMask;
+    }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GrowBuckets
+//
+//  Synopsis:   Double the number of hash buckets and reinsert every symbol.
+//              Symbol indices are unchanged since only the buckets move.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLSymbolTable::GrowBuckets()
+{
+    CHK_START;
+
+    const UINT uNewCount = _aryBuckets.GetCount() * 2;
+    CHKB(uNewCount > _aryBuckets.GetCount());
+
+    CHK(_aryBuckets.Resize(uNewCount));
+    for (UINT i = 0; i < uNewCount; i++)
+    {
+        _aryBuckets[i] = s_iEmptyBucket;
+    }
+
+    const UINT uMask = uNewCount - 1;
+    for (UINT i = 0; i < _aryHashInfo.GetCount(); i++)
+    {
+        UINT uBucket = _aryHashInfo[i]._uHash & uMask;
+        while (_aryBuckets[uBucket] != s_iEmptyBucket)
+        {
+            uBucket = (uBucket + 1) & uMask;
+        }
+
+        _aryBuckets[uBucket] = static_cast<int>(i);
+    }
 
     CHK_RETURN;
 }
@@ -122,7 +376,36 @@ const char* CGLSLSymbolTable::NameFromIndex(
     int index                                                           // Index of symbol
     ) const
 {
-    Assert(index >=0 && index < (int)_rgSymbolList.GetCount());
+    Assert(index >=0 && index < static_cast<int>(GetCount()));
+
+    if (index < _iFirstLocalIndex)
+    {
+        return GLSLSymbolInfo::s_info[index]._pGLSLName;
+    }
+
+    return _rgSymbolList[index - _iFirstLocalIndex];
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetMemorySize
+//
+//  Synopsis:   Returns the approximate memory retained by the table. The known
+//              symbols are shared by the process and not counted.
+//
+//-----------------------------------------------------------------------------
+UINT CGLSLSymbolTable::GetMemorySize() const
+{
+    UINT cbMemorySize = sizeof(*this);
+
+    cbMemorySize += _rgSymbolList.GetCapacity() * sizeof(CSmartSTR);
+    cbMemorySize += _aryHashInfo.GetCapacity() * sizeof(SymbolHashInfo);
+    cbMemorySize += _aryBuckets.GetCapacity() * sizeof(int);
+
+    for (UINT i = 0; i < _aryHashInfo.GetCount(); i++)
+    {
+        cbMemorySize += _aryHashInfo[i]._uLength + 1;
+    }
 
-    return _rgSymbolList[index];
+    return cbMemorySize;
 }
@@ -36,9 +36,17 @@
 //
 //  Synopsis:   Class to encapsulate the symbol table for the GLSL parse tree.
 //
-//              The implementation of the table is an array of strings, with
-//              the addition of a lookup array that indicates for each ASCII
-//              codepoint if an entry starting with that codepoint exists.
+//              The implementation of the table is an array of strings, where
+//              the index of a string in the array is the symbol index. Lookup
+//              goes through an open addressing hash table (linear probing)
+//              whose buckets hold indices into the string array, so symbol
+//              indices stay dense and stable as the table grows.
+//
+//              A table can be layered on top of the known GLSL symbols. The
+//              known symbols live in a process-wide immutable table that is
+//              built once, so they occupy indices 0 to GLSLSymbols::count - 1
+//              without being copied into every table. Symbols added to the
+//              table itself start at GLSLSymbols::count.
 //
 //------------------------------------------------------------------------------
 class CGLSLSymbolTable : public IUnknown
@@ -58,10 +66,71 @@ public:
         int index                                                           // Index of symbol
         ) const;
 
+    UINT GetCount() const { return _iFirstLocalIndex + _rgSymbolList.GetCount(); }
+    UINT GetMemorySize() const;
+
 protected:
     HRESULT Initialize();
 
+    HRESULT Initialize(
+        bool fIncludeKnownSymbols                                           // Whether indices start after the known symbols
+        );
+
 private:
-    CModernArray<CSmartSTR, CSmartStringTraits<CSmartSTR>> _rgSymbolList;   // The current list of symbols
-    bool _rgSymbolExists[128];                                              // Map of ASCII char to symbol existence
+    struct SymbolHashInfo
+    {
+        UINT _uHash;                                                        // Hash of the symbol
+        UINT _uLength;                                                      // Length of the symbol, not including null
+    };
+
+    static UINT ComputeHash(
+        __in_z const char* pszSymbol,                                       // Symbol to hash
+        __out UINT* puLength                                                // Length of the symbol
+        );
+
+    //+-------------------------------------------------------------------------
+    //
+    //  Struct:     KnownSymbolTable
+    //
+    //  Synopsis:   Immutable hash table over GLSLSymbolInfo::s_info, shared by
+    //              every symbol table in the process.
+    //
+    //--------------------------------------------------------------------------
+    struct KnownSymbolTable
+    {
+        KnownSymbolTable();
+
+        bool Find(
+            __in_z const char* pszSymbol,                                   // Symbol to find
+            UINT uHash,                                                     // Hash of the symbol
+            UINT uLength,                                                   // Length of the symbol
+            __out int* pIndex                                               // Index of the known symbol
+            ) const;
+
+        static const UINT s_uBucketCount = 256;                             // Must be a power of 2
+
+        SymbolHashInfo _rgHashInfo[GLSLSymbols::count];                     // Hash and length for each known symbol
+        int _rgBuckets[s_uBucketCount];                                     // Hash buckets holding GLSLSymbols values
+    };
+
+    static const KnownSymbolTable& GetKnownSymbolTable();
+
+    bool FindBucket(
+        __in_z const char* pszSymbol,                                       // Symbol to find
+        UINT uHash,                                                         // Hash of the symbol
+        UINT uLength,                                                       // Length of the symbol
+        __out UINT* puBucket                                                // Bucket holding the symbol, or first empty bucket
+        ) const;
+
+    HRESULT GrowBuckets();
+
+private:
+    static const int s_iEmptyBucket = -1;                                   // Marker for an unused bucket
+    static const UINT s_uInitialBucketCount = 256;                          // Must be a power of 2
+
+    const KnownSymbolTable* _pKnownSymbols;                                 // Shared known symbols, or null if not included
+    int _iFirstLocalIndex;                                                  // Symbol index of _rgSymbolList[0]
+    CModernArray<CSmartSTR, CSmartStringTraits<CSmartSTR>> _rgSymbolList;   // The symbols added to this table
+    CModernArray<SymbolHashInfo> _aryHashInfo;                              // Hash and length for each symbol in _rgSymbolList
+    CModernArray<int> _aryBuckets;                                          // Hash buckets holding indices into _rgSymbolList
 };
@@ -30,6 +30,7 @@
 #include "RefCounted.hxx"
 #include "IStringStream.hxx"
 #include "GLSLConvertedShader.hxx"
+#include "GLSLWorkStealingScheduler.hxx"
 
 //+----------------------------------------------------------------------------
 //
@@ -60,3 +61,197 @@ HRESULT GLSLTranslate(
 
     CHK_RETURN;
 }
+
+//+-----------------------------------------------------------------------------
+//
+//  Struct:     GLSLTranslateBatchItem
+//
+//  Synopsis:   Result of translating one shader in a batch.
+//
+//------------------------------------------------------------------------------
+struct GLSLTranslateBatchItem
+{
+    HRESULT hr;                                                 // Result of GLSLTranslate
+    CGLSLConvertedShader* pConvertedShader;                     // Converted shader, owned by the item
+};
+
+//+-----------------------------------------------------------------------------
+//
+//  Struct:     GLSLTranslateBatchContext
+//
+//  Synopsis:   State shared by the workers translating a batch.
+//
+//------------------------------------------------------------------------------
+struct GLSLTranslateBatchContext
+{
+    const GLSLTranslateBatchInput* pInputs;                     // Shaders to translate
+    UINT uOptions;                                              // Translation options
+    WebGLFeatureLevel glFeatureLevel;                           // Feature level we're translating for
+    GLSLTranslateBatchItem* pItems;                             // Result of each shader
+    CGLSLWorkStealingScheduler* pScheduler;                     // Hands out shaders to workers
+    volatile LONG lNextWorker;                                  // Index of the next pool worker to start
+};
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   RunTranslateBatchWorker
+//
+//  Synopsis:   Translates shaders from the batch until the scheduler has
+//              none left to hand out.
+//
+//              GLSLTranslate does not touch any mutable shared state: the
+//              lexers and parsers are reentrant, parse tree allocations go
+//              to a thread local arena, and the known symbol table is built
+//              once and then only read. So each worker can run translations
+//              without any locking.
+//
+//-----------------------------------------------------------------------------
+static void RunTranslateBatchWorker(
+    __inout GLSLTranslateBatchContext* pContext,                // Batch being translated
+    UINT uWorker                                                // Index of this worker
+    )
+{
+    UINT uItem;
+    while (pContext->pScheduler->TryGetItem(uWorker, &uItem))
+    {
+        const GLSLTranslateBatchInput& input = pContext->pInputs[uItem];
+        GLSLTranslateBatchItem& item = pContext->pItems[uItem];
+
+        item.hr = GLSLTranslate(
+            input.bstrInput,
+            input.shaderType,
+            pContext->uOptions,
+            pContext->glFeatureLevel,
+            &item.pConvertedShader
+            );
+    }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   TranslateBatchWorkCallback
+//
+//  Synopsis:   Thread pool callback that runs one batch worker.
+//
+//-----------------------------------------------------------------------------
+static void CALLBACK TranslateBatchWorkCallback(
+    __inout PTP_CALLBACK_INSTANCE pInstance,                    // Callback instance
+    __inout_opt PVOID pvContext,                                // Batch being translated
+    __inout PTP_WORK pWork                                      // Work object
+    )
+{
+    UNREFERENCED_PARAMETER(pInstance);
+    UNREFERENCED_PARAMETER(pWork);
+
+    GLSLTranslateBatchContext* pContext = static_cast<GLSLTranslateBatchContext*>(pvContext);
+    RunTranslateBatchWorker(pContext, static_cast<UINT>(::InterlockedIncrement(&pContext->lNextWorker)));
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GLSLTranslateBatch
+//
+//  Synopsis:   Translates a batch of shaders in parallel. The calling thread
+//              is one of the workers and the others run on the process
+//              thread pool; shaders are spread over them with a work
+//              stealing scheduler so that a few large shaders do not leave
+//              the other workers idle.
+//
+//              Each output matches what GLSLTranslate gives for the same
+//              input. If translating any shader fails, all of the outputs
+//              are released and the first failure in input order is
+//              returned.
+//
+//              Outputs are created on whichever worker translated them and
+//              handed to the caller. Everything a converted shader holds on
+//              to is created with MultiThreadedRefCount for this, so the
+//              caller can use and release the outputs on its own thread.
+//              Parse tree nodes keep single threaded counts, since they
+//              never outlive the translation on the worker.
+//
+//-----------------------------------------------------------------------------
+HRESULT GLSLTranslateBatch(
+    UINT cShaders,                                              // Number of shaders in the batch
+    __in_ecount(cShaders) const GLSLTranslateBatchInput* pInputs, // Shaders to translate
+    UINT uOptions,                                              // Translation options
+    WebGLFeatureLevel glFeatureLevel,                           // Feature level we're translating for
+    UINT uMaxThreads,                                           // Most threads to use, or 0 for one per processor
+    __out_ecount(cShaders) CGLSLConvertedShader** ppConvertedShaders // Converted shaders, in input order
+    )
+{
+    CHK_START;
+
+    for (UINT i = 0; i < cShaders; i++)
+    {
+        ppConvertedShaders[i] = nullptr;
+    }
+
+    if (cShaders > 0)
+    {
+        UINT cWorkers = (uMaxThreads != 0) ? uMaxThreads : ::GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+        cWorkers = max(1U, min(cWorkers, cShaders));
+
+        CModernArray<GLSLTranslateBatchItem> aryItems;
+        CHK(aryItems.Resize(cShaders));
+        for (UINT i = 0; i < cShaders; i++)
+        {
+            aryItems[i].hr = E_FAIL;
+            aryItems[i].pConvertedShader = nullptr;
+        }
+
+        CGLSLWorkStealingScheduler scheduler;
+        CHK(scheduler.Initialize(cShaders, cWorkers));
+
+        GLSLTranslateBatchContext context;
+        context.pInputs = pInputs;
+        context.uOptions = uOptions;
+        context.glFeatureLevel = glFeatureLevel;
+        context.pItems = &aryItems[0];
+        context.pScheduler = &scheduler;
+        context.lNextWorker = 0;
+
+        // If the pool work cannot be created the calling thread does the
+        // whole batch by itself, since it steals from every other worker.
+        PTP_WORK pWork = nullptr;
+        if (cWorkers > 1)
+        {
+            pWork = ::CreateThreadpoolWork(TranslateBatchWorkCallback, &context, nullptr);
+            if (pWork != nullptr)
+            {
+                for (UINT i = 1; i < cWorkers; i++)
+                {
+                    ::SubmitThreadpoolWork(pWork);
+                }
+            }
+        }
+
+        RunTranslateBatchWorker(&context, 0);
+
+        if (pWork != nullptr)
+        {
+            ::WaitForThreadpoolWorkCallbacks(pWork, FALSE);
+            ::CloseThreadpoolWork(pWork);
+        }
+
+        for (UINT i = 0; i < cShaders && SUCCEEDED(hr); i++)
+        {
+            hr = aryItems[i].hr;
+        }
+
+        for (UINT i = 0; i < cShaders; i++)
+        {
+            if (SUCCEEDED(hr))
+            {
+                ppConvertedShaders[i] = aryItems[i].pConvertedShader;
+            }
+            else if (aryItems[i].pConvertedShader != nullptr)
+            {
+                aryItems[i].pConvertedShader->Release();
+            }
+        }
+
+        CHK(hr);
+    }
+
+    CHK_RETURN;
+}
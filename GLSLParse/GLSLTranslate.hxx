@@ -33,6 +33,13 @@
 class CGLSLConvertedShader;
 enum class WebGLFeatureLevel;
 
+// Version of what GLSLTranslate produces. Translations persisted by the
+// translation cache are only reused by a translator with the same version,
+// so bump this with any change that can alter the HLSL, the errors, or the
+// identifier and varying information of a converted shader for the same
+// input and options.
+const UINT GLSLTranslatorOutputVersion = 1;
+
 HRESULT GLSLTranslate(
     __in BSTR bstrInput,                                        // Input unicode GLSL string
     GLSLShaderType::Enum shaderType,                            // Indicates what kind of shader is being translated
@@ -40,3 +47,25 @@ HRESULT GLSLTranslate(
     WebGLFeatureLevel glFeatureLevel,                           // Feature level we're translating for
     __deref_out CGLSLConvertedShader** ppConvertedShader        // Converted shader
     );
+
+//+-----------------------------------------------------------------------------
+//
+//  Struct:     GLSLTranslateBatchInput
+//
+//  Synopsis:   One shader in a batch passed to GLSLTranslateBatch.
+//
+//------------------------------------------------------------------------------
+struct GLSLTranslateBatchInput
+{
+    BSTR bstrInput;                                             // Input unicode GLSL string
+    GLSLShaderType::Enum shaderType;                            // Indicates what kind of shader is being translated
+};
+
+HRESULT GLSLTranslateBatch(
+    UINT cShaders,                                              // Number of shaders in the batch
+    __in_ecount(cShaders) const GLSLTranslateBatchInput* pInputs, // Shaders to translate
+    UINT uOptions,                                              // Translation options
+    WebGLFeatureLevel glFeatureLevel,                           // Feature level we're translating for
+    UINT uMaxThreads,                                           // Most threads to use, or 0 for one per processor
+    __out_ecount(cShaders) CGLSLConvertedShader** ppConvertedShaders // Converted shaders, in input order
+    );
@@ -36,5 +36,8 @@ namespace GLSLTranslateOptions
         ForceFeatureLevel9 = 0x4,
         EnableStandardDerivatives = 0x8,
         EnableFragDepth = 0x10,
+        EnableStats = 0x20,
+        EliminateDeadCode = 0x40,
+        FoldConstants = 0x80,
     };
 }
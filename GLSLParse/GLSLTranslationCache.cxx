@@ -0,0 +1,767 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#include "PreComp.hxx"
+#include "GLSLTranslationCache.hxx"
+#include "GLSLTranslate.hxx"
+#include "WebGLFeatureLevel.hxx"
+#include "GLSLTranslateOptions.hxx"
+#include "GLSLShaderSerializer.hxx"
+#include "GLSLBinaryStream.hxx"
+#include "RefCounted.hxx"
+
+// Start of the module the translator is linked into
+EXTERN_C IMAGE_DOS_HEADER __ImageBase;
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   CGLSLTranslationCacheEntry constructor
+//
+//-----------------------------------------------------------------------------
+CGLSLTranslationCacheEntry::CGLSLTranslationCacheEntry() :
+    _uHash(0),
+    _cchSource(0),
+    _shaderType(GLSLShaderType::Vertex),
+    _uOptions(0),
+    _glFeatureLevel(WebGLFeatureLevel::Level_9_1),
+    _cbMemorySize(0),
+    _pNextInBucket(nullptr),
+    _pMoreRecent(nullptr),
+    _pLessRecent(nullptr)
+{
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   CGLSLTranslationCacheEntry::Initialize
+//
+//  Synopsis:   Copies the key and takes a reference on the translated shader.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLTranslationCacheEntry::Initialize(
+    UINT64 uHash,                                               // Hash of the key
+    __in_ecount(cchSource) const WCHAR* pwchSource,             // Source the shader was translated from
+    UINT cchSource,                                             // Number of characters in the source
+    GLSLShaderType::Enum shaderType,                            // Type of shader
+    UINT uOptions,                                              // Translation options
+    WebGLFeatureLevel glFeatureLevel,                           // Feature level translated for
+    __in CGLSLConvertedShader* pShader                          // Translated shader
+    )
+{
+    CHK_START;
+
+    if (cchSource > 0)
+    {
+        CHK(_spSource.New(cchSource));
+        ::memcpy(_spSource, pwchSource, cchSource * sizeof(WCHAR));
+    }
+
+    _uHash = uHash;
+    _cchSource = cchSource;
+    _shaderType = shaderType;
+    _uOptions = uOptions;
+    _glFeatureLevel = glFeatureLevel;
+    _spShader = pShader;
+
+    // Charge the entry for the shader, the copy of the source and itself
+    UINT64 cbMemorySize = static_cast<UINT64>(pShader->GetMemorySize()) + static_cast<UINT64>(cchSource) * sizeof(WCHAR) + sizeof(*this);
+    _cbMemorySize = (cbMemorySize > UINT_MAX) ? UINT_MAX : static_cast<UINT>(cbMemorySize);
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   CGLSLTranslationCacheEntry::IsMatch
+//
+//  Synopsis:   Compares the full key of the entry, not just the hash.
+//
+//-----------------------------------------------------------------------------
+bool CGLSLTranslationCacheEntry::IsMatch(
+    UINT64 uHash,                                               // Hash of the key
+    __in_ecount(cchSource) const WCHAR* pwchSource,             // Source to compare
+    UINT cchSource,                                             // Number of characters in the source
+    GLSLShaderType::Enum shaderType,                            // Type of shader
+    UINT uOptions,                                              // Translation options
+    WebGLFeatureLevel glFeatureLevel                            // Feature level
+    ) const
+{
+    return (_uHash == uHash &&
+            _cchSource == cchSource &&
+            _shaderType == shaderType &&
+            _uOptions == uOptions &&
+            _glFeatureLevel == glFeatureLevel &&
+            (cchSource == 0 || ::memcmp(_spSource, pwchSource, cchSource * sizeof(WCHAR)) == 0));
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Constructor
+//
+//-----------------------------------------------------------------------------
+CGLSLTranslationCache::CGLSLTranslationCache() :
+    _pMostRecent(nullptr),
+    _pLeastRecent(nullptr),
+    _uEntryCount(0),
+    _cbMemoryUsed(0),
+    _cbMemoryBudget(0),
+    _uHitCount(0),
+    _uMissCount(0),
+    _uEvictionCount(0),
+    _uDiskHitCount(0),
+    _uBypassCount(0)
+{
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Destructor
+//
+//-----------------------------------------------------------------------------
+CGLSLTranslationCache::~CGLSLTranslationCache()
+{
+    Clear();
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Initialize
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLTranslationCache::Initialize(
+    UINT cbMemoryBudget                                         // Maximum memory the cached shaders may use
+    )
+{
+    return Initialize(cbMemoryBudget, nullptr);
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Initialize
+//
+//  Synopsis:   Initialize a cache that persists translations in a directory.
+//              The directory must already exist.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLTranslationCache::Initialize(
+    UINT cbMemoryBudget,                                        // Maximum memory the cached shaders may use
+    __in_z_opt const WCHAR* pwszDirectory                       // Directory to persist translations in, or null
+    )
+{
+    CHK_START;
+
+    if (pwszDirectory != nullptr)
+    {
+        CHK(_spszDirectory.Set(pwszDirectory));
+    }
+
+    static_assert((s_uInitialBucketCount & (s_uInitialBucketCount - 1)) == 0, "Bucket count must be a power of two");
+
+    _cbMemoryBudget = cbMemoryBudget;
+
+    CHK(_aryBuckets.Resize(s_uInitialBucketCount));
+    for (UINT i = 0; i < s_uInitialBucketCount; i++)
+    {
+        _aryBuckets[i] = nullptr;
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Translate
+//
+//  Synopsis:   Returns the converted shader for the input, from the cache
+//              when possible.
+//
+//              Translations with EnableStats bypass the cache in memory and
+//              on disk. Their stats time this translation, so handing back
+//              the stats of an earlier one, or a restored shader that has
+//              none, would be wrong.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLTranslationCache::Translate(
+    __in BSTR bstrInput,                                        // Input unicode GLSL string
+    GLSLShaderType::Enum shaderType,                            // Indicates what kind of shader is being translated
+    UINT uOptions,                                              // Translation options
+    WebGLFeatureLevel glFeatureLevel,                           // Feature level we're translating for
+    __deref_out CGLSLConvertedShader** ppConvertedShader        // Converted shader
+    )
+{
+    CHK_START;
+
+    if ((uOptions & GLSLTranslateOptions::EnableStats) != 0)
+    {
+        _uBypassCount++;
+        CHK(::GLSLTranslate(bstrInput, shaderType, uOptions, glFeatureLevel, ppConvertedShader));
+    }
+    else
+    {
+        CHK(TranslateThroughCache(bstrInput, shaderType, uOptions, glFeatureLevel, ppConvertedShader));
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   TranslateThroughCache
+//
+//  Synopsis:   Returns the converted shader for the input from the cache,
+//              translating it with GLSLTranslate if it is not there. When
+//              the cache is persistent, a shader that is not in memory is
+//              looked for in the directory before translating, and newly
+//              translated shaders are written to the directory.
+//
+//              Shaders that failed to translate are cached as well, since
+//              translating them again would produce the same errors.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLTranslationCache::TranslateThroughCache(
+    __in BSTR bstrInput,                                        // Input unicode GLSL string
+    GLSLShaderType::Enum shaderType,                            // Indicates what kind of shader is being translated
+    UINT uOptions,                                              // Translation options
+    WebGLFeatureLevel glFeatureLevel,                           // Feature level we're translating for
+    __deref_out CGLSLConvertedShader** ppConvertedShader        // Converted shader
+    )
+{
+    CHK_START;
+
+    const WCHAR* pwchSource = (bstrInput != nullptr) ? bstrInput : L"";
+    UINT cchSource = ::SysStringLen(bstrInput);
+    UINT64 uHash = ComputeHash(pwchSource, cchSource, shaderType, uOptions, glFeatureLevel);
+
+    CGLSLTranslationCacheEntry* pFound = nullptr;
+    for (CGLSLTranslationCacheEntry* pEntry = _aryBuckets[BucketFromHash(uHash)]; pEntry != nullptr; pEntry = pEntry->_pNextInBucket)
+    {
+        if (pEntry->IsMatch(uHash, pwchSource, cchSource, shaderType, uOptions, glFeatureLevel))
+        {
+            pFound = pEntry;
+            break;
+        }
+    }
+
+    TSmartPointer<CGLSLConvertedShader> spConvertedShader;
+    if (pFound != nullptr)
+    {
+        _uHitCount++;
+        MarkMostRecent(pFound);
+
+        spConvertedShader = pFound->UseShader();
+    }
+    else
+    {
+        _uMissCount++;
+
+        // Problems with the directory are not fatal, the shader is translated instead
+        bool fFromDisk = false;
+        if (IsPersistent())
+        {
+            fFromDisk = SUCCEEDED(LoadFromDisk(uHash, pwchSource, cchSource, shaderType, uOptions, glFeatureLevel, &spConvertedShader)) && spConvertedShader != nullptr;
+        }
+
+        if (fFromDisk)
+        {
+            _uDiskHitCount++;
+        }
+        else
+        {
+            CHK(::GLSLTranslate(bstrInput, shaderType, uOptions, glFeatureLevel, &spConvertedShader));
+        }
+
+        TSmartPointer<CGLSLTranslationCacheEntry> spEntry;
+        CHK(RefCounted<CGLSLTranslationCacheEntry>::Create(uHash, pwchSource, cchSource, shaderType, uOptions, glFeatureLevel, spConvertedShader, /*out*/spEntry));
+
+        if (IsPersistent() && !fFromDisk)
+        {
+            // A shader that could not be persisted is still handed back
+            HRESULT hrStore = StoreToDisk(spEntry);
+            UNREFERENCED_PARAMETER(hrStore);
+        }
+
+        // Shaders bigger than the whole budget are handed back without being cached
+        if (spEntry->GetMemorySize() <= _cbMemoryBudget)
+        {
+            while (_cbMemoryBudget - _cbMemoryUsed < spEntry->GetMemorySize())
+            {
+                EvictLeastRecent();
+            }
+
+            CHK(AddEntry(spEntry));
+        }
+    }
+
+    (*ppConvertedShader) = spConvertedShader.Extract();
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Clear
+//
+//  Synopsis:   Removes all entries from the cache. Counters are preserved.
+//
+//-----------------------------------------------------------------------------
+void CGLSLTranslationCache::Clear()
+{
+    while (_pLeastRecent != nullptr)
+    {
+        RemoveEntry(_pLeastRecent);
+    }
+
+    Assert(_uEntryCount == 0);
+    Assert(_cbMemoryUsed == 0);
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetTranslatorBuildStamp
+//
+//  Synopsis:   Returns the link time stamp of the module the translator is
+//              built into. Persisted translations are tied to it as well as
+//              to GLSLTranslatorOutputVersion, so that a build which changed
+//              the translator without bumping the version does not pick up
+//              output from an earlier build.
+//
+//-----------------------------------------------------------------------------
+UINT CGLSLTranslationCache::GetTranslatorBuildStamp()
+{
+    const BYTE* pbImage = reinterpret_cast<const BYTE*>(&__ImageBase);
+    const IMAGE_NT_HEADERS* pNtHeaders = reinterpret_cast<const IMAGE_NT_HEADERS*>(pbImage + __ImageBase.e_lfanew);
+
+    return pNtHeaders->FileHeader.TimeDateStamp;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   ComputeHash
+//
+//  Synopsis:   FNV-1a hash of the key. The source is hashed as bytes so that
+//              every character contributes fully. The translator's version
+//              and build stamp are part of the key, so a translator that
+//              produces different output never looks at the files of another.
+//
+//-----------------------------------------------------------------------------
+UINT64 CGLSLTranslationCache::ComputeHash(
+    __in_ecount(cchSource) const WCHAR* pwchSource,             // Source to hash
+    UINT cchSource,                                             // Number of characters in the source
+    GLSLShaderType::Enum shaderType,                            // Type of shader
+    UINT uOptions,                                              // Translation options
+    WebGLFeatureLevel glFeatureLevel                            // Feature level
+    )
+{
+    const UINT64 uPrime = 1099511628211ULL;
+    UINT64 uHash = 14695981039346656037ULL;
+
+    UINT rgKey[] = { GLSLTranslatorOutputVersion, GetTranslatorBuildStamp(), static_cast<UINT>(shaderType), uOptions, static_cast<UINT>(glFeatureLevel) };
+    const BYTE* pbKey = reinterpret_cast<const BYTE*>(rgKey);
+    for (UINT i = 0; i < sizeof(rgKey); i++)
+    {
+        uHash = (uHash ^ pbKey[i]) * uPrime;
+    }
+
+    const BYTE* pbSource = reinterpret_cast<const BYTE*>(pwchSource);
+    UINT cbSource = cchSource * sizeof(WCHAR);
+    for (UINT i = 0; i < cbSource; i++)
+    {
+        uHash = (uHash ^ pbSource[i]) * uPrime;
+    }
+
+    return uHash;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetDiskPath
+//
+//  Synopsis:   Returns the path of the file for a key in the directory.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLTranslationCache::GetDiskPath(
+    UINT64 uHash,                                               // Hash of the key
+    __inout CMutableString<WCHAR>& spszPath                     // Path of the file
+    ) const
+{
+    return spszPath.Format(MAX_PATH, L"%s\\%016I64x.glslc", static_cast<const WCHAR*>(_spszDirectory), uHash);
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   LoadFromDisk
+//
+//  Synopsis:   Restores a shader from the directory. The file is mapped
+//              rather than read, and the restored shader copies what it
+//              keeps, so the view is unmapped before returning.
+//
+//              A missing file, or one for a different key or translator
+//              with the same hash, returns S_OK with a null shader. Files
+//              that cannot be restored fail, and the caller translates
+//              instead.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLTranslationCache::LoadFromDisk(
+    UINT64 uHash,                                               // Hash of the key
+    __in_ecount(cchSource) const WCHAR* pwchSource,             // Source to look for
+    UINT cchSource,                                             // Number of characters in the source
+    GLSLShaderType::Enum shaderType,                            // Type of shader
+    UINT uOptions,                                              // Translation options
+    WebGLFeatureLevel glFeatureLevel,                           // Feature level
+    __deref_out_opt CGLSLConvertedShader** ppConvertedShader    // Restored shader, or null if not on disk
+    ) const
+{
+    HANDLE hFile = INVALID_HANDLE_VALUE;
+    HANDLE hMapping = nullptr;
+    const BYTE* pView = nullptr;
+
+    CHK_START;
+
+    (*ppConvertedShader) = nullptr;
+
+    CMutableString<WCHAR> spszPath;
+    CHK(GetDiskPath(uHash, spszPath));
+
+    hFile = ::CreateFileW(spszPath, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER cbFile;
+        CHKB(::GetFileSizeEx(hFile, &cbFile));
+        CHKB_HR(cbFile.QuadPart > 0 && cbFile.QuadPart <= UINT_MAX, E_GLSL_INVALIDDATA);
+
+        hMapping = ::CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CHKB(hMapping != nullptr);
+
+        pView = static_cast<const BYTE*>(::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+        CHKB(pView != nullptr);
+
+        CGLSLBinaryReader reader(pView, static_cast<UINT>(cbFile.QuadPart));
+
+        UINT uMagic;
+        UINT uVersion;
+        UINT uFileOutputVersion;
+        UINT uFileBuildStamp;
+        UINT64 uFileHash;
+        UINT uFileShaderType;
+        UINT uFileOptions;
+        UINT uFileFeatureLevel;
+        UINT cchFileSource;
+        CHK(reader.ReadUInt(&uMagic));
+        CHK(reader.ReadUInt(&uVersion));
+        CHK(reader.ReadUInt(&uFileOutputVersion));
+        CHK(reader.ReadUInt(&uFileBuildStamp));
+        CHK(reader.ReadUInt64(&uFileHash));
+        CHK(reader.ReadUInt(&uFileShaderType));
+        CHK(reader.ReadUInt(&uFileOptions));
+        CHK(reader.ReadUInt(&uFileFeatureLevel));
+        CHK(reader.ReadUInt(&cchFileSource));
+
+        CHKB_HR(uMagic == s_uFileMagic && uVersion == s_uFileVersion, E_GLSL_INVALIDDATA);
+        CHKB_HR(cchFileSource <= UINT_MAX / sizeof(WCHAR), E_GLSL_INVALIDDATA);
+
+        const BYTE* pbFileSource;
+        CHK(reader.ReadBytes(cchFileSource * sizeof(WCHAR), &pbFileSource));
+
+        // Like the entries in memory, compare the full key and not just the hash.
+        // A file from another translator is not used, and the new translation
+        // replaces it.
+        if (uFileOutputVersion == GLSLTranslatorOutputVersion &&
+            uFileBuildStamp == GetTranslatorBuildStamp() &&
+            uFileHash == uHash &&
+            uFileShaderType == static_cast<UINT>(shaderType) &&
+            uFileOptions == uOptions &&
+            uFileFeatureLevel == static_cast<UINT>(glFeatureLevel) &&
+            cchFileSource == cchSource &&
+            (cchSource == 0 || ::memcmp(pbFileSource, pwchSource, cchSource * sizeof(WCHAR)) == 0))
+        {
+            CHK(CGLSLShaderSerializer::Deserialize(&reader, ppConvertedShader));
+        }
+    }
+
+    CHK_END;
+
+    if (pView != nullptr)
+    {
+        ::UnmapViewOfFile(pView);
+    }
+
+    if (hMapping != nullptr)
+    {
+        ::CloseHandle(hMapping);
+    }
+
+    if (hFile != INVALID_HANDLE_VALUE)
+    {
+        ::CloseHandle(hFile);
+    }
+
+    return hr;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   StoreToDisk
+//
+//  Synopsis:   Writes an entry to the directory. The file is written under a
+//              name of its own and then renamed over the real one, so that
+//              other processes reading the directory never see a partially
+//              written file.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLTranslationCache::StoreToDisk(
+    __in const CGLSLTranslationCacheEntry* pEntry               // Entry to persist
+    ) const
+{
+    HANDLE hFile = INVALID_HANDLE_VALUE;
+    bool fRenamed = false;
+    CMutableString<WCHAR> spszTempPath;
+
+    CHK_START;
+
+    CGLSLBinaryWriter writer;
+    CHK(writer.WriteUInt(s_uFileMagic));
+    CHK(writer.WriteUInt(s_uFileVersion));
+    CHK(writer.WriteUInt(GLSLTranslatorOutputVersion));
+    CHK(writer.WriteUInt(GetTranslatorBuildStamp()));
+    CHK(writer.WriteUInt64(pEntry->_uHash));
+    CHK(writer.WriteUInt(static_cast<UINT>(pEntry->_shaderType)));
+    CHK(writer.WriteUInt(pEntry->_uOptions));
+    CHK(writer.WriteUInt(static_cast<UINT>(pEntry->_glFeatureLevel)));
+    CHK(writer.WriteUInt(pEntry->_cchSource));
+    CHK(writer.WriteBytes(pEntry->_spSource, pEntry->_cchSource * sizeof(WCHAR)));
+    CHK(CGLSLShaderSerializer::Serialize(pEntry->UseShader(), &writer));
+
+    CMutableString<WCHAR> spszPath;
+    CHK(GetDiskPath(pEntry->_uHash, spszPath));
+    CHK(spszTempPath.Format(MAX_PATH, L"%s.%lx.%lx.tmp", static_cast<const WCHAR*>(spszPath), ::GetCurrentProcessId(), ::GetCurrentThreadId()));
+
+    hFile = ::CreateFileW(spszTempPath, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    CHKB(hFile != INVALID_HANDLE_VALUE);
+
+    DWORD cbWritten;
+    CHKB(::WriteFile(hFile, writer.GetData(), writer.GetSize(), &cbWritten, nullptr) && cbWritten == writer.GetSize());
+
+    ::CloseHandle(hFile);
+    hFile = INVALID_HANDLE_VALUE;
+
+    CHKB(::MoveFileExW(spszTempPath, spszPath, MOVEFILE_REPLACE_EXISTING));
+    fRenamed = true;
+
+    CHK_END;
+
+    if (hFile != INVALID_HANDLE_VALUE)
+    {
+        ::CloseHandle(hFile);
+    }
+
+    if (!fRenamed && spszTempPath.GetLength() > 0)
+    {
+        ::DeleteFileW(spszTempPath);
+    }
+
+    return hr;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddEntry
+//
+//  Synopsis:   Links a new entry into its bucket and makes it the most
+//              recently used. The caller has already made room for it.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLTranslationCache::AddEntry(
+    __in CGLSLTranslationCacheEntry* pEntry                     // Entry to add
+    )
+{
+    CHK_START;
+
+    Assert(_cbMemoryBudget - _cbMemoryUsed >= pEntry->GetMemorySize());
+
+    // Keep the chains short by keeping at most one entry per bucket on average
+    if (_uEntryCount >= _aryBuckets.GetCount())
+    {
+        CHK(GrowBuckets());
+    }
+
+    UINT uBucket = BucketFromHash(pEntry->GetHash());
+    pEntry->_pNextInBucket = _aryBuckets[uBucket];
+    _aryBuckets[uBucket] = pEntry;
+
+    pEntry->AddRef();
+    MarkMostRecent(pEntry);
+
+    _uEntryCount++;
+    _cbMemoryUsed += pEntry->GetMemorySize();
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   EvictLeastRecent
+//
+//  Synopsis:   Removes the least recently used entry to make room.
+//
+//-----------------------------------------------------------------------------
+void CGLSLTranslationCache::EvictLeastRecent()
+{
+    Assert(_pLeastRecent != nullptr);
+
+    RemoveEntry(_pLeastRecent);
+    _uEvictionCount++;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   RemoveEntry
+//
+//  Synopsis:   Unlinks an entry from its bucket and the most recently used
+//              list, and drops the cache's reference on it. Callers that got
+//              the shader from the cache keep their own reference.
+//
+//-----------------------------------------------------------------------------
+void CGLSLTranslationCache::RemoveEntry(
+    __in CGLSLTranslationCacheEntry* pEntry                     // Entry to remove
+    )
+{
+    UINT uBucket = BucketFromHash(pEntry->GetHash());
+    if (_aryBuckets[uBucket] == pEntry)
+    {
+        _aryBuckets[uBucket] = pEntry->_pNextInBucket;
+    }
+    else
+    {
+        CGLSLTranslationCacheEntry* pPrevious = _aryBuckets[uBucket];
+        while (pPrevious->_pNextInBucket != pEntry)
+        {
+            pPrevious = pPrevious->_pNextInBucket;
+        }
+
+        pPrevious->_pNextInBucket = pEntry->_pNextInBucket;
+    }
+
+    pEntry->_pNextInBucket = nullptr;
+    UnlinkRecent(pEntry);
+
+    _uEntryCount--;
+    _cbMemoryUsed -= pEntry->GetMemorySize();
+
+    pEntry->Release();
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   MarkMostRecent
+//
+//  Synopsis:   Moves an entry to the head of the most recently used list.
+//
+//-----------------------------------------------------------------------------
+void CGLSLTranslationCache::MarkMostRecent(
+    __in CGLSLTranslationCacheEntry* pEntry                     // Entry that was used
+    )
+{
+    if (_pMostRecent != pEntry)
+    {
+        UnlinkRecent(pEntry);
+
+        pEntry->_pLessRecent = _pMostRecent;
+        if (_pMostRecent != nullptr)
+        {
+            _pMostRecent->_pMoreRecent = pEntry;
+        }
+
+        _pMostRecent = pEntry;
+        if (_pLeastRecent == nullptr)
+        {
+            _pLeastRecent = pEntry;
+        }
+    }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   UnlinkRecent
+//
+//  Synopsis:   Removes an entry from the most recently used list, if it is
+//              in it.
+//
+//-----------------------------------------------------------------------------
+void CGLSLTranslationCache::UnlinkRecent(
+    __in CGLSLTranslationCacheEntry* pEntry                     // Entry to unlink
+    )
+{
+    if (pEntry->_pMoreRecent != nullptr)
+    {
+        pEntry->_pMoreRecent->_pLessRecent = pEntry->_pLessRecent;
+    }
+    else if (_pMostRecent == pEntry)
+    {
+        _pMostRecent = pEntry->_pLessRecent;
+    }
+
+    if (pEntry->_pLessRecent != nullptr)
+    {
+        pEntry->_pLessRecent->_pMoreRecent = pEntry->_pMoreRecent;
+    }
+    else if (_pLeastRecent == pEntry)
+    {
+        _pLeastRecent = pEntry->_pMoreRecent;
+    }
+
+    pEntry->_pMoreRecent = nullptr;
+    pEntry->_pLessRecent = nullptr;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GrowBuckets
+//
+//  Synopsis:   Doubles the number of buckets and rechains every entry.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLTranslationCache::GrowBuckets()
+{
+    CHK_START;
+
+    UINT uNewBucketCount = _aryBuckets.GetCount() * 2;
+    CHKB(uNewBucketCount > _aryBuckets.GetCount());
+
+    CHK(_aryBuckets.Resize(uNewBucketCount));
+    for (UINT i = 0; i < uNewBucketCount; i++)
+    {
+        _aryBuckets[i] = nullptr;
+    }
+
+    for (CGLSLTranslationCacheEntry* pEntry = _pMostRecent; pEntry != nullptr; pEntry = pEntry->_pLessRecent)
+    {
+        UINT uBucket = BucketFromHash(pEntry->GetHash());
+        pEntry->_pNextInBucket = _aryBuckets[uBucket];
+        _aryBuckets[uBucket] = pEntry;
+    }
+
+    CHK_RETURN;
+}
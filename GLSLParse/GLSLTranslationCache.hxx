@@ -0,0 +1,223 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#pragma once
+
+#include "GLSLShaderType.hxx"
+#include "GLSLConvertedShader.hxx"
+
+enum class WebGLFeatureLevel;
+
+//+-----------------------------------------------------------------------------
+//
+//  Class:      CGLSLTranslationCacheEntry
+//
+//  Synopsis:   A translated shader in the translation cache along with the
+//              key it was translated from.
+//
+//              Entries are chained in their hash bucket and linked into the
+//              cache's most recently used list. The cache holds a reference on
+//              each entry while it is in the list.
+//
+//------------------------------------------------------------------------------
+class CGLSLTranslationCacheEntry : public IUnknown
+{
+public:
+    HRESULT Initialize(
+        UINT64 uHash,                                                       // Hash of the key
+        __in_ecount(cchSource) const WCHAR* pwchSource,                     // Source the shader was translated from
+        UINT cchSource,                                                     // Number of characters in the source
+        GLSLShaderType::Enum shaderType,                                    // Type of shader
+        UINT uOptions,                                                      // Translation options
+        WebGLFeatureLevel glFeatureLevel,                                   // Feature level translated for
+        __in CGLSLConvertedShader* pShader                                  // Translated shader
+        );
+
+    bool IsMatch(
+        UINT64 uHash,                                                       // Hash of the key
+        __in_ecount(cchSource) const WCHAR* pwchSource,                     // Source to compare
+        UINT cchSource,                                                     // Number of characters in the source
+        GLSLShaderType::Enum shaderType,                                    // Type of shader
+        UINT uOptions,                                                      // Translation options
+        WebGLFeatureLevel glFeatureLevel                                    // Feature level
+        ) const;
+
+    CGLSLConvertedShader* UseShader() const { return _spShader; }
+    UINT64 GetHash() const { return _uHash; }
+    UINT GetMemorySize() const { return _cbMemorySize; }
+
+protected:
+    CGLSLTranslationCacheEntry();
+
+private:
+    friend class CGLSLTranslationCache;
+
+    UINT64 _uHash;                                                          // Hash of the key
+    TSmartArray<WCHAR> _spSource;                                           // Copy of the source, to rule out hash collisions
+    UINT _cchSource;                                                        // Number of characters in the source
+    GLSLShaderType::Enum _shaderType;                                       // Type of shader
+    UINT _uOptions;                                                         // Translation options
+    WebGLFeatureLevel _glFeatureLevel;                                      // Feature level translated for
+    TSmartPointer<CGLSLConvertedShader> _spShader;                          // Translated shader
+    UINT _cbMemorySize;                                                     // Memory charged against the cache budget
+
+    CGLSLTranslationCacheEntry* _pNextInBucket;                             // Next entry in the same hash bucket
+    CGLSLTranslationCacheEntry* _pMoreRecent;                               // Next more recently used entry
+    CGLSLTranslationCacheEntry* _pLessRecent;                               // Next less recently used entry
+};
+
+//+-----------------------------------------------------------------------------
+//
+//  Class:      CGLSLTranslationCache
+//
+//  Synopsis:   Bounded cache of translated shaders in front of GLSLTranslate.
+//
+//              Shaders are keyed by their source text, shader type, options
+//              and feature level. Translation is deterministic for a given
+//              key, so a hit hands back the same converted shader that the
+//              first translation produced. Callers must treat the shader as
+//              immutable since it is shared. Translations with EnableStats
+//              are not cached, since their stats belong to one translation.
+//
+//              The cache evicts the least recently used shaders to stay
+//              within its memory budget, charging each entry for the size of
+//              its converted shader plus its copy of the source. The cache
+//              is not thread safe; unlike GLSLTranslate itself, it must only
+//              be used from one thread at a time.
+//
+//              Optionally the cache is backed by a directory, so that
+//              translations survive the process. Each translation is stored
+//              in a file named after the hash of its key, holding the full
+//              key and the shader in the format of CGLSLShaderSerializer.
+//              The key includes GLSLTranslatorOutputVersion and the build
+//              stamp of the translator, so files written by a translator
+//              that produced different output are never used.
+//              Files are mapped to read them and are replaced atomically
+//              when written, so concurrent processes only ever see complete
+//              files. Failures to read or write the directory never fail a
+//              translation; the shader is translated instead.
+//
+//------------------------------------------------------------------------------
+class CGLSLTranslationCache : public IUnknown
+{
+public:
+    HRESULT Translate(
+        __in BSTR bstrInput,                                                // Input unicode GLSL string
+        GLSLShaderType::Enum shaderType,                                    // Indicates what kind of shader is being translated
+        UINT uOptions,                                                      // Translation options
+        WebGLFeatureLevel glFeatureLevel,                                   // Feature level we're translating for
+        __deref_out CGLSLConvertedShader** ppConvertedShader                // Converted shader
+        );
+
+    void Clear();
+
+    UINT GetHitCount() const { return _uHitCount; }
+    UINT GetMissCount() const { return _uMissCount; }
+    UINT GetEvictionCount() const { return _uEvictionCount; }
+    UINT GetEntryCount() const { return _uEntryCount; }
+    UINT GetMemoryUsed() const { return _cbMemoryUsed; }
+    UINT GetMemoryBudget() const { return _cbMemoryBudget; }
+    UINT GetDiskHitCount() const { return _uDiskHitCount; }
+    UINT GetBypassCount() const { return _uBypassCount; }
+    bool IsPersistent() const { return _spszDirectory.GetLength() > 0; }
+
+protected:
+    CGLSLTranslationCache();
+    ~CGLSLTranslationCache();
+
+    HRESULT Initialize(UINT cbMemoryBudget);
+
+    HRESULT Initialize(
+        UINT cbMemoryBudget,                                                // Maximum memory the cached shaders may use
+        __in_z_opt const WCHAR* pwszDirectory                               // Directory to persist translations in, or null
+        );
+
+private:
+    HRESULT TranslateThroughCache(
+        __in BSTR bstrInput,                                                // Input unicode GLSL string
+        GLSLShaderType::Enum shaderType,                                    // Indicates what kind of shader is being translated
+        UINT uOptions,                                                      // Translation options
+        WebGLFeatureLevel glFeatureLevel,                                   // Feature level we're translating for
+        __deref_out CGLSLConvertedShader** ppConvertedShader                // Converted shader
+        );
+
+    static UINT GetTranslatorBuildStamp();
+
+    static UINT64 ComputeHash(
+        __in_ecount(cchSource) const WCHAR* pwchSource,                     // Source to hash
+        UINT cchSource,                                                     // Number of characters in the source
+        GLSLShaderType::Enum shaderType,                                    // Type of shader
+        UINT uOptions,                                                      // Translation options
+        WebGLFeatureLevel glFeatureLevel                                    // Feature level
+        );
+
+    UINT BucketFromHash(UINT64 uHash) const { return static_cast<UINT>(uHash) & (_aryBuckets.GetCount() - 1); }
+
+    HRESULT GetDiskPath(
+        UINT64 uHash,                                                       // Hash of the key
+        __inout CMutableString<WCHAR>& spszPath                             // Path of the file
+        ) const;
+
+    HRESULT LoadFromDisk(
+        UINT64 uHash,                                                       // Hash of the key
+        __in_ecount(cchSource) const WCHAR* pwchSource,                     // Source to look for
+        UINT cchSource,                                                     // Number of characters in the source
+        GLSLShaderType::Enum shaderType,                                    // Type of shader
+        UINT uOptions,                                                      // Translation options
+        WebGLFeatureLevel glFeatureLevel,                                   // Feature level
+        __deref_out_opt CGLSLConvertedShader** ppConvertedShader            // Restored shader, or null if not on disk
+        ) const;
+
+    HRESULT StoreToDisk(
+        __in const CGLSLTranslationCacheEntry* pEntry                       // Entry to persist
+        ) const;
+
+    HRESULT AddEntry(__in CGLSLTranslationCacheEntry* pEntry);
+    void EvictLeastRecent();
+    void RemoveEntry(__in CGLSLTranslationCacheEntry* pEntry);
+    void MarkMostRecent(__in CGLSLTranslationCacheEntry* pEntry);
+    void UnlinkRecent(__in CGLSLTranslationCacheEntry* pEntry);
+    HRESULT GrowBuckets();
+
+private:
+    static const UINT s_uInitialBucketCount = 64;                           // Must be a power of two
+    static const UINT s_uFileMagic = 0x43534C47;                            // 'GLSC'
+    static const UINT s_uFileVersion = 2;                                   // Bump when the file header changes; bump GLSLTranslatorOutputVersion when the translation changes
+
+    CMutableString<WCHAR> _spszDirectory;                                   // Directory to persist translations in, if any
+
+    CModernArray<CGLSLTranslationCacheEntry*> _aryBuckets;                  // Hash buckets, each a chain of entries
+    CGLSLTranslationCacheEntry* _pMostRecent;                               // Head of the most recently used list
+    CGLSLTranslationCacheEntry* _pLeastRecent;                              // Tail of the most recently used list
+    UINT _uEntryCount;                                                      // Number of entries in the cache
+    UINT _cbMemoryUsed;                                                     // Memory charged for all entries
+    UINT _cbMemoryBudget;                                                   // Maximum memory the entries may use
+    UINT _uHitCount;                                                        // Number of translations served from the cache
+    UINT _uMissCount;                                                       // Number of translations that were not in memory
+    UINT _uEvictionCount;                                                   // Number of entries evicted to stay within budget
+    UINT _uDiskHitCount;                                                    // Number of misses that were restored from the directory
+    UINT _uBypassCount;                                                     // Number of translations with stats, which skip the cache
+};
@@ -0,0 +1,166 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#include "PreComp.hxx"
+#include "GLSLTranslationStats.hxx"
+#include "GLSLArena.hxx"
+#include "CollectionNode.hxx"
+#include "SimpleStack.hxx"
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Constructor
+//
+//-----------------------------------------------------------------------------
+CGLSLTranslationStats::CGLSLTranslationStats() :
+    _llFrequency(0),
+    _uInputSize(0),
+    _uPreprocessedSize(0),
+    _uOutputSize(0),
+    _uMacroExpansionCount(0),
+    _uSymbolCount(0),
+    _uTotalNodeCount(0),
+    _uArenaAllocationCount(0),
+    _uArenaChunkCount(0),
+    _cbArenaAllocated(0)
+{
+    ::ZeroMemory(_rgPhaseMicroseconds, sizeof(_rgPhaseMicroseconds));
+    ::ZeroMemory(_rgNodeCounts, sizeof(_rgNodeCounts));
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Initialize
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLTranslationStats::Initialize()
+{
+    LARGE_INTEGER liFrequency;
+    ::QueryPerformanceFrequency(&liFrequency);
+    _llFrequency = liFrequency.QuadPart;
+
+    return S_OK;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   AddPhaseTime
+//
+//  Synopsis:   Add the time since the given counter value to a phase. Phases
+//              are added to rather than set so that a phase can be timed in
+//              more than one piece.
+//
+//-----------------------------------------------------------------------------
+void CGLSLTranslationStats::AddPhaseTime(
+    GLSLTranslationPhase::Enum phase,                           // Phase to add the time to
+    const LARGE_INTEGER& liStart                                // Counter value when the phase started
+    )
+{
+    LARGE_INTEGER liEnd;
+    ::QueryPerformanceCounter(&liEnd);
+
+    if (_llFrequency > 0 && liEnd.QuadPart > liStart.QuadPart)
+    {
+        UINT64 ullTicks = static_cast<UINT64>(liEnd.QuadPart - liStart.QuadPart);
+        _rgPhaseMicroseconds[phase] += (ullTicks * 1000000) / static_cast<UINT64>(_llFrequency);
+    }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetTotalMicroseconds
+//
+//  Synopsis:   Wall time of all of the phases together.
+//
+//-----------------------------------------------------------------------------
+UINT64 CGLSLTranslationStats::GetTotalMicroseconds() const
+{
+    UINT64 ullTotal = 0;
+    for (UINT i = 0; i < GLSLTranslationPhase::count; i++)
+    {
+        ullTotal += _rgPhaseMicroseconds[i];
+    }
+
+    return ullTotal;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   RecordArena
+//
+//  Synopsis:   Take the allocation counts from the arena of the translation.
+//
+//-----------------------------------------------------------------------------
+void CGLSLTranslationStats::RecordArena(__in const CGLSLArena* pArena)
+{
+    _uArenaAllocationCount = pArena->GetAllocationCount();
+    _uArenaChunkCount = pArena->GetChunkCount();
+    _cbArenaAllocated = pArena->GetBytesAllocated();
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   CountNodes
+//
+//  Synopsis:   Count the nodes in the tree under the given root by type. This
+//              uses its own stack rather than recursing, since it is not
+//              worth failing a translation over stats for a deep tree.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLTranslationStats::CountNodes(__in ParseTreeNode* pRoot)
+{
+    CHK_START;
+
+    ::ZeroMemory(_rgNodeCounts, sizeof(_rgNodeCounts));
+    _uTotalNodeCount = 0;
+
+    CSimpleStack<ParseTreeNode*> pendingStack;
+    CHK(pendingStack.Push(pRoot));
+
+    while (!pendingStack.IsEmpty())
+    {
+        ParseTreeNode* pNode;
+        CHK(pendingStack.Pop(/*out*/pNode));
+
+        _rgNodeCounts[pNode->GetParseNodeType()]++;
+        _uTotalNodeCount++;
+
+        if (pNode->IsCollectionNode())
+        {
+            CollectionNode* pCollection = pNode->AsCollection();
+            for (UINT i = 0; i < pCollection->GetChildCount(); i++)
+            {
+                ParseTreeNode* pChild = pCollection->GetChild(i);
+                if (pChild != nullptr)
+                {
+                    CHK(pendingStack.Push(pChild));
+                }
+            }
+        }
+    }
+
+    CHK_RETURN;
+}
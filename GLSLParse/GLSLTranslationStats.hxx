@@ -0,0 +1,143 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#pragma once
+
+#include "ParseTreeNode.hxx"
+
+class CGLSLArena;
+
+//+-----------------------------------------------------------------------------
+//
+//  Enum:       GLSLTranslationPhase
+//
+//  Synopsis:   The phases of a translation that are timed when stats are
+//              enabled, in the order that they run.
+//
+//------------------------------------------------------------------------------
+namespace GLSLTranslationPhase
+{
+    enum Enum
+    {
+        ConvertInput,                   // Conversion of the input to ASCII
+        Preprocess,                     // Running the preprocessor
+        Parse,                          // Lexing and parsing the preprocessed shader into a tree
+        Verify,                         // Type verification of the tree
+        VerifyInputs,                   // Verification of the attributes, uniforms and varyings
+        Transform,                      // Rewriting the verified tree for HLSL
+        Output,                         // Writing the HLSL
+        count
+    };
+}
+
+//+-----------------------------------------------------------------------------
+//
+//  Class:      CGLSLTranslationStats
+//
+//  Synopsis:   Metrics for one translation. These are only gathered when the
+//              translation is run with GLSLTranslateOptions::EnableStats, and
+//              are available from the converted shader afterwards.
+//
+//------------------------------------------------------------------------------
+class CGLSLTranslationStats : public IUnknown
+{
+public:
+    CGLSLTranslationStats();
+
+    void AddPhaseTime(GLSLTranslationPhase::Enum phase, const LARGE_INTEGER& liStart);
+    void SetInputSize(UINT uSize) { _uInputSize = uSize; }
+    void SetPreprocessedSize(UINT uSize) { _uPreprocessedSize = uSize; }
+    void SetOutputSize(UINT uSize) { _uOutputSize = uSize; }
+    void SetMacroExpansionCount(UINT uCount) { _uMacroExpansionCount = uCount; }
+    void SetSymbolCount(UINT uCount) { _uSymbolCount = uCount; }
+    void RecordArena(__in const CGLSLArena* pArena);
+    HRESULT CountNodes(__in ParseTreeNode* pRoot);
+
+    UINT64 GetPhaseMicroseconds(GLSLTranslationPhase::Enum phase) const { return _rgPhaseMicroseconds[phase]; }
+    UINT64 GetTotalMicroseconds() const;
+    UINT GetInputSize() const { return _uInputSize; }
+    UINT GetPreprocessedSize() const { return _uPreprocessedSize; }
+    UINT GetOutputSize() const { return _uOutputSize; }
+    UINT GetMacroExpansionCount() const { return _uMacroExpansionCount; }
+    UINT GetSymbolCount() const { return _uSymbolCount; }
+    UINT GetNodeCount(ParseNodeType::Enum nodeType) const { return _rgNodeCounts[nodeType]; }
+    UINT GetTotalNodeCount() const { return _uTotalNodeCount; }
+    UINT GetArenaAllocationCount() const { return _uArenaAllocationCount; }
+    UINT GetArenaChunkCount() const { return _uArenaChunkCount; }
+    size_t GetArenaBytesAllocated() const { return _cbArenaAllocated; }
+    UINT GetMemorySize() const { return sizeof(*this); }
+
+protected:
+    HRESULT Initialize();
+
+private:
+    LONGLONG _llFrequency;                                                  // Performance counter ticks per second
+    UINT64 _rgPhaseMicroseconds[GLSLTranslationPhase::count];               // Wall time spent in each phase
+    UINT _uInputSize;                                                       // Length of the input after conversion to ASCII
+    UINT _uPreprocessedSize;                                                // Length of the preprocessor output
+    UINT _uOutputSize;                                                      // Length of the converted HLSL
+    UINT _uMacroExpansionCount;                                             // Number of macros the preprocessor expanded
+    UINT _uSymbolCount;                                                     // Number of symbols in the parser symbol table, including known symbols
+    UINT _rgNodeCounts[ParseNodeType::count];                               // Number of nodes of each type in the final tree
+    UINT _uTotalNodeCount;                                                  // Number of nodes in the final tree
+    UINT _uArenaAllocationCount;                                            // Number of objects allocated from the translation arena
+    UINT _uArenaChunkCount;                                                 // Number of chunks the translation arena allocated
+    size_t _cbArenaAllocated;                                               // Number of bytes allocated from the translation arena
+};
+
+//+-----------------------------------------------------------------------------
+//
+//  Class:      CGLSLTranslationPhaseTimer
+//
+//  Synopsis:   Adds the time from construction to destruction to a phase of
+//              the given stats. Does nothing when there are no stats, which
+//              is the case unless they were asked for.
+//
+//------------------------------------------------------------------------------
+class CGLSLTranslationPhaseTimer
+{
+public:
+    CGLSLTranslationPhaseTimer(__in_opt CGLSLTranslationStats* pStats, GLSLTranslationPhase::Enum phase) : _pStats(pStats), _phase(phase)
+    {
+        if (_pStats != nullptr)
+        {
+            ::QueryPerformanceCounter(&_liStart);
+        }
+    }
+
+    ~CGLSLTranslationPhaseTimer()
+    {
+        if (_pStats != nullptr)
+        {
+            _pStats->AddPhaseTime(_phase, _liStart);
+        }
+    }
+
+private:
+    CGLSLTranslationStats* _pStats;                                         // Stats to add the time to, if any
+    GLSLTranslationPhase::Enum _phase;                                      // Phase being timed
+    LARGE_INTEGER _liStart;                                                 // Counter value at construction
+};
@@ -29,25 +29,21 @@
 #include "BasicGLSLType.hxx"
 #include "ArrayGLSLType.hxx"
 #include "StructGLSLType.hxx"
+#include "GLSLTypeTable.hxx"
 #include "RefCounted.hxx"
 
 //+----------------------------------------------------------------------------
 //
 //  Function:   CreateFromBasicTypeToken
 //
-//  Synopsis:   Creates a BasicGLSLType from the passed in basic token type.
+//  Synopsis:   Gets the BasicGLSLType for the passed in basic token type.
+//              Basic types are shared by the whole process, so this does
+//              not allocate.
 //
 //-----------------------------------------------------------------------------
 HRESULT GLSLType::CreateFromBasicTypeToken(int basicType, __deref_out GLSLType** ppNewType)
 {
-    CHK_START;
-
-    TSmartPointer<BasicGLSLType> spBasicType;
-    CHK(RefCounted<BasicGLSLType>::Create(basicType, /*out*/spBasicType));
-
-    spBasicType.CopyTo(ppNewType);
-
-    CHK_RETURN;
+    return CGLSLTypeTable::GetBasicType(basicType, ppNewType);
 }
 
 //+----------------------------------------------------------------------------
@@ -58,6 +54,10 @@ HRESULT GLSLType::CreateFromBasicTypeToken(int basicType, __deref_out GLSLType**
 //              the passed in type. Otherwise returns a pointer to the input
 //              object with an extra reference.
 //
+//              While a type table is current, array types come from it and
+//              are shared by everything in the translation that asks for
+//              the same array.
+//
 //-----------------------------------------------------------------------------
 HRESULT GLSLType::CreateFromType(__in GLSLType* pType, int arraySize, __deref_out GLSLType** ppNewType)
 {
@@ -66,10 +66,19 @@ HRESULT GLSLType::CreateFromType(__in GLSLType* pType, int arraySize, __deref_ou
     if (arraySize != -1)
     {
         CHK_VERIFY(!pType->IsArrayType());
-        TSmartPointer<ArrayGLSLType> spArrayType;
-        CHK(RefCounted<ArrayGLSLType>::Create(pType, arraySize, /*out*/spArrayType));
 
-        spArrayType.CopyTo(ppNewType);
+        CGLSLTypeTable* pTypeTable = CGLSLTypeTable::GetCurrent();
+        if (pTypeTable != nullptr)
+        {
+            CHK(pTypeTable->GetArrayType(pType, arraySize, ppNewType));
+        }
+        else
+        {
+            TSmartPointer<ArrayGLSLType> spArrayType;
+            CHK(RefCounted<ArrayGLSLType, MultiThreadedRefCount>::Create(pType, arraySize, /*out*/spArrayType));
+
+            spArrayType.CopyTo(ppNewType);
+        }
     }
     else
     {
@@ -98,7 +107,7 @@ HRESULT GLSLType::CreateStructTypeFromIdentifierInfoAry(
     CHK_START;
 
     TSmartPointer<StructGLSLType> spStructType;
-    CHK(RefCounted<StructGLSLType>::Create(aryIdInfo, /*out*/spStructType));
+    CHK(RefCounted<StructGLSLType, MultiThreadedRefCount>::Create(aryIdInfo, /*out*/spStructType));
     spStructType.CopyTo(ppNewType);
 
     CHK_RETURN;
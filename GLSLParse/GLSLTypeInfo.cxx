@@ -83,3 +83,25 @@ HRESULT BasicGLSLTypeInfo::GetInfo(
 
     CHK_RETURN;
 }
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   IsKnownType
+//
+//  Synopsis:   Returns whether there is info for the type. Unlike GetInfo,
+//              this is for types that did not come from our parser, so an
+//              unknown type is not a bug.
+//
+//-----------------------------------------------------------------------------
+bool BasicGLSLTypeInfo::IsKnownType(int type)
+{
+    for (int i = 0; i < ARRAYSIZE(s_typeInfo); i++)
+    {
+        if (s_typeInfo[i]._type == type)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -51,4 +51,6 @@ struct BasicGLSLTypeInfo
         int type,                                   // Type to get info for
         __deref_out const BasicGLSLTypeInfo** pInfo // Info for that type
         );
+
+    static bool IsKnownType(int type);
 };
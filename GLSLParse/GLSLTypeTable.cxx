@@ -0,0 +1,273 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#include "PreComp.hxx"
+#include "GLSLTypeTable.hxx"
+#include "RefCounted.hxx"
+
+// The type table that types created on this thread are interned in, if any
+static __declspec(thread) CGLSLTypeTable* s_pCurrentTypeTable = nullptr;
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Constructor
+//
+//-----------------------------------------------------------------------------
+CGLSLTypeTable::CGLSLTypeTable() :
+    _uRequestCount(0)
+{
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Initialize
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLTypeTable::Initialize()
+{
+    CHK_START;
+
+    CHK(_aryBuckets.Resize(s_uInitialBucketCount));
+    for (UINT i = 0; i < s_uInitialBucketCount; i++)
+    {
+        _aryBuckets[i] = s_iEmptyBucket;
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetCurrent
+//
+//  Synopsis:   Returns the type table for the current thread, if there is one.
+//
+//-----------------------------------------------------------------------------
+CGLSLTypeTable* CGLSLTypeTable::GetCurrent()
+{
+    return s_pCurrentTypeTable;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   SetCurrent
+//
+//  Synopsis:   Sets the type table for the current thread. Used by
+//              CGLSLTypeTableScope.
+//
+//-----------------------------------------------------------------------------
+void CGLSLTypeTable::SetCurrent(
+    __in_opt CGLSLTypeTable* pTypeTable                         // Type table to make current
+    )
+{
+    s_pCurrentTypeTable = pTypeTable;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetBasicTypeTable
+//
+//  Synopsis:   Get the process-wide basic type table. It is built on first
+//              use (the static local makes that thread safe) and never
+//              changes afterwards, so it can be read without locking.
+//
+//-----------------------------------------------------------------------------
+const CGLSLTypeTable::BasicTypeTable& CGLSLTypeTable::GetBasicTypeTable()
+{
+    static const BasicTypeTable s_basicTypes;
+
+    return s_basicTypes;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   BasicTypeTable constructor
+//
+//  Synopsis:   Give each type in the table its token. The types live in the
+//              table itself, so building it cannot fail.
+//
+//-----------------------------------------------------------------------------
+CGLSLTypeTable::BasicTypeTable::BasicTypeTable()
+{
+    for (int i = 0; i < ARRAYSIZE(_rgTypes); i++)
+    {
+        _rgTypes[i].Initialize(s_iFirstToken + i);
+    }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetBasicType
+//
+//  Synopsis:   Returns the shared type for a basic type token. Every basic
+//              type is one of these, so two basic types are equal exactly
+//              when they are the same object.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLTypeTable::GetBasicType(
+    int basicType,                                              // Bison token of the type
+    __deref_out GLSLType** ppType                               // Shared basic type
+    )
+{
+    CHK_START;
+
+    // Anything outside the range is not a type token, which means the
+    // caller has a bug
+    CHK_VERIFY(basicType >= BasicTypeTable::s_iFirstToken && basicType <= BasicTypeTable::s_iLastToken);
+
+    CGLSLTypeTable* pCurrent = GetCurrent();
+    if (pCurrent != nullptr)
+    {
+        pCurrent->_uRequestCount++;
+    }
+
+    // The types are immortal, so handing out a reference does not change
+    // them and casting away const is safe.
+    const BasicTypeTable& basicTypes = GetBasicTypeTable();
+    (*ppType) = const_cast<CImmortalBasicGLSLType*>(&basicTypes._rgTypes[basicType - BasicTypeTable::s_iFirstToken]);
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   HashArrayType
+//
+//  Synopsis:   Hash an array type by the identity of its element type and its
+//              size. Element types are basic or struct types, which are
+//              already unique, so identity is enough.
+//
+//-----------------------------------------------------------------------------
+UINT CGLSLTypeTable::HashArrayType(
+    __in const GLSLType* pElementType,                          // Type of the array elements
+    int arraySize                                               // Size of the array
+    )
+{
+    ULONGLONG ullPointer = reinterpret_cast<UINT_PTR>(pElementType);
+    UINT uHash = static_cast<UINT>(ullPointer ^ (ullPointer >> 32)) ^ (static_cast<UINT>(arraySize) * 0x9E3779B1);
+
+    // The low bits of the pointer are always zero since allocations are
+    // aligned, so fold the high bits into the ones that pick the bucket
+    return uHash ^ (uHash >> 16);
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetArrayType
+//
+//  Synopsis:   Returns the array type for an element type and size, creating
+//              it the first time it is asked for.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLTypeTable::GetArrayType(
+    __in GLSLType* pElementType,                                // Type of the array elements
+    int arraySize,                                              // Size of the array
+    __deref_out GLSLType** ppType                               // Shared array type
+    )
+{
+    CHK_START;
+
+    Assert(!pElementType->IsArrayType());
+
+    _uRequestCount++;
+
+    const UINT uMask = _aryBuckets.GetCount() - 1;
+    UINT uBucket = HashArrayType(pElementType, arraySize) & uMask;
+
+    TSmartPointer<ArrayGLSLType> spArrayType;
+    while (spArrayType == nullptr && _aryBuckets[uBucket] != s_iEmptyBucket)
+    {
+        ArrayGLSLType* pArrayType = _aryArrayTypes[_aryBuckets[uBucket]];
+
+        TSmartPointer<GLSLType> spExistingElementType;
+        CHK(pArrayType->GetArrayElementType(&spExistingElementType));
+        if (spExistingElementType == pElementType && pArrayType->GetArraySize() == arraySize)
+        {
+            spArrayType = pArrayType;
+        }
+        else
+        {
+            uBucket = (uBucket + 1) & uMask;
+        }
+    }
+
+    if (spArrayType == nullptr)
+    {
+        CHK(RefCounted<ArrayGLSLType, MultiThreadedRefCount>::Create(pElementType, arraySize, /*out*/spArrayType));
+
+        // The bucket only refers to the type once it is in the array
+        CHK(_aryArrayTypes.Add(spArrayType));
+        _aryBuckets[uBucket] = static_cast<int>(_aryArrayTypes.GetCount() - 1);
+
+        // Keep the load factor at or below one half
+        if (_aryArrayTypes.GetCount() * 2 > _aryBuckets.GetCount())
+        {
+            CHK(GrowBuckets());
+        }
+    }
+
+    spArrayType.CopyTo(ppType);
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GrowBuckets
+//
+//  Synopsis:   Doubles the number of buckets and rehashes the array types.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLTypeTable::GrowBuckets()
+{
+    CHK_START;
+
+    UINT uNewCount;
+    CHK(UIntMult(_aryBuckets.GetCount(), 2, &uNewCount));
+    CHK(_aryBuckets.Resize(uNewCount));
+
+    for (UINT i = 0; i < uNewCount; i++)
+    {
+        _aryBuckets[i] = s_iEmptyBucket;
+    }
+
+    const UINT uMask = uNewCount - 1;
+    for (UINT i = 0; i < _aryArrayTypes.GetCount(); i++)
+    {
+        TSmartPointer<GLSLType> spElementType;
+        CHK(_aryArrayTypes[i]->GetArrayElementType(&spElementType));
+
+        UINT uBucket = HashArrayType(spElementType, _aryArrayTypes[i]->GetArraySize()) & uMask;
+        while (_aryBuckets[uBucket] != s_iEmptyBucket)
+        {
+            uBucket = (uBucket + 1) & uMask;
+        }
+
+        _aryBuckets[uBucket] = static_cast<int>(i);
+    }
+
+    CHK_RETURN;
+}
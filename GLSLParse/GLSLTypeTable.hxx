@@ -0,0 +1,157 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#pragma once
+
+#include "GLSLType.hxx"
+#include "BasicGLSLType.hxx"
+#include "ArrayGLSLType.hxx"
+#include "GLSL.tab.h"
+
+//+-----------------------------------------------------------------------------
+//
+//  Class:      CGLSLTypeTable
+//
+//  Synopsis:   Hands out shared, immutable type objects so that creating a
+//              type does not allocate and equal types are the same object.
+//
+//              Basic types come from a process-wide table with one immortal
+//              object per Bison type token. Array types are hash-consed on
+//              their element type and size in the table that is current for
+//              the thread, which lives as long as one translation. Struct
+//              types need no table since each declaration is its own type.
+//
+//              A table is only current while a CGLSLTypeTableScope for it is
+//              active on the current thread; without one, array types are
+//              allocated each time they are asked for.
+//
+//------------------------------------------------------------------------------
+class CGLSLTypeTable : public IUnknown
+{
+public:
+    static HRESULT GetBasicType(
+        int basicType,                                                      // Bison token of the type
+        __deref_out GLSLType** ppType                                       // Shared basic type
+        );
+
+    HRESULT GetArrayType(
+        __in GLSLType* pElementType,                                        // Type of the array elements
+        int arraySize,                                                      // Size of the array
+        __deref_out GLSLType** ppType                                       // Shared array type
+        );
+
+    static CGLSLTypeTable* GetCurrent();
+
+    UINT GetRequestCount() const { return _uRequestCount; }
+    UINT GetArrayTypeCount() const { return _aryArrayTypes.GetCount(); }
+
+protected:
+    CGLSLTypeTable();
+
+    HRESULT Initialize();
+
+private:
+    friend class CGLSLTypeTableScope;
+    static void SetCurrent(__in_opt CGLSLTypeTable* pTypeTable);
+
+    static UINT HashArrayType(__in const GLSLType* pElementType, int arraySize);
+    HRESULT GrowBuckets();
+
+private:
+    //+-------------------------------------------------------------------------
+    //
+    //  Class:      CImmortalBasicGLSLType
+    //
+    //  Synopsis:   Basic type that lives as long as the process. Reference
+    //              counting is a no-op, so the type can be shared by threads
+    //              translating in parallel without any interlocked traffic.
+    //
+    //--------------------------------------------------------------------------
+    class CImmortalBasicGLSLType : public BasicGLSLType
+    {
+    public:
+        CImmortalBasicGLSLType() {}
+
+        void Initialize(int basicType) { BasicGLSLType::Initialize(basicType); }
+
+        // IUnknown
+        STDMETHOD(QueryInterface)(REFIID riid, __deref_out void** ppvObject) override { (*ppvObject) = nullptr; return E_NOINTERFACE; }
+        STDMETHOD_(ULONG, AddRef)() override { return 1; }
+        STDMETHOD_(ULONG, Release)() override { return 1; }
+    };
+
+    //+-------------------------------------------------------------------------
+    //
+    //  Struct:     BasicTypeTable
+    //
+    //  Synopsis:   Immutable table of the basic types, indexed by Bison token
+    //              from NO_TYPE to LEFT_EXPR_TYPE, shared by the process.
+    //
+    //--------------------------------------------------------------------------
+    struct BasicTypeTable
+    {
+        BasicTypeTable();
+
+        static const int s_iFirstToken = NO_TYPE;                           // Token of the first type in the table
+        static const int s_iLastToken = LEFT_EXPR_TYPE;                     // Token of the last type in the table
+
+        CImmortalBasicGLSLType _rgTypes[s_iLastToken - s_iFirstToken + 1];  // One type for each token in the range
+    };
+
+    static const BasicTypeTable& GetBasicTypeTable();
+
+    static const int s_iEmptyBucket = -1;                                   // Marker for an unused bucket
+    static const UINT s_uInitialBucketCount = 16;                           // Must be a power of 2
+
+    CModernArray<TSmartPointer<ArrayGLSLType>> _aryArrayTypes;              // Every array type handed out by this table
+    CModernArray<int> _aryBuckets;                                          // Hash buckets holding indices into _aryArrayTypes
+    UINT _uRequestCount;                                                    // Number of types asked for while the table was current
+};
+
+//+-----------------------------------------------------------------------------
+//
+//  Class:      CGLSLTypeTableScope
+//
+//  Synopsis:   Makes a type table the current one for the thread for the
+//              lifetime of the scope, restoring the previous table afterwards.
+//
+//------------------------------------------------------------------------------
+class CGLSLTypeTableScope
+{
+public:
+    CGLSLTypeTableScope(__in_opt CGLSLTypeTable* pTypeTable) : _pPrevious(CGLSLTypeTable::GetCurrent())
+    {
+        CGLSLTypeTable::SetCurrent(pTypeTable);
+    }
+
+    ~CGLSLTypeTableScope()
+    {
+        CGLSLTypeTable::SetCurrent(_pPrevious);
+    }
+
+private:
+    CGLSLTypeTable* _pPrevious;                                             // Type table that was current before this scope
+};
@@ -29,6 +29,11 @@
 #include "MemoryStream.hxx"
 #include "RefCounted.hxx"
 
+#if defined(_M_IX86) || defined(_M_X64)
+#include <emmintrin.h>
+#define GLSL_CONVERT_SSE2
+#endif
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   s_rgLegalChar
@@ -82,7 +87,8 @@ const bool CGLSLUnicodeConverter::s_rgWhitespaceChar[33] = {
 //              Since we only support a limited character set, we can be
 //              faster and more explicit than OS functions. We can look at
 //              each char and check that it is in our map and just cast if
-//              it is.
+//              it is. The whole string is narrowed straight into the spare
+//              capacity of the output stream.
 //
 //              Because this is called before preprocessing, characters outside
 //              of the allowed set do not cause an error. They are transformed
@@ -102,30 +108,137 @@ HRESULT CGLSLUnicodeConverter::ConvertToAscii(
     CHK(RefCounted<CMemoryStream>::Create(/*out*/spConverted));
 
     UINT uLength = ::SysStringLen(bstrInput);
-    for (UINT i = 0; i < uLength; i++)
-    {
-        wchar_t c = bstrInput[i];
-        char converted = static_cast<char>(c);
+    CHKB(uLength < UINT_MAX);
 
-        // Reject anything that is not ASCII, or not in the GLSL char spec
-        if (!IsLegalChar(c))
-        {
-            converted = '$';
-        }
+    char* pNarrowed;
+    CHK(spConverted->ReserveBuffer(uLength + 1, &pNarrowed));
+
+    NarrowToAscii(bstrInput, uLength, pNarrowed);
 
-        // Store the converted value now
-        CHK(spConverted->WriteChar(converted));
-    }
-    
     // Our preprocessor assumes there is at least one newline in its
     // grammar. So we add it here.
-    CHK(spConverted->WriteChar('\n'));
+    pNarrowed[uLength] = '\n';
+
+    spConverted->CommitBuffer(uLength + 1);
 
     (*ppConverted) = spConverted.Extract();
 
     CHK_RETURN;
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   NarrowToAscii
+//
+//  Synopsis:   Convert UTF-16 code units to ASCII, replacing anything that
+//              is not ASCII or not in the GLSL char spec with '$'. Most of
+//              the string goes through the vector kernel where one exists,
+//              and the scalar loop handles the remainder.
+//
+//-----------------------------------------------------------------------------
+void CGLSLUnicodeConverter::NarrowToAscii(
+    __in_ecount(uLength) const wchar_t* pInput,                 // UTF-16 code units to convert
+    UINT uLength,                                               // Number of code units
+    __out_ecount(uLength) char* pOutput                         // One ASCII char per code unit
+    )
+{
+    UINT uConverted = NarrowToAsciiVector(pInput, uLength, pOutput);
+
+    NarrowToAsciiScalar(pInput + uConverted, uLength - uConverted, pOutput + uConverted);
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   NarrowToAsciiScalar
+//
+//  Synopsis:   Table driven conversion, one code unit at a time.
+//
+//-----------------------------------------------------------------------------
+void CGLSLUnicodeConverter::NarrowToAsciiScalar(
+    __in_ecount(uLength) const wchar_t* pInput,                 // UTF-16 code units to convert
+    UINT uLength,                                               // Number of code units
+    __out_ecount(uLength) char* pOutput                         // One ASCII char per code unit
+    )
+{
+    for (UINT i = 0; i < uLength; i++)
+    {
+        wchar_t c = pInput[i];
+
+        // Reject anything that is not ASCII, or not in the GLSL char spec
+        pOutput[i] = IsLegalChar(c) ? static_cast<char>(c) : '$';
+    }
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   NarrowToAsciiVector
+//
+//  Synopsis:   SSE2 conversion of 16 code units per step. Returns how many
+//              code units were converted, which is a multiple of 16; the
+//              caller converts the rest. Returns 0 where SSE2 is not
+//              available.
+//
+//              The code units are packed to bytes with unsigned saturation,
+//              so anything above 0xFF (and anything with the top bit set,
+//              which packs as negative) lands on 0x00 or 0xFF, both illegal.
+//              The bytes are then checked against the same set of legal
+//              characters as s_rgLegalChar: 9-13 and 32-126, less a handful
+//              of punctuation. This must be kept in sync with that table.
+//
+//-----------------------------------------------------------------------------
+UINT CGLSLUnicodeConverter::NarrowToAsciiVector(
+    __in_ecount(uLength) const wchar_t* pInput,                 // UTF-16 code units to convert
+    UINT uLength,                                               // Number of code units
+    __out_ecount_part(uLength, return) char* pOutput            // One ASCII char per code unit
+    )
+{
+#ifdef GLSL_CONVERT_SSE2
+    const __m128i whitespaceBase = _mm_set1_epi8(9);
+    const __m128i whitespaceRange = _mm_set1_epi8(13 - 9);
+    const __m128i printableBase = _mm_set1_epi8(32);
+    const __m128i printableRange = _mm_set1_epi8(126 - 32);
+    const __m128i illegalChar = _mm_set1_epi8('$');
+
+    UINT i = 0;
+    for (; i + 16 <= uLength; i += 16)
+    {
+        __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pInput + i));
+        __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pInput + i + 8));
+        __m128i bytes = _mm_packus_epi16(low, high);
+
+        // x - base <= range as unsigned bytes, which is min(x - base, range) == x - base
+        __m128i whitespaceOffset = _mm_sub_epi8(bytes, whitespaceBase);
+        __m128i printableOffset = _mm_sub_epi8(bytes, printableBase);
+        __m128i legal = _mm_or_si128(
+            _mm_cmpeq_epi8(_mm_min_epu8(whitespaceOffset, whitespaceRange), whitespaceOffset),
+            _mm_cmpeq_epi8(_mm_min_epu8(printableOffset, printableRange), printableOffset)
+            );
+
+        // Printable characters that GLSL does not allow: " $ ' @ \ `
+        __m128i excluded = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('"')), _mm_cmpeq_epi8(bytes, illegalChar)),
+            _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\'')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('@')))
+            );
+        excluded = _mm_or_si128(
+            excluded,
+            _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\\')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('`')))
+            );
+        legal = _mm_andnot_si128(excluded, legal);
+
+        __m128i converted = _mm_or_si128(_mm_and_si128(legal, bytes), _mm_andnot_si128(legal, illegalChar));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pOutput + i), converted);
+    }
+
+    return i;
+#else
+    UNREFERENCED_PARAMETER(pInput);
+    UNREFERENCED_PARAMETER(uLength);
+    UNREFERENCED_PARAMETER(pOutput);
+
+    return 0;
+#endif
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   IsLegalChar
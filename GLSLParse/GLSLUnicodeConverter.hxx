@@ -44,10 +44,28 @@ public:
         __deref_out CMemoryStream** ppConverted                     // Output ASCII stream
         );
 
+    static void NarrowToAscii(
+        __in_ecount(uLength) const wchar_t* pInput,                 // UTF-16 code units to convert
+        UINT uLength,                                               // Number of code units
+        __out_ecount(uLength) char* pOutput                         // One ASCII char per code unit
+        );
+
+    static void NarrowToAsciiScalar(
+        __in_ecount(uLength) const wchar_t* pInput,                 // UTF-16 code units to convert
+        UINT uLength,                                               // Number of code units
+        __out_ecount(uLength) char* pOutput                         // One ASCII char per code unit
+        );
+
     static bool IsLegalChar(wchar_t c);
     static bool IsWhitespaceChar(char c);
 
 private:
+    static UINT NarrowToAsciiVector(
+        __in_ecount(uLength) const wchar_t* pInput,                 // UTF-16 code units to convert
+        UINT uLength,                                               // Number of code units
+        __out_ecount_part(uLength, return) char* pOutput            // One ASCII char per code unit
+        );
+
     static const bool s_rgLegalChar[128];                           // Legal character map
     static const bool s_rgWhitespaceChar[33];                       // Whitespace character map
 };
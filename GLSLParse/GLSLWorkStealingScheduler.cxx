@@ -0,0 +1,168 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#include "PreComp.hxx"
+#include "GLSLWorkStealingScheduler.hxx"
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Constructor
+//
+//-----------------------------------------------------------------------------
+CGLSLWorkStealingScheduler::CGLSLWorkStealingScheduler() :
+    _lStealCount(0)
+{
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Initialize
+//
+//  Synopsis:   Splits the items into one contiguous range per worker.
+//
+//-----------------------------------------------------------------------------
+HRESULT CGLSLWorkStealingScheduler::Initialize(
+    UINT cItems,                                                // Number of work items
+    UINT cWorkers                                               // Number of workers
+    )
+{
+    CHK_START;
+
+    CHKB_HR(cWorkers > 0, E_INVALIDARG);
+    CHK(_aryRanges.Resize(cWorkers));
+
+    UINT uBegin = 0;
+    for (UINT i = 0; i < cWorkers; i++)
+    {
+        // Spread the remainder over the first workers
+        UINT cWorkerItems = cItems / cWorkers + ((i < cItems % cWorkers) ? 1 : 0);
+        _aryRanges[i]._range = MakeRange(uBegin, uBegin + cWorkerItems);
+        uBegin += cWorkerItems;
+    }
+
+    Assert(uBegin == cItems);
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   TryGetItem
+//
+//  Synopsis:   Takes the next item from the worker's own range, or steals
+//              from another worker when the range is empty. Returns false
+//              when no items are left to hand out.
+//
+//-----------------------------------------------------------------------------
+bool CGLSLWorkStealingScheduler::TryGetItem(
+    UINT uWorker,                                               // Worker asking for an item
+    __out UINT* puItem                                          // Item to work on
+    )
+{
+    Assert(uWorker < _aryRanges.GetCount());
+
+    volatile LONGLONG* pRange = &_aryRanges[uWorker]._range;
+    for (;;)
+    {
+        LONGLONG range = *pRange;
+        UINT uBegin = GetRangeBegin(range);
+        UINT uEnd = GetRangeEnd(range);
+
+        if (uBegin == uEnd)
+        {
+            break;
+        }
+
+        // A thief may have shrunk the range since we read it, in which case
+        // the exchange fails and we look again.
+        if (::InterlockedCompareExchange64(pRange, MakeRange(uBegin + 1, uEnd), range) == range)
+        {
+            (*puItem) = uBegin;
+            return true;
+        }
+    }
+
+    return TrySteal(uWorker, puItem);
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   TrySteal
+//
+//  Synopsis:   Steals the back half of the largest range of another worker.
+//              The first stolen item is returned and the rest become the
+//              thief's own range.
+//
+//              The thief's range is empty while it steals, so no other
+//              worker changes it and it can simply be replaced.
+//
+//-----------------------------------------------------------------------------
+bool CGLSLWorkStealingScheduler::TrySteal(
+    UINT uWorker,                                               // Worker that ran out of items
+    __out UINT* puItem                                          // Item to work on
+    )
+{
+    UINT cWorkers = _aryRanges.GetCount();
+    for (;;)
+    {
+        UINT uVictim = cWorkers;
+        UINT cMostRemaining = 0;
+        LONGLONG victimRange = 0;
+        for (UINT i = 1; i < cWorkers; i++)
+        {
+            // Start looking after ourselves so that thieves spread out
+            UINT uCandidate = (uWorker + i) % cWorkers;
+            LONGLONG range = _aryRanges[uCandidate]._range;
+            UINT cRemaining = GetRangeEnd(range) - GetRangeBegin(range);
+            if (cRemaining > cMostRemaining)
+            {
+                uVictim = uCandidate;
+                cMostRemaining = cRemaining;
+                victimRange = range;
+            }
+        }
+
+        if (uVictim == cWorkers)
+        {
+            return false;
+        }
+
+        UINT uBegin = GetRangeBegin(victimRange);
+        UINT uEnd = GetRangeEnd(victimRange);
+        UINT uSplit = uEnd - (cMostRemaining + 1) / 2;
+
+        if (::InterlockedCompareExchange64(&_aryRanges[uVictim]._range, MakeRange(uBegin, uSplit), victimRange) == victimRange)
+        {
+            ::InterlockedIncrement(&_lStealCount);
+
+            Assert(GetRangeBegin(_aryRanges[uWorker]._range) == GetRangeEnd(_aryRanges[uWorker]._range));
+            ::InterlockedExchange64(&_aryRanges[uWorker]._range, MakeRange(uSplit + 1, uEnd));
+
+            (*puItem) = uSplit;
+            return true;
+        }
+    }
+}
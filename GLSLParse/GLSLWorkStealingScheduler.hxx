@@ -0,0 +1,95 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+#pragma once
+
+#include <foundation/collections.hxx>
+
+//+-----------------------------------------------------------------------------
+//
+//  Class:      CGLSLWorkStealingScheduler
+//
+//  Synopsis:   Hands out the indices of a fixed set of work items to a fixed
+//              set of workers, balancing the load by work stealing.
+//
+//              Each worker starts with a contiguous range of the items and
+//              takes items from the front of its own range. A worker whose
+//              range is empty steals the back half of the largest remaining
+//              range. Ranges are packed into 64-bit values that are updated
+//              with compare-exchange, so workers never block each other, and
+//              every item is handed out exactly once.
+//
+//              TryGetItem may be called concurrently by different workers,
+//              but each worker index must only be used by one thread.
+//
+//------------------------------------------------------------------------------
+class CGLSLWorkStealingScheduler
+{
+public:
+    CGLSLWorkStealingScheduler();
+
+    HRESULT Initialize(
+        UINT cItems,                                                        // Number of work items
+        UINT cWorkers                                                       // Number of workers
+        );
+
+    bool TryGetItem(
+        UINT uWorker,                                                       // Worker asking for an item
+        __out UINT* puItem                                                  // Item to work on
+        );
+
+    UINT GetWorkerCount() const { return _aryRanges.GetCount(); }
+    UINT GetStealCount() const { return static_cast<UINT>(_lStealCount); }
+
+private:
+    bool TrySteal(
+        UINT uWorker,                                                       // Worker that ran out of items
+        __out UINT* puItem                                                  // Item to work on
+        );
+
+    static LONGLONG MakeRange(UINT uBegin, UINT uEnd) { return static_cast<LONGLONG>((static_cast<ULONGLONG>(uEnd) << 32) | uBegin); }
+    static UINT GetRangeBegin(LONGLONG range) { return static_cast<UINT>(static_cast<ULONGLONG>(range)); }
+    static UINT GetRangeEnd(LONGLONG range) { return static_cast<UINT>(static_cast<ULONGLONG>(range) >> 32); }
+
+private:
+    //+-------------------------------------------------------------------------
+    //
+    //  Struct:     WorkerRange
+    //
+    //  Synopsis:   The items left for one worker, padded to a cache line so
+    //              that workers taking items do not contend on each other's
+    //              ranges.
+    //
+    //--------------------------------------------------------------------------
+    struct WorkerRange
+    {
+        volatile LONGLONG _range;                                           // Packed begin and end of the range
+        BYTE _rgPadding[64 - sizeof(LONGLONG)];                             // Keeps ranges on separate cache lines
+    };
+
+    CModernArray<WorkerRange> _aryRanges;                                   // Range of items for each worker
+    volatile LONG _lStealCount;                                             // Number of successful steals
+};
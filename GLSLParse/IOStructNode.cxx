@@ -152,7 +152,7 @@ HRESULT IOStructNode::OutputHLSL(__in IStringStream* pOutput)
 
         // Make a struct info
         TSmartPointer<CGLSLIOStructInfo> spStructInfo;
-        CHK(RefCounted<CGLSLIOStructInfo>::Create(
+        CHK(RefCounted<CGLSLIOStructInfo, MultiThreadedRefCount>::Create(
             _structType,
             GetParser()->GetFeaturesUsed(),
             GetParser()->UseSymbolTable(), 
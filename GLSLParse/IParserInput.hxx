@@ -31,11 +31,33 @@
 //  Interface:  IParserInput
 //
 //  Synopsis:   This interface encapsulates the logic for pulling input into the
-//              Bison / Flex code from some source
+//              Bison / Flex code from some source.
+//
+//              PullInput fills as much of the given buffer as it can and
+//              returns the number of characters written, or 0 at the end of
+//              the input. Flex asks for large blocks, so implementations
+//              should copy in bulk rather than one character at a time.
+//
+//              Inputs that hold their text in a single buffer can also hand
+//              that buffer to the scanner with GetScanBuffer, which lets flex
+//              scan it in place (yy_scan_buffer) and skip PullInput entirely.
+//              The scanner writes into the buffer while it runs, so the input
+//              must not be pulled or scanned again afterwards. If the scanner
+//              refuses the buffer, ReleaseScanBuffer hands it back.
 //
 //------------------------------------------------------------------------------
 interface IParserInput : public IUnknown
 {
 public:
-    virtual int PullInput(__out_ecount(1) char* buf) = 0;
+    virtual int PullInput(
+        __out_ecount_part(maxSize, return) char* buf,               // Buffer to fill
+        int maxSize                                                 // Size of the buffer
+        ) = 0;
+
+    virtual HRESULT GetScanBuffer(
+        __deref_out_ecount(*puSize) char** ppBuffer,                // Buffer ending in two null characters
+        __out UINT* puSize                                          // Size of the buffer, including both nulls
+        ) = 0;
+
+    virtual void ReleaseScanBuffer() = 0;
 };
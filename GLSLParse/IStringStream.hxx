@@ -41,8 +41,21 @@ interface IStringStream : public IUnknown
 public:
     virtual HRESULT WriteChar(char c) = 0;
     virtual HRESULT WriteString(const char* pString) = 0;
+    virtual HRESULT WriteBuffer(
+        __in_ecount(uLength) const char* pBuffer,                   // Characters to write
+        UINT uLength                                                // Number of characters
+        ) = 0;
     virtual HRESULT WriteFormat(UINT uMax, const char* pszFormat, ...) = 0;
     virtual HRESULT WriteIndent() = 0;
     virtual void IncreaseIndent() = 0;
     virtual void DecreaseIndent() = 0;
+
+    // Write a string literal, taking the length from its type rather than
+    // scanning for the terminator.
+    template <UINT N>
+    HRESULT WriteLiteral(const char (&szLiteral)[N])
+    {
+        static_assert(N > 0, "String literal must include its terminator");
+        return WriteBuffer(szLiteral, N - 1);
+    }
 };
@@ -181,7 +181,7 @@ HRESULT InitDeclaratorListEntryNode::OutputTranslation(
         // If we are grabbing the semantic, make sure that the index is sensible
         CHKB(spInfo->GetHLSLSemanticCount() > _uHLSLNameIndex);
 
-        CHK(pOutput->WriteString(":"));
+        CHK(pOutput->WriteLiteral(":"));
 
         if (pszIdentifierOverride == nullptr)
         {
@@ -246,10 +246,10 @@ HRESULT InitDeclaratorListEntryNode::OutputTranslation(
                     {
                         CHK_VERIFY_MSG(false, "Array of array type should not have been constructed");
                     }
-                    CHK(pOutput->WriteString("=("));
+                    CHK(pOutput->WriteLiteral("=("));
                     CHK(pOutput->WriteString(pszTypeName));
                     CHK(pOutput->WriteString(szArraySuffix));
-                    CHK(pOutput->WriteString(")0"));
+                    CHK(pOutput->WriteLiteral(")0"));
                 }
                 else
                 {
@@ -258,9 +258,9 @@ HRESULT InitDeclaratorListEntryNode::OutputTranslation(
                     //      typename var=(typename)0;
                     // which 0-inits all the fields.
                     const CTypeNameIdentifierInfo* pTypeNameInfo = pType->AsStructType()->UseTypeNameInfo();
-                    CHK(pOutput->WriteString("=("));
+                    CHK(pOutput->WriteLiteral("=("));
                     CHK(pOutput->WriteString(pTypeNameInfo->GetHLSLName(0)));
-                    CHK(pOutput->WriteString(")0"));
+                    CHK(pOutput->WriteLiteral(")0"));
                 }
             }
         }
@@ -256,7 +256,7 @@ HRESULT InitDeclaratorListNode::OutputTranslation(
                 // Output a comma between each of the entry children (not after the last one though)
                 if (i < (cChildren - 1))
                 {
-                    CHK(pOutput->WriteString(", "));
+                    CHK(pOutput->WriteLiteral(", "));
                 }
             }
         }
@@ -275,7 +275,7 @@ HRESULT InitDeclaratorListNode::OutputTranslation(
         }
 
         // Write out the semicolon terminating the list, and a newline for each list
-        CHK(pOutput->WriteString(";\n"));
+        CHK(pOutput->WriteLiteral(";\n"));
     }
 
     CHK_RETURN;
@@ -454,5 +454,5 @@ UINT InitDeclaratorListNode::GetVectorCount() const
 //-----------------------------------------------------------------------------
 HRESULT InitDeclaratorListNode::GetDumpString(__in IStringStream* pOutput)
 {
-    return pOutput->WriteString("InitDeclaratorList");
+    return pOutput->WriteLiteral("InitDeclaratorList");
 }
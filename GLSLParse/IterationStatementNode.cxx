@@ -96,5 +96,5 @@ HRESULT IterationStatementNode::OutputHLSL(__in IStringStream* pOutput)
 //-----------------------------------------------------------------------------
 HRESULT IterationStatementNode::GetDumpString(__in IStringStream* pOutput)
 {
-    return pOutput->WriteString("IterationStatementNode");
+    return pOutput->WriteLiteral("IterationStatementNode");
 }
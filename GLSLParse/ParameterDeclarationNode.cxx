@@ -114,7 +114,7 @@ HRESULT ParameterDeclarationNode::OutputHLSL(__in IStringStream* pOutput)
         // Our verification phase should have done the right thing here
         Assert(_typeQual == CONST_TOK);
 
-        CHK(pOutput->WriteString("const "));
+        CHK(pOutput->WriteLiteral("const "));
     }
 
     // Output the parameter qualifier if we have one
@@ -126,7 +126,7 @@ HRESULT ParameterDeclarationNode::OutputHLSL(__in IStringStream* pOutput)
         // assigned to. The GLSL spec says that this results in undefined behavior. To get
         // deterministic behavior and not fail at the linking stage, we'll translate 'out' to
         // 'inout' which causes the parameter to be initialized and avoids the HLSL compiler error.
-        CHK(pOutput->WriteString("inout "));
+        CHK(pOutput->WriteLiteral("inout "));
         break;
 
     default:
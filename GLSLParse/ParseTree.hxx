@@ -41,6 +41,7 @@
 #include "ExpressionStatementNode.hxx"
 #include "FieldSelectionNode.hxx"
 #include "FloatConstantNode.hxx"
+#include "FoldedConstantNode.hxx"
 #include "FullySpecifiedTypeNode.hxx"
 #include "FunctionCallGenericNode.hxx"
 #include "FunctionCallHeaderNode.hxx"
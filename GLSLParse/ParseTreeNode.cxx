@@ -33,6 +33,7 @@
 #include "GLSLTypeInfo.hxx"
 #include "GLSLParser.hxx"
 #include "CollectionNodeWithScope.hxx"
+#include "FunctionDefinitionNode.hxx"
 #include "GLSL.tab.h"
 
 MtDefine(ParseTreeNode, CGLSLParser, "ParseTreeNode");
@@ -109,6 +110,42 @@ HRESULT ParseTreeNode::VerifyNode()
         CHK(E_GLSLERROR_KNOWNERROR);
     }
 
+    {
+        // If this node owns a scope, the identifiers declared in it are
+        // resolved through the parser's scoped symbol index while the
+        // subtree is being verified.
+        CollectionNodeWithScope* pScope = UseScopeOpenedForVerification();
+        if (pScope != nullptr)
+        {
+            CHK(GetParser()->UseScopedSymbolIndex()->OpenScope(pScope));
+        }
+
+        hr = VerifySubtree();
+
+        if (pScope != nullptr)
+        {
+            GetParser()->UseScopedSymbolIndex()->CloseScope(pScope);
+        }
+
+        CHK(hr);
+    }
+
+    _fTypesVerified = true;
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   VerifySubtree
+//
+//  Synopsis:   Runs the verification steps for this node and its children.
+//
+//-----------------------------------------------------------------------------
+HRESULT ParseTreeNode::VerifySubtree()
+{
+    CHK_START;
+
     // Do any work before verifying children
     CHK(PreVerifyChildren());
 
@@ -116,10 +153,7 @@ HRESULT ParseTreeNode::VerifyNode()
     CHK(VerifyChildren());
 
     // Then verify self
-    hr = VerifySelf();
-    CHK(hr);
-
-    _fTypesVerified = true;
+    CHK(VerifySelf());
 
     CHK_RETURN;
 }
@@ -299,13 +333,13 @@ HRESULT ParseTreeNode::WriteScalarAsVector(__in IStringStream* pOutput, int numC
     CHKB(TypeHelpers::IsVectorComponentType(basicType));
 
     // Wrap in paren + swizzle with 'x' will give us what we want
-    CHK(pOutput->WriteString("("));
+    CHK(pOutput->WriteLiteral("("));
     CHK(OutputHLSL(pOutput));
-    CHK(pOutput->WriteString(")."));
+    CHK(pOutput->WriteLiteral(")."));
 
     for (int i = 0; i < numComponents; i++)
     {
-        CHK(pOutput->WriteString("x"));
+        CHK(pOutput->WriteLiteral("x"));
     }
 
     CHK_RETURN;
@@ -341,18 +375,18 @@ HRESULT ParseTreeNode::WriteScalarAsMatrix(__in IStringStream* pOutput, int matr
 
     // Construct a matrix with the scalar written as a vector as arguments
     CHK(pOutput->WriteString(pInfo->_pszHLSLName));
-    CHK(pOutput->WriteString("("));
+    CHK(pOutput->WriteLiteral("("));
 
     for (int i = 0; i < numComponents; i++)
     {
         CHK(WriteScalarAsVector(pOutput, numComponents));
         if (i != numComponents - 1)
         {
-            CHK(pOutput->WriteString(","));
+            CHK(pOutput->WriteLiteral(","));
         }
     }
 
-    CHK(pOutput->WriteString(")"));
+    CHK(pOutput->WriteLiteral(")"));
 
     CHK_RETURN;
 }
@@ -383,9 +417,9 @@ HRESULT ParseTreeNode::WriteVectorTruncated(__in IStringStream* pOutput, int num
     char szComps[4] = { 'x', 'y', 'z', 'w' };
 
     // Wrap in paren + swizzle with 'x' will give us what we want
-    CHK(pOutput->WriteString("("));
+    CHK(pOutput->WriteLiteral("("));
     CHK(OutputHLSL(pOutput));
-    CHK(pOutput->WriteString(")."));
+    CHK(pOutput->WriteLiteral(")."));
 
     for (int i = 0; i < numComponents; i++)
     {
@@ -426,9 +460,9 @@ HRESULT ParseTreeNode::WriteMatrixTruncated(__in IStringStream* pOutput, int num
 
     UINT cMatrixDimension = TypeHelpers::GetMatrixLength(basicType);
     // Wrap in paren + swizzle with 'x' will give us what we want
-    CHK(pOutput->WriteString("("));
+    CHK(pOutput->WriteLiteral("("));
     CHK(OutputHLSL(pOutput));
-    CHK(pOutput->WriteString(")."));
+    CHK(pOutput->WriteLiteral(")."));
 
     for (int i = 0; i < numComponents; i++)
     {
@@ -489,6 +523,30 @@ bool ParseTreeNode::OccursInLoop() const
     return fInLoop;
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetOwningFunctionDefinition
+//
+//  Synopsis:   Returns the function definition that this node is in, or null
+//              if it is not in one (for example a global initializer).
+//
+//-----------------------------------------------------------------------------
+FunctionDefinitionNode* ParseTreeNode::GetOwningFunctionDefinition()
+{
+    ParseTreeNode* pWalk = this;
+    while (pWalk != nullptr)
+    {
+        if (pWalk->GetParseNodeType() == ParseNodeType::functionDefinition)
+        {
+            return pWalk->GetAs<FunctionDefinitionNode>();
+        }
+
+        pWalk = pWalk->GetParent();
+    }
+
+    return nullptr;
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   GatherExpressions
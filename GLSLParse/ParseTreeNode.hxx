@@ -29,11 +29,14 @@
 #include "GLSLType.hxx"
 #include "GLSLError.hxx"
 #include "RefCounted.hxx"
+#include "GLSLArena.hxx"
 
 class CGLSLParser;
 class InitDeclaratorListNode;
 class IdentifierNodeBase;
 class CollectionNode;
+class CollectionNodeWithScope;
+class FunctionDefinitionNode;
 class CVariableIdentifierInfo;
 class ConstantValue;
 
@@ -74,6 +77,7 @@ namespace ParseNodeType
         discardStatement,
         expressionList,
         fieldSelection,
+        foldedConstant,
         forStatement,
         forRestStatement,
         fullySpecifiedType,
@@ -116,6 +120,7 @@ namespace ParseNodeType
         typeSpecifier,
         unaryOperator,
         variableIdentifier,
+        count
     };
 }
 
@@ -143,8 +148,11 @@ namespace IdentifierUsage
 //  Synopsis:   Abstract base for parse tree nodes. The parse tree nodes are
 //              always a derived class of this node.
 //
+//              Nodes created while the parser is running are allocated from
+//              the parser's arena (see CGLSLArena).
+//
 //------------------------------------------------------------------------------
-class ParseTreeNode : public IUnknown
+class ParseTreeNode : public IUnknown, public CGLSLArenaObject
 {
 public:
     ParseTreeNode();
@@ -181,6 +189,8 @@ public:
         __deref_out_opt ParseTreeNode** ppActual                    // Tree node that is the actual scope
         ) { return false; }
 
+    virtual CollectionNodeWithScope* UseScopeOpenedForVerification() { return nullptr; }
+
     virtual HRESULT IsConstExpression(
         bool fIncludeIndex,                                         // Whether to include loop index in the definition of a constant expression
         __out bool* pfIsConstantExpression,                         // Whether this node is a constant expression
@@ -262,6 +272,7 @@ protected:
     void SetBasicExpressionType(int type);
 
     bool OccursInLoop() const;
+    FunctionDefinitionNode* GetOwningFunctionDefinition();
 
     void Initialize(
         __in CGLSLParser* pParser                                   // The parser that owns the tree
@@ -271,6 +282,9 @@ protected:
     const static UINT s_uMaxTreeDepth;                              // Maximum allowed parse tree depth
     const static UINT s_uMaxFunctionCallDepth;                      // Maximum allowed function call depth
 
+private:
+    HRESULT VerifySubtree();
+
 private:
     CGLSLParser* _pParser;                                          // The parser that owns this tree node
     CollectionNode* _pParent;                                       // The parent of this tree node
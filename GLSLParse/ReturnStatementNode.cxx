@@ -77,7 +77,7 @@ HRESULT ReturnStatementNode::OutputHLSL(__in IStringStream* pOutput)
         CHK(GetParser()->WriteEntryPointEnd(pOutput));
     }
 
-    CHK(pOutput->WriteString("return"));
+    CHK(pOutput->WriteLiteral("return"));
 
     if (GetChild(0) != nullptr)
     {
@@ -85,7 +85,7 @@ HRESULT ReturnStatementNode::OutputHLSL(__in IStringStream* pOutput)
         CHK(GetChild(0)->OutputHLSL(pOutput));
     }
 
-    CHK(pOutput->WriteString(";\n"));
+    CHK(pOutput->WriteLiteral(";\n"));
 
     CHK_RETURN;
 }
@@ -121,26 +121,15 @@ HRESULT ReturnStatementNode::VerifySelf()
 
     SetExpressionType(spType);
 
-    // Go through the parent nodes until the first function definition is
-    // found. Then add this return statement to the list of those that
-    // are in the function (there can be more than one).
-    ParseTreeNode* pWalk = this;
-    while (pWalk != nullptr)
-    {
-        if (pWalk->GetParseNodeType() == ParseNodeType::functionDefinition)
-        {
-            break;
-        }
-
-        pWalk = pWalk->GetParent();
-    }
+    // Add this return statement to the list of those that are in the
+    // function (there can be more than one).
+    _pOwningFunction = GetOwningFunctionDefinition();
 
     // Return statements should not find their way into being outside of
     // a function definition (based on the grammar).
-    Assert(pWalk != nullptr);
-    CHKB(pWalk != nullptr);
+    Assert(_pOwningFunction != nullptr);
+    CHKB(_pOwningFunction != nullptr);
 
-    _pOwningFunction = pWalk->GetAs<FunctionDefinitionNode>();
     CHK(_pOwningFunction->AddReturnStatement(this));
 
     CHK_RETURN;
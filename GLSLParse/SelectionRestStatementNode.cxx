@@ -81,7 +81,7 @@ HRESULT SelectionRestStatementNode::OutputHLSL(__in IStringStream* pOutput)
     // See if there was an else clause
     if (GetChildCount() == 2)
     {
-        CHK(pOutput->WriteString("else\n"));
+        CHK(pOutput->WriteLiteral("else\n"));
         CHK(GetChild(1)->OutputHLSL(pOutput));
     }
 
@@ -95,5 +95,5 @@ HRESULT SelectionRestStatementNode::OutputHLSL(__in IStringStream* pOutput)
 //-----------------------------------------------------------------------------
 HRESULT SelectionRestStatementNode::GetDumpString(__in IStringStream* pOutput)
 {
-    return pOutput->WriteString("SelectionRestStatementNode");
+    return pOutput->WriteLiteral("SelectionRestStatementNode");
 }
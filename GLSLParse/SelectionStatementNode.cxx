@@ -101,9 +101,9 @@ HRESULT SelectionStatementNode::OutputHLSL(__in IStringStream* pOutput)
 {
     CHK_START;
 
-    CHK(pOutput->WriteString("if ("));
+    CHK(pOutput->WriteLiteral("if ("));
     CHK(GetChild(0)->OutputHLSL(pOutput));
-    CHK(pOutput->WriteString(")"));
+    CHK(pOutput->WriteLiteral(")"));
     CHK(GetChild(1)->OutputHLSL(pOutput));
 
     CHK_RETURN;
@@ -116,5 +116,5 @@ HRESULT SelectionStatementNode::OutputHLSL(__in IStringStream* pOutput)
 //-----------------------------------------------------------------------------
 HRESULT SelectionStatementNode::GetDumpString(__in IStringStream* pOutput)
 {
-    return pOutput->WriteString("SelectionStatementNode");
+    return pOutput->WriteLiteral("SelectionStatementNode");
 }
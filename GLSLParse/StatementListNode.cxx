@@ -81,6 +81,6 @@ HRESULT StatementListNode::OutputHLSL(__in IStringStream* pOutput)
 //-----------------------------------------------------------------------------
 HRESULT StatementListNode::GetDumpString(__in IStringStream* pOutput)
 {
-    return pOutput->WriteString("StatementListNode");
+    return pOutput->WriteLiteral("StatementListNode");
 }
 
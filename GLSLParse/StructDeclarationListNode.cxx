@@ -82,6 +82,6 @@ HRESULT StructDeclarationListNode::OutputHLSL(__in IStringStream* pOutput)
 //-----------------------------------------------------------------------------
 HRESULT StructDeclarationListNode::GetDumpString(__in IStringStream* pOutput)
 {
-    return pOutput->WriteString("StructDeclarationList");
+    return pOutput->WriteLiteral("StructDeclarationList");
 }
 
@@ -150,11 +150,11 @@ HRESULT StructDeclarationNode::OutputHLSL(__in IStringStream* pOutput)
         // Output a space between the children (but not after the last one)
         if (i < cChildren - 1)
         {
-            CHK(pOutput->WriteString(" "));
+            CHK(pOutput->WriteLiteral(" "));
         }
     }
 
-    CHK(pOutput->WriteString(";\n"));
+    CHK(pOutput->WriteLiteral(";\n"));
 
     CHK_RETURN;
 }
@@ -168,7 +168,7 @@ HRESULT StructDeclarationNode::OutputHLSL(__in IStringStream* pOutput)
 //-----------------------------------------------------------------------------
 HRESULT StructDeclarationNode::GetDumpString(__in IStringStream* pOutput)
 {
-    return pOutput->WriteString("StructDeclaration");
+    return pOutput->WriteLiteral("StructDeclaration");
 }
 
 //+----------------------------------------------------------------------------
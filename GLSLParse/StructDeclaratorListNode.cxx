@@ -73,7 +73,7 @@ HRESULT StructDeclaratorListNode::OutputHLSL(__in IStringStream* pOutput)
         // Output a comma with space between the children, but not after the last one
         if (i < cChildren - 1)
         {
-            CHK(pOutput->WriteString(", "));
+            CHK(pOutput->WriteLiteral(", "));
         }
     }
 
@@ -89,5 +89,5 @@ HRESULT StructDeclaratorListNode::OutputHLSL(__in IStringStream* pOutput)
 //-----------------------------------------------------------------------------
 HRESULT StructDeclaratorListNode::GetDumpString(__in IStringStream* pOutput)
 {
-    return pOutput->WriteString("StructDeclaratorList");
+    return pOutput->WriteLiteral("StructDeclaratorList");
 }
@@ -384,7 +384,7 @@ HRESULT StructGLSLType::OutputHLSLConstructor(__in IStringStream* pOutput) const
         // Output the field variables as a parameter list
         CHK(pOutput->WriteChar('('));
         CHK(OutputHLSLVariablesAsParameters(pOutput));
-        CHK(pOutput->WriteString(") {\n"));
+        CHK(pOutput->WriteLiteral(") {\n"));
 
         static const char* s_c_pszLocalStructName = "var_localstruct";
 
@@ -392,16 +392,16 @@ HRESULT StructGLSLType::OutputHLSLConstructor(__in IStringStream* pOutput) const
         CHK(pOutput->WriteString(pszTypeName));
         CHK(pOutput->WriteChar(' '));
         CHK(pOutput->WriteString(s_c_pszLocalStructName));
-        CHK(pOutput->WriteString(";\n"));
+        CHK(pOutput->WriteLiteral(";\n"));
 
         // Output the individual field selection assignments.
         CHK(OutputHLSLVariablesAsAssignments(s_c_pszLocalStructName, pOutput));
 
         // Then return the fully assigned local variable.
-        CHK(pOutput->WriteString("return "));
+        CHK(pOutput->WriteLiteral("return "));
         CHK(pOutput->WriteString(s_c_pszLocalStructName));
-        CHK(pOutput->WriteString(";\n"));
-        CHK(pOutput->WriteString("}\n"));
+        CHK(pOutput->WriteLiteral(";\n"));
+        CHK(pOutput->WriteLiteral("}\n"));
     }
 
     CHK_RETURN;
@@ -425,7 +425,7 @@ HRESULT StructGLSLType::OutputHLSLEqualsFunction(__in IStringStream* pOutput) co
     if (_fEqualsOperatorUsed)
     {
         // Output a return type of bool and the equals operator function name.
-        CHK(pOutput->WriteString("bool "));
+        CHK(pOutput->WriteLiteral("bool "));
         CHK(pOutput->WriteString(_pTypeNameInfo->GetHLSLEqualsFunctionName()));
 
         // Get strings for the parameter names as well as their type
@@ -438,15 +438,15 @@ HRESULT StructGLSLType::OutputHLSLEqualsFunction(__in IStringStream* pOutput) co
         CHK(pOutput->WriteString(pszTypeName));
         CHK(pOutput->WriteChar(' '));
         CHK(pOutput->WriteString(s_pszVal1));
-        CHK(pOutput->WriteString(", "));
+        CHK(pOutput->WriteLiteral(", "));
         CHK(pOutput->WriteString(pszTypeName));
         CHK(pOutput->WriteChar(' '));
         CHK(pOutput->WriteString(s_pszVal2));
-        CHK(pOutput->WriteString(") {\n"));
+        CHK(pOutput->WriteLiteral(") {\n"));
 
         // Begin the return statement (which will be an expression 
         // 'anding' the fields' equivalence together).
-        CHK(pOutput->WriteString("return ("));
+        CHK(pOutput->WriteLiteral("return ("));
 
         // We'll output comparison between each of the fields, &&'ing the results.
         const UINT cFields = _aryFields.GetCount();
@@ -471,7 +471,7 @@ HRESULT StructGLSLType::OutputHLSLEqualsFunction(__in IStringStream* pOutput) co
                 bool fWrapWithAll = !(TypeHelpers::IsVectorComponentType(basicType));
                 if (fWrapWithAll)
                 {
-                    CHK(pOutput->WriteString("all("));
+                    CHK(pOutput->WriteLiteral("all("));
                 }
 
                 // Output the comparison for the two fields:
@@ -480,7 +480,7 @@ HRESULT StructGLSLType::OutputHLSLEqualsFunction(__in IStringStream* pOutput) co
                 CHK(pOutput->WriteChar('.'));
                 CHK(pOutput->WriteString(pszHLSLName));
 
-                CHK(pOutput->WriteString("=="));
+                CHK(pOutput->WriteLiteral("=="));
 
                 CHK(pOutput->WriteString(s_pszVal2));
                 CHK(pOutput->WriteChar('.'));
@@ -514,14 +514,14 @@ HRESULT StructGLSLType::OutputHLSLEqualsFunction(__in IStringStream* pOutput) co
             // Output an && operator between all the comparisons, but not after the last one.
             if (i + 1 < cFields)
             {
-                CHK(pOutput->WriteString(" && "));
+                CHK(pOutput->WriteLiteral(" && "));
             }
 
         }
 
         // Close and finish the return statement, and close the function definition.
-        CHK(pOutput->WriteString(");\n"));
-        CHK(pOutput->WriteString("}\n"));
+        CHK(pOutput->WriteLiteral(");\n"));
+        CHK(pOutput->WriteLiteral("}\n"));
     }
 
     CHK_RETURN;
@@ -650,7 +650,7 @@ HRESULT StructGLSLType::OutputHLSLVariablesAsParameters(__in IStringStream* pOut
         // Output comma separation between all parameters, but not after the last one
         if (i + 1 < cFields)
         {
-            CHK(pOutput->WriteString(", "));
+            CHK(pOutput->WriteLiteral(", "));
         }
     }
 
@@ -688,7 +688,7 @@ HRESULT StructGLSLType::OutputHLSLVariablesAsAssignments(__in const char* pszLoc
 
         CHK(pOutput->WriteChar('='));
         CHK(pOutput->WriteString(pszHLSLName));
-        CHK(pOutput->WriteString(";\n"));
+        CHK(pOutput->WriteLiteral(";\n"));
     }
 
     CHK_RETURN;
@@ -100,6 +100,9 @@ public:
 
     bool ContainsArrayType() const;
 
+    UINT GetFieldCount() const { return _aryFields.GetCount(); }
+    CVariableIdentifierInfo* UseField(UINT uIndex) const { return _aryFields[uIndex]; }
+
 protected:
     StructGLSLType();
 
@@ -57,7 +57,7 @@ HRESULT StructSpecifierCollectionNode::OutputHLSL(__in IStringStream* pOutput)
         // in between them.
         StructSpecifierNode* pStructSpecifierNode = GetChild(i)->GetAs<StructSpecifierNode>();
         CHK(pStructSpecifierNode->OutputHLSL(pOutput));
-        CHK(pOutput->WriteString(";\n"));
+        CHK(pOutput->WriteLiteral(";\n"));
 
         // Now that we've output the type declaration in HLSL, we can ask the 
         // struct specifier node to output any functions that may be needed for
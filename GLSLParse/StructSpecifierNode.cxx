@@ -115,7 +115,7 @@ HRESULT StructSpecifierNode::VerifySelf()
     {
         // Otherwise, whip up an anonymous typename info which will be used
         // when outputting HLSL to facilitate things like default initializer
-        CHK(RefCounted<CTypeNameIdentifierInfo>::Create(
+        CHK(RefCounted<CTypeNameIdentifierInfo, MultiThreadedRefCount>::Create(
             GetParser(),
             _spType,
             /*out*/_spTypeNameInfo
@@ -139,7 +139,7 @@ HRESULT StructSpecifierNode::OutputHLSL(__in IStringStream* pOutput)
 {
     CHK_START;
 
-    CHK(pOutput->WriteString("struct "));
+    CHK(pOutput->WriteLiteral("struct "));
 
     AssertSz(_spTypeNameInfo != nullptr, 
         "We should have set this node's typename info at verification time"
@@ -152,13 +152,13 @@ HRESULT StructSpecifierNode::OutputHLSL(__in IStringStream* pOutput)
     CHKB(pszHLSLName != nullptr);
     CHK(pOutput->WriteString(pszHLSLName));
 
-    CHK(pOutput->WriteString(" {\n"));
+    CHK(pOutput->WriteLiteral(" {\n"));
 
     pOutput->IncreaseIndent();
     CHK(GetStructDeclListChild()->OutputHLSL(pOutput));
     pOutput->DecreaseIndent();
 
-    CHK(pOutput->WriteString("}"));
+    CHK(pOutput->WriteLiteral("}"));
 
     CHK_RETURN;
 }
@@ -172,7 +172,7 @@ HRESULT StructSpecifierNode::OutputHLSL(__in IStringStream* pOutput)
 //-----------------------------------------------------------------------------
 HRESULT StructSpecifierNode::GetDumpString(__in IStringStream* pOutput)
 {
-    return pOutput->WriteString("StructSpecifier");
+    return pOutput->WriteLiteral("StructSpecifier");
 }
 
 //+----------------------------------------------------------------------------
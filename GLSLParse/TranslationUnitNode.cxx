@@ -33,7 +33,7 @@
 #include "TextNode.hxx"
 #include "StructSpecifierCollectionNode.hxx"
 #include "FunctionDefinitionNode.hxx"
-#include "CompoundStatementNode.hxx"
+#include "FunctionIdentifierInfo.hxx"
 
 MtDefine(TranslationUnitCollectionNode, CGLSLParser, "TranslationUnitCollectionNode");
 
@@ -43,6 +43,9 @@ const UINT TranslationUnitCollectionNode::s_cIOStructChildren = 2;
 
 // Struct specifier collection node is the child right after the IOStructNode children and the text node
 const UINT TranslationUnitCollectionNode::s_uStructSpecifierChildIndex = TranslationUnitCollectionNode::s_uIOStructChildStartIndex + TranslationUnitCollectionNode::s_cIOStructChildren + 1;
+
+// Marks a function that is on the path being walked, so that recursion is found
+const UINT TranslationUnitCollectionNode::s_uCallDepthInProgress = UINT_MAX;
 //+----------------------------------------------------------------------------
 //
 //  Function:   Constructor
@@ -110,7 +113,7 @@ HRESULT TranslationUnitCollectionNode::VerifySelf()
 {
     CHK_START;
 
-    const FunctionDefinitionNode* pEntryPointDefinition = nullptr;
+    CFunctionIdentifierInfo* pEntryPointInfo = nullptr;
 
     for (UINT i = 0; i < GetIdentifierCount(); i++)
     {
@@ -129,22 +132,21 @@ HRESULT TranslationUnitCollectionNode::VerifySelf()
                 CHK(E_GLSLERROR_KNOWNERROR);
             }
 
-            // When we encounter 'main', grab a pointer to the function definition for
-            // function call depth verification below.
+            // When we encounter 'main', grab it for function call depth verification below.
             if (fFunctionDefined && pFuncInfo->IsGLSLSymbol(GLSLSymbols::main))
             {
-                pEntryPointDefinition = pFuncInfo->UseFunctionDefinition();
+                pEntryPointInfo = pFuncInfo;
             }
         }
     }
 
-    if (pEntryPointDefinition != nullptr)
+    if (pEntryPointInfo != nullptr)
     {
         // The D3D compiler basically inlines all function calls, but performs this in
         // a recursive manner. This can lead to crashes via stack overflows. In order to
         // prevent this, part of verfication/translation is verifing that the function
         // call depth for this shader is reasonable.
-        CHK(VerifyFunctionCallDepth(pEntryPointDefinition, GetParser()));
+        CHK(VerifyFunctionCallDepth(pEntryPointInfo, GetParser()));
     }
 
     CHK_RETURN;
@@ -226,40 +228,82 @@ StructSpecifierCollectionNode* TranslationUnitCollectionNode::GetStructSpecifier
 //              into each function call which can lead to stack overflows so
 //              we have to protect ourselves.
 //
+//              The call graph is recorded on the function infos as calls
+//              are verified. This walks it depth first from the entry point
+//              with an explicit stack, and remembers the depth of each
+//              function once its callees are done, so a function called from
+//              many places is only walked once. Recursion, which GLSL does
+//              not allow, has no depth limit and is reported the same way.
+//
 //+----------------------------------------------------------------------------
-HRESULT TranslationUnitCollectionNode::VerifyFunctionCallDepth(__in const FunctionDefinitionNode* pEntryPointDefinition, __in CGLSLParser* pParser)
+HRESULT TranslationUnitCollectionNode::VerifyFunctionCallDepth(__in CFunctionIdentifierInfo* pEntryPointInfo, __in CGLSLParser* pParser)
 {
     CHK_START;
 
-    CModernArray<const FunctionDefinitionNode*> aryCallers;
-    CHK(aryCallers.Add(pEntryPointDefinition));
-
-    UINT cNestingLevel = 0;
     const UINT cMaxNestingLevel = ParseTreeNode::GetMaxFunctionNestingLevel();
+    bool fDepthExceeded = false;
+
+    CModernArray<CallFrame> aryPath;
+    if (pEntryPointInfo->GetCallDepth() == 0)
+    {
+        CallFrame entryFrame = { pEntryPointInfo, 0, 0 };
+        CHK(aryPath.Add(entryFrame));
+        pEntryPointInfo->SetCallDepth(s_uCallDepthInProgress);
+    }
 
-    CModernArray<const FunctionDefinitionNode*> aryCalled;
-    while (aryCallers.GetCount() != 0 && cNestingLevel <= cMaxNestingLevel)
+    while (aryPath.GetCount() != 0 && !fDepthExceeded)
     {
-        // For each of the current callers, find each function that is called
-        for (UINT i = 0; i < aryCallers.GetCount(); i++)
+        CallFrame& frame = aryPath[aryPath.GetCount() - 1];
+
+        if (frame._uNextCallee < frame._pInfo->GetCalleeCount())
         {
-            ParseTreeNode* pFunctionBody = aryCallers[i]->GetFunctionBody();
-            Assert(pFunctionBody->GetParseNodeType() == ParseNodeType::compoundStatement);
-            CHK(pFunctionBody->GetAs<CompoundStatementNode>()->GatherDefinitionsOfCalledFunctions(aryCalled));
-        }
+            CFunctionIdentifierInfo* pCallee = frame._pInfo->UseCallee(frame._uNextCallee);
+            frame._uNextCallee++;
 
-        // Transfer the called functions to the caller collection,
-        // clear the called functions to start with an empty collection
-        // for the next iteration, and go deeper in the next iteration...
-        aryCallers.RemoveAllAndMaintainCapacity();
-        CHK(aryCallers.AddArray(aryCalled));
-        aryCalled.RemoveAllAndMaintainCapacity();
+            UINT uCalleeDepth = pCallee->GetCallDepth();
+            if (pCallee->UseFunctionDefinition() == nullptr)
+            {
+                // Nothing to walk into
+            }
+            else if (uCalleeDepth == s_uCallDepthInProgress)
+            {
+                // The callee is already on the path, so the calls are recursive
+                fDepthExceeded = true;
+            }
+            else if (uCalleeDepth != 0)
+            {
+                // The callee was walked from another caller already
+                frame._uMaxCalleeDepth = max(frame._uMaxCalleeDepth, uCalleeDepth);
+            }
+            else if (aryPath.GetCount() >= cMaxNestingLevel)
+            {
+                // Walking into the callee would make the path too long
+                fDepthExceeded = true;
+            }
+            else
+            {
+                // The frame reference is not used after this, since adding can move the path
+                CallFrame calleeFrame = { pCallee, 0, 0 };
+                CHK(aryPath.Add(calleeFrame));
+                pCallee->SetCallDepth(s_uCallDepthInProgress);
+            }
+        }
+        else
+        {
+            // All of the callees are done, so the depth of this function is known
+            UINT uDepth = frame._uMaxCalleeDepth + 1;
+            frame._pInfo->SetCallDepth(uDepth);
+            aryPath.RemoveAt(aryPath.GetCount() - 1);
 
-        // ... keeping record of the increased nesting level.
-        cNestingLevel++;
+            if (aryPath.GetCount() != 0)
+            {
+                CallFrame& callerFrame = aryPath[aryPath.GetCount() - 1];
+                callerFrame._uMaxCalleeDepth = max(callerFrame._uMaxCalleeDepth, uDepth);
+            }
+        }
     }
 
-    if (cNestingLevel > cMaxNestingLevel)
+    if (fDepthExceeded || pEntryPointInfo->GetCallDepth() > cMaxNestingLevel)
     {
         CHK(pParser->LogError(nullptr, E_GLSLERROR_MAXFUNCTIONDEPTHEXCEEDED, nullptr));
         CHK(E_GLSLERROR_KNOWNERROR);
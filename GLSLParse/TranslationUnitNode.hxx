@@ -31,6 +31,7 @@
 
 class SamplerCollectionNode;
 class StructSpecifierCollectionNode;
+class CFunctionIdentifierInfo;
 
 //+-----------------------------------------------------------------------------
 //
@@ -68,9 +69,26 @@ public:
     static ParseNodeType::Enum GetClassNodeType() { return ParseNodeType::translationUnit; }
 
 private:
-    static HRESULT VerifyFunctionCallDepth(__in const FunctionDefinitionNode* pEntryPointDefinition, __in CGLSLParser* pParser);
+    static HRESULT VerifyFunctionCallDepth(__in CFunctionIdentifierInfo* pEntryPointInfo, __in CGLSLParser* pParser);
 
 private:
+    //+-------------------------------------------------------------------------
+    //
+    //  Struct:     CallFrame
+    //
+    //  Synopsis:   A function on the path being walked by
+    //              VerifyFunctionCallDepth.
+    //
+    //--------------------------------------------------------------------------
+    struct CallFrame
+    {
+        CFunctionIdentifierInfo* _pInfo;            // Function on the path
+        UINT _uNextCallee;                          // Index of the next callee to walk into
+        UINT _uMaxCalleeDepth;                      // Deepest call chain of the callees walked so far
+    };
+
+    static const UINT s_uCallDepthInProgress;       // Call depth of a function whose callees are being walked
+
     static const UINT s_uIOStructChildStartIndex;
     static const UINT s_cIOStructChildren;
     static const UINT s_uStructSpecifierChildIndex;
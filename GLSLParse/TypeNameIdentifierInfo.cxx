@@ -30,6 +30,7 @@
 #include "CollectionNodeWithScope.hxx"
 #include "GLSLSymbolTable.hxx"
 #include "GLSLParser.hxx"
+#include "GLSLBinaryStream.hxx"
 
 MtDefine(CTypeNameIdentifierInfo, CGLSLParser, "IdentifierInfo");
 
@@ -195,6 +196,73 @@ HRESULT CTypeNameIdentifierInfo::Initialize(
     CHK_RETURN;
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   Initialize
+//
+//  Synopsis:   Init typename info that was written with Serialize, when
+//              restoring a translated shader.
+//
+//-----------------------------------------------------------------------------
+HRESULT CTypeNameIdentifierInfo::Initialize(
+    __inout CGLSLBinaryReader* pReader,                         // Reader positioned at data written by Serialize
+    __in GLSLType* pTypeDefined                                 // The type defined by this identifier
+    )
+{
+    CHK_START;
+
+    const char* pszHLSLName;
+    const char* pszHLSLConstructorName;
+    const char* pszHLSLEqualsFunctionName;
+    CHK(pReader->ReadInt(&_iSymbolIndex));
+    CHK(pReader->ReadString(&pszHLSLName));
+    CHK(pReader->ReadString(&pszHLSLConstructorName));
+    CHK(pReader->ReadString(&pszHLSLEqualsFunctionName));
+
+    // Names that were never generated stay unset
+    if (pszHLSLName != nullptr)
+    {
+        CHK(_rgHLSLName.Set(pszHLSLName));
+    }
+
+    if (pszHLSLConstructorName != nullptr)
+    {
+        CHK(_rgHLSLConstructorName.Set(pszHLSLConstructorName));
+    }
+
+    if (pszHLSLEqualsFunctionName != nullptr)
+    {
+        CHK(_rgHLSLEqualsFunctionName.Set(pszHLSLEqualsFunctionName));
+    }
+
+    CHKB_HR(pTypeDefined->IsStructType(), E_GLSL_INVALIDDATA);
+    _spType = pTypeDefined->AsStructType();
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Serialize
+//
+//  Synopsis:   Writes the symbol and HLSL names of the typename. The type it
+//              defines is serialized separately.
+//
+//-----------------------------------------------------------------------------
+HRESULT CTypeNameIdentifierInfo::Serialize(
+    __inout CGLSLBinaryWriter* pWriter                          // Where to write the typename
+    ) const
+{
+    CHK_START;
+
+    CHK(pWriter->WriteInt(_iSymbolIndex));
+    CHK(pWriter->WriteString(_rgHLSLName));
+    CHK(pWriter->WriteString(_rgHLSLConstructorName));
+    CHK(pWriter->WriteString(_rgHLSLEqualsFunctionName));
+
+    CHK_RETURN;
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   GetType
@@ -257,3 +325,28 @@ HRESULT CTypeNameIdentifierInfo::OutputHLSLEqualsFunction(__in IStringStream* pO
 {
     return _spType->OutputHLSLEqualsFunction(pOutput);
 }
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetMemorySize
+//
+//  Synopsis:   Returns the approximate memory retained by the info and the
+//              struct type it defines. The field infos are counted with the
+//              rest of the variables in the identifier table.
+//
+//-----------------------------------------------------------------------------
+UINT CTypeNameIdentifierInfo::GetMemorySize() const
+{
+    UINT cbMemorySize = sizeof(*this);
+
+    cbMemorySize += static_cast<UINT>(_rgHLSLName.GetLength()) + 1;
+    cbMemorySize += static_cast<UINT>(_rgHLSLConstructorName.GetLength()) + 1;
+    cbMemorySize += static_cast<UINT>(_rgHLSLEqualsFunctionName.GetLength()) + 1;
+
+    if (_spType != nullptr)
+    {
+        cbMemorySize += sizeof(StructGLSLType) + _spType->GetFieldCount() * sizeof(TSmartPointer<CVariableIdentifierInfo>);
+    }
+
+    return cbMemorySize;
+}
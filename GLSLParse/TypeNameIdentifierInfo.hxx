@@ -33,6 +33,8 @@ class StructGLSLType;
 class TypeNameIdentifierNode;
 class FunctionHeaderWithParametersNode;
 class CGLSLSymbolTable;
+class CGLSLBinaryWriter;
+class CGLSLBinaryReader;
 
 //+-----------------------------------------------------------------------------
 //
@@ -69,6 +71,13 @@ public:
         __in const CTypeNameIdentifierInfo* pOtherTypeInfo          // Existing type info to copy from
         );
 
+    HRESULT Initialize(
+        __inout CGLSLBinaryReader* pReader,                         // Reader positioned at data written by Serialize
+        __in GLSLType* pTypeDefined                                 // The type defined by this identifier
+        );
+
+    HRESULT Serialize(__inout CGLSLBinaryWriter* pWriter) const;
+
     // IIdentifierInfo override
     const char* GetHLSLName(UINT uIndex) const override { return _rgHLSLName; }
     UINT GetHLSLNameCount() const override { return 1; }
@@ -82,6 +91,7 @@ public:
 
     const char* GetHLSLConstructorName() const;
     const char* GetHLSLEqualsFunctionName() const;
+    UINT GetMemorySize() const;
 
     HRESULT OutputHLSLConstructor(__in IStringStream* pOutput) const;
     HRESULT OutputHLSLEqualsFunction(__in IStringStream* pOutput) const;
@@ -183,11 +183,11 @@ HRESULT UnaryOperatorNode::OutputHLSL(__in IStringStream* pOutput)
         break;
 
     case INC_OP:
-        CHK(pOutput->WriteString("++"));
+        CHK(pOutput->WriteLiteral("++"));
         break;
 
     case DEC_OP:
-        CHK(pOutput->WriteString("--"));
+        CHK(pOutput->WriteLiteral("--"));
         break;
 
     default:
@@ -234,7 +234,8 @@ HRESULT UnaryOperatorNode::IsConstExpression(
         int basicType;
         CHK(pValue->GetBasicType(&basicType));
 
-        if (basicType == INT_TOK || basicType == FLOAT_TOK)
+        int componentType;
+        if (pValue->HasValue() && SUCCEEDED(pValue->GetComponentType(&componentType)) && componentType != BOOL_TOK)
         {
             switch (_op)
             {
@@ -243,14 +244,7 @@ HRESULT UnaryOperatorNode::IsConstExpression(
                 break;
 
             case DASH:
-                if (basicType == INT_TOK)
-                {
-                    NegateValue<int>(pValue, INT_TOK);
-                }
-                else
-                {
-                    NegateValue<float>(pValue, FLOAT_TOK);
-                }
+                CHK(NegateValue(pValue));
                 break;
 
             default:
@@ -259,7 +253,6 @@ HRESULT UnaryOperatorNode::IsConstExpression(
                 CHK(E_UNEXPECTED);
                 break;
             }
-
         }
         else
         {
@@ -274,23 +267,39 @@ HRESULT UnaryOperatorNode::IsConstExpression(
 //
 //  Function:   NegateValue
 //
-//  Synopsis:   Negate the value stored in the given constant value. The type
-//              given is set if we cannot get a value to negate.
+//  Synopsis:   Negate each component of the value stored in the given
+//              constant value.
 //
 //-----------------------------------------------------------------------------
-template<typename T>
-void UnaryOperatorNode::NegateValue(
-    __inout ConstantValue* pValue,              // Value to negate
-    int basicType                               // Type to set to if it cannot be obtained
+HRESULT UnaryOperatorNode::NegateValue(
+    __inout ConstantValue* pValue               // Value to negate
     )
 {
-    T value;
-    if (SUCCEEDED(pValue->GetValue(&value)))
-    {
-        pValue->SetValue(-value);
-    }
-    else
+    CHK_START;
+
+    int componentType;
+    CHK(pValue->GetComponentType(&componentType));
+
+    for (UINT i = 0; i < pValue->GetComponentCount(); i++)
     {
-        pValue->SetTypeOnly(basicType);
+        ConstantValue component;
+        CHK(pValue->GetComponent(i, &component));
+
+        if (componentType == INT_TOK)
+        {
+            int intValue;
+            CHK(component.GetValue(&intValue));
+            component.SetValue(-intValue);
+        }
+        else
+        {
+            double doubleValue;
+            CHK(component.GetValue(&doubleValue));
+            component.SetValue(-doubleValue);
+        }
+
+        CHK(pValue->SetComponent(i, component));
     }
+
+    CHK_RETURN;
 }
@@ -80,10 +80,8 @@ public:
     UnaryOperatorType::Enum GetOperatorType() const { return _type; }
 
 private:
-    template<typename T>
-    static void NegateValue(
-        __inout ConstantValue* pValue,              // Value to negate
-        int basicType                               // Type to set to if it cannot be obtained
+    static HRESULT NegateValue(
+        __inout ConstantValue* pValue               // Value to negate
         );
 
 private:
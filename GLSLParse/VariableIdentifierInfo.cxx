@@ -30,10 +30,12 @@
 #include "GLSLParser.hxx"
 #include "RefCounted.hxx"
 #include "StructGLSLType.hxx"
+#include "ArrayGLSLType.hxx"
 #include "TypeNameIdentifierInfo.hxx"
 #include "StructSpecifierCollectionNode.hxx"
 #include "TranslationUnitNode.hxx"
 #include "GLSL.tab.h"
+#include "GLSLBinaryStream.hxx"
 
 MtDefine(CVariableIdentifierInfo, CGLSLParser, "IdentifierInfo");
 
@@ -202,7 +204,7 @@ HRESULT CVariableIdentifierInfo::Initialize(
         for (int i = 0; i < typeInfo._numFields; i++)
         {
             TSmartPointer<IIdentifierInfo> spNewInfo;
-            CHK(RefCounted<CVariableIdentifierInfo>::Create(
+            CHK(RefCounted<CVariableIdentifierInfo, MultiThreadedRefCount>::Create(
                 typeInfo._rgFields[i]._type, 
                 typeInfo._rgFields[i]._pszName,
                 pParser->UseSymbolTable(),
@@ -218,7 +220,7 @@ HRESULT CVariableIdentifierInfo::Initialize(
 
         // We also need a typename identifier info for that type
         TSmartPointer<CTypeNameIdentifierInfo> spTypeNameInfo;
-        CHK(RefCounted<CTypeNameIdentifierInfo>::Create(
+        CHK(RefCounted<CTypeNameIdentifierInfo, MultiThreadedRefCount>::Create(
             typeInfo,
             spStructType,
             /*out*/spTypeNameInfo
@@ -250,6 +252,102 @@ HRESULT CVariableIdentifierInfo::Initialize(
     CHK_RETURN;
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   Initialize
+//
+//  Synopsis:   Init identifier information that was written with Serialize,
+//              when restoring a translated shader. The type is serialized
+//              separately because types are shared between identifiers.
+//
+//-----------------------------------------------------------------------------
+HRESULT CVariableIdentifierInfo::Initialize(
+    __inout CGLSLBinaryReader* pReader,                         // Reader positioned at data written by Serialize
+    __in GLSLType* pType                                        // The GLSL type of the identifier
+    )
+{
+    CHK_START;
+
+    UINT uFlags;
+    UINT uSpecialVariable;
+    CHK(pReader->ReadInt(&_iSymbolIndex));
+    CHK(pReader->ReadInt(&_declarationScopeId));
+    CHK(pReader->ReadInt(&_typeQualifier));
+    CHK(pReader->ReadInt(&_precisionQualifier));
+    CHK(pReader->ReadUInt(&uFlags));
+    CHK(pReader->ReadUInt(&_uWriteCount));
+    CHK(pReader->ReadUInt(&uSpecialVariable));
+
+    CHKB_HR(uSpecialVariable <= static_cast<UINT>(GLSLSpecialVariables::count), E_GLSL_INVALIDDATA);
+    _specialVariable = static_cast<GLSLSpecialVariables::Enum>(uSpecialVariable);
+
+    _fUsed = (uFlags & 0x1) != 0;
+    _fIsLoopDeclared = (uFlags & 0x2) != 0;
+    _fIsParameter = (uFlags & 0x4) != 0;
+
+    UINT uNameCount;
+    CHK(pReader->ReadUInt(&uNameCount));
+    for (UINT i = 0; i < uNameCount; i++)
+    {
+        const char* pszName;
+        CHK(pReader->ReadString(&pszName));
+        CHK(_rgHLSLNames.Add(pszName));
+    }
+
+    UINT uSemanticCount;
+    CHK(pReader->ReadUInt(&uSemanticCount));
+    for (UINT i = 0; i < uSemanticCount; i++)
+    {
+        const char* pszSemantic;
+        CHK(pReader->ReadString(&pszSemantic));
+        CHK(_rgHLSLSemantics.Add(pszSemantic));
+    }
+
+    _spType = pType;
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   Serialize
+//
+//  Synopsis:   Writes everything about the identifier except its type and
+//              its initial value. The initial value is only used while the
+//              shader is being verified.
+//
+//-----------------------------------------------------------------------------
+HRESULT CVariableIdentifierInfo::Serialize(
+    __inout CGLSLBinaryWriter* pWriter                          // Where to write the identifier
+    ) const
+{
+    CHK_START;
+
+    UINT uFlags = (_fUsed ? 0x1 : 0) | (_fIsLoopDeclared ? 0x2 : 0) | (_fIsParameter ? 0x4 : 0);
+
+    CHK(pWriter->WriteInt(_iSymbolIndex));
+    CHK(pWriter->WriteInt(_declarationScopeId));
+    CHK(pWriter->WriteInt(_typeQualifier));
+    CHK(pWriter->WriteInt(_precisionQualifier));
+    CHK(pWriter->WriteUInt(uFlags));
+    CHK(pWriter->WriteUInt(_uWriteCount));
+    CHK(pWriter->WriteUInt(static_cast<UINT>(_specialVariable)));
+
+    CHK(pWriter->WriteUInt(_rgHLSLNames.GetCount()));
+    for (UINT i = 0; i < _rgHLSLNames.GetCount(); i++)
+    {
+        CHK(pWriter->WriteString(_rgHLSLNames[i]));
+    }
+
+    CHK(pWriter->WriteUInt(_rgHLSLSemantics.GetCount()));
+    for (UINT i = 0; i < _rgHLSLSemantics.GetCount(); i++)
+    {
+        CHK(pWriter->WriteString(_rgHLSLSemantics[i]));
+    }
+
+    CHK_RETURN;
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   SetHLSLName
@@ -391,3 +489,37 @@ bool CVariableIdentifierInfo::AreEqualTypesForUniforms(
 
     return fTypesEqual && fPrecisionsEqual;
 }
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   GetMemorySize
+//
+//  Synopsis:   Returns the approximate memory retained by the info, including
+//              its names and semantics. Basic types are shared by the process
+//              and not counted; an array type is counted for each variable
+//              that has one, even though equal array types may be shared.
+//
+//-----------------------------------------------------------------------------
+UINT CVariableIdentifierInfo::GetMemorySize() const
+{
+    UINT cbMemorySize = sizeof(*this);
+
+    cbMemorySize += _rgHLSLNames.GetCapacity() * sizeof(_rgHLSLNames[0]);
+    for (UINT i = 0; i < _rgHLSLNames.GetCount(); i++)
+    {
+        cbMemorySize += static_cast<UINT>(_rgHLSLNames[i].GetLength()) + 1;
+    }
+
+    cbMemorySize += _rgHLSLSemantics.GetCapacity() * sizeof(_rgHLSLSemantics[0]);
+    for (UINT i = 0; i < _rgHLSLSemantics.GetCount(); i++)
+    {
+        cbMemorySize += static_cast<UINT>(_rgHLSLSemantics[i].GetLength()) + 1;
+    }
+
+    if (_spType != nullptr && _spType->IsArrayType())
+    {
+        cbMemorySize += sizeof(ArrayGLSLType);
+    }
+
+    return cbMemorySize;
+}
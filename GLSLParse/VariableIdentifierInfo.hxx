@@ -29,6 +29,9 @@
 #include "IdentifierInfo.hxx"
 #include "ConstantValue.hxx"
 
+class CGLSLBinaryWriter;
+class CGLSLBinaryReader;
+
 //+-----------------------------------------------------------------------------
 //
 //  Class:      CVariableIdentifierInfo
@@ -61,6 +64,13 @@ public:
         __in CGLSLParser* pParser                                   // Parser
         );
 
+    HRESULT Initialize(
+        __inout CGLSLBinaryReader* pReader,                         // Reader positioned at data written by Serialize
+        __in GLSLType* pType                                        // The GLSL type of the identifier
+        );
+
+    HRESULT Serialize(__inout CGLSLBinaryWriter* pWriter) const;
+
     // IIdentifierInfo overrides
     const char* GetHLSLName(UINT uIndex) const override;
     UINT GetHLSLNameCount() const override { return _rgHLSLNames.GetCount(); }
@@ -95,6 +105,7 @@ public:
     GLSLSpecialVariables::Enum GetSpecialVariable() const { return _specialVariable; }
     bool HasSemantic() const { return (_rgHLSLSemantics.GetCount() != 0); }
     bool IsInputStructVariable() const;
+    UINT GetMemorySize() const;
 
     static bool AreEqualTypesForUniforms(
         __in const CVariableIdentifierInfo* pVertexVariableInfo,    // Variable in vertex shader
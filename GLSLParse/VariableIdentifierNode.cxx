@@ -99,14 +99,14 @@ HRESULT VariableIdentifierNode::OutputHLSL(__in IStringStream* pOutput)
         if (spInfo->GetTypeQualifier() == ATTRIBUTE)
         {
             // Attributes are inputs to the vertex shader
-            CHK(pOutput->WriteString("vsInput."));
+            CHK(pOutput->WriteLiteral("vsInput."));
         }
         else
         {
             Assert(spInfo->GetTypeQualifier() == VARYING);
 
             // Varyings are inputs to the fragment shader
-            CHK(pOutput->WriteString("psInput."));
+            CHK(pOutput->WriteLiteral("psInput."));
         }
     }
 
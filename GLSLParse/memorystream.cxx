@@ -33,7 +33,10 @@
 //
 //-----------------------------------------------------------------------------
 CMemoryStream::CMemoryStream() :
-    _uIndent(0)
+    _uSize(0),
+    _uReadPosition(0),
+    _uIndent(0),
+    _fScanLocked(false)
 {
 }
 
@@ -41,22 +44,46 @@ CMemoryStream::CMemoryStream() :
 //
 //  Function:   Initialize
 //
+//  Synopsis:   The buffer is allocated by the first write, so that streams
+//              which never get written to cost nothing.
+//
 //-----------------------------------------------------------------------------
 HRESULT CMemoryStream::Initialize()
 {
-    return ::CreateStreamOnHGlobal(nullptr, TRUE, &_spStream);
+    return S_OK;
 }
 
 //+----------------------------------------------------------------------------
 //
-//  Function:   WriteChar
+//  Function:   EnsureSpareCapacity
 //
-//  Synopsis:   Write a single character to the stream.
+//  Synopsis:   Make sure there is room for at least cchSpare more characters
+//              after the end of the stream. The buffer at least doubles each
+//              time it grows, so a run of small appends costs amortized
+//              constant time.
 //
 //-----------------------------------------------------------------------------
-HRESULT CMemoryStream::WriteChar(char c)
+HRESULT CMemoryStream::EnsureSpareCapacity(UINT cchSpare)
 {
-    return _spStream->Write(&c, 1, nullptr);
+    CHK_START;
+
+    // Growing moves the buffer, which would pull it out from under the scanner
+    Assert(!_fScanLocked);
+    CHKB(!_fScanLocked);
+
+    UINT cchRequired;
+    CHK(::UIntAdd(_uSize, cchSpare, &cchRequired));
+
+    UINT cchCapacity = _aryBuffer.GetCapacity();
+    if (cchRequired > cchCapacity)
+    {
+        const UINT c_cchMinimumCapacity = 256;
+
+        UINT cchGrowTo = (cchCapacity < UINT_MAX / 2) ? max(cchCapacity * 2, c_cchMinimumCapacity) : UINT_MAX - 1;
+        CHK(_aryBuffer.EnsureCapacity(max(cchGrowTo, cchRequired)));
+    }
+
+    CHK_RETURN;
 }
 
 //+----------------------------------------------------------------------------
@@ -73,7 +100,7 @@ HRESULT CMemoryStream::WriteString(const char *pString)
     size_t length;
     CHK(::StringCchLengthA(pString, STRSAFE_MAX_CCH, &length));
 
-    CHK(_spStream->Write(pString, length, nullptr));
+    CHK(WriteBuffer(pString, static_cast<UINT>(length)));
 
     CHK_RETURN;
 }
@@ -86,30 +113,78 @@ HRESULT CMemoryStream::WriteString(const char *pString)
 //              set locally on the length that the result can have, exceeding
 //              this limit will propogate an error.
 //
+//              The result is formatted straight into the spare capacity at
+//              the end of the buffer, and only becomes part of the stream
+//              once it is known to have fit.
+//
 //-----------------------------------------------------------------------------
 HRESULT CMemoryStream::WriteFormat(UINT uMax, const char* pszFormat, ...)
 {
     CHK_START;
 
+    CHK(EnsureSpareCapacity(uMax));
+
     va_list args;
     va_start(args, pszFormat);
 
-    TSmartArray<char> spFormated;
-    CHK(spFormated.New(uMax));
-    CHK(::StringCchVPrintfA(spFormated, uMax, pszFormat, args));
+    char* pszDest = _aryBuffer.GetData() + _uSize;
+    hr = ::StringCchVPrintfA(pszDest, uMax, pszFormat, args);
+    va_end(args);
+    CHK(hr);
 
     size_t length;
-    CHK(::StringCchLengthA(spFormated, STRSAFE_MAX_CCH, &length));
-    CHK(_spStream->Write(spFormated, length, nullptr));
+    CHK(::StringCchLengthA(pszDest, uMax, &length));
+    _uSize += static_cast<UINT>(length);
 
     CHK_RETURN;
 }
 
+//+----------------------------------------------------------------------------
+//
+//  Function:   ReserveBuffer
+//
+//  Synopsis:   Hand out room for cchReserve characters at the end of the
+//              stream so that a caller can produce its output in place.
+//              Nothing becomes part of the stream until CommitBuffer is
+//              called, and any other write in between invalidates the
+//              buffer.
+//
+//-----------------------------------------------------------------------------
+HRESULT CMemoryStream::ReserveBuffer(
+    UINT cchReserve,                                            // Number of characters to make room for
+    __deref_out_ecount(cchReserve) char** ppBuffer              // Spare capacity at the end of the stream
+    )
+{
+    CHK_START;
+
+    CHK(EnsureSpareCapacity(cchReserve));
+
+    (*ppBuffer) = _aryBuffer.GetData() + _uSize;
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   CommitBuffer
+//
+//  Synopsis:   Add the first cchWritten characters of the buffer handed out
+//              by ReserveBuffer to the stream.
+//
+//-----------------------------------------------------------------------------
+void CMemoryStream::CommitBuffer(UINT cchWritten)
+{
+    Assert(cchWritten <= _aryBuffer.GetCapacity() - _uSize);
+
+    _uSize += cchWritten;
+}
+
 //+----------------------------------------------------------------------------
 //
 //  Function:   ExtractString
 //
-//  Synopsis:   Convert the stream into a string.
+//  Synopsis:   Append a copy of the stream contents to a string. The stream
+//              is left as it is.
 //
 //-----------------------------------------------------------------------------
 HRESULT CMemoryStream::ExtractString(
@@ -118,21 +193,48 @@ HRESULT CMemoryStream::ExtractString(
 {
     CHK_START;
 
-    UINT length;
-    CHK(GetSize(&length));
-
-    // Now lock the memory and copy it across
-    if (length != 0)
+    if (_uSize != 0)
     {
-        HGLOBAL hStreamGlobal;
-        CHK(::GetHGlobalFromStream(_spStream, &hStreamGlobal));
+        CHK(spCode.Append(_aryBuffer.GetData(), _uSize));
+    }
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   TakeString
+//
+//  Synopsis:   Move the stream contents onto the end of a string, leaving the
+//              stream empty. When the string is empty the buffer is handed
+//              over to it as is, otherwise the contents are appended.
+//
+//-----------------------------------------------------------------------------
+HRESULT CMemoryStream::TakeString(
+    __inout CMutableString<char>& spCode                        // Output ASCII string
+    )
+{
+    CHK_START;
 
-        LPVOID pStreamMem = ::GlobalLock(hStreamGlobal);
-        hr = spCode.Append(static_cast<char*>(pStreamMem), length);
-        ::GlobalUnlock(hStreamGlobal);
-        CHK(hr);
+    if (_uSize != 0)
+    {
+        if (spCode.GetLength() == 0)
+        {
+            // Strings are null terminated, streams are not
+            CHK(EnsureSpareCapacity(1));
+            _aryBuffer.GetData()[_uSize] = '\0';
+
+            spCode.AdoptBuffer(_aryBuffer, _uSize);
+        }
+        else
+        {
+            CHK(spCode.Append(_aryBuffer.GetData(), _uSize));
+        }
     }
 
+    _uSize = 0;
+    _uReadPosition = 0;
+
     CHK_RETURN;
 }
 
@@ -140,16 +242,26 @@ HRESULT CMemoryStream::ExtractString(
 //
 //  Function:   SetSize
 //
-//  Synopsis:   Set the current size of the stream. Use in conjunction with
-//              Seek to reinit the stream.
+//  Synopsis:   Set the current size of the stream. Growing the stream pads
+//              it with nulls. Use in conjunction with Seek to reinit the
+//              stream.
 //
 //-----------------------------------------------------------------------------
 HRESULT CMemoryStream::SetSize(UINT uSize)
 {
-    ULARGE_INTEGER newSize;
-    newSize.QuadPart = uSize;
+    CHK_START;
 
-    return _spStream->SetSize(newSize);
+    if (uSize > _uSize)
+    {
+        UINT cchPad = uSize - _uSize;
+        CHK(EnsureSpareCapacity(cchPad));
+        ::memset(_aryBuffer.GetData() + _uSize, 0, cchPad);
+    }
+
+    _uSize = uSize;
+    _uReadPosition = min(_uReadPosition, _uSize);
+
+    CHK_RETURN;
 }
 
 //+----------------------------------------------------------------------------
@@ -161,16 +273,9 @@ HRESULT CMemoryStream::SetSize(UINT uSize)
 //-----------------------------------------------------------------------------
 HRESULT CMemoryStream::GetSize(__out UINT* puSize) const
 {
-    CHK_START;
-
-    HGLOBAL hStreamGlobal;
-    CHK(::GetHGlobalFromStream(_spStream, &hStreamGlobal));
-
-    // Grab the size, which could be zero if the tree was valid but nothing was output
-    SIZE_T length = ::GlobalSize(hStreamGlobal);
-    (*puSize) = static_cast<UINT>(length);
+    (*puSize) = _uSize;
 
-    CHK_RETURN 
+    return S_OK;
 }
 
 //+----------------------------------------------------------------------------
@@ -182,12 +287,14 @@ HRESULT CMemoryStream::GetSize(__out UINT* puSize) const
 //-----------------------------------------------------------------------------
 HRESULT CMemoryStream::WriteIndent()
 {
+    CHK_START;
+
     for (UINT i = 0 ; i < _uIndent; i++)
     {
-        WriteString("  ");
+        CHK(WriteLiteral("  "));
     }
 
-    return S_OK;
+    CHK_RETURN;
 }
 
 //+----------------------------------------------------------------------------
@@ -216,20 +323,28 @@ void CMemoryStream::DecreaseIndent()
 
 //+----------------------------------------------------------------------------
 //
-//  Function:   ReadChar
+//  Function:   Read
 //
-//  Synopsis:   Pull a character from the stream
+//  Synopsis:   Pull up to uMax characters from the stream. Reading at the end
+//              of the stream succeeds with zero characters read.
 //
 //-----------------------------------------------------------------------------
-HRESULT CMemoryStream::ReadChar(__out char* pChar)
+HRESULT CMemoryStream::Read(
+    __out_ecount_part(uMax, *puRead) char* pBuffer,             // Buffer to read into
+    UINT uMax,                                                  // Size of the buffer
+    __out UINT* puRead                                          // Number of characters read
+    )
 {
-    CHK_START;
+    UINT cchRead = min(uMax, _uSize - _uReadPosition);
+    if (cchRead > 0)
+    {
+        ::memcpy(pBuffer, _aryBuffer.GetData() + _uReadPosition, cchRead);
+        _uReadPosition += cchRead;
+    }
 
-    ULONG cbRead;
-    CHK(_spStream->Read(pChar, 1, &cbRead));
-    CHKB(cbRead == 1);    
+    (*puRead) = cchRead;
 
-    CHK_RETURN;
+    return S_OK;
 }
 
 //+----------------------------------------------------------------------------
@@ -241,8 +356,51 @@ HRESULT CMemoryStream::ReadChar(__out char* pChar)
 //-----------------------------------------------------------------------------
 HRESULT CMemoryStream::SeekToStart()
 {
-    LARGE_INTEGER li;
-    li.QuadPart = 0;
+    _uReadPosition = 0;
 
-    return _spStream->Seek(li, STREAM_SEEK_SET, nullptr);
+    return S_OK;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   LockScanBuffer
+//
+//  Synopsis:   Terminate the stream with the two nulls that flex needs for
+//              in place scanning, and hand out the buffer so the scanner can
+//              run directly over it. The terminators are left in the stream,
+//              so it is only good for scanning afterwards. The buffer must
+//              not move while it is locked, so the stream cannot grow until
+//              UnlockScanBuffer is called.
+//
+//-----------------------------------------------------------------------------
+HRESULT CMemoryStream::LockScanBuffer(
+    __deref_out_ecount(*puSize) char** ppBuffer,                // Stream contents followed by two nulls
+    __out UINT* puSize                                          // Size of the buffer, including both nulls
+    )
+{
+    CHK_START;
+
+    CHKB(!_fScanLocked);
+
+    CHK(WriteChar('\0'));
+    CHK(WriteChar('\0'));
+
+    _fScanLocked = true;
+
+    (*ppBuffer) = _aryBuffer.GetData();
+    (*puSize) = _uSize;
+
+    CHK_RETURN;
+}
+
+//+----------------------------------------------------------------------------
+//
+//  Function:   UnlockScanBuffer
+//
+//  Synopsis:   Release the lock taken by LockScanBuffer.
+//
+//-----------------------------------------------------------------------------
+void CMemoryStream::UnlockScanBuffer()
+{
+    _fScanLocked = false;
 }
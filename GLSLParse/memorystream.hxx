@@ -35,6 +35,12 @@
 //  Synopsis:   Class to encapsulate a stream that is fed the generated scanner and the associated
 //              input / output.
 //
+//              The contents live in a single buffer that grows geometrically,
+//              so appends are a bounds check and a copy, formatted writes land
+//              directly in the spare capacity and TakeString can hand the
+//              buffer to a string without copying it. Writes always append;
+//              the read position is only used by Read.
+//
 //              This is not meant to be consumed from outside of the lib - 
 //              use the GLSLTranslate function rather than this directly.
 //
@@ -50,13 +56,71 @@ public:
         __inout CMutableString<char>& spCode                        // Output ASCII string
         );
 
-    HRESULT ReadChar(__out char* pChar);
-  
+    HRESULT TakeString(
+        __inout CMutableString<char>& spCode                        // Output ASCII string
+        );
+
+    HRESULT Read(
+        __out_ecount_part(uMax, *puRead) char* pBuffer,             // Buffer to read into
+        UINT uMax,                                                  // Size of the buffer
+        __out UINT* puRead                                          // Number of characters read
+        );
+
     HRESULT SetSize(UINT uSize);
     HRESULT GetSize(__out UINT* puSize) const;
+    UINT GetMemorySize() const { return sizeof(*this) + _aryBuffer.GetCapacity(); }
+
+    HRESULT LockScanBuffer(
+        __deref_out_ecount(*puSize) char** ppBuffer,                // Stream contents followed by two nulls
+        __out UINT* puSize                                          // Size of the buffer, including both nulls
+        );
+    void UnlockScanBuffer();
 
     // IStringStream implementation
-    HRESULT WriteChar(char c) override;
+    HRESULT WriteChar(char c) override
+    {
+        if (_uSize == _aryBuffer.GetCapacity())
+        {
+            HRESULT hr = EnsureSpareCapacity(1);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        _aryBuffer.GetData()[_uSize++] = c;
+        return S_OK;
+    }
+
+    HRESULT WriteBuffer(
+        __in_ecount(uLength) const char* pBuffer,                   // Characters to write
+        UINT uLength                                                // Number of characters
+        ) override
+    {
+        if (uLength > _aryBuffer.GetCapacity() - _uSize)
+        {
+            HRESULT hr = EnsureSpareCapacity(uLength);
+            if (FAILED(hr))
+            {
+                return hr;
+            }
+        }
+
+        if (uLength > 0)
+        {
+            ::memcpy(_aryBuffer.GetData() + _uSize, pBuffer, uLength);
+            _uSize += uLength;
+        }
+
+        return S_OK;
+    }
+
+    HRESULT ReserveBuffer(
+        UINT cchReserve,                                            // Number of characters to make room for
+        __deref_out_ecount(cchReserve) char** ppBuffer              // Spare capacity at the end of the stream
+        );
+    void CommitBuffer(UINT cchWritten);
+
     HRESULT WriteString(const char* pString) override;
     HRESULT WriteFormat(UINT uMax, const char* pszFormat, ...) override;
     HRESULT WriteIndent() override;
@@ -67,6 +131,12 @@ protected:
     HRESULT Initialize();
 
 private:
-    TSmartPointer<IStream> _spStream;
+    HRESULT EnsureSpareCapacity(UINT cchSpare);
+
+private:
+    CModernArray<char> _aryBuffer;                                  // Stream contents; only the capacity of the array is used
+    UINT _uSize;                                                    // Number of characters written to the buffer
+    UINT _uReadPosition;                                            // Position that the next Read starts from
     UINT _uIndent;
+    bool _fScanLocked;                                              // LockScanBuffer has handed out the buffer
 };
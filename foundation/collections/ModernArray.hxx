@@ -112,6 +112,7 @@ public:
     T*          GetData() const;
     const T*    GetConstData() const;
     HRESULT_VOID Resize(UINT nNewSize);
+    void        Swap(CModernArray<T, TElementTraits>& other);
 
     //
     // The following three functions are templated to permit the caller to
@@ -748,6 +749,29 @@ CModernArray<T, TElementTraits>::Resize
     return S_OK_VOID;
 }
 
+//
+// Exchanges the storage of this array with another one. No elements are
+// copied, so this is how ownership of a buffer is handed over.
+//
+template <class T, class TElementTraits>
+void CModernArray<T, TElementTraits>::Swap
+(
+    CModernArray<T, TElementTraits>& other  // Array to exchange storage with
+)
+{
+    T* aT = _aT;
+    UINT nSize = _nSize;
+    UINT nAllocSize = _nAllocSize;
+
+    _aT = other._aT;
+    _nSize = other._nSize;
+    _nAllocSize = other._nAllocSize;
+
+    other._aT = aT;
+    other._nSize = nSize;
+    other._nAllocSize = nAllocSize;
+}
+
 //----------------------------------------------------------------------------
 // TRefCountedAbstractModernArray
 //
@@ -147,6 +147,19 @@ HRESULT CMutableString<T>::Format(size_t uMax, _In_z_ const T* pszFormatString,
     return S_OK;
 }
 
+// Take over the storage of the given array, which must hold a null terminated string
+// of the given length. The array is left empty and the previous contents are released.
+template <typename T>
+void CMutableString<T>::AdoptBuffer(CModernArray<T>& rgChars, size_t uLength)
+{
+    requires(uLength < rgChars.GetCapacity());
+    requires(rgChars.GetData()[uLength] == 0);
+
+    _rgCharArray.RemoveAll();
+    _rgCharArray.Swap(rgChars);
+    _uStringLength = uLength;
+}
+
 // Cast to non-const C char pointer.
 template <typename T>
 CMutableString<T>::operator T*()
@@ -58,6 +58,10 @@ public:
     // Replace the string with the given format string and subsitution.
     HRESULT Format(size_t uMax, _In_z_ const T* pszFormatString, ...);
 
+    // Take over the storage of the given array, which must hold a null terminated string
+    // of the given length. The array is left empty and the previous contents are released.
+    void AdoptBuffer(CModernArray<T>& rgChars, size_t uLength);
+
     // Cast to non-const C char pointer.
     operator T*();
 
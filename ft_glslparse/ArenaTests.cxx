@@ -0,0 +1,184 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+
+//  Class:      ArenaTests
+//  Synopsis:   Defines tests for the arena used to allocate the parse tree
+
+#include "headers.hxx"
+#include "ArenaTests.hxx"
+#include "GLSLArena.hxx"
+#include "RefCounted.hxx"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace ft_glslparse
+{
+    //+-----------------------------------------------------------------------------
+    //
+    //  Class:      CArenaTestObject
+    //
+    //  Synopsis:   Object allocated through the arena, with an optional payload
+    //              to control its size.
+    //
+    //------------------------------------------------------------------------------
+    template<UINT uPayloadSize>
+    class CArenaTestObject : public IUnknown, public CGLSLArenaObject
+    {
+    public:
+        HRESULT Initialize() { return S_OK; }
+
+    private:
+        BYTE _rgPayload[uPayloadSize];
+    };
+
+    typedef CArenaTestObject<16> CSmallArenaTestObject;
+    typedef CArenaTestObject<32 * 1024> CLargeArenaTestObject;
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   ScopeTests
+    //
+    //  Synopsis:   Objects only come from an arena while a scope for it is
+    //              active, and scopes restore the previous arena on exit.
+    //
+    //-----------------------------------------------------------------------------
+    void ArenaTests::ScopeTests()
+    {
+        TSmartPointer<CGLSLArena> spArena;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLArena>::Create(/*out*/spArena));
+
+        TSmartPointer<CGLSLArena> spOtherArena;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLArena>::Create(/*out*/spOtherArena));
+
+        VERIFY_IS_NULL(CGLSLArena::GetCurrent());
+
+        // Outside of a scope objects come from the heap
+        TSmartPointer<CSmallArenaTestObject> spHeapObject;
+        VERIFY_SUCCEEDED(RefCounted<CSmallArenaTestObject>::Create(/*out*/spHeapObject));
+        VERIFY_ARE_EQUAL(0U, spArena->GetChunkCount());
+        VERIFY_ARE_EQUAL(0U, spArena->GetAllocationCount());
+
+        {
+            CGLSLArenaScope scope(spArena);
+            VERIFY_ARE_EQUAL(static_cast<CGLSLArena*>(spArena), CGLSLArena::GetCurrent());
+
+            TSmartPointer<CSmallArenaTestObject> spFirst;
+            VERIFY_SUCCEEDED(RefCounted<CSmallArenaTestObject>::Create(/*out*/spFirst));
+            TSmartPointer<CSmallArenaTestObject> spSecond;
+            VERIFY_SUCCEEDED(RefCounted<CSmallArenaTestObject>::Create(/*out*/spSecond));
+
+            // Both small objects fit in the first chunk
+            VERIFY_ARE_EQUAL(1U, spArena->GetChunkCount());
+            VERIFY_ARE_EQUAL(2U, spArena->GetAllocationCount());
+            VERIFY_IS_TRUE(spArena->GetBytesAllocated() >= 2 * sizeof(RefCounted<CSmallArenaTestObject>));
+
+            {
+                CGLSLArenaScope innerScope(spOtherArena);
+
+                TSmartPointer<CSmallArenaTestObject> spInner;
+                VERIFY_SUCCEEDED(RefCounted<CSmallArenaTestObject>::Create(/*out*/spInner));
+                VERIFY_ARE_EQUAL(1U, spOtherArena->GetChunkCount());
+            }
+
+            VERIFY_ARE_EQUAL(static_cast<CGLSLArena*>(spArena), CGLSLArena::GetCurrent());
+        }
+
+        VERIFY_IS_NULL(CGLSLArena::GetCurrent());
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   LifetimeTests
+    //
+    //  Synopsis:   Objects do not hold references on their arena. Freeing one
+    //              only updates the count of live objects, and the memory is
+    //              kept until the arena goes away.
+    //
+    //-----------------------------------------------------------------------------
+    void ArenaTests::LifetimeTests()
+    {
+        TSmartPointer<CGLSLArena> spArena;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLArena>::Create(/*out*/spArena));
+
+        TSmartPointer<CSmallArenaTestObject> spFirst;
+        TSmartPointer<CSmallArenaTestObject> spSecond;
+        {
+            CGLSLArenaScope scope(spArena);
+            VERIFY_SUCCEEDED(RefCounted<CSmallArenaTestObject>::Create(/*out*/spFirst));
+            VERIFY_SUCCEEDED(RefCounted<CSmallArenaTestObject>::Create(/*out*/spSecond));
+        }
+
+        // Only this function references the arena
+        spArena->AddRef();
+        VERIFY_ARE_EQUAL(2UL, spArena->Release());
+        VERIFY_ARE_EQUAL(2U, spArena->GetLiveObjectCount());
+
+        // Objects can be freed outside of the scope they were allocated in
+        spFirst.Release();
+        VERIFY_ARE_EQUAL(1U, spArena->GetLiveObjectCount());
+        VERIFY_ARE_EQUAL(2U, spArena->GetAllocationCount());
+        VERIFY_ARE_EQUAL(1U, spArena->GetChunkCount());
+
+        spSecond.Release();
+        VERIFY_ARE_EQUAL(0U, spArena->GetLiveObjectCount());
+
+        spArena->AddRef();
+        VERIFY_ARE_EQUAL(2UL, spArena->Release());
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   LargeAllocationTests
+    //
+    //  Synopsis:   Large objects get a chunk of their own and do not cause the
+    //              current chunk to be abandoned.
+    //
+    //-----------------------------------------------------------------------------
+    void ArenaTests::LargeAllocationTests()
+    {
+        TSmartPointer<CGLSLArena> spArena;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLArena>::Create(/*out*/spArena));
+
+        CGLSLArenaScope scope(spArena);
+
+        TSmartPointer<CSmallArenaTestObject> spSmall;
+        VERIFY_SUCCEEDED(RefCounted<CSmallArenaTestObject>::Create(/*out*/spSmall));
+        VERIFY_ARE_EQUAL(1U, spArena->GetChunkCount());
+
+        TSmartPointer<CLargeArenaTestObject> spLarge;
+        VERIFY_SUCCEEDED(RefCounted<CLargeArenaTestObject>::Create(/*out*/spLarge));
+        VERIFY_ARE_EQUAL(2U, spArena->GetChunkCount());
+        VERIFY_IS_TRUE(spArena->GetBytesReserved() >= spArena->GetBytesAllocated());
+
+        // Small objects keep filling the first chunk
+        TSmartPointer<CSmallArenaTestObject> spSmallAfter;
+        VERIFY_SUCCEEDED(RefCounted<CSmallArenaTestObject>::Create(/*out*/spSmallAfter));
+        VERIFY_ARE_EQUAL(2U, spArena->GetChunkCount());
+    }
+} /* namespace ft_glslparse */
@@ -1937,6 +1937,12 @@ namespace ft_glslparse
         // Function definition defines a scope too
         TestParserInputNegativeError(GLSLShaderType::Vertex, 0, L"void foo(float bar) { float bar; }", E_GLSLERROR_IDENTIFIERALREADYDECLARED);
 
+        // Declarations are not visible once their scope has ended, or from a sibling scope
+        TestParserInputNegativeError(GLSLShaderType::Vertex, 0, L"void foo() { { float bar; } bar = 1.0; }", E_GLSLERROR_UNDECLAREDIDENTIFIER);
+        TestParserInputNegativeError(GLSLShaderType::Vertex, 0, L"void foo() { if (true) { float bar; } else { bar = 1.0; } }", E_GLSLERROR_UNDECLAREDIDENTIFIER);
+        TestParserInputNegativeError(GLSLShaderType::Vertex, 0, L"void foo() { for (int i = 0; i < 2; i++) { } i = 1; }", E_GLSLERROR_UNDECLAREDIDENTIFIER);
+        TestParserInputNegativeError(GLSLShaderType::Vertex, 0, L"void f1(float bar) {} void foo() { bar = 1.0; }", E_GLSLERROR_UNDECLAREDIDENTIFIER);
+
         // Regular blocks define scope
         TestParserInput(GLSLShaderType::Vertex,     GLSLTranslateOptions::DisableWriteInputs,   L"void foo(float bar) { { float bar; } }",                                                          "void fn_0_0(float var_1_1)\n{\n{\nfloat var_2_1=0.0;\n}\n}\n");
 
@@ -2285,7 +2291,64 @@ namespace ft_glslparse
             strNestedFunctionShader.Append(strCurrentFunctionName);
 
             TestParserInputNegativeError(GLSLShaderType::Vertex, 0, strNestedFunctionShader, E_GLSLERROR_MAXFUNCTIONDEPTHEXCEEDED);
+
+            // Calling foo_{uMaxFunctionNestingLevel - 2} from main is right at the limit
+            strNestedFunctionShader.Set(L"");
+            for (UINT i = 0; i < uMaxFunctionNestingLevel - 1; i++)
+            {
+                if (i == 0)
+                {
+                    strCurrentFunctionName.Format(uMaxStringSize, L"void foo_%i() {}", i);
+                }
+                else
+                {
+                    strCurrentFunctionName.Format(uMaxStringSize, L"void foo_%i() { foo_%i(); }", i, i - 1);
+                }
+                strNestedFunctionShader.Append(strCurrentFunctionName);
+            }
+
+            strCurrentFunctionName.Format(uMaxStringSize, L"void main() { foo_%i(); }", uMaxFunctionNestingLevel - 2);
+            strNestedFunctionShader.Append(strCurrentFunctionName);
+
+            CSmartBstr bstrAtLimit;
+            bstrAtLimit.Set(strNestedFunctionShader);
+
+            TSmartPointer<CGLSLConvertedShader> spAtLimit;
+            VERIFY_SUCCEEDED(::GLSLTranslate(bstrAtLimit, GLSLShaderType::Vertex, 0, WebGLFeatureLevel::Level_10, &spAtLimit));
+            VERIFY_IS_TRUE(spAtLimit->TranslationSucceeded());
         }
+
+        {
+            // Functions that each call both functions of the level below make a call graph
+            // with a number of paths that doubles with each level. Each function should only
+            // be walked once when checking the depth.
+            const UINT uDiamondLevels = 64;
+            CMutableString<wchar_t> strDiamondShader(uMaxStringSize);
+            CMutableString<wchar_t> strCurrentFunctionName(uMaxStringSize);
+
+            strDiamondShader.Append(L"float a_0(float x) { return x; } float b_0(float x) { return x * 2.0; }");
+            for (UINT i = 1; i < uDiamondLevels; i++)
+            {
+                strCurrentFunctionName.Format(uMaxStringSize, L"float a_%i(float x) { return a_%i(x) + b_%i(x); }", i, i - 1, i - 1);
+                strDiamondShader.Append(strCurrentFunctionName);
+                strCurrentFunctionName.Format(uMaxStringSize, L"float b_%i(float x) { return b_%i(x) - a_%i(x); }", i, i - 1, i - 1);
+                strDiamondShader.Append(strCurrentFunctionName);
+            }
+
+            strCurrentFunctionName.Format(uMaxStringSize, L"void main() { gl_Position = vec4(a_%i(1.0) + b_%i(1.0)); }", uDiamondLevels - 1, uDiamondLevels - 1);
+            strDiamondShader.Append(strCurrentFunctionName);
+
+            CSmartBstr bstrDiamond;
+            bstrDiamond.Set(strDiamondShader);
+
+            TSmartPointer<CGLSLConvertedShader> spDiamond;
+            VERIFY_SUCCEEDED(::GLSLTranslate(bstrDiamond, GLSLShaderType::Vertex, 0, WebGLFeatureLevel::Level_10, &spDiamond));
+            VERIFY_IS_TRUE(spDiamond->TranslationSucceeded());
+        }
+
+        // Recursion has no depth limit at all
+        TestParserInputNegativeError(GLSLShaderType::Vertex, 0, L"void foo(); void foo() { foo(); } void main() { foo(); }", E_GLSLERROR_MAXFUNCTIONDEPTHEXCEEDED);
+        TestParserInputNegativeError(GLSLShaderType::Vertex, 0, L"void foo(); void bar() { foo(); } void foo() { bar(); } void main() { foo(); }", E_GLSLERROR_MAXFUNCTIONDEPTHEXCEEDED);
     }
     
     // Test limits on individually declared variables. Limits on arrays are in BasicGLSLTests::ArrayDeclarationTests.
@@ -3487,6 +3550,207 @@ namespace ft_glslparse
             );
     }
 
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   DeadCodeEliminationTests
+    //
+    //  Synopsis:   Tests that functions the entry point cannot reach, and
+    //              globals that are never used, are left out of the output
+    //              when asked for. The interface of the shader must not change.
+    //
+    //+----------------------------------------------------------------------------
+    void BasicGLSLTests::DeadCodeEliminationTests()
+    {
+        const UINT uOptions = GLSLTranslateOptions::DisableWriteInputs | GLSLTranslateOptions::EliminateDeadCode;
+
+        // Unreachable functions go along with their prototypes, while functions reached
+        // through other functions stay. Globals stay if anything uses them, even dead code.
+        TestParserInput(
+            GLSLShaderType::Vertex,
+            uOptions,
+            L"float unused;"
+            L"const float scale = 2.0;"
+            L"float dead();"
+            L"float helper2() { return scale; }"
+            L"float helper() { return helper2(); }"
+            L"float dead() { return helper2() * scale; }"
+            L"void main() { helper(); }",
+            "static const float var_0_1=2.000000e+000;\nfloat fn_0_3()\n{\nreturn var_0_1;\n}\nfloat fn_0_4()\n{\nreturn fn_0_3();\n}\nvoid main(in VSInput vsInputArg, out PSInput psInputOut)\n{\nfn_0_4();\n}\n"
+            );
+
+        // Globals with initializers that are not constant are kept, and still get moved into the init function
+        TestParserInput(
+            GLSLShaderType::Vertex,
+            uOptions,
+            L"vec4 v1 = vec4(1.0);"
+            L"vec2 v2 = v1.xx;"
+            L"void main() {}"
+            L"vec2 v3 = v2;"
+            L"const bool f = true;"
+            L"void bar() {}"
+            L"vec2 v4 = v1.yy;",
+            "static float4 var_0_0=float4((1.000000e+000).xxxx);\nstatic float2 var_0_1=0.0;\nvoid fn_0_11();\nvoid main(in VSInput vsInputArg, out PSInput psInputOut)\n{\nfn_0_11();\n}\nstatic float2 var_0_3=0.0;\nstatic float2 var_0_6=0.0;\nvoid fn_0_11()\n{\nvar_0_1=var_0_0.xx;\nvar_0_3=var_0_1;\nvar_0_6=var_0_0.yy;\n}\n"
+            );
+
+        // Without the option everything is output
+        TestParserInput(
+            GLSLShaderType::Vertex,
+            GLSLTranslateOptions::DisableWriteInputs,
+            L"float unused;"
+            L"void bar() {}"
+            L"void main() {}",
+            "static float var_0_0=0.0;\nvoid fn_0_1()\n{\n}\nvoid main(in VSInput vsInputArg, out PSInput psInputOut)\n{\n}\n"
+            );
+
+        // Unused uniforms and attributes are still reflected
+        CSmartBstr bstrText;
+        bstrText.Set(L"uniform vec4 u; attribute vec4 a; void main() {}");
+
+        TSmartPointer<CGLSLConvertedShader> spShader;
+        VERIFY_SUCCEEDED(::GLSLTranslate(bstrText, GLSLShaderType::Vertex, uOptions, WebGLFeatureLevel::Level_10, &spShader));
+        VERIFY_ARE_EQUAL(0U, spShader->GetErrorCount());
+
+        TSmartPointer<CVariableIdentifierInfo> spInfo;
+        VERIFY_SUCCEEDED(spShader->UseIdentifierTable()->GetVariableInfoFromString("u", GLSLQualifier::Uniform, &spInfo));
+
+        spInfo.Release();
+        VERIFY_SUCCEEDED(spShader->UseIdentifierTable()->GetVariableInfoFromString("a", GLSLQualifier::Attribute, &spInfo));
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   ConstantFoldingTests
+    //
+    //  Synopsis:   Tests that constant expressions are replaced with their
+    //              values when asked for, and that expressions that cannot
+    //              be calculated are left as they were.
+    //
+    //+----------------------------------------------------------------------------
+    void BasicGLSLTests::ConstantFoldingTests()
+    {
+        const UINT uOptions = GLSLTranslateOptions::DisableWriteInputs | GLSLTranslateOptions::FoldConstants;
+
+        // Scalars, including reads of const variables
+        TestParserInput(GLSLShaderType::Vertex, uOptions, L"const int x = 1; const int y = x + 2;",                                           "static const int var_0_0=1;\nstatic const int var_0_1=3;\n");
+        TestParserInput(GLSLShaderType::Vertex, uOptions, L"const int x = 1; const int y = -x;",                                              "static const int var_0_0=1;\nstatic const int var_0_1=(-1);\n");
+        TestParserInput(GLSLShaderType::Vertex, uOptions, L"const float x = 0.5; const float y = (x + x) * 2.0;",                             "static const float var_0_0=5.000000e-001;\nstatic const float var_0_1=2.000000e+000;\n");
+        TestParserInput(GLSLShaderType::Vertex, uOptions, L"const int x = 7; const float y = float(x / 2);",                                  "static const int var_0_0=7;\nstatic const float var_0_1=3.000000e+000;\n");
+
+        // Vectors and matrices
+        TestParserInput(GLSLShaderType::Vertex, uOptions, L"const vec3 v = vec3(1.0);",                                                       "static const float3 var_0_0=float3(1.000000e+000,1.000000e+000,1.000000e+000);\n");
+        TestParserInput(GLSLShaderType::Vertex, uOptions, L"const vec2 v = vec2(1.0, 2.0) * 2.0;",                                            "static const float2 var_0_0=float2(2.000000e+000,4.000000e+000);\n");
+        TestParserInput(GLSLShaderType::Vertex, uOptions, L"const ivec2 v = -ivec2(vec3(1.5, 2.5, 3.5));",                                    "static const int2 var_0_0=int2(-1,-2);\n");
+        TestParserInput(GLSLShaderType::Vertex, uOptions, L"const mat2 m = mat2(2.0);",                                                       "static const float2x2 var_0_0=float2x2(2.000000e+000,0.000000e+000,0.000000e+000,2.000000e+000);\n");
+
+        // Only the constant parts of an expression are folded
+        TestParserInput(GLSLShaderType::Vertex, uOptions, L"float foo(float a) { return a * (2.0 + 1.0); }",                                  "float fn_0_0(float var_1_1)\n{\nreturn var_1_1*3.000000e+000;\n}\n");
+        TestParserInput(GLSLShaderType::Vertex, uOptions, L"int nc; const int x = 1; const int y = (nc, x + 1);",                             "static int var_0_0=0;\nstatic const int var_0_1=1;\nstatic const int var_0_2=(var_0_0,2);\n");
+
+        // Expressions that cannot be calculated are not errors when they do not need to be constant
+        TestParserInput(GLSLShaderType::Vertex, uOptions, L"float foo(float a) { return a + 1.0 / 0.0; }",                                    "float fn_0_0(float var_1_1)\n{\nreturn var_1_1+1.000000e+000/0.000000e+000;\n}\n");
+
+        // Without the option nothing is folded
+        TestParserInput(GLSLShaderType::Vertex, GLSLTranslateOptions::DisableWriteInputs, L"const int x = 1; const int y = x + 2;",         "static const int var_0_0=1;\nstatic const int var_0_1=var_0_0+2;\n");
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   ShortCircuitScalingTests
+    //
+    //  Synopsis:   Translates shaders with a growing number of conditionals in
+    //              one function, both in expression statements and in
+    //              declarations. Every conditional must become an if/else, and
+    //              translation time per conditional is logged for each size;
+    //              it should stay flat as the count grows.
+    //
+    //+----------------------------------------------------------------------------
+    void BasicGLSLTests::ShortCircuitScalingTests()
+    {
+        // Two declarations in a row are translated in order, each after the
+        // if/else for its initializer
+        TestParserInput(
+            GLSLShaderType::Vertex,
+            GLSLTranslateOptions::DisableWriteInputs,
+            L"void foo() { float a; float b; float t0 = (a < b) ? 1.0 : 0.0; float t1 = (a < t0) ? 1.0 : 0.0; }",
+            "void fn_0_0()\n{\nfloat var_1_1=0.0;\nfloat var_1_2=0.0;\nfloat var_1_8=0.0;\nif ((var_1_1<var_1_2)){\nvar_1_8=1.000000e+000;\n}\nelse\n{\nvar_1_8=0.000000e+000;\n}\nfloat var_1_3=var_1_8;\nfloat var_1_9=0.0;\nif ((var_1_1<var_1_3)){\nvar_1_9=1.000000e+000;\n}\nelse\n{\nvar_1_9=0.000000e+000;\n}\nfloat var_1_4=var_1_9;\n}\n"
+            );
+
+        const WCHAR* rgpwszStatementFormats[] =
+        {
+            L"r+=b?x:r;",
+            L"float t%u=b?x:r;",
+        };
+
+        for (UINT i = 0; i < ARRAYSIZE(rgpwszStatementFormats); i++)
+        {
+            MeasureShortCircuitTranslation(rgpwszStatementFormats[i], 100);
+            MeasureShortCircuitTranslation(rgpwszStatementFormats[i], 1000);
+            MeasureShortCircuitTranslation(rgpwszStatementFormats[i], 10000);
+        }
+    }
+
+    void BasicGLSLTests::MeasureShortCircuitTranslation(_In_z_ const WCHAR* pwszStatementFormat, UINT uConditionalCount)
+    {
+        // Every conditional becomes an if/else in front of its statement, in the same statement list
+        CMutableString<wchar_t> strShader;
+        VERIFY_SUCCEEDED(strShader.Append(L"uniform bool b; uniform float x; void main() { float r = 0.0;\n"));
+        for (UINT i = 0; i < uConditionalCount; i++)
+        {
+            CMutableString<wchar_t> strStatement;
+            VERIFY_SUCCEEDED(strStatement.Format(64, pwszStatementFormat, i));
+            VERIFY_SUCCEEDED(strShader.Append(strStatement));
+            VERIFY_SUCCEEDED(strShader.Append(L"\n"));
+        }
+        VERIFY_SUCCEEDED(strShader.Append(L"gl_Position = vec4(r); }"));
+
+        CSmartBstr bstrText;
+        bstrText.Set(strShader);
+
+        LARGE_INTEGER liFrequency;
+        ::QueryPerformanceFrequency(&liFrequency);
+
+        LARGE_INTEGER liStart;
+        LARGE_INTEGER liEnd;
+        ::QueryPerformanceCounter(&liStart);
+
+        TSmartPointer<CGLSLConvertedShader> spShader;
+        VERIFY_SUCCEEDED(::GLSLTranslate(
+            bstrText,
+            GLSLShaderType::Vertex,
+            GLSLTranslateOptions::DisableBoilerPlate,
+            WebGLFeatureLevel::Level_10,
+            &spShader
+            ));
+
+        ::QueryPerformanceCounter(&liEnd);
+
+        CMutableString<char> spConverted;
+        VERIFY_SUCCEEDED(spShader->GetConvertedCodeWithParsedStructInfo(/*out*/spConverted));
+
+        // No conditional is left in the output, and each one has its own if/else
+        VERIFY_IS_NULL(strchr(spConverted, '?'));
+
+        UINT cIfStatements = 0;
+        for (const char* pszIf = strstr(spConverted, "if ("); pszIf != nullptr; pszIf = strstr(pszIf + 1, "if ("))
+        {
+            cIfStatements++;
+        }
+        VERIFY_ARE_EQUAL(uConditionalCount, cIfStatements);
+
+        const double dMs = static_cast<double>(liEnd.QuadPart - liStart.QuadPart) * 1000.0 / static_cast<double>(liFrequency.QuadPart);
+
+        CMutableString<WCHAR> spszComment;
+        VERIFY_SUCCEEDED(spszComment.Format(
+            256,
+            L"%u conditionals like '%s': %.4f ms to translate, %.4f us per conditional",
+            uConditionalCount,
+            pwszStatementFormat,
+            dMs,
+            dMs * 1000.0 / uConditionalCount
+            ));
+        Log::Comment(spszComment);
+    }
+
     void BasicGLSLTests::TestParserInput(GLSLShaderType::Enum shaderType, UINT uOptions, const WCHAR* pszInput, const char* pszExpected)
     {
         CSmartBstr bstrText;
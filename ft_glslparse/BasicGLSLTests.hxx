@@ -88,8 +88,12 @@ namespace ft_glslparse
         TEST_METHOD(TestExtensions)
         TEST_METHOD(PrecisionTests)
         TEST_METHOD(GlobalDeclarationTests)
+        TEST_METHOD(DeadCodeEliminationTests)
+        TEST_METHOD(ConstantFoldingTests)
+        TEST_METHOD(ShortCircuitScalingTests)
 
     private:
+        void MeasureShortCircuitTranslation(_In_z_ const WCHAR* pwszStatementFormat, UINT uConditionalCount);
         void TestParserInput(GLSLShaderType::Enum shaderType, UINT uOptions, const WCHAR* pszInput, const char* pszExpected);
         void TestParserInputDefault(__in const WCHAR* pszInput, __in const char* pszExpected);
         void TestParserInputNegativeError(GLSLShaderType::Enum shaderType, UINT uOptions, const WCHAR* pszInput, HRESULT hrCode);
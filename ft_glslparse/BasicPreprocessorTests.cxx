@@ -606,6 +606,11 @@ namespace ft_glslparse
         TestPreprocessorInput("#define X x--\nX\n",                                                 "\nx --\n");
         TestPreprocessorInput("#define X ++x\nX\n",                                                 "\n++ x\n");
         TestPreprocessorInput("#define X --x\nX\n",                                                 "\n-- x\n");
+
+        // Parameters used out of order, more than once, or not given any tokens
+        TestPreprocessorInput("#define FOO(x, y) y x y\nFOO(a, b)\n",                                "\n b a  b\n");
+        TestPreprocessorInput("#define FOO(x) x+1\nFOO(a)\nFOO(b)\n",                               "\na + 1\nb + 1\n");
+        TestPreprocessorInput("#define FOO(x) [x]\nFOO()\n",                                         "\n[  ]\n");
     }
 
     void BasicPreprocessorTests::RedefineTests()
@@ -657,6 +662,15 @@ namespace ft_glslparse
 
         // Compound define, before and after undefine
         TestPreprocessorInput("#define X\n#ifdef X\nFOO\n#undef X\n#ifdef X\nBAR\n#endif\n#endif\n","\n\nFOO\n\n\n\n\n\n");
+
+        // Undefine then define again with a different value - the old definition should be gone
+        TestPreprocessorInput("#define A 1\nA\n#undef A\n#define A 2\nA\n",                         "\n1\n\n\n2\n");
+        TestPreprocessorInput("#define A(x) x\nA(1)\n#undef A\n#define A 2\nA\n",                   "\n1\n\n\n2\n");
+        TestPreprocessorInput("#define A 1\n#undef A\n#undef A\n#ifdef A\nBAR\n#endif\nA\n",        "\n\n\n\n\n\nA\n");
+
+        // Recursion guards only apply while a macro is being expanded, so the same
+        // macros should expand again on the next line
+        TestPreprocessorInput("#define X Y+1\n#define Y X*2\nX\nX\n",                               "\n\nX * 2 + 1\nX * 2 + 1\n");
     }
 
     void BasicPreprocessorTests::CommentTests()
@@ -829,6 +843,179 @@ namespace ft_glslparse
         TestPreprocessorNegative("#line 0 0x1\n", E_GLSLERROR_SYNTAXERROR);
     }
 
+    void BasicPreprocessorTests::OutputLimitTests()
+    {
+        HRESULT hrFirstError;
+
+        // Output that exactly fits is fine, one more character is not
+        VERIFY_SUCCEEDED(TestPreprocessorOutputLimit("int a;\n", 7, &hrFirstError));
+        VERIFY_FAILED(TestPreprocessorOutputLimit("int a;\n", 6, &hrFirstError));
+        VERIFY_ARE_EQUAL(E_GLSLERROR_SHADERTOOLONG, hrFirstError);
+
+        // Comments and newlines count since they are kept as whitespace
+        VERIFY_FAILED(TestPreprocessorOutputLimit("/* a long comment */\n", 8, &hrFirstError));
+        VERIFY_ARE_EQUAL(E_GLSLERROR_SHADERTOOLONG, hrFirstError);
+
+        // Macro expansion is stopped as soon as the output goes over, well
+        // before the whole expansion would have been built
+        VERIFY_FAILED(TestPreprocessorOutputLimit(
+            "#define A xxxxxxxxxxxxxxxx\n#define B A A A A A A A A\n#define C B B B B B B B B\n#define D C C C C C C C C\nD D D D D D D D\n",
+            64,
+            &hrFirstError));
+        VERIFY_ARE_EQUAL(E_GLSLERROR_SHADERTOOLONG, hrFirstError);
+    }
+
+    void BasicPreprocessorTests::ExpansionLimitTests()
+    {
+        char szLine[128];
+
+        // A chain of macros that each expand to the next one nests one level
+        // deeper for every macro. A chain of 100 is fine, 200 is over the limit.
+        CMutableString<char> strChain;
+        VERIFY_SUCCEEDED(strChain.Append("#define M0 x\n"));
+        for (UINT i = 1; i < 200; i++)
+        {
+            VERIFY_SUCCEEDED(::StringCchPrintfA(szLine, ARRAYSIZE(szLine), "#define M%u M%u\n", i, i - 1));
+            VERIFY_SUCCEEDED(strChain.Append(szLine));
+        }
+
+        CMutableString<char> strInput;
+        CMutableString<char> strExpected;
+        VERIFY_SUCCEEDED(strInput.Append(strChain));
+        VERIFY_SUCCEEDED(strInput.Append("M99\n"));
+        for (UINT i = 0; i < 200; i++)
+        {
+            VERIFY_SUCCEEDED(strExpected.Append("\n"));
+        }
+        VERIFY_SUCCEEDED(strExpected.Append("x\n"));
+        TestPreprocessorInput(strInput, strExpected);
+
+        VERIFY_SUCCEEDED(strInput.Set(strChain));
+        VERIFY_SUCCEEDED(strInput.Append("M199\n"));
+        TestPreprocessorExpansionLimit(strInput, "Macro expansion exceeds the maximum nesting depth of 128");
+
+        // Each macro calls the one below it twice, and the last one expands to
+        // nothing. This produces no output at all, but 2^24 expansions.
+        VERIFY_SUCCEEDED(strInput.Set("#define F0(x)\n"));
+        for (UINT i = 1; i <= 24; i++)
+        {
+            VERIFY_SUCCEEDED(::StringCchPrintfA(szLine, ARRAYSIZE(szLine), "#define F%u(x) F%u(x) F%u(x)\n", i, i - 1, i - 1));
+            VERIFY_SUCCEEDED(strInput.Append(szLine));
+        }
+        VERIFY_SUCCEEDED(strInput.Append("F24(a)\n"));
+        TestPreprocessorExpansionLimit(strInput, "Macro expansion exceeds the maximum number of expansions of 65536");
+
+        // Arguments are expanded before they are substituted, so each nested
+        // call doubles the text. Only 32 macros are expanded, but the last one
+        // would be 2^32 times the length of the innermost argument.
+        VERIFY_SUCCEEDED(strInput.Set("#define D(x) x x\n"));
+        for (UINT i = 0; i < 32; i++)
+        {
+            VERIFY_SUCCEEDED(strInput.Append("D("));
+        }
+        VERIFY_SUCCEEDED(strInput.Append("abcdefghijklmnop"));
+        for (UINT i = 0; i < 32; i++)
+        {
+            VERIFY_SUCCEEDED(strInput.Append(")"));
+        }
+        VERIFY_SUCCEEDED(strInput.Append("\n"));
+        TestPreprocessorExpansionLimit(strInput, "Macro expansion exceeds the maximum total size in bytes of 4194304");
+    }
+
+    void BasicPreprocessorTests::MacroExpansionBenchmark()
+    {
+        // A small library of nested function-like macros, used many times
+        CMutableString<char> strInput;
+        VERIFY_SUCCEEDED(strInput.Append(
+            "#define ADD(a, b) ((a) + (b))\n"
+            "#define SUB(a, b) ((a) - (b))\n"
+            "#define MUL(a, b) ((a) * (b))\n"
+            "#define MAD(a, b, c) ADD(MUL(a, b), c)\n"
+            "#define LERP(a, b, t) MAD(SUB(b, a), t, a)\n"
+            "#define SCALE 0.5\n"
+            ));
+
+        const UINT uLines = 256;
+        for (UINT i = 0; i < uLines; i++)
+        {
+            VERIFY_SUCCEEDED(strInput.Append("x = LERP(x, y, SCALE) + MAD(y, SCALE, x);\n"));
+        }
+
+        const UINT uIterations = 50;
+
+        LARGE_INTEGER liFrequency;
+        ::QueryPerformanceFrequency(&liFrequency);
+
+        LARGE_INTEGER liStart;
+        LARGE_INTEGER liEnd;
+        ::QueryPerformanceCounter(&liStart);
+        for (UINT uIteration = 0; uIteration < uIterations; uIteration++)
+        {
+            TSmartPointer<CGLSLStringParserInput> spInput;
+            VERIFY_SUCCEEDED(RefCounted<CGLSLStringParserInput>::Create(strInput, static_cast<UINT>(strInput.GetLength()), /*out*/spInput));
+
+            TSmartPointer<CTestErrorSink> spErrorSink;
+            VERIFY_SUCCEEDED(RefCounted<CTestErrorSink>::Create(/*out*/spErrorSink));
+
+            TSmartPointer<CMemoryStream> spStream;
+            TSmartPointer<CGLSLLineMap> spLineMap;
+            TSmartPointer<CGLSLExtensionState> spExtensionState;
+            VERIFY_SUCCEEDED(::GLSLPreprocess(spInput, spErrorSink, 0, GLSLShaderType::Fragment, &spStream, &spLineMap, &spExtensionState));
+        }
+        ::QueryPerformanceCounter(&liEnd);
+
+        const double dMsPerTick = 1000.0 / static_cast<double>(liFrequency.QuadPart);
+
+        CMutableString<WCHAR> spszComment;
+        VERIFY_SUCCEEDED(spszComment.Format(
+            256,
+            L"%u lines of nested macro calls: %.4f ms to preprocess",
+            uLines,
+            static_cast<double>(liEnd.QuadPart - liStart.QuadPart) * dMsPerTick / static_cast<double>(uIterations)
+            ));
+        Log::Comment(spszComment);
+    }
+
+    void BasicPreprocessorTests::TestPreprocessorExpansionLimit(char* pszInput, const char* pszErrorExpected)
+    {
+        LARGE_INTEGER liFrequency;
+        ::QueryPerformanceFrequency(&liFrequency);
+
+        LARGE_INTEGER liStart;
+        LARGE_INTEGER liEnd;
+        ::QueryPerformanceCounter(&liStart);
+        TestPreprocessorNegative(pszInput, E_GLSLERROR_PREMAXEXPANSION, pszErrorExpected);
+        ::QueryPerformanceCounter(&liEnd);
+
+        // Hitting a limit should be quick, since the whole point of the limits
+        // is to stop before the work gets out of hand
+        const double dMs = static_cast<double>(liEnd.QuadPart - liStart.QuadPart) * 1000.0 / static_cast<double>(liFrequency.QuadPart);
+
+        CMutableString<WCHAR> spszComment;
+        VERIFY_SUCCEEDED(spszComment.Format(256, L"Expansion limit hit after %.4f ms", dMs));
+        Log::Comment(spszComment);
+    }
+
+    HRESULT BasicPreprocessorTests::TestPreprocessorOutputLimit(char* pszInput, UINT uMaxOutputSize, __out HRESULT* phrFirstError)
+    {
+        UINT inputSize = ::strlen(pszInput);
+
+        TSmartPointer<CGLSLStringParserInput> spInput;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLStringParserInput>::Create(pszInput, inputSize, /*out*/spInput));
+
+        TSmartPointer<CTestErrorSink> spErrorSink;
+        VERIFY_SUCCEEDED(RefCounted<CTestErrorSink>::Create(/*out*/spErrorSink));
+
+        TSmartPointer<CMemoryStream> spStream;
+        TSmartPointer<CGLSLLineMap> spLineMap;
+        TSmartPointer<CGLSLExtensionState> spExtensionState;
+        HRESULT hr = ::GLSLPreprocess(spInput, spErrorSink, 0, GLSLShaderType::Fragment, uMaxOutputSize, &spStream, &spLineMap, &spExtensionState);
+
+        (*phrFirstError) = (spErrorSink->GetErrorCount() > 0) ? spErrorSink->UseError(0)->GetCode() : S_OK;
+
+        return hr;
+    }
+
     void BasicPreprocessorTests::TestPreprocessorNegative(char* pszInput, HRESULT hrExpected, int lineNumber, const char* pszErrorExpected)
     {
         UINT inputSize = ::strlen(pszInput);
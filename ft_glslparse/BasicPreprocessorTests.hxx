@@ -67,6 +67,9 @@ namespace ft_glslparse
         TEST_METHOD(CharacterSetTests)
         TEST_METHOD(TokenLimitTests)
         TEST_METHOD(LineMacroTests)
+        TEST_METHOD(OutputLimitTests)
+        TEST_METHOD(ExpansionLimitTests)
+        TEST_METHOD(MacroExpansionBenchmark)
 
     private:
         void TestPreprocessorNegative(char* pszInput, HRESULT hrExpected, int lineNumber, const char* pszErrorExpected);
@@ -74,6 +77,8 @@ namespace ft_glslparse
         void TestPreprocessorNegative(char* pszInput, HRESULT hrExpected, const char* pszErrorExpected);
         void TestPreprocessorNegative(char* pszInput, HRESULT hrExpected);
         void TestPreprocessorInput(char* pszInput, const char* pszExpected);
+        HRESULT TestPreprocessorOutputLimit(char* pszInput, UINT uMaxOutputSize, __out HRESULT* phrFirstError);
+        void TestPreprocessorExpansionLimit(char* pszInput, const char* pszErrorExpected);
 
         void TestPreprocessorLargeTokenNegative(char* pszInput, HRESULT hrExpected, PFNCreateToken pfnCreateToken);
     };
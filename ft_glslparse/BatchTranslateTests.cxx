@@ -0,0 +1,451 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+
+//  Class:      BatchTranslateTests
+//  Synopsis:   Defines tests for translating batches of shaders in parallel
+
+#include "headers.hxx"
+#include "BatchTranslateTests.hxx"
+#include "GLSLWorkStealingScheduler.hxx"
+#include "GLSLConvertedShader.hxx"
+#include "GLSLIdentifierTable.hxx"
+#include "VariableIdentifierInfo.hxx"
+#include "GLSLTranslate.hxx"
+#include "GLSLTranslateOptions.hxx"
+#include "WebGLFeatureLevel.hxx"
+#include "RefCounted.hxx"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace ft_glslparse
+{
+    //+----------------------------------------------------------------------------
+    //
+    //  Struct:     BatchCorpusShader
+    //
+    //  Synopsis:   A shader in the corpus used by the batch tests.
+    //
+    //-----------------------------------------------------------------------------
+    struct BatchCorpusShader
+    {
+        GLSLShaderType::Enum shaderType;                                // Type of shader
+        const WCHAR* pwszShader;                                        // Shader source
+    };
+
+    // A mix of small and larger shaders, including some that fail to
+    // translate, so that workers finish their ranges at different times.
+    static const BatchCorpusShader s_rgCorpus[] =
+    {
+        { GLSLShaderType::Vertex,   L"attribute vec4 pos; varying vec2 uv; void main() { uv = pos.xy; gl_Position = pos; }" },
+        { GLSLShaderType::Fragment, L"precision mediump float; varying vec2 uv; uniform sampler2D s; void main() { gl_FragColor = texture2D(s, uv); }" },
+        { GLSLShaderType::Vertex,   L"attribute vec3 n; attribute vec4 pos; uniform mat4 mvp; uniform mat3 nm; varying vec3 vn; void main() { vn = normalize(nm * n); gl_Position = mvp * pos; }" },
+        { GLSLShaderType::Fragment, L"precision mediump float; varying vec3 vn; uniform vec3 l; void main() { float d = max(dot(normalize(vn), l), 0.0); gl_FragColor = vec4(d, d, d, 1.0); }" },
+        { GLSLShaderType::Vertex,   L"void main() { undeclared = 1; }" },
+        { GLSLShaderType::Vertex,   L"struct S { vec4 a; float b[4]; }; uniform S u; attribute vec4 pos; void main() { vec4 sum = u.a; for (int i = 0; i < 4; i++) { sum += vec4(u.b[i]); } gl_Position = pos * sum; }" },
+        { GLSLShaderType::Fragment, L"precision highp float; uniform vec2 res; float f(float x) { return x * x; } float g(float x) { return f(x) + f(x * 0.5); } void main() { vec2 p = gl_FragCoord.xy / res; gl_FragColor = vec4(g(p.x), g(p.y), g(p.x * p.y), 1.0); }" },
+        { GLSLShaderType::Fragment, L"precision mediump float; void main() { gl_FragColor = vec4(1.0) }" },
+        { GLSLShaderType::Vertex,   L"#define SCALE 2.0\nattribute vec4 pos;\n#ifdef SCALE\nvoid main() { gl_Position = pos * SCALE; }\n#else\nvoid main() { gl_Position = pos; }\n#endif\n" },
+        { GLSLShaderType::Fragment, L"precision mediump float; varying vec4 c; void main() { vec4 x = c; if (x.r > 0.5 && x.g < 0.5 || x.b == 0.0) { x = x.bgra; } gl_FragColor = x; }" },
+    };
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Class:      BatchCorpus
+    //
+    //  Synopsis:   Batch inputs made by repeating the corpus.
+    //
+    //-----------------------------------------------------------------------------
+    class BatchCorpus
+    {
+    public:
+        void Initialize(UINT cRepeats)
+        {
+            _cShaders = ARRAYSIZE(s_rgCorpus) * cRepeats;
+            VERIFY_SUCCEEDED(_aryBstrs.Resize(ARRAYSIZE(s_rgCorpus)));
+            VERIFY_SUCCEEDED(_aryInputs.Resize(_cShaders));
+
+            for (UINT i = 0; i < ARRAYSIZE(s_rgCorpus); i++)
+            {
+                _aryBstrs[i].Set(s_rgCorpus[i].pwszShader);
+            }
+
+            for (UINT i = 0; i < _cShaders; i++)
+            {
+                _aryInputs[i].bstrInput = _aryBstrs[i % ARRAYSIZE(s_rgCorpus)];
+                _aryInputs[i].shaderType = s_rgCorpus[i % ARRAYSIZE(s_rgCorpus)].shaderType;
+            }
+        }
+
+        UINT GetCount() const { return _cShaders; }
+        const GLSLTranslateBatchInput* GetInputs() const { return &_aryInputs[0]; }
+
+    private:
+        UINT _cShaders;
+        CModernArray<CSmartBstr> _aryBstrs;
+        CModernArray<GLSLTranslateBatchInput> _aryInputs;
+    };
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   VerifySameTranslation
+    //
+    //  Synopsis:   Verifies that two translations of a shader have the same
+    //              output, or the same log if they failed.
+    //
+    //-----------------------------------------------------------------------------
+    static void VerifySameTranslation(
+        __in CGLSLConvertedShader* pExpected,                           // Shader translated by itself
+        __in CGLSLConvertedShader* pActual                              // Shader translated in the batch
+        )
+    {
+        VERIFY_ARE_EQUAL(pExpected->TranslationSucceeded(), pActual->TranslationSucceeded());
+        VERIFY_ARE_EQUAL(pExpected->GetErrorCount(), pActual->GetErrorCount());
+
+        if (pExpected->TranslationSucceeded())
+        {
+            CMutableString<char> spExpectedCode;
+            CMutableString<char> spActualCode;
+            VERIFY_SUCCEEDED(pExpected->GetConvertedCodeWithParsedStructInfo(spExpectedCode));
+            VERIFY_SUCCEEDED(pActual->GetConvertedCodeWithParsedStructInfo(spActualCode));
+            VERIFY_ARE_EQUAL(0, strcmp(spExpectedCode, spActualCode));
+        }
+        else
+        {
+            CSmartBstr bstrExpectedLog;
+            CSmartBstr bstrActualLog;
+            VERIFY_SUCCEEDED(pExpected->GetLog(&bstrExpectedLog));
+            VERIFY_SUCCEEDED(pActual->GetLog(&bstrActualLog));
+            VERIFY_ARE_EQUAL(0, wcscmp(bstrExpectedLog, bstrActualLog));
+        }
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   ReleaseShaders
+    //
+    //  Synopsis:   Releases the outputs of a batch.
+    //
+    //-----------------------------------------------------------------------------
+    static void ReleaseShaders(
+        UINT cShaders,                                                  // Number of shaders
+        __inout_ecount(cShaders) CGLSLConvertedShader** ppShaders       // Shaders to release
+        )
+    {
+        for (UINT i = 0; i < cShaders; i++)
+        {
+            if (ppShaders[i] != nullptr)
+            {
+                ppShaders[i]->Release();
+                ppShaders[i] = nullptr;
+            }
+        }
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   ConsistencyTests
+    //
+    //  Synopsis:   Each shader translated in a batch matches translating it by
+    //              itself, whatever the number of threads.
+    //
+    //-----------------------------------------------------------------------------
+    void BatchTranslateTests::ConsistencyTests()
+    {
+        BatchCorpus corpus;
+        corpus.Initialize(8);
+
+        CModernArray<TSmartPointer<CGLSLConvertedShader>> aryExpected;
+        VERIFY_SUCCEEDED(aryExpected.Resize(corpus.GetCount()));
+        for (UINT i = 0; i < corpus.GetCount(); i++)
+        {
+            const GLSLTranslateBatchInput& input = corpus.GetInputs()[i];
+            VERIFY_SUCCEEDED(::GLSLTranslate(input.bstrInput, input.shaderType, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &aryExpected[i]));
+        }
+
+        const UINT rguThreads[] = { 1, 2, 3, 0 };
+        for (UINT uThreads = 0; uThreads < ARRAYSIZE(rguThreads); uThreads++)
+        {
+            CMutableString<WCHAR> spszComment;
+            VERIFY_SUCCEEDED(spszComment.Format(128, L"Translating %u shaders with at most %u threads", corpus.GetCount(), rguThreads[uThreads]));
+            Log::Comment(spszComment);
+
+            CModernArray<CGLSLConvertedShader*> aryActual;
+            VERIFY_SUCCEEDED(aryActual.Resize(corpus.GetCount()));
+            VERIFY_SUCCEEDED(::GLSLTranslateBatch(
+                corpus.GetCount(),
+                corpus.GetInputs(),
+                GLSLTranslateOptions::None,
+                WebGLFeatureLevel::Level_9_1,
+                rguThreads[uThreads],
+                &aryActual[0]
+                ));
+
+            for (UINT i = 0; i < corpus.GetCount(); i++)
+            {
+                VERIFY_IS_NOT_NULL(aryActual[i]);
+                VerifySameTranslation(aryExpected[i], aryActual[i]);
+            }
+
+            ReleaseShaders(corpus.GetCount(), &aryActual[0]);
+        }
+
+        // An empty batch does nothing
+        VERIFY_SUCCEEDED(::GLSLTranslateBatch(0, nullptr, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, 0, nullptr));
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   CallerReleaseTests
+    //
+    //  Synopsis:   Shaders that pool threads translated can be taken apart and
+    //              released on the calling thread, down to the identifiers
+    //              and types they hold on to.
+    //
+    //-----------------------------------------------------------------------------
+    void BatchTranslateTests::CallerReleaseTests()
+    {
+        BatchCorpus corpus;
+        corpus.Initialize(8);
+
+        CModernArray<CGLSLConvertedShader*> aryShaders;
+        VERIFY_SUCCEEDED(aryShaders.Resize(corpus.GetCount()));
+        VERIFY_SUCCEEDED(::GLSLTranslateBatch(
+            corpus.GetCount(),
+            corpus.GetInputs(),
+            GLSLTranslateOptions::EnableStats,
+            WebGLFeatureLevel::Level_9_1,
+            4,
+            &aryShaders[0]
+            ));
+
+        for (UINT i = 0; i < corpus.GetCount(); i++)
+        {
+            // Hold on to the parts of the shader, release the shader, and then
+            // the parts, so that each is released last on this thread
+            TSmartPointer<CGLSLIdentifierTable> spIdTable = aryShaders[i]->UseIdentifierTable();
+            TSmartPointer<CMemoryStream> spConvertedStream = aryShaders[i]->UseConvertedStream();
+            VERIFY_IS_NOT_NULL(aryShaders[i]->UseStats());
+
+            CModernArray<TSmartPointer<CVariableIdentifierInfo>> aryInfos;
+            CModernArray<TSmartPointer<GLSLType>> aryTypes;
+            if (spIdTable != nullptr)
+            {
+                for (UINT j = 0; j < spIdTable->GetVariableCount(); j++)
+                {
+                    VERIFY_SUCCEEDED(aryInfos.Add(spIdTable->UseVariableInfo(j)));
+                    VERIFY_SUCCEEDED(aryTypes.Add(spIdTable->UseVariableInfo(j)->UseType()));
+                }
+            }
+
+            aryShaders[i]->Release();
+            aryShaders[i] = nullptr;
+
+            if (spConvertedStream != nullptr)
+            {
+                UINT cbConverted;
+                VERIFY_SUCCEEDED(spConvertedStream->GetSize(&cbConverted));
+            }
+
+            spConvertedStream.Release();
+            spIdTable.Release();
+            aryTypes.RemoveAll();
+            aryInfos.RemoveAll();
+        }
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Struct:     SchedulerTestContext
+    //
+    //  Synopsis:   State shared by the threads of SchedulerTests.
+    //
+    //-----------------------------------------------------------------------------
+    struct SchedulerTestContext
+    {
+        CGLSLWorkStealingScheduler* pScheduler;                         // Scheduler under test
+        volatile LONG* plHandedOut;                                     // Times each item was handed out
+        UINT uWorker;                                                   // Worker run by the thread
+        UINT cSlowItems;                                                // Items below this spin to force steals
+    };
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   SchedulerTestThreadProc
+    //
+    //  Synopsis:   Takes items from the scheduler until there are none left.
+    //
+    //-----------------------------------------------------------------------------
+    static DWORD WINAPI SchedulerTestThreadProc(
+        __in LPVOID pvContext                                           // SchedulerTestContext for this thread
+        )
+    {
+        SchedulerTestContext* pContext = static_cast<SchedulerTestContext*>(pvContext);
+
+        UINT uItem;
+        while (pContext->pScheduler->TryGetItem(pContext->uWorker, &uItem))
+        {
+            ::InterlockedIncrement(&pContext->plHandedOut[uItem]);
+
+            if (uItem < pContext->cSlowItems)
+            {
+                ::Sleep(1);
+            }
+        }
+
+        return 0;
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   SchedulerTests
+    //
+    //  Synopsis:   Every item is handed out exactly once while workers steal
+    //              from each other.
+    //
+    //-----------------------------------------------------------------------------
+    void BatchTranslateTests::SchedulerTests()
+    {
+        // Fewer items than workers leaves some workers with nothing to start with
+        {
+            CGLSLWorkStealingScheduler scheduler;
+            VERIFY_SUCCEEDED(scheduler.Initialize(2, 4));
+
+            UINT uItem;
+            VERIFY_IS_TRUE(scheduler.TryGetItem(3, &uItem));
+            VERIFY_IS_TRUE(scheduler.TryGetItem(3, &uItem));
+            VERIFY_IS_FALSE(scheduler.TryGetItem(3, &uItem));
+            VERIFY_IS_FALSE(scheduler.TryGetItem(0, &uItem));
+            VERIFY_ARE_EQUAL(2U, scheduler.GetStealCount());
+        }
+
+        const UINT cItems = 2000;
+        const UINT cWorkers = 4;
+
+        CGLSLWorkStealingScheduler scheduler;
+        VERIFY_SUCCEEDED(scheduler.Initialize(cItems, cWorkers));
+        VERIFY_ARE_EQUAL(cWorkers, scheduler.GetWorkerCount());
+
+        volatile LONG rglHandedOut[cItems] = {};
+
+        // The first worker's items are slow, so the others run out and steal
+        SchedulerTestContext rgContexts[cWorkers];
+        HANDLE rghThreads[cWorkers];
+        for (UINT i = 0; i < cWorkers; i++)
+        {
+            rgContexts[i].pScheduler = &scheduler;
+            rgContexts[i].plHandedOut = rglHandedOut;
+            rgContexts[i].uWorker = i;
+            rgContexts[i].cSlowItems = cItems / cWorkers;
+
+            rghThreads[i] = ::CreateThread(nullptr, 0, SchedulerTestThreadProc, &rgContexts[i], 0, nullptr);
+            VERIFY_IS_NOT_NULL(rghThreads[i]);
+        }
+
+        VERIFY_ARE_EQUAL(WAIT_OBJECT_0, ::WaitForMultipleObjects(cWorkers, rghThreads, TRUE, INFINITE));
+        for (UINT i = 0; i < cWorkers; i++)
+        {
+            ::CloseHandle(rghThreads[i]);
+        }
+
+        for (UINT i = 0; i < cItems; i++)
+        {
+            VERIFY_ARE_EQUAL(1L, rglHandedOut[i]);
+        }
+
+        VERIFY_IS_TRUE(scheduler.GetStealCount() > 0);
+        CMutableString<WCHAR> spszComment;
+        VERIFY_SUCCEEDED(spszComment.Format(64, L"%u steals", scheduler.GetStealCount()));
+        Log::Comment(spszComment);
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   ScalingBenchmark
+    //
+    //  Synopsis:   Times translating the corpus with an increasing number of
+    //              threads, up to one per processor, and logs the speedup
+    //              over a single thread. Timings depend on the machine so
+    //              nothing is verified about them.
+    //
+    //-----------------------------------------------------------------------------
+    void BatchTranslateTests::ScalingBenchmark()
+    {
+        BatchCorpus corpus;
+        corpus.Initialize(200);
+
+        CModernArray<CGLSLConvertedShader*> aryShaders;
+        VERIFY_SUCCEEDED(aryShaders.Resize(corpus.GetCount()));
+
+        LARGE_INTEGER liFrequency;
+        ::QueryPerformanceFrequency(&liFrequency);
+
+        const UINT cProcessors = ::GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+
+        double dblSingleThreadSeconds = 0.0;
+        for (UINT uThreads = 1; ; uThreads = min(uThreads * 2, cProcessors))
+        {
+            LARGE_INTEGER liStart;
+            LARGE_INTEGER liEnd;
+            ::QueryPerformanceCounter(&liStart);
+            VERIFY_SUCCEEDED(::GLSLTranslateBatch(
+                corpus.GetCount(),
+                corpus.GetInputs(),
+                GLSLTranslateOptions::None,
+                WebGLFeatureLevel::Level_9_1,
+                uThreads,
+                &aryShaders[0]
+                ));
+            ::QueryPerformanceCounter(&liEnd);
+
+            ReleaseShaders(corpus.GetCount(), &aryShaders[0]);
+
+            double dblSeconds = static_cast<double>(liEnd.QuadPart - liStart.QuadPart) / static_cast<double>(liFrequency.QuadPart);
+            if (uThreads == 1)
+            {
+                dblSingleThreadSeconds = dblSeconds;
+            }
+
+            CMutableString<WCHAR> spszComment;
+            VERIFY_SUCCEEDED(spszComment.Format(
+                128,
+                L"%u threads: %u shaders in %.3f ms, %.2fx speedup",
+                uThreads,
+                corpus.GetCount(),
+                dblSeconds * 1000.0,
+                (dblSeconds > 0.0) ? dblSingleThreadSeconds / dblSeconds : 0.0
+                ));
+            Log::Comment(spszComment);
+
+            if (uThreads >= cProcessors)
+            {
+                break;
+            }
+        }
+    }
+} /* namespace ft_glslparse */
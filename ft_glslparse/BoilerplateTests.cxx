@@ -0,0 +1,289 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+
+
+//  Class:      BoilerplateTests
+//  Synopsis:   Defines tests for the precomputed HLSL boilerplate
+
+#include "headers.hxx"
+#include "BoilerplateTests.hxx"
+#include "GLSLBoilerplate.hxx"
+#include "GLSLParser.hxx"
+#include "GLSLTranslate.hxx"
+#include "GLSLTranslateOptions.hxx"
+#include "MemoryStream.hxx"
+#include "RefCounted.hxx"
+#include "WebGLFeatureLevel.hxx"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace ft_glslparse
+{
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   Contains
+    //
+    //  Synopsis:   Whether a string contains the given text.
+    //
+    //-----------------------------------------------------------------------------
+    static bool Contains(
+        const CMutableString<char>& str,                            // String to look in
+        __in_z const char* pszText                                  // Text to look for
+        )
+    {
+        return (::strstr(static_cast<const char*>(str), pszText) != nullptr);
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   WriteSection
+    //
+    //  Synopsis:   Write one section of boilerplate into a string.
+    //
+    //-----------------------------------------------------------------------------
+    static void WriteSection(
+        GLSLShaderType::Enum shaderType,                            // Type of shader
+        WebGLFeatureLevel glFeatureLevel,                           // Feature level
+        UINT uFeaturesUsed,                                         // FeatureUsedFlags of the shader
+        CGLSLBoilerplate::Section section,                          // Which boilerplate to write
+        __out CMutableString<char>& strOutput                       // The boilerplate text
+        )
+    {
+        TSmartPointer<CMemoryStream> spStream;
+        VERIFY_SUCCEEDED(RefCounted<CMemoryStream>::Create(/*out*/spStream));
+        VERIFY_SUCCEEDED(CGLSLBoilerplate::Write(shaderType, glFeatureLevel, uFeaturesUsed, section, spStream));
+        VERIFY_SUCCEEDED(strOutput.Set(""));
+        VERIFY_SUCCEEDED(spStream->TakeString(strOutput));
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   SectionTests
+    //
+    //  Synopsis:   Each segment of boilerplate is only written for the shader
+    //              type, feature level and features that it belongs to.
+    //
+    //-----------------------------------------------------------------------------
+    void BoilerplateTests::SectionTests()
+    {
+        CMutableString<char> strOutput;
+
+        // Texture wrappers differ between the shader types
+        WriteSection(GLSLShaderType::Vertex, WebGLFeatureLevel::Level_9_1, FeatureUsedFlags::GLSLtexture2D, CGLSLBoilerplate::Section::Globals, strOutput);
+        VERIFY_IS_TRUE(Contains(strOutput, "static const int gl_MaxVertexAttribs = "));
+        VERIFY_IS_TRUE(Contains(strOutput, "static VSInput vsInput;\n"));
+        VERIFY_IS_TRUE(Contains(strOutput, "float4 GLSLtexture2D(SamplerState s, Texture2D<float4> t, float2 coord) { return t.SampleLevel(s, coord, 0.0); }\n"));
+        VERIFY_IS_FALSE(Contains(strOutput, "GLSLtexture2DProj"));
+        VERIFY_IS_FALSE(Contains(strOutput, "AdjustPositionByPointSize"));
+        VERIFY_IS_FALSE(Contains(strOutput, "float4 depthRange;\n"));
+
+        WriteSection(GLSLShaderType::Fragment, WebGLFeatureLevel::Level_9_1, FeatureUsedFlags::GLSLtexture2D, CGLSLBoilerplate::Section::Globals, strOutput);
+        VERIFY_IS_TRUE(Contains(strOutput, "float4 GLSLtexture2D(SamplerState s, Texture2D<float4> t, float2 coord) { return t.Sample(s, coord); }\n"));
+        VERIFY_IS_FALSE(Contains(strOutput, "static VSInput vsInput;\n"));
+
+        // A segment guarded by more than one feature is written for either of them
+        WriteSection(GLSLShaderType::Fragment, WebGLFeatureLevel::Level_9_1, FeatureUsedFlags::glDepthRange, CGLSLBoilerplate::Section::Globals, strOutput);
+        VERIFY_IS_TRUE(Contains(strOutput, "float4 depthRange;\n"));
+        VERIFY_IS_TRUE(Contains(strOutput, "static gl_DepthRangeParameters gl_DepthRange;\n"));
+        VERIFY_IS_FALSE(Contains(strOutput, "static float4 gl_FragCoord;\n"));
+
+        // gl_FragCoord comes from SV_Position on feature level 10 and is computed below that
+        WriteSection(GLSLShaderType::Fragment, WebGLFeatureLevel::Level_10, FeatureUsedFlags::glFragCoord, CGLSLBoilerplate::Section::EntryPointBegin, strOutput);
+        VERIFY_IS_TRUE(Contains(strOutput, "gl_FragCoord.xy = psInput.position.xy;\n"));
+        VERIFY_IS_FALSE(Contains(strOutput, "gl_FragCoord.x = "));
+        VERIFY_IS_TRUE(Contains(strOutput, "gl_FragCoord.w = wInverse;\n"));
+
+        WriteSection(GLSLShaderType::Fragment, WebGLFeatureLevel::Level_9_1, FeatureUsedFlags::glFragCoord, CGLSLBoilerplate::Section::EntryPointBegin, strOutput);
+        VERIFY_IS_FALSE(Contains(strOutput, "gl_FragCoord.xy = psInput.position.xy;\n"));
+        VERIFY_IS_TRUE(Contains(strOutput, "gl_FragCoord.x = "));
+        VERIFY_IS_TRUE(Contains(strOutput, "gl_FragCoord.w = wInverse;\n"));
+
+        WriteSection(GLSLShaderType::Fragment, WebGLFeatureLevel::Level_9_1, FeatureUsedFlags::None, CGLSLBoilerplate::Section::EntryPointBegin, strOutput);
+        VERIFY_ARE_EQUAL(0, ::strcmp("psInput = psInputArg;\npsOutput.fragColor[0] = float4(0.0, 0.0, 0.0, 0.0);\n", strOutput));
+
+        WriteSection(GLSLShaderType::Vertex, WebGLFeatureLevel::Level_9_1, FeatureUsedFlags::glPointSize, CGLSLBoilerplate::Section::EntryPointEnd, strOutput);
+        const char szPointSizeEnd[] = "flippedPosition.xy = AdjustPositionByPointSize(flippedPosition, vsInput);\n";
+        VERIFY_ARE_EQUAL(0, ::strncmp(szPointSizeEnd, strOutput, ARRAYSIZE(szPointSizeEnd) - 1));
+        VERIFY_IS_TRUE(Contains(strOutput, "psInputOut = psInput;\n"));
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   TranslatedShaderTests
+    //
+    //  Synopsis:   The boilerplate for the features a shader uses shows up in
+    //              its translation, and none shows up when boilerplate is
+    //              disabled.
+    //
+    //-----------------------------------------------------------------------------
+    void BoilerplateTests::TranslatedShaderTests()
+    {
+        CSmartBstr bstrShader;
+        bstrShader.Set(
+            L"precision mediump float;\n"
+            L"uniform sampler2D s;\n"
+            L"varying vec2 v;\n"
+            L"void main() {\n"
+            L"    gl_FragColor = texture2D(s, v) + vec4(mod(gl_FragCoord.x, 2.0));\n"
+            L"}\n"
+            );
+
+        CGLSLParser parser;
+        VERIFY_SUCCEEDED(parser.Initialize(bstrShader, GLSLShaderType::Fragment, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1));
+
+        TSmartPointer<CGLSLConvertedShader> spConvertedShader;
+        VERIFY_SUCCEEDED(parser.Translate(&spConvertedShader));
+        VERIFY_IS_TRUE(spConvertedShader->TranslationSucceeded());
+
+        CMutableString<char> strCode;
+        VERIFY_SUCCEEDED(spConvertedShader->AppendConvertedCode(strCode));
+
+        for (UINT i = 0; i < static_cast<UINT>(CGLSLBoilerplate::Section::Count); i++)
+        {
+            CMutableString<char> strSection;
+            WriteSection(GLSLShaderType::Fragment, WebGLFeatureLevel::Level_9_1, parser.GetFeaturesUsed(), static_cast<CGLSLBoilerplate::Section>(i), strSection);
+            VERIFY_IS_TRUE(Contains(strCode, strSection));
+        }
+
+        VERIFY_IS_TRUE(Contains(strCode, "float GLSLmod(float x, float y)"));
+        VERIFY_IS_TRUE(Contains(strCode, "static float4 gl_FragCoord;\n"));
+
+        TSmartPointer<CGLSLConvertedShader> spBareShader;
+        VERIFY_SUCCEEDED(::GLSLTranslate(bstrShader, GLSLShaderType::Fragment, GLSLTranslateOptions::DisableBoilerPlate, WebGLFeatureLevel::Level_9_1, &spBareShader));
+        VERIFY_IS_TRUE(spBareShader->TranslationSucceeded());
+
+        CMutableString<char> strBareCode;
+        VERIFY_SUCCEEDED(spBareShader->AppendConvertedCode(strBareCode));
+        VERIFY_IS_FALSE(Contains(strBareCode, "gl_MaxVertexAttribs"));
+        VERIFY_IS_FALSE(Contains(strBareCode, "psOutputOut = psOutput;\n"));
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   SmallShaderOutputBenchmark
+    //
+    //  Synopsis:   Times translating a corpus of small shaders with and
+    //              without boilerplate, along with writing the boilerplate on
+    //              its own, since for shaders this size the boilerplate is most
+    //              of the output. Timings depend on the machine so nothing is
+    //              verified about them.
+    //
+    //-----------------------------------------------------------------------------
+    void BoilerplateTests::SmallShaderOutputBenchmark()
+    {
+        struct CorpusShader
+        {
+            GLSLShaderType::Enum _shaderType;
+            const wchar_t* _pszShader;
+        };
+
+        static const CorpusShader rgCorpus[] = {
+            { GLSLShaderType::Vertex,   L"attribute vec4 p;\nvoid main() { gl_Position = p; }\n" },
+            { GLSLShaderType::Vertex,   L"attribute vec4 p;\nuniform mat4 m;\nvarying vec2 t;\nvoid main() { t = p.xy; gl_Position = m * p; gl_PointSize = 2.0; }\n" },
+            { GLSLShaderType::Vertex,   L"attribute vec2 p;\nvoid main() { gl_Position = vec4(mod(p, 2.0), 0.0, 1.0); }\n" },
+            { GLSLShaderType::Fragment, L"precision mediump float;\nvoid main() { gl_FragColor = vec4(1.0); }\n" },
+            { GLSLShaderType::Fragment, L"precision mediump float;\nuniform sampler2D s;\nvarying vec2 t;\nvoid main() { gl_FragColor = texture2D(s, t); }\n" },
+            { GLSLShaderType::Fragment, L"precision mediump float;\nuniform samplerCube c;\nvarying vec3 n;\nvoid main() { gl_FragColor = textureCube(c, n) * sign(n.x) + vec4(mod(gl_FragCoord.y, 4.0)); }\n" },
+        };
+
+        const UINT uIterations = 200;
+
+        LARGE_INTEGER liFrequency;
+        ::QueryPerformanceFrequency(&liFrequency);
+
+        LONGLONG llWithBoilerplate = 0;
+        LONGLONG llWithoutBoilerplate = 0;
+        LONGLONG llBoilerplateOnly = 0;
+
+        TSmartPointer<CMemoryStream> spStream;
+        VERIFY_SUCCEEDED(RefCounted<CMemoryStream>::Create(/*out*/spStream));
+
+        for (UINT i = 0; i < ARRAYSIZE(rgCorpus); i++)
+        {
+            CSmartBstr bstrShader;
+            bstrShader.Set(rgCorpus[i]._pszShader);
+
+            // Find out which features the shader uses
+            CGLSLParser parser;
+            VERIFY_SUCCEEDED(parser.Initialize(bstrShader, rgCorpus[i]._shaderType, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1));
+
+            TSmartPointer<CGLSLConvertedShader> spParsedShader;
+            VERIFY_SUCCEEDED(parser.Translate(&spParsedShader));
+            VERIFY_IS_TRUE(spParsedShader->TranslationSucceeded());
+            const UINT uFeaturesUsed = parser.GetFeaturesUsed();
+
+            LARGE_INTEGER liStart;
+            LARGE_INTEGER liEnd;
+
+            ::QueryPerformanceCounter(&liStart);
+            for (UINT uIteration = 0; uIteration < uIterations; uIteration++)
+            {
+                TSmartPointer<CGLSLConvertedShader> spConvertedShader;
+                VERIFY_SUCCEEDED(::GLSLTranslate(bstrShader, rgCorpus[i]._shaderType, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spConvertedShader));
+            }
+            ::QueryPerformanceCounter(&liEnd);
+            llWithBoilerplate += liEnd.QuadPart - liStart.QuadPart;
+
+            ::QueryPerformanceCounter(&liStart);
+            for (UINT uIteration = 0; uIteration < uIterations; uIteration++)
+            {
+                TSmartPointer<CGLSLConvertedShader> spConvertedShader;
+                VERIFY_SUCCEEDED(::GLSLTranslate(bstrShader, rgCorpus[i]._shaderType, GLSLTranslateOptions::DisableBoilerPlate, WebGLFeatureLevel::Level_9_1, &spConvertedShader));
+            }
+            ::QueryPerformanceCounter(&liEnd);
+            llWithoutBoilerplate += liEnd.QuadPart - liStart.QuadPart;
+
+            ::QueryPerformanceCounter(&liStart);
+            for (UINT uIteration = 0; uIteration < uIterations; uIteration++)
+            {
+                VERIFY_SUCCEEDED(spStream->SetSize(0));
+                for (UINT uSection = 0; uSection < static_cast<UINT>(CGLSLBoilerplate::Section::Count); uSection++)
+                {
+                    VERIFY_SUCCEEDED(CGLSLBoilerplate::Write(rgCorpus[i]._shaderType, WebGLFeatureLevel::Level_9_1, uFeaturesUsed, static_cast<CGLSLBoilerplate::Section>(uSection), spStream));
+                }
+            }
+            ::QueryPerformanceCounter(&liEnd);
+            llBoilerplateOnly += liEnd.QuadPart - liStart.QuadPart;
+        }
+
+        const double dMsPerTick = 1000.0 / static_cast<double>(liFrequency.QuadPart);
+        const double dShaders = static_cast<double>(ARRAYSIZE(rgCorpus) * uIterations);
+
+        CMutableString<WCHAR> spszComment;
+        VERIFY_SUCCEEDED(spszComment.Format(
+            256,
+            L"%u small shaders: %.4f ms each with boilerplate, %.4f ms without, %.4f ms writing the boilerplate alone",
+            static_cast<UINT>(ARRAYSIZE(rgCorpus)) * uIterations,
+            static_cast<double>(llWithBoilerplate) * dMsPerTick / dShaders,
+            static_cast<double>(llWithoutBoilerplate) * dMsPerTick / dShaders,
+            static_cast<double>(llBoilerplateOnly) * dMsPerTick / dShaders
+            ));
+        Log::Comment(spszComment);
+    }
+} /* namespace ft_glslparse */
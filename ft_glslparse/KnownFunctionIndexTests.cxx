@@ -0,0 +1,232 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+
+
+//  Class:      KnownFunctionIndexTests
+//  Synopsis:   Defines tests for resolving calls to known functions
+
+#include "headers.hxx"
+#include "KnownFunctionIndexTests.hxx"
+#include "GLSLKnownFunctionIndex.hxx"
+#include "GLSLFunctionSignature.hxx"
+#include "GLSLConvertedShader.hxx"
+#include "GLSLTranslate.hxx"
+#include "GLSLTranslateOptions.hxx"
+#include "WebGLFeatureLevel.hxx"
+#include "TypeHelpers.hxx"
+#include "GLSL.tab.h"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace ft_glslparse
+{
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   FindMatchBySignature
+    //
+    //  Synopsis:   Resolve a call to a known function the way it was done
+    //              before the index, by matching the signature of each
+    //              overload in order.
+    //
+    //-----------------------------------------------------------------------------
+    static bool FindMatchBySignature(
+        GLSLSymbols::Enum symbol,                                       // Function being called
+        const CModernArray<TSmartPointer<GLSLType>>& aryArgTypes,       // Types of the arguments
+        __out GLSLFunctions::Enum* pFunction,                           // Overload that matched
+        __out int* pGenType,                                            // What gentype stands for
+        __out int* pReturnType                                          // Basic type that the call returns
+        )
+    {
+        for (int i = 0; i < GLSLFunctions::count; i++)
+        {
+            const GLSLFunctionInfo& info = GLSLFunctionInfo::s_info[i];
+            if (info._symbolEnum != symbol || info._hlslEnum == HLSLFunctions::count)
+            {
+                continue;
+            }
+
+            // Vector relational functions assume that they are given vectors
+            bool fComparesVectors = (info._sigType == GLSLSignatureType::CompareFloatVector ||
+                                     info._sigType == GLSLSignatureType::CompareIntVector ||
+                                     info._sigType == GLSLSignatureType::CompareBoolVector);
+            bool fArgsAreVectors = true;
+            for (UINT uArg = 0; uArg < aryArgTypes.GetCount(); uArg++)
+            {
+                int argType;
+                VERIFY_SUCCEEDED(aryArgTypes[uArg]->GetBasicType(&argType));
+                fArgsAreVectors = fArgsAreVectors && TypeHelpers::IsVectorType(argType);
+            }
+
+            if (fComparesVectors && !fArgsAreVectors)
+            {
+                continue;
+            }
+
+            CGLSLFunctionSignature signature;
+            VERIFY_SUCCEEDED(signature.InitFromKnown(info));
+
+            TSmartPointer<GLSLType> spReturnType;
+            if (SUCCEEDED(signature.SignatureMatchesArgumentTypes(aryArgTypes, pGenType, &spReturnType)))
+            {
+                (*pFunction) = info._indexEnum;
+                VERIFY_SUCCEEDED(spReturnType->GetBasicType(pReturnType));
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   SignatureAgreementTests
+    //
+    //  Synopsis:   For each known function, try every basic type in place of
+    //              its gentype or vector arguments, and check that the index
+    //              resolves the call to the same overload, gentype and return
+    //              type as matching the signatures in order does.
+    //
+    //-----------------------------------------------------------------------------
+    void KnownFunctionIndexTests::SignatureAgreementTests()
+    {
+        const int rgCandidateTypes[] = {
+            FLOAT_TOK, VEC2, VEC3, VEC4,
+            INT_TOK, IVEC2_TOK, IVEC3_TOK, IVEC4_TOK,
+            BOOL_TOK, BVEC2_TOK, BVEC3_TOK, BVEC4_TOK,
+            MAT2_TOK, MAT3_TOK, MAT4_TOK,
+            SAMPLER2D, SAMPLERCUBE
+            };
+
+        UINT cResolved = 0;
+        for (int i = 0; i < GLSLFunctions::count; i++)
+        {
+            const GLSLFunctionInfo& info = GLSLFunctionInfo::s_info[i];
+            if (info._hlslEnum == HLSLFunctions::count)
+            {
+                continue;
+            }
+
+            // Relational and test functions take one or two of the same type
+            UINT uArgCount = static_cast<UINT>(info._numArgs);
+            if (info._sigType == GLSLSignatureType::TestBoolVector)
+            {
+                uArgCount = 1;
+            }
+            else if (info._sigType != GLSLSignatureType::Normal)
+            {
+                uArgCount = 2;
+            }
+
+            for (UINT uCandidate = 0; uCandidate < ARRAYSIZE(rgCandidateTypes); uCandidate++)
+            {
+                int rgArgTokens[CGLSLKnownFunctionIndex::s_uMaxArgCount];
+                CModernArray<TSmartPointer<GLSLType>> aryArgTypes;
+                for (UINT uArg = 0; uArg < uArgCount; uArg++)
+                {
+                    bool fReplaced = (info._sigType != GLSLSignatureType::Normal || info._rgArgTypes[uArg] == GENTYPE);
+                    rgArgTokens[uArg] = fReplaced ? rgCandidateTypes[uCandidate] : info._rgArgTypes[uArg];
+
+                    TSmartPointer<GLSLType> spArgType;
+                    VERIFY_SUCCEEDED(GLSLType::CreateFromBasicTypeToken(rgArgTokens[uArg], &spArgType));
+                    VERIFY_SUCCEEDED(aryArgTypes.Add(spArgType));
+                }
+
+                GLSLFunctions::Enum expectedFunction;
+                int expectedGenType;
+                int expectedReturnType;
+                bool fExpected = FindMatchBySignature(info._symbolEnum, aryArgTypes, &expectedFunction, &expectedGenType, &expectedReturnType);
+
+                const CGLSLKnownFunctionIndex::Match* pMatch = CGLSLKnownFunctionIndex::Find(info._symbolEnum, rgArgTokens, uArgCount);
+                VERIFY_ARE_EQUAL(fExpected, pMatch != nullptr);
+
+                if (fExpected && pMatch != nullptr)
+                {
+                    VERIFY_ARE_EQUAL(static_cast<int>(expectedFunction), static_cast<int>(pMatch->_function));
+                    VERIFY_ARE_EQUAL(expectedGenType, pMatch->_genType);
+                    VERIFY_ARE_EQUAL(expectedReturnType, pMatch->_returnType);
+                    cResolved++;
+                }
+            }
+        }
+
+        CMutableString<WCHAR> spszComment;
+        VERIFY_SUCCEEDED(spszComment.Format(64, L"%u calls resolved", cResolved));
+        Log::Comment(spszComment);
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   CallResolutionTests
+    //
+    //  Synopsis:   Calls to known functions with many overloads translate, and
+    //              calls that no overload accepts are still rejected.
+    //
+    //-----------------------------------------------------------------------------
+    void KnownFunctionIndexTests::CallResolutionTests()
+    {
+        CSmartBstr bstrShader;
+        bstrShader.Set(
+            L"precision mediump float;\n"
+            L"uniform sampler2D tex;\n"
+            L"varying vec2 uv;\n"
+            L"float min(float a, float b, float c) { return min(min(a, b), c); }\n"
+            L"void main() {\n"
+            L"    vec4 texel = texture2D(tex, uv);\n"
+            L"    vec3 c = clamp(texel.rgb, 0.0, 1.0);\n"
+            L"    c = mix(c, vec3(1.0), 0.5);\n"
+            L"    float m = max(min(c.r, c.g, c.b), 0.25);\n"
+            L"    bvec2 b = lessThan(uv, vec2(0.5));\n"
+            L"    gl_FragColor = any(b) ? vec4(c, m) : texel;\n"
+            L"}\n"
+            );
+
+        TSmartPointer<CGLSLConvertedShader> spConvertedShader;
+        VERIFY_SUCCEEDED(::GLSLTranslate(bstrShader, GLSLShaderType::Fragment, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spConvertedShader));
+        VERIFY_IS_TRUE(spConvertedShader->TranslationSucceeded());
+
+        // No implicit conversions, and gentype arguments must agree
+        const WCHAR* rgInvalidCalls[] = {
+            L"void main() { float f = min(1.0, 2); }",
+            L"void main() { vec2 v = max(vec2(1.0), vec3(1.0)); }",
+            L"void main() { ivec2 v = abs(ivec2(1)); }",
+            L"void main() { bvec2 b = lessThan(vec2(1.0), ivec2(1)); }",
+            };
+
+        for (UINT i = 0; i < ARRAYSIZE(rgInvalidCalls); i++)
+        {
+            bstrShader.Set(rgInvalidCalls[i]);
+
+            spConvertedShader.Release();
+            VERIFY_SUCCEEDED(::GLSLTranslate(bstrShader, GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spConvertedShader));
+            VERIFY_IS_FALSE(spConvertedShader->TranslationSucceeded());
+            VERIFY_IS_TRUE(spConvertedShader->GetErrorCount() > 0);
+            VERIFY_ARE_EQUAL(E_GLSLERROR_INVALIDARGUMENTS, spConvertedShader->UseError(0)->GetCode());
+        }
+    }
+} /* namespace ft_glslparse */
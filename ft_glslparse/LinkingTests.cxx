@@ -0,0 +1,170 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+
+//  Class:      LinkingTests
+//  Synopsis:   Defines tests for linking the varyings of translated shaders
+
+#include "headers.hxx"
+#include "LinkingTests.hxx"
+#include "GLSLConvertedShader.hxx"
+#include "GLSLTranslate.hxx"
+#include "GLSLTranslateOptions.hxx"
+#include "WebGLFeatureLevel.hxx"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace ft_glslparse
+{
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   Translate
+    //
+    //  Synopsis:   Translates a shader that is expected to succeed.
+    //
+    //-----------------------------------------------------------------------------
+    static void Translate(
+        __in_z const WCHAR* pwszShader,                                 // Shader source
+        GLSLShaderType::Enum shaderType,                                // Type of shader
+        __deref_out CGLSLConvertedShader** ppConverted                  // Translated shader
+        )
+    {
+        CSmartBstr bstrShader;
+        bstrShader.Set(pwszShader);
+
+        VERIFY_SUCCEEDED(::GLSLTranslate(bstrShader, shaderType, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, ppConverted));
+        VERIFY_IS_TRUE((*ppConverted)->TranslationSucceeded());
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   Link
+    //
+    //  Synopsis:   Links the varyings of two shaders and returns the error that
+    //              linking recorded, if any.
+    //
+    //-----------------------------------------------------------------------------
+    static CGLSLConvertedShader::LinkingErrorRecord::ErrorType Link(
+        __in_z const WCHAR* pwszVertexShader,                           // Vertex shader source
+        __in_z const WCHAR* pwszFragmentShader                          // Fragment shader source
+        )
+    {
+        TSmartPointer<CGLSLConvertedShader> spVertex;
+        Translate(pwszVertexShader, GLSLShaderType::Vertex, &spVertex);
+
+        TSmartPointer<CGLSLConvertedShader> spFragment;
+        Translate(pwszFragmentShader, GLSLShaderType::Fragment, &spFragment);
+
+        CGLSLConvertedShader::LinkingErrorRecord errorRecord;
+        CMutableString<char> spVertexPrologue;
+        CMutableString<char> spFragmentPrologue;
+        VERIFY_SUCCEEDED(CGLSLConvertedShader::LinkVaryingStructEntries(spVertex, spFragment, 8, errorRecord, spVertexPrologue, spFragmentPrologue));
+
+        return errorRecord.errorType;
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   VariableLookupTests
+    //
+    //  Synopsis:   Looking up a variable by name finds the first variable with
+    //              that name and qualifier, skipping other variables with the
+    //              same name.
+    //
+    //-----------------------------------------------------------------------------
+    void LinkingTests::VariableLookupTests()
+    {
+        TSmartPointer<CGLSLConvertedShader> spVertex;
+        Translate(
+            L"attribute vec4 pos;\n"
+            L"void f() { vec2 v = vec2(0.0); }\n"
+            L"varying vec4 v;\n"
+            L"uniform vec4 u;\n"
+            L"void main() { f(); v = pos; gl_Position = pos + u; }\n",
+            GLSLShaderType::Vertex,
+            &spVertex
+            );
+
+        CGLSLIdentifierTable* pTable = spVertex->UseIdentifierTable();
+
+        // The local v comes first, but does not have the qualifier
+        TSmartPointer<CVariableIdentifierInfo> spInfo;
+        VERIFY_SUCCEEDED(pTable->GetVariableInfoFromString("v", GLSLQualifier::Varying, &spInfo));
+        VERIFY_ARE_EQUAL(GLSLQualifier::Varying, spInfo->GetQualifierEnum());
+
+        spInfo.Release();
+        VERIFY_SUCCEEDED(pTable->GetVariableInfoFromString("u", GLSLQualifier::Uniform, &spInfo));
+        VERIFY_ARE_EQUAL(GLSLQualifier::Uniform, spInfo->GetQualifierEnum());
+
+        // Known names with the wrong qualifier, and names that are not symbols at all, are not found
+        spInfo.Release();
+        VERIFY_FAILED(pTable->GetVariableInfoFromString("u", GLSLQualifier::Varying, &spInfo));
+        VERIFY_FAILED(pTable->GetVariableInfoFromString("pos", GLSLQualifier::Uniform, &spInfo));
+        VERIFY_FAILED(pTable->GetVariableInfoFromString("missing", GLSLQualifier::Uniform, &spInfo));
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   LinkingErrorTests
+    //
+    //  Synopsis:   Varyings are matched up by name between the shaders, and
+    //              mismatches are recorded.
+    //
+    //-----------------------------------------------------------------------------
+    void LinkingTests::LinkingErrorTests()
+    {
+        const WCHAR* pwszVertex =
+            L"attribute vec4 pos;\n"
+            L"void f() { vec2 a = vec2(0.0); }\n"
+            L"varying vec4 a;\n"
+            L"varying vec3 b;\n"
+            L"varying float extra;\n"
+            L"void main() { f(); a = pos; b = pos.xyz; extra = 0.0; gl_Position = pos; }\n";
+
+        VERIFY_ARE_EQUAL(
+            CGLSLConvertedShader::LinkingErrorRecord::ErrorType::NoError,
+            Link(pwszVertex, L"precision mediump float; varying vec4 a; varying vec3 b; void main() { gl_FragColor = a + vec4(b, 1.0); }")
+            );
+
+        VERIFY_ARE_EQUAL(
+            CGLSLConvertedShader::LinkingErrorRecord::ErrorType::TypeMismatch,
+            Link(pwszVertex, L"precision mediump float; varying vec4 b; void main() { gl_FragColor = b; }")
+            );
+
+        VERIFY_ARE_EQUAL(
+            CGLSLConvertedShader::LinkingErrorRecord::ErrorType::NotVertexDeclared,
+            Link(pwszVertex, L"precision mediump float; varying vec4 c; void main() { gl_FragColor = c; }")
+            );
+
+        // Varyings that the fragment shader declares but does not use do not need to be in the vertex shader
+        VERIFY_ARE_EQUAL(
+            CGLSLConvertedShader::LinkingErrorRecord::ErrorType::NoError,
+            Link(pwszVertex, L"precision mediump float; varying vec4 a; varying vec4 c; void main() { gl_FragColor = a; }")
+            );
+    }
+} /* namespace ft_glslparse */
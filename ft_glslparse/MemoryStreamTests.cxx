@@ -0,0 +1,188 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+
+
+//  Class:      MemoryStreamTests
+//  Synopsis:   Defines tests for the buffer behind CMemoryStream
+
+#include "headers.hxx"
+#include "MemoryStreamTests.hxx"
+#include "MemoryStream.hxx"
+#include "RefCounted.hxx"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace ft_glslparse
+{
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   WriteTests
+    //
+    //  Synopsis:   Characters, literals, strings, formatted writes and
+    //              reserved buffers all land at the end of the stream as the
+    //              buffer grows, and a format that does not fit leaves the
+    //              stream untouched.
+    //
+    //-----------------------------------------------------------------------------
+    void MemoryStreamTests::WriteTests()
+    {
+        TSmartPointer<CMemoryStream> spStream;
+        VERIFY_SUCCEEDED(RefCounted<CMemoryStream>::Create(/*out*/spStream));
+
+        CMutableString<char> strExpected;
+        VERIFY_SUCCEEDED(strExpected.Set(""));
+
+        // Enough output to make the buffer grow several times
+        for (UINT i = 0; i < 1000; i++)
+        {
+            VERIFY_SUCCEEDED(spStream->WriteChar('a'));
+            VERIFY_SUCCEEDED(spStream->WriteLiteral("bc"));
+            VERIFY_SUCCEEDED(spStream->WriteString("de"));
+            VERIFY_SUCCEEDED(spStream->WriteFormat(16, "%u;", i));
+
+            CMutableString<char> strPiece;
+            VERIFY_SUCCEEDED(strPiece.Format(32, "abcde%u;", i));
+            VERIFY_SUCCEEDED(strExpected.Append(strPiece));
+        }
+
+        VERIFY_FAILED(spStream->WriteFormat(4, "%s", "too long"));
+
+        // Only the committed part of a reserved buffer joins the stream
+        char* pReserved;
+        VERIFY_SUCCEEDED(spStream->ReserveBuffer(8, &pReserved));
+        ::memcpy(pReserved, "fghijklm", 8);
+        spStream->CommitBuffer(3);
+        VERIFY_SUCCEEDED(strExpected.Append("fgh"));
+
+        UINT uSize;
+        VERIFY_SUCCEEDED(spStream->GetSize(&uSize));
+        VERIFY_ARE_EQUAL(strExpected.GetLength(), static_cast<size_t>(uSize));
+
+        CMutableString<char> strOutput;
+        VERIFY_SUCCEEDED(spStream->ExtractString(strOutput));
+        VERIFY_ARE_EQUAL(0, ::strcmp(strExpected, strOutput));
+
+        // Extracting copies, so the stream still holds everything
+        VERIFY_SUCCEEDED(spStream->GetSize(&uSize));
+        VERIFY_ARE_EQUAL(strExpected.GetLength(), static_cast<size_t>(uSize));
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   TakeStringTests
+    //
+    //  Synopsis:   Taking into an empty string hands the buffer over without a
+    //              copy, taking into a non-empty string appends, and either
+    //              way the stream is left empty and ready for reuse.
+    //
+    //-----------------------------------------------------------------------------
+    void MemoryStreamTests::TakeStringTests()
+    {
+        TSmartPointer<CMemoryStream> spStream;
+        VERIFY_SUCCEEDED(RefCounted<CMemoryStream>::Create(/*out*/spStream));
+
+        // Taking an empty stream leaves the string alone
+        CMutableString<char> strEmpty;
+        VERIFY_SUCCEEDED(spStream->TakeString(strEmpty));
+        VERIFY_IS_TRUE(static_cast<const char*>(strEmpty) == nullptr);
+
+        // Find out where the buffer lives by locking it, then drop the terminators again
+        VERIFY_SUCCEEDED(spStream->WriteLiteral("struct PSInput {\n"));
+
+        char* pBuffer;
+        UINT uScanSize;
+        VERIFY_SUCCEEDED(spStream->LockScanBuffer(&pBuffer, &uScanSize));
+        spStream->UnlockScanBuffer();
+        VERIFY_SUCCEEDED(spStream->SetSize(uScanSize - 2));
+
+        CMutableString<char> strVertex;
+        VERIFY_SUCCEEDED(spStream->TakeString(strVertex));
+        VERIFY_ARE_EQUAL(static_cast<void*>(pBuffer), static_cast<void*>(static_cast<char*>(strVertex)));
+        VERIFY_ARE_EQUAL(0, ::strcmp("struct PSInput {\n", strVertex));
+
+        UINT uSize;
+        VERIFY_SUCCEEDED(spStream->GetSize(&uSize));
+        VERIFY_ARE_EQUAL(0U, uSize);
+
+        // The stream keeps working after its buffer has been taken
+        VERIFY_SUCCEEDED(spStream->WriteLiteral("};\n"));
+
+        CMutableString<char> strFragment;
+        VERIFY_SUCCEEDED(strFragment.Set("struct PSInput {\n"));
+        VERIFY_SUCCEEDED(spStream->TakeString(strFragment));
+        VERIFY_ARE_EQUAL(0, ::strcmp("struct PSInput {\n};\n", strFragment));
+
+        VERIFY_SUCCEEDED(spStream->GetSize(&uSize));
+        VERIFY_ARE_EQUAL(0U, uSize);
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   ReadAndResizeTests
+    //
+    //  Synopsis:   Reads pick up where the last one stopped, SeekToStart only
+    //              moves the read position, and SetSize truncates the stream.
+    //
+    //-----------------------------------------------------------------------------
+    void MemoryStreamTests::ReadAndResizeTests()
+    {
+        TSmartPointer<CMemoryStream> spStream;
+        VERIFY_SUCCEEDED(RefCounted<CMemoryStream>::Create(/*out*/spStream));
+        VERIFY_SUCCEEDED(spStream->WriteLiteral("abcdef"));
+
+        char rgBuffer[4];
+        UINT uRead;
+        VERIFY_SUCCEEDED(spStream->Read(rgBuffer, ARRAYSIZE(rgBuffer), &uRead));
+        VERIFY_ARE_EQUAL(4U, uRead);
+        VERIFY_ARE_EQUAL(0, ::memcmp("abcd", rgBuffer, uRead));
+
+        VERIFY_SUCCEEDED(spStream->Read(rgBuffer, ARRAYSIZE(rgBuffer), &uRead));
+        VERIFY_ARE_EQUAL(2U, uRead);
+        VERIFY_ARE_EQUAL(0, ::memcmp("ef", rgBuffer, uRead));
+
+        VERIFY_SUCCEEDED(spStream->Read(rgBuffer, ARRAYSIZE(rgBuffer), &uRead));
+        VERIFY_ARE_EQUAL(0U, uRead);
+
+        // Writes still append after seeking back for reading
+        VERIFY_SUCCEEDED(spStream->SeekToStart());
+        VERIFY_SUCCEEDED(spStream->WriteChar('g'));
+
+        VERIFY_SUCCEEDED(spStream->Read(rgBuffer, ARRAYSIZE(rgBuffer), &uRead));
+        VERIFY_ARE_EQUAL(4U, uRead);
+        VERIFY_ARE_EQUAL(0, ::memcmp("abcd", rgBuffer, uRead));
+
+        VERIFY_SUCCEEDED(spStream->SetSize(2));
+        VERIFY_SUCCEEDED(spStream->Read(rgBuffer, ARRAYSIZE(rgBuffer), &uRead));
+        VERIFY_ARE_EQUAL(0U, uRead);
+
+        CMutableString<char> strOutput;
+        VERIFY_SUCCEEDED(spStream->ExtractString(strOutput));
+        VERIFY_ARE_EQUAL(0, ::strcmp("ab", strOutput));
+    }
+} /* namespace ft_glslparse */
@@ -0,0 +1,260 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+
+//  Class:      ParserInputTests
+//  Synopsis:   Defines tests for the inputs that feed the generated scanners
+
+#include "headers.hxx"
+#include "ParserInputTests.hxx"
+#include "GLSLPreProcess.hxx"
+#include "GLSLStreamParserInput.hxx"
+#include "GLSLStringParserInput.hxx"
+#include "MemoryStream.hxx"
+#include "RefCounted.hxx"
+#include "TestErrorSink.hxx"
+#include "GLSLLineMap.hxx"
+#include "GLSLExtensionState.hxx"
+#include "GLSLTranslateOptions.hxx"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace ft_glslparse
+{
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   StringInputBlockTests
+    //
+    //  Synopsis:   String input fills each buffer it is given, returns the
+    //              remainder on the last call and 0 once exhausted.
+    //
+    //-----------------------------------------------------------------------------
+    void ParserInputTests::StringInputBlockTests()
+    {
+        char szInput[] = "void main() {}\n";
+
+        for (int maxSize = 1; maxSize <= static_cast<int>(ARRAYSIZE(szInput)) + 1; maxSize++)
+        {
+            TSmartPointer<CGLSLStringParserInput> spInput;
+            VERIFY_SUCCEEDED(RefCounted<CGLSLStringParserInput>::Create(szInput, ARRAYSIZE(szInput) - 1, /*out*/spInput));
+
+            VerifyBlockReads(spInput, szInput, maxSize);
+        }
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   StreamInputBlockTests
+    //
+    //  Synopsis:   Stream input fills each buffer it is given, returns the
+    //              remainder on the last call and 0 once exhausted.
+    //
+    //-----------------------------------------------------------------------------
+    void ParserInputTests::StreamInputBlockTests()
+    {
+        const char szInput[] = "void main() {}\n";
+
+        for (int maxSize = 1; maxSize <= static_cast<int>(ARRAYSIZE(szInput)) + 1; maxSize++)
+        {
+            TSmartPointer<CMemoryStream> spStream;
+            VERIFY_SUCCEEDED(RefCounted<CMemoryStream>::Create(/*out*/spStream));
+            VERIFY_SUCCEEDED(spStream->WriteString(szInput));
+
+            TSmartPointer<CGLSLStreamParserInput> spInput;
+            VERIFY_SUCCEEDED(RefCounted<CGLSLStreamParserInput>::Create(spStream, /*out*/spInput));
+
+            VerifyBlockReads(spInput, szInput, maxSize);
+        }
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   StringScanBufferTests
+    //
+    //  Synopsis:   A referenced string is scanned in place from the caller's
+    //              buffer, which must already carry two null terminators. A
+    //              copied string gets its own terminated buffer.
+    //
+    //-----------------------------------------------------------------------------
+    void ParserInputTests::StringScanBufferTests()
+    {
+        // Two nulls: the one from the literal and an explicit one
+        char szTerminated[] = "#define FOO 1\nFOO\n\0";
+        const UINT uLength = ARRAYSIZE(szTerminated) - 2;
+
+        TSmartPointer<CGLSLStringParserInput> spInput;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLStringParserInput>::Create(szTerminated, uLength, false, /*out*/spInput));
+
+        char* pBuffer;
+        UINT uSize;
+        VERIFY_SUCCEEDED(spInput->GetScanBuffer(&pBuffer, &uSize));
+        VERIFY_ARE_EQUAL(static_cast<void*>(szTerminated), static_cast<void*>(pBuffer));
+        VERIFY_ARE_EQUAL(uLength + 2, uSize);
+
+        // The preprocessor scans the referenced buffer in place
+        TSmartPointer<CGLSLStringParserInput> spPreprocessInput;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLStringParserInput>::Create(szTerminated, uLength, false, /*out*/spPreprocessInput));
+
+        TSmartPointer<CTestErrorSink> spErrorSink;
+        VERIFY_SUCCEEDED(RefCounted<CTestErrorSink>::Create(/*out*/spErrorSink));
+
+        TSmartPointer<CMemoryStream> spStream;
+        TSmartPointer<CGLSLLineMap> spLineMap;
+        TSmartPointer<CGLSLExtensionState> spExtensionState;
+        VERIFY_SUCCEEDED(::GLSLPreprocess(spPreprocessInput, spErrorSink, 0, GLSLShaderType::Fragment, &spStream, &spLineMap, &spExtensionState));
+
+        CMutableString<char> strOutput;
+        VERIFY_SUCCEEDED(spStream->ExtractString(strOutput));
+        VERIFY_ARE_EQUAL(0, ::strcmp("\n1\n", strOutput));
+
+        // Referencing a buffer without the second terminator fails
+        char szUnterminated[] = "FOO";
+        TSmartPointer<CGLSLStringParserInput> spBadInput;
+        VERIFY_FAILED(RefCounted<CGLSLStringParserInput>::Create(szUnterminated, ARRAYSIZE(szUnterminated) - 1, false, /*out*/spBadInput));
+
+        // Copying adds the terminators
+        TSmartPointer<CGLSLStringParserInput> spCopiedInput;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLStringParserInput>::Create(szUnterminated, ARRAYSIZE(szUnterminated) - 1, /*out*/spCopiedInput));
+        VERIFY_SUCCEEDED(spCopiedInput->GetScanBuffer(&pBuffer, &uSize));
+        VERIFY_ARE_NOT_EQUAL(static_cast<void*>(szUnterminated), static_cast<void*>(pBuffer));
+        VERIFY_ARE_EQUAL(5U, uSize);
+        VERIFY_ARE_EQUAL(0, ::memcmp("FOO\0\0", pBuffer, uSize));
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   StreamScanBufferTests
+    //
+    //  Synopsis:   A stream hands out its own memory, terminated for scanning,
+    //              and stays locked until the buffer is handed back.
+    //
+    //-----------------------------------------------------------------------------
+    void ParserInputTests::StreamScanBufferTests()
+    {
+        TSmartPointer<CMemoryStream> spStream;
+        VERIFY_SUCCEEDED(RefCounted<CMemoryStream>::Create(/*out*/spStream));
+        VERIFY_SUCCEEDED(spStream->WriteString("void main() {}\n"));
+
+        TSmartPointer<CGLSLStreamParserInput> spInput;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLStreamParserInput>::Create(spStream, /*out*/spInput));
+
+        char* pBuffer;
+        UINT uSize;
+        VERIFY_SUCCEEDED(spInput->GetScanBuffer(&pBuffer, &uSize));
+        VERIFY_ARE_EQUAL(17U, uSize);
+        VERIFY_ARE_EQUAL(0, ::memcmp("void main() {}\n\0\0", pBuffer, uSize));
+
+        // The buffer can only be handed out once
+        VERIFY_FAILED(spInput->GetScanBuffer(&pBuffer, &uSize));
+
+        // Handing the buffer back unlocks the stream
+        spInput->ReleaseScanBuffer();
+        VERIFY_SUCCEEDED(spInput->GetScanBuffer(&pBuffer, &uSize));
+        spInput->ReleaseScanBuffer();
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   PreprocessorThroughputTests
+    //
+    //  Synopsis:   Run a large shader through the preprocessor scanner and log
+    //              the throughput. The output must match the input since there
+    //              are no directives or macros in it.
+    //
+    //-----------------------------------------------------------------------------
+    void ParserInputTests::PreprocessorThroughputTests()
+    {
+        const UINT uTargetSize = 4 * 1024 * 1024;
+
+        CMutableString<char> strInput;
+        char szLine[64];
+        for (UINT i = 0; strInput.GetLength() < uTargetSize; i++)
+        {
+            VERIFY_SUCCEEDED(::StringCchPrintfA(szLine, ARRAYSIZE(szLine), "float value_%u = %u.0 * 2.0;\n", i, i));
+            VERIFY_SUCCEEDED(strInput.Append(szLine, static_cast<UINT>(::strlen(szLine))));
+        }
+
+        TSmartPointer<CGLSLStringParserInput> spInput;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLStringParserInput>::Create(static_cast<char*>(strInput), strInput.GetLength(), /*out*/spInput));
+
+        TSmartPointer<CTestErrorSink> spErrorSink;
+        VERIFY_SUCCEEDED(RefCounted<CTestErrorSink>::Create(/*out*/spErrorSink));
+
+        LARGE_INTEGER liFrequency;
+        LARGE_INTEGER liStart;
+        LARGE_INTEGER liEnd;
+        ::QueryPerformanceFrequency(&liFrequency);
+        ::QueryPerformanceCounter(&liStart);
+
+        TSmartPointer<CMemoryStream> spStream;
+        TSmartPointer<CGLSLLineMap> spLineMap;
+        TSmartPointer<CGLSLExtensionState> spExtensionState;
+        VERIFY_SUCCEEDED(::GLSLPreprocess(spInput, spErrorSink, 0, GLSLShaderType::Fragment, &spStream, &spLineMap, &spExtensionState));
+
+        ::QueryPerformanceCounter(&liEnd);
+
+        CMutableString<char> strOutput;
+        VERIFY_SUCCEEDED(spStream->ExtractString(strOutput));
+        VERIFY_ARE_EQUAL(strInput.GetLength(), strOutput.GetLength());
+        VERIFY_ARE_EQUAL(0, ::memcmp(static_cast<char*>(strInput), static_cast<char*>(strOutput), strInput.GetLength()));
+
+        double seconds = static_cast<double>(liEnd.QuadPart - liStart.QuadPart) / static_cast<double>(liFrequency.QuadPart);
+        double megabytes = static_cast<double>(strInput.GetLength()) / (1024.0 * 1024.0);
+        Log::Comment(String().Format(L"Preprocessed %.1f MB in %.3f s: %.1f MB/s", megabytes, seconds, megabytes / seconds));
+    }
+
+    void ParserInputTests::VerifyBlockReads(IParserInput* pInput, const char* pszExpected, int maxSize)
+    {
+        const int expectedLength = static_cast<int>(::strlen(pszExpected));
+
+        char rgBuffer[64];
+        VERIFY_IS_TRUE(maxSize <= static_cast<int>(ARRAYSIZE(rgBuffer)));
+
+        int totalRead = 0;
+        for (;;)
+        {
+            int read = pInput->PullInput(rgBuffer, maxSize);
+            if (read == 0)
+            {
+                break;
+            }
+
+            // Every read but the last must fill the buffer
+            VERIFY_IS_TRUE(read == maxSize || totalRead + read == expectedLength);
+            VERIFY_IS_TRUE(totalRead + read <= expectedLength);
+            VERIFY_ARE_EQUAL(0, ::memcmp(rgBuffer, pszExpected + totalRead, read));
+
+            totalRead += read;
+        }
+
+        VERIFY_ARE_EQUAL(expectedLength, totalRead);
+
+        // Reading past the end keeps returning 0
+        VERIFY_ARE_EQUAL(0, pInput->PullInput(rgBuffer, maxSize));
+    }
+} /* namespace ft_glslparse */
@@ -0,0 +1,155 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+
+
+//  Class:      ScopedSymbolIndexTests
+//  Synopsis:   Defines tests for resolving identifiers through the scoped
+//              symbol index
+
+#include "headers.hxx"
+#include "ScopedSymbolIndexTests.hxx"
+#include "GLSLScopedSymbolIndex.hxx"
+#include "GLSLParser.hxx"
+#include "GLSLTranslate.hxx"
+#include "GLSLTranslateOptions.hxx"
+#include "WebGLFeatureLevel.hxx"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace ft_glslparse
+{
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   ShadowingTests
+    //
+    //  Synopsis:   Inner declarations hide outer ones only until their scope
+    //              ends, and every scope is closed again once the tree has
+    //              been verified.
+    //
+    //-----------------------------------------------------------------------------
+    void ScopedSymbolIndexTests::ShadowingTests()
+    {
+        CSmartBstr bstrShader;
+        bstrShader.Set(
+            L"precision mediump float;\n"
+            L"float x;\n"
+            L"float shade(float x) { { int x = 1; } return x * 2.0; }\n"
+            L"void main() {\n"
+            L"    vec2 x = vec2(0.0);\n"
+            L"    for (int i = 0; i < 2; i++) { float x = 1.0; x += 1.0; }\n"
+            L"    if (true) { bool x = true; }\n"
+            L"    x.y = shade(x.x);\n"
+            L"    gl_FragColor = vec4(x, 0.0, 1.0);\n"
+            L"}\n"
+            );
+
+        CGLSLParser parser;
+        VERIFY_SUCCEEDED(parser.Initialize(bstrShader, GLSLShaderType::Fragment, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1));
+
+        TSmartPointer<CGLSLConvertedShader> spConvertedShader;
+        VERIFY_SUCCEEDED(parser.Translate(&spConvertedShader));
+        VERIFY_IS_TRUE(spConvertedShader->TranslationSucceeded());
+
+        VERIFY_ARE_EQUAL(0U, parser.UseScopedSymbolIndex()->GetOpenScopeCount());
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   ManyLocalsBenchmark
+    //
+    //  Synopsis:   Times translating a generated shader with hundreds of
+    //              locals in nested blocks, where every use used to search
+    //              the identifier list of each scope up to the declaration.
+    //              Timings depend on the machine so nothing is verified
+    //              about them.
+    //
+    //-----------------------------------------------------------------------------
+    void ScopedSymbolIndexTests::ManyLocalsBenchmark()
+    {
+        const UINT uBlocks = 8;
+        const UINT uLocalsPerBlock = 64;
+
+        CMutableString<wchar_t> strShader(64 * uBlocks * uLocalsPerBlock);
+        VERIFY_SUCCEEDED(strShader.Append(L"precision mediump float;\nuniform float u;\nvoid main() {\n"));
+
+        CMutableString<wchar_t> strLine;
+        for (UINT uBlock = 0; uBlock < uBlocks; uBlock++)
+        {
+            VERIFY_SUCCEEDED(strShader.Append(L"{\n"));
+
+            for (UINT uLocal = 0; uLocal < uLocalsPerBlock; uLocal++)
+            {
+                // Each local reads the first local of the outermost block, so
+                // resolving it has to get past every scope in between
+                if (uBlock == 0 && uLocal == 0)
+                {
+                    VERIFY_SUCCEEDED(strLine.Format(64, L"float v_0_0 = u;\n"));
+                }
+                else
+                {
+                    VERIFY_SUCCEEDED(strLine.Format(64, L"float v_%u_%u = v_0_0 + u;\n", uBlock, uLocal));
+                }
+
+                VERIFY_SUCCEEDED(strShader.Append(strLine));
+            }
+        }
+
+        for (UINT uBlock = 0; uBlock < uBlocks; uBlock++)
+        {
+            VERIFY_SUCCEEDED(strShader.Append(L"}\n"));
+        }
+
+        VERIFY_SUCCEEDED(strShader.Append(L"gl_FragColor = vec4(u);\n}\n"));
+
+        CSmartBstr bstrShader;
+        bstrShader.Set(strShader);
+
+        LARGE_INTEGER liFrequency;
+        LARGE_INTEGER liStart;
+        LARGE_INTEGER liEnd;
+        ::QueryPerformanceFrequency(&liFrequency);
+        ::QueryPerformanceCounter(&liStart);
+
+        TSmartPointer<CGLSLConvertedShader> spConvertedShader;
+        VERIFY_SUCCEEDED(::GLSLTranslate(bstrShader, GLSLShaderType::Fragment, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spConvertedShader));
+
+        ::QueryPerformanceCounter(&liEnd);
+        VERIFY_IS_TRUE(spConvertedShader->TranslationSucceeded());
+
+        CMutableString<WCHAR> spszComment;
+        VERIFY_SUCCEEDED(spszComment.Format(
+            128,
+            L"%u locals in %u nested blocks: %.3f ms",
+            uBlocks * uLocalsPerBlock,
+            uBlocks,
+            static_cast<double>(liEnd.QuadPart - liStart.QuadPart) * 1000.0 / static_cast<double>(liFrequency.QuadPart)
+            ));
+        Log::Comment(spszComment);
+    }
+} /* namespace ft_glslparse */
@@ -0,0 +1,293 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+
+//  Class:      SerializationTests
+//  Synopsis:   Defines tests for writing and restoring translated shaders
+
+#include "headers.hxx"
+#include "SerializationTests.hxx"
+#include "GLSLShaderSerializer.hxx"
+#include "GLSLBinaryStream.hxx"
+#include "GLSLConvertedShader.hxx"
+#include "GLSLTranslate.hxx"
+#include "GLSLTranslateOptions.hxx"
+#include "GLSLType.hxx"
+#include "WebGLFeatureLevel.hxx"
+#include "RefCounted.hxx"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace ft_glslparse
+{
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   TranslateAndRestore
+    //
+    //  Synopsis:   Translates a shader, writes it and restores it from what was
+    //              written.
+    //
+    //-----------------------------------------------------------------------------
+    static void TranslateAndRestore(
+        __in_z const WCHAR* pwszShader,                                 // Shader source
+        GLSLShaderType::Enum shaderType,                                // Type of shader
+        __deref_out CGLSLConvertedShader** ppOriginal,                  // Translated shader
+        __deref_out CGLSLConvertedShader** ppRestored                   // Shader restored from the translated one
+        )
+    {
+        CSmartBstr bstrShader;
+        bstrShader.Set(pwszShader);
+
+        VERIFY_SUCCEEDED(::GLSLTranslate(bstrShader, shaderType, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, ppOriginal));
+
+        CGLSLBinaryWriter writer;
+        VERIFY_SUCCEEDED(CGLSLShaderSerializer::Serialize(*ppOriginal, &writer));
+
+        CGLSLBinaryReader reader(writer.GetData(), writer.GetSize());
+        VERIFY_SUCCEEDED(CGLSLShaderSerializer::Deserialize(&reader, ppRestored));
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   RoundTripTests
+    //
+    //  Synopsis:   The restored shader has the same HLSL and log as the shader
+    //              it was written from.
+    //
+    //-----------------------------------------------------------------------------
+    void SerializationTests::RoundTripTests()
+    {
+        TSmartPointer<CGLSLConvertedShader> spOriginal;
+        TSmartPointer<CGLSLConvertedShader> spRestored;
+        TranslateAndRestore(
+            L"attribute vec4 pos; varying vec2 uv; void main() { uv = pos.xy; gl_Position = pos; }",
+            GLSLShaderType::Vertex,
+            &spOriginal,
+            &spRestored
+            );
+
+        VERIFY_IS_TRUE(spRestored->TranslationSucceeded());
+        VERIFY_ARE_EQUAL(0U, spRestored->GetErrorCount());
+
+        CMutableString<char> spOriginalCode;
+        CMutableString<char> spRestoredCode;
+        VERIFY_SUCCEEDED(spOriginal->GetConvertedCodeWithParsedStructInfo(spOriginalCode));
+        VERIFY_SUCCEEDED(spRestored->GetConvertedCodeWithParsedStructInfo(spRestoredCode));
+        VERIFY_ARE_EQUAL(0, strcmp(spOriginalCode, spRestoredCode));
+
+        // Errors come back with their formatted text
+        TranslateAndRestore(L"void main() { undeclared = 1; }", GLSLShaderType::Vertex, &spOriginal, &spRestored);
+        VERIFY_IS_FALSE(spRestored->TranslationSucceeded());
+        VERIFY_ARE_EQUAL(spOriginal->GetErrorCount(), spRestored->GetErrorCount());
+
+        CSmartBstr bstrOriginalLog;
+        CSmartBstr bstrRestoredLog;
+        VERIFY_SUCCEEDED(spOriginal->GetLog(&bstrOriginalLog));
+        VERIFY_SUCCEEDED(spRestored->GetLog(&bstrRestoredLog));
+        VERIFY_ARE_EQUAL(0, wcscmp(bstrOriginalLog, bstrRestoredLog));
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   IdentifierTests
+    //
+    //  Synopsis:   Variables, their struct types and fields are restored and
+    //              can be looked up like in the translated shader.
+    //
+    //-----------------------------------------------------------------------------
+    void SerializationTests::IdentifierTests()
+    {
+        TSmartPointer<CGLSLConvertedShader> spOriginal;
+        TSmartPointer<CGLSLConvertedShader> spRestored;
+        TranslateAndRestore(
+            L"struct S { float a; vec2 b[2]; }; uniform S u; uniform S rg[3]; void main() { gl_Position = vec4(u.a + rg[1].b[0].x); }",
+            GLSLShaderType::Vertex,
+            &spOriginal,
+            &spRestored
+            );
+
+        CGLSLIdentifierTable* pOriginalTable = spOriginal->UseIdentifierTable();
+        CGLSLIdentifierTable* pRestoredTable = spRestored->UseIdentifierTable();
+        VERIFY_IS_NOT_NULL(pRestoredTable);
+        VERIFY_ARE_EQUAL(pOriginalTable->GetVariableCount(), pRestoredTable->GetVariableCount());
+
+        // Every variable has the same name, HLSL name and usage
+        for (UINT i = 0; i < pOriginalTable->GetVariableCount(); i++)
+        {
+            TSmartPointer<CVariableIdentifierInfo> spOriginalInfo;
+            TSmartPointer<CVariableIdentifierInfo> spRestoredInfo;
+            PCSTR pszOriginalName;
+            PCSTR pszRestoredName;
+            VERIFY_SUCCEEDED(pOriginalTable->GetVariableInfoAndNameByIndex(i, &spOriginalInfo, &pszOriginalName));
+            VERIFY_SUCCEEDED(pRestoredTable->GetVariableInfoAndNameByIndex(i, &spRestoredInfo, &pszRestoredName));
+
+            VERIFY_ARE_EQUAL(0, strcmp(pszOriginalName, pszRestoredName));
+            VERIFY_ARE_EQUAL(spOriginalInfo->IsUsed(), spRestoredInfo->IsUsed());
+            VERIFY_ARE_EQUAL(spOriginalInfo->GetHLSLNameCount(), spRestoredInfo->GetHLSLNameCount());
+            if (spOriginalInfo->GetHLSLNameCount() > 0 && spOriginalInfo->GetHLSLName(0) != nullptr)
+            {
+                VERIFY_ARE_EQUAL(0, strcmp(spOriginalInfo->GetHLSLName(0), spRestoredInfo->GetHLSLName(0)));
+            }
+        }
+
+        // Struct types keep their fields, and variables of the same struct type
+        // share the restored type
+        TSmartPointer<CVariableIdentifierInfo> spOriginalU;
+        TSmartPointer<CVariableIdentifierInfo> spRestoredU;
+        TSmartPointer<CVariableIdentifierInfo> spRestoredArray;
+        VERIFY_SUCCEEDED(pOriginalTable->GetVariableInfoFromString("u", GLSLQualifier::Uniform, &spOriginalU));
+        VERIFY_SUCCEEDED(pRestoredTable->GetVariableInfoFromString("u", GLSLQualifier::Uniform, &spRestoredU));
+        VERIFY_SUCCEEDED(pRestoredTable->GetVariableInfoFromString("rg", GLSLQualifier::Uniform, &spRestoredArray));
+
+        VERIFY_IS_TRUE(spRestoredU->UseType()->IsStructType());
+        VERIFY_IS_TRUE(spOriginalU->UseType()->IsEqualTypeForUniforms(pOriginalTable, spRestoredU->UseType(), pRestoredTable));
+
+        TSmartPointer<GLSLType> spElementType;
+        VERIFY_SUCCEEDED(spRestoredArray->UseType()->GetArrayElementType(&spElementType));
+        VERIFY_IS_TRUE(spElementType->IsEqualType(spRestoredU->UseType()));
+
+        TSmartPointer<CVariableIdentifierInfo> spField;
+        VERIFY_SUCCEEDED(pRestoredTable->GetFieldInfoForVariableName(spRestoredU->UseType(), "b", &spField));
+        int arraySize;
+        VERIFY_SUCCEEDED(spField->UseType()->GetArraySize(&arraySize));
+        VERIFY_ARE_EQUAL(2, arraySize);
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   LinkingTests
+    //
+    //  Synopsis:   Restored shaders link to the same varying structs as the
+    //              translated ones.
+    //
+    //-----------------------------------------------------------------------------
+    void SerializationTests::LinkingTests()
+    {
+        TSmartPointer<CGLSLConvertedShader> spVertex;
+        TSmartPointer<CGLSLConvertedShader> spRestoredVertex;
+        TranslateAndRestore(
+            L"attribute vec4 pos; varying vec4 used; varying vec4 unused; void main() { used = pos; unused = pos; gl_Position = pos; }",
+            GLSLShaderType::Vertex,
+            &spVertex,
+            &spRestoredVertex
+            );
+
+        TSmartPointer<CGLSLConvertedShader> spFragment;
+        TSmartPointer<CGLSLConvertedShader> spRestoredFragment;
+        TranslateAndRestore(
+            L"precision mediump float; varying vec4 used; void main() { gl_FragColor = used; }",
+            GLSLShaderType::Fragment,
+            &spFragment,
+            &spRestoredFragment
+            );
+
+        CGLSLConvertedShader::LinkingErrorRecord errorRecord;
+        CMutableString<char> spVertexPrologue;
+        CMutableString<char> spFragmentPrologue;
+        VERIFY_SUCCEEDED(CGLSLConvertedShader::LinkVaryingStructEntries(spVertex, spFragment, 8, errorRecord, spVertexPrologue, spFragmentPrologue));
+        VERIFY_ARE_EQUAL(CGLSLConvertedShader::LinkingErrorRecord::ErrorType::NoError, errorRecord.errorType);
+
+        CGLSLConvertedShader::LinkingErrorRecord restoredErrorRecord;
+        CMutableString<char> spRestoredVertexPrologue;
+        CMutableString<char> spRestoredFragmentPrologue;
+        VERIFY_SUCCEEDED(CGLSLConvertedShader::LinkVaryingStructEntries(spRestoredVertex, spRestoredFragment, 8, restoredErrorRecord, spRestoredVertexPrologue, spRestoredFragmentPrologue));
+        VERIFY_ARE_EQUAL(CGLSLConvertedShader::LinkingErrorRecord::ErrorType::NoError, restoredErrorRecord.errorType);
+
+        VERIFY_ARE_EQUAL(0, strcmp(spVertexPrologue, spRestoredVertexPrologue));
+        VERIFY_ARE_EQUAL(0, strcmp(spFragmentPrologue, spRestoredFragmentPrologue));
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   CorruptDataTests
+    //
+    //  Synopsis:   Truncated or modified data is rejected rather than restored
+    //              into a shader that points outside of its tables.
+    //
+    //-----------------------------------------------------------------------------
+    void SerializationTests::CorruptDataTests()
+    {
+        CSmartBstr bstrShader;
+        bstrShader.Set(L"struct S { float a; }; attribute vec4 pos; varying vec4 v; uniform S u; void main() { v = pos * u.a; gl_Position = pos; }");
+
+        TSmartPointer<CGLSLConvertedShader> spShader;
+        VERIFY_SUCCEEDED(::GLSLTranslate(bstrShader, GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spShader));
+
+        CGLSLBinaryWriter writer;
+        VERIFY_SUCCEEDED(CGLSLShaderSerializer::Serialize(spShader, &writer));
+
+        // Every truncation fails
+        for (UINT cbSize = 0; cbSize < writer.GetSize(); cbSize++)
+        {
+            CGLSLBinaryReader reader(writer.GetData(), cbSize);
+            TSmartPointer<CGLSLConvertedShader> spRestored;
+            VERIFY_FAILED(CGLSLShaderSerializer::Deserialize(&reader, &spRestored));
+        }
+
+        // Trailing data fails
+        CModernArray<BYTE> aryData;
+        VERIFY_SUCCEEDED(aryData.Resize(writer.GetSize() + 1));
+        ::memcpy(aryData.GetData(), writer.GetData(), writer.GetSize());
+        aryData[writer.GetSize()] = 0;
+        {
+            CGLSLBinaryReader reader(aryData.GetData(), aryData.GetCount());
+            TSmartPointer<CGLSLConvertedShader> spRestored;
+            VERIFY_FAILED(CGLSLShaderSerializer::Deserialize(&reader, &spRestored));
+        }
+
+        // Flipping bits anywhere either fails or restores a shader that
+        // can be used without reading out of bounds
+        for (UINT i = 0; i < writer.GetSize(); i++)
+        {
+            ::memcpy(aryData.GetData(), writer.GetData(), writer.GetSize());
+            aryData[i] ^= 0xFF;
+
+            CGLSLBinaryReader reader(aryData.GetData(), writer.GetSize());
+            TSmartPointer<CGLSLConvertedShader> spRestored;
+            if (SUCCEEDED(CGLSLShaderSerializer::Deserialize(&reader, &spRestored)))
+            {
+                CSmartBstr bstrLog;
+                VERIFY_SUCCEEDED(spRestored->GetLog(&bstrLog));
+
+                CMutableString<char> spCode;
+                if (spRestored->TranslationSucceeded())
+                {
+                    VERIFY_SUCCEEDED(spRestored->GetConvertedCodeWithParsedStructInfo(spCode));
+                }
+
+                CGLSLIdentifierTable* pTable = spRestored->UseIdentifierTable();
+                TSmartPointer<CVariableIdentifierInfo> spInfo;
+                PCSTR pszName;
+                for (UINT j = 0; pTable != nullptr && SUCCEEDED(pTable->GetVariableInfoAndNameByIndex(j, &spInfo, &pszName)); j++)
+                {
+                    VERIFY_IS_NOT_NULL(pszName);
+                }
+            }
+        }
+    }
+} /* namespace ft_glslparse */
@@ -0,0 +1,188 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+
+//  Class:      SymbolTableTests
+//  Synopsis:   Defines tests for the symbol table used by the GLSL parser
+
+#include "headers.hxx"
+#include "SymbolTableTests.hxx"
+#include "GLSLSymbolTable.hxx"
+#include "RefCounted.hxx"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace ft_glslparse
+{
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   DenseIndexTests
+    //
+    //  Synopsis:   Symbols are given consecutive indices in the order they are
+    //              added, and adding an existing symbol returns its old index.
+    //
+    //-----------------------------------------------------------------------------
+    void SymbolTableTests::DenseIndexTests()
+    {
+        TSmartPointer<CGLSLSymbolTable> spTable;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLSymbolTable>::Create(/*out*/spTable));
+
+        int index;
+        VERIFY_SUCCEEDED(spTable->EnsureSymbolIndex("foo", &index));
+        VERIFY_ARE_EQUAL(0, index);
+        VERIFY_SUCCEEDED(spTable->EnsureSymbolIndex("bar", &index));
+        VERIFY_ARE_EQUAL(1, index);
+        VERIFY_SUCCEEDED(spTable->EnsureSymbolIndex("foo", &index));
+        VERIFY_ARE_EQUAL(0, index);
+
+        // Prefixes and extensions of existing symbols are distinct symbols
+        VERIFY_SUCCEEDED(spTable->EnsureSymbolIndex("fo", &index));
+        VERIFY_ARE_EQUAL(2, index);
+        VERIFY_SUCCEEDED(spTable->EnsureSymbolIndex("fooo", &index));
+        VERIFY_ARE_EQUAL(3, index);
+
+        VERIFY_SUCCEEDED(spTable->LookupSymbolIndex("bar", &index));
+        VERIFY_ARE_EQUAL(1, index);
+        VERIFY_ARE_EQUAL(0, ::strcmp(spTable->NameFromIndex(3), "fooo"));
+        VERIFY_ARE_EQUAL(4U, spTable->GetCount());
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   LookupNegativeTests
+    //
+    //  Synopsis:   Looking up a symbol that was never added fails.
+    //
+    //-----------------------------------------------------------------------------
+    void SymbolTableTests::LookupNegativeTests()
+    {
+        TSmartPointer<CGLSLSymbolTable> spTable;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLSymbolTable>::Create(/*out*/spTable));
+
+        int index;
+        VERIFY_ARE_EQUAL(E_INVALIDARG, spTable->LookupSymbolIndex("foo", &index));
+
+        VERIFY_SUCCEEDED(spTable->EnsureSymbolIndex("foo", &index));
+        VERIFY_ARE_EQUAL(E_INVALIDARG, spTable->LookupSymbolIndex("Foo", &index));
+        VERIFY_ARE_EQUAL(E_INVALIDARG, spTable->LookupSymbolIndex("", &index));
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   KnownSymbolTests
+    //
+    //  Synopsis:   Tables that include the known symbols give each known symbol
+    //              its GLSLSymbols value as the index, and number new symbols
+    //              after them. Separate tables do not see each other's symbols.
+    //
+    //-----------------------------------------------------------------------------
+    void SymbolTableTests::KnownSymbolTests()
+    {
+        TSmartPointer<CGLSLSymbolTable> spTable;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLSymbolTable>::Create(true, /*out*/spTable));
+        VERIFY_ARE_EQUAL(static_cast<UINT>(GLSLSymbols::count), spTable->GetCount());
+
+        for (int i = 0; i < GLSLSymbols::count; i++)
+        {
+            const char* pszName = GLSLSymbolInfo::s_info[i]._pGLSLName;
+
+            int index;
+            VERIFY_SUCCEEDED(spTable->EnsureSymbolIndex(pszName, &index));
+            VERIFY_ARE_EQUAL(i, index);
+            VERIFY_ARE_EQUAL(0, ::strcmp(spTable->NameFromIndex(i), pszName));
+        }
+
+        int index;
+        VERIFY_SUCCEEDED(spTable->EnsureSymbolIndex("foo", &index));
+        VERIFY_ARE_EQUAL(static_cast<int>(GLSLSymbols::count), index);
+        VERIFY_SUCCEEDED(spTable->EnsureSymbolIndex("main", &index));
+        VERIFY_ARE_EQUAL(static_cast<int>(GLSLSymbols::main), index);
+
+        TSmartPointer<CGLSLSymbolTable> spOtherTable;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLSymbolTable>::Create(true, /*out*/spOtherTable));
+        VERIFY_ARE_EQUAL(E_INVALIDARG, spOtherTable->LookupSymbolIndex("foo", &index));
+        VERIFY_SUCCEEDED(spOtherTable->EnsureSymbolIndex("bar", &index));
+        VERIFY_ARE_EQUAL(static_cast<int>(GLSLSymbols::count), index);
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   LargeSymbolCountTests
+    //
+    //  Synopsis:   Fill the table past several rehashes and verify every symbol
+    //              keeps its index. Lookup time per symbol is logged for a
+    //              range of table sizes; it should stay flat as the table grows.
+    //
+    //-----------------------------------------------------------------------------
+    void SymbolTableTests::LargeSymbolCountTests()
+    {
+        MeasureLookupTime(100);
+        MeasureLookupTime(1000);
+        MeasureLookupTime(10000);
+    }
+
+    void SymbolTableTests::MeasureLookupTime(UINT uSymbolCount)
+    {
+        TSmartPointer<CGLSLSymbolTable> spTable;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLSymbolTable>::Create(/*out*/spTable));
+
+        char szSymbol[32];
+        for (UINT i = 0; i < uSymbolCount; i++)
+        {
+            VERIFY_SUCCEEDED(::StringCchPrintfA(szSymbol, ARRAYSIZE(szSymbol), "symbol_%u", i));
+
+            int index;
+            VERIFY_SUCCEEDED(spTable->EnsureSymbolIndex(szSymbol, &index));
+            VERIFY_ARE_EQUAL(static_cast<int>(i), index);
+        }
+
+        LARGE_INTEGER liFrequency;
+        LARGE_INTEGER liStart;
+        LARGE_INTEGER liEnd;
+        ::QueryPerformanceFrequency(&liFrequency);
+        ::QueryPerformanceCounter(&liStart);
+
+        bool fAllFound = true;
+        for (UINT i = 0; i < uSymbolCount; i++)
+        {
+            ::StringCchPrintfA(szSymbol, ARRAYSIZE(szSymbol), "symbol_%u", i);
+
+            int index;
+            if (FAILED(spTable->LookupSymbolIndex(szSymbol, &index)) || index != static_cast<int>(i))
+            {
+                fAllFound = false;
+            }
+        }
+
+        ::QueryPerformanceCounter(&liEnd);
+        VERIFY_IS_TRUE(fAllFound);
+
+        double nsPerLookup = static_cast<double>(liEnd.QuadPart - liStart.QuadPart) * 1e9 / static_cast<double>(liFrequency.QuadPart) / uSymbolCount;
+        Log::Comment(String().Format(L"%u symbols: %.1f ns per lookup", uSymbolCount, nsPerLookup));
+    }
+} /* namespace ft_glslparse */
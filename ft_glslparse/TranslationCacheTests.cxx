@@ -0,0 +1,401 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+
+//  Class:      TranslationCacheTests
+//  Synopsis:   Defines tests for the cache of translated shaders
+
+#include "headers.hxx"
+#include "TranslationCacheTests.hxx"
+#include "GLSLTranslationCache.hxx"
+#include "GLSLTranslate.hxx"
+#include "GLSLTranslateOptions.hxx"
+#include "WebGLFeatureLevel.hxx"
+#include "RefCounted.hxx"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace ft_glslparse
+{
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   OverwriteCacheFiles
+    //
+    //  Synopsis:   Overwrites bytes at the same offset in every cache file in a
+    //              directory.
+    //
+    //-----------------------------------------------------------------------------
+    static void OverwriteCacheFiles(
+        __in_z const WCHAR* pszDirectory,                       // Directory of the persistent cache
+        LONG lOffset,                                           // Offset in each file to write at
+        __in_bcount(cbData) const BYTE* pData,                  // Bytes to write
+        DWORD cbData                                            // Number of bytes to write
+        )
+    {
+        CMutableString<WCHAR> spszPattern;
+        VERIFY_SUCCEEDED(spszPattern.Format(MAX_PATH, L"%s\\*.glslc", pszDirectory));
+
+        WIN32_FIND_DATAW findData;
+        HANDLE hFind = ::FindFirstFileW(spszPattern, &findData);
+        VERIFY_ARE_NOT_EQUAL(INVALID_HANDLE_VALUE, hFind);
+        do
+        {
+            CMutableString<WCHAR> spszFile;
+            VERIFY_SUCCEEDED(spszFile.Format(MAX_PATH, L"%s\\%s", pszDirectory, findData.cFileName));
+
+            HANDLE hFile = ::CreateFileW(spszFile, GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            VERIFY_ARE_NOT_EQUAL(INVALID_HANDLE_VALUE, hFile);
+
+            DWORD cbWritten;
+            VERIFY_IS_TRUE(::SetFilePointer(hFile, lOffset, nullptr, FILE_BEGIN) != INVALID_SET_FILE_POINTER);
+            VERIFY_IS_TRUE(::WriteFile(hFile, pData, cbData, &cbWritten, nullptr));
+            ::CloseHandle(hFile);
+        } while (::FindNextFileW(hFind, &findData));
+        ::FindClose(hFind);
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   HitMissTests
+    //
+    //  Synopsis:   Translating the same key twice returns the same shader, and
+    //              changing any part of the key misses.
+    //
+    //-----------------------------------------------------------------------------
+    void TranslationCacheTests::HitMissTests()
+    {
+        TSmartPointer<CGLSLTranslationCache> spCache;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLTranslationCache>::Create(1024 * 1024, /*out*/spCache));
+
+        CSmartBstr bstrShader;
+        bstrShader.Set(L"void main() { gl_Position = vec4(0.0); }");
+
+        TSmartPointer<CGLSLConvertedShader> spFirst;
+        VERIFY_SUCCEEDED(spCache->Translate(bstrShader, GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spFirst));
+        VERIFY_ARE_EQUAL(0U, spCache->GetHitCount());
+        VERIFY_ARE_EQUAL(1U, spCache->GetMissCount());
+
+        // An equal source in a different string is a hit
+        CSmartBstr bstrSameShader;
+        bstrSameShader.Set(L"void main() { gl_Position = vec4(0.0); }");
+
+        TSmartPointer<CGLSLConvertedShader> spSecond;
+        VERIFY_SUCCEEDED(spCache->Translate(bstrSameShader, GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spSecond));
+        VERIFY_ARE_EQUAL(1U, spCache->GetHitCount());
+        VERIFY_ARE_EQUAL(static_cast<CGLSLConvertedShader*>(spFirst), static_cast<CGLSLConvertedShader*>(spSecond));
+
+        // Each part of the key is significant
+        TSmartPointer<CGLSLConvertedShader> spOther;
+        VERIFY_SUCCEEDED(spCache->Translate(bstrShader, GLSLShaderType::Vertex, GLSLTranslateOptions::DisableBoilerPlate, WebGLFeatureLevel::Level_9_1, &spOther));
+        VERIFY_SUCCEEDED(spCache->Translate(bstrShader, GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_10, &spOther));
+        VERIFY_SUCCEEDED(spCache->Translate(bstrShader, GLSLShaderType::Fragment, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spOther));
+        VERIFY_ARE_EQUAL(1U, spCache->GetHitCount());
+        VERIFY_ARE_EQUAL(4U, spCache->GetMissCount());
+        VERIFY_ARE_EQUAL(4U, spCache->GetEntryCount());
+
+        // Shaders with errors are cached too
+        CSmartBstr bstrBadShader;
+        bstrBadShader.Set(L"void main() { undeclared = 1; }");
+        VERIFY_SUCCEEDED(spCache->Translate(bstrBadShader, GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spOther));
+        VERIFY_IS_FALSE(spOther->TranslationSucceeded());
+        VERIFY_SUCCEEDED(spCache->Translate(bstrBadShader, GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spOther));
+        VERIFY_ARE_EQUAL(2U, spCache->GetHitCount());
+
+        spCache->Clear();
+        VERIFY_ARE_EQUAL(0U, spCache->GetEntryCount());
+        VERIFY_ARE_EQUAL(0U, spCache->GetMemoryUsed());
+
+        // Shaders handed out earlier stay valid after they leave the cache
+        CMutableString<char> spCode;
+        VERIFY_SUCCEEDED(spFirst->GetConvertedCodeWithParsedStructInfo(spCode));
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   EvictionTests
+    //
+    //  Synopsis:   The least recently used shader is evicted to stay within the
+    //              memory budget.
+    //
+    //-----------------------------------------------------------------------------
+    void TranslationCacheTests::EvictionTests()
+    {
+        // These shaders translate to outputs of the same size
+        CSmartBstr rgbstrShaders[3];
+        rgbstrShaders[0].Set(L"void f0() {}");
+        rgbstrShaders[1].Set(L"void f1() {}");
+        rgbstrShaders[2].Set(L"void f2() {}");
+
+        // Find out what one entry costs
+        UINT cbEntry;
+        {
+            TSmartPointer<CGLSLTranslationCache> spCache;
+            VERIFY_SUCCEEDED(RefCounted<CGLSLTranslationCache>::Create(1024 * 1024, /*out*/spCache));
+
+            TSmartPointer<CGLSLConvertedShader> spShader;
+            VERIFY_SUCCEEDED(spCache->Translate(rgbstrShaders[0], GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spShader));
+            cbEntry = spCache->GetMemoryUsed();
+            VERIFY_IS_TRUE(cbEntry > 0);
+        }
+
+        TSmartPointer<CGLSLTranslationCache> spCache;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLTranslationCache>::Create(2 * cbEntry, /*out*/spCache));
+
+        TSmartPointer<CGLSLConvertedShader> spShader;
+        VERIFY_SUCCEEDED(spCache->Translate(rgbstrShaders[0], GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spShader));
+        VERIFY_SUCCEEDED(spCache->Translate(rgbstrShaders[1], GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spShader));
+        VERIFY_ARE_EQUAL(2U, spCache->GetEntryCount());
+        VERIFY_ARE_EQUAL(0U, spCache->GetEvictionCount());
+
+        // Touch the first shader so that the second is the least recently used
+        VERIFY_SUCCEEDED(spCache->Translate(rgbstrShaders[0], GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spShader));
+        VERIFY_ARE_EQUAL(1U, spCache->GetHitCount());
+
+        VERIFY_SUCCEEDED(spCache->Translate(rgbstrShaders[2], GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spShader));
+        VERIFY_ARE_EQUAL(2U, spCache->GetEntryCount());
+        VERIFY_ARE_EQUAL(1U, spCache->GetEvictionCount());
+        VERIFY_IS_TRUE(spCache->GetMemoryUsed() <= spCache->GetMemoryBudget());
+
+        // The first shader is still cached, the second is not
+        VERIFY_SUCCEEDED(spCache->Translate(rgbstrShaders[0], GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spShader));
+        VERIFY_ARE_EQUAL(2U, spCache->GetHitCount());
+        VERIFY_SUCCEEDED(spCache->Translate(rgbstrShaders[1], GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spShader));
+        VERIFY_ARE_EQUAL(2U, spCache->GetHitCount());
+        VERIFY_ARE_EQUAL(4U, spCache->GetMissCount());
+        VERIFY_ARE_EQUAL(2U, spCache->GetEvictionCount());
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   OversizedShaderTests
+    //
+    //  Synopsis:   A shader bigger than the whole budget is translated but not
+    //              cached, and does not evict anything.
+    //
+    //-----------------------------------------------------------------------------
+    void TranslationCacheTests::OversizedShaderTests()
+    {
+        TSmartPointer<CGLSLTranslationCache> spCache;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLTranslationCache>::Create(16, /*out*/spCache));
+
+        CSmartBstr bstrShader;
+        bstrShader.Set(L"void main() { gl_Position = vec4(0.0); }");
+
+        TSmartPointer<CGLSLConvertedShader> spShader;
+        VERIFY_SUCCEEDED(spCache->Translate(bstrShader, GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spShader));
+        VERIFY_IS_TRUE(spShader->TranslationSucceeded());
+        VERIFY_ARE_EQUAL(0U, spCache->GetEntryCount());
+        VERIFY_ARE_EQUAL(0U, spCache->GetEvictionCount());
+        VERIFY_ARE_EQUAL(0U, spCache->GetMemoryUsed());
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   MemorySizeTests
+    //
+    //  Synopsis:   Entries are charged for everything the shader keeps alive,
+    //              not just its HLSL.
+    //
+    //-----------------------------------------------------------------------------
+    void TranslationCacheTests::MemorySizeTests()
+    {
+        TSmartPointer<CGLSLTranslationCache> spCache;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLTranslationCache>::Create(1024 * 1024, /*out*/spCache));
+
+        CSmartBstr bstrShader;
+        bstrShader.Set(
+            L"struct S { vec4 a; float b[4]; };"
+            L"uniform S u[2];"
+            L"attribute vec4 pos;"
+            L"varying vec4 v0; varying vec4 v1;"
+            L"void main() { float t[3]; t[0] = u[0].b[1]; v0 = pos * t[0]; v1 = u[1].a; gl_Position = pos; }"
+            );
+
+        TSmartPointer<CGLSLConvertedShader> spShader;
+        VERIFY_SUCCEEDED(spCache->Translate(bstrShader, GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spShader));
+        VERIFY_IS_TRUE(spShader->TranslationSucceeded());
+
+        UINT cbOutput;
+        VERIFY_SUCCEEDED(spShader->UseConvertedStream()->GetSize(&cbOutput));
+
+        // The identifier table alone holds a symbol and an info for every variable
+        const CGLSLIdentifierTable* pIdTable = spShader->UseIdentifierTable();
+        VERIFY_IS_TRUE(pIdTable->GetMemorySize() > pIdTable->GetVariableCount() * sizeof(CVariableIdentifierInfo));
+        VERIFY_IS_TRUE(spShader->GetMemorySize() > cbOutput + pIdTable->GetMemorySize());
+
+        // The cache charges the entry for all of it, plus the copy of the source
+        VERIFY_IS_TRUE(spCache->GetMemoryUsed() > spShader->GetMemorySize() + ::SysStringLen(bstrShader) * sizeof(WCHAR));
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   StatsBypassTests
+    //
+    //  Synopsis:   Translations with stats are not cached, so each one gets
+    //              its own stats.
+    //
+    //-----------------------------------------------------------------------------
+    void TranslationCacheTests::StatsBypassTests()
+    {
+        TSmartPointer<CGLSLTranslationCache> spCache;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLTranslationCache>::Create(1024 * 1024, /*out*/spCache));
+
+        CSmartBstr bstrShader;
+        bstrShader.Set(L"attribute vec4 pos; void main() { gl_Position = pos * 2.0; }");
+
+        TSmartPointer<CGLSLConvertedShader> spFirst;
+        VERIFY_SUCCEEDED(spCache->Translate(bstrShader, GLSLShaderType::Vertex, GLSLTranslateOptions::EnableStats, WebGLFeatureLevel::Level_9_1, &spFirst));
+        VERIFY_IS_NOT_NULL(spFirst->UseStats());
+
+        TSmartPointer<CGLSLConvertedShader> spSecond;
+        VERIFY_SUCCEEDED(spCache->Translate(bstrShader, GLSLShaderType::Vertex, GLSLTranslateOptions::EnableStats, WebGLFeatureLevel::Level_9_1, &spSecond));
+        VERIFY_IS_NOT_NULL(spSecond->UseStats());
+
+        VERIFY_ARE_NOT_EQUAL(static_cast<CGLSLConvertedShader*>(spFirst), static_cast<CGLSLConvertedShader*>(spSecond));
+        VERIFY_ARE_NOT_EQUAL(spFirst->UseStats(), spSecond->UseStats());
+        VERIFY_ARE_EQUAL(2U, spCache->GetBypassCount());
+        VERIFY_ARE_EQUAL(0U, spCache->GetHitCount());
+        VERIFY_ARE_EQUAL(0U, spCache->GetMissCount());
+        VERIFY_ARE_EQUAL(0U, spCache->GetEntryCount());
+
+        // The same source without stats is still cached
+        TSmartPointer<CGLSLConvertedShader> spThird;
+        VERIFY_SUCCEEDED(spCache->Translate(bstrShader, GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spThird));
+        VERIFY_IS_NULL(spThird->UseStats());
+        VERIFY_ARE_EQUAL(1U, spCache->GetEntryCount());
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   PersistentCacheTests
+    //
+    //  Synopsis:   A cache backed by a directory restores shaders translated by
+    //              an earlier cache, and ignores files it cannot restore.
+    //
+    //-----------------------------------------------------------------------------
+    void TranslationCacheTests::PersistentCacheTests()
+    {
+        WCHAR wszTempPath[MAX_PATH];
+        VERIFY_IS_TRUE(::GetTempPathW(ARRAYSIZE(wszTempPath), wszTempPath) > 0);
+
+        CMutableString<WCHAR> spszDirectory;
+        VERIFY_SUCCEEDED(spszDirectory.Format(MAX_PATH, L"%sglslcache.%lx", wszTempPath, ::GetCurrentProcessId()));
+        VERIFY_IS_TRUE(::CreateDirectoryW(spszDirectory, nullptr) || ::GetLastError() == ERROR_ALREADY_EXISTS);
+
+        CSmartBstr bstrShader;
+        bstrShader.Set(L"attribute vec4 pos; varying vec4 v; void main() { v = pos; gl_Position = pos; }");
+
+        CMutableString<char> spFirstCode;
+        {
+            TSmartPointer<CGLSLTranslationCache> spCache;
+            VERIFY_SUCCEEDED(RefCounted<CGLSLTranslationCache>::Create(1024 * 1024, static_cast<const WCHAR*>(spszDirectory), /*out*/spCache));
+            VERIFY_IS_TRUE(spCache->IsPersistent());
+
+            TSmartPointer<CGLSLConvertedShader> spShader;
+            VERIFY_SUCCEEDED(spCache->Translate(bstrShader, GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spShader));
+            VERIFY_ARE_EQUAL(0U, spCache->GetDiskHitCount());
+            VERIFY_SUCCEEDED(spShader->GetConvertedCodeWithParsedStructInfo(spFirstCode));
+        }
+
+        // A new cache, standing in for a new process, finds the shader on disk
+        {
+            TSmartPointer<CGLSLTranslationCache> spCache;
+            VERIFY_SUCCEEDED(RefCounted<CGLSLTranslationCache>::Create(1024 * 1024, static_cast<const WCHAR*>(spszDirectory), /*out*/spCache));
+
+            TSmartPointer<CGLSLConvertedShader> spShader;
+            VERIFY_SUCCEEDED(spCache->Translate(bstrShader, GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spShader));
+            VERIFY_ARE_EQUAL(1U, spCache->GetMissCount());
+            VERIFY_ARE_EQUAL(1U, spCache->GetDiskHitCount());
+
+            CMutableString<char> spCode;
+            VERIFY_SUCCEEDED(spShader->GetConvertedCodeWithParsedStructInfo(spCode));
+            VERIFY_ARE_EQUAL(0, strcmp(spFirstCode, spCode));
+
+            // A different key with the same source is not a disk hit
+            VERIFY_SUCCEEDED(spCache->Translate(bstrShader, GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_10, &spShader));
+            VERIFY_ARE_EQUAL(1U, spCache->GetDiskHitCount());
+        }
+
+        // A file written by a different version of the translator is not a disk
+        // hit, and the translation that replaces it is
+        const UINT uOtherOutputVersion = GLSLTranslatorOutputVersion + 1;
+        OverwriteCacheFiles(spszDirectory, 8, reinterpret_cast<const BYTE*>(&uOtherOutputVersion), sizeof(uOtherOutputVersion));
+
+        {
+            TSmartPointer<CGLSLTranslationCache> spCache;
+            VERIFY_SUCCEEDED(RefCounted<CGLSLTranslationCache>::Create(1024 * 1024, static_cast<const WCHAR*>(spszDirectory), /*out*/spCache));
+
+            TSmartPointer<CGLSLConvertedShader> spShader;
+            VERIFY_SUCCEEDED(spCache->Translate(bstrShader, GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spShader));
+            VERIFY_ARE_EQUAL(0U, spCache->GetDiskHitCount());
+        }
+
+        {
+            TSmartPointer<CGLSLTranslationCache> spCache;
+            VERIFY_SUCCEEDED(RefCounted<CGLSLTranslationCache>::Create(1024 * 1024, static_cast<const WCHAR*>(spszDirectory), /*out*/spCache));
+
+            TSmartPointer<CGLSLConvertedShader> spShader;
+            VERIFY_SUCCEEDED(spCache->Translate(bstrShader, GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spShader));
+            VERIFY_ARE_EQUAL(1U, spCache->GetDiskHitCount());
+        }
+
+        // Corrupt the serialized shader in every file in the directory, past the
+        // file header and the source
+        const BYTE rgGarbage[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+        OverwriteCacheFiles(spszDirectory, 40 + ::SysStringLen(bstrShader) * sizeof(WCHAR) + 4, rgGarbage, sizeof(rgGarbage));
+
+        {
+            TSmartPointer<CGLSLTranslationCache> spCache;
+            VERIFY_SUCCEEDED(RefCounted<CGLSLTranslationCache>::Create(1024 * 1024, static_cast<const WCHAR*>(spszDirectory), /*out*/spCache));
+
+            TSmartPointer<CGLSLConvertedShader> spShader;
+            VERIFY_SUCCEEDED(spCache->Translate(bstrShader, GLSLShaderType::Vertex, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spShader));
+            VERIFY_IS_TRUE(spShader->TranslationSucceeded());
+            VERIFY_ARE_EQUAL(0U, spCache->GetDiskHitCount());
+        }
+
+        // Clean up the directory
+        CMutableString<WCHAR> spszPattern;
+        VERIFY_SUCCEEDED(spszPattern.Format(MAX_PATH, L"%s\\*.glslc", static_cast<const WCHAR*>(spszDirectory)));
+
+        WIN32_FIND_DATAW findData;
+        HANDLE hFind = ::FindFirstFileW(spszPattern, &findData);
+        if (hFind != INVALID_HANDLE_VALUE)
+        {
+            do
+            {
+                CMutableString<WCHAR> spszFile;
+                VERIFY_SUCCEEDED(spszFile.Format(MAX_PATH, L"%s\\%s", static_cast<const WCHAR*>(spszDirectory), findData.cFileName));
+                ::DeleteFileW(spszFile);
+            } while (::FindNextFileW(hFind, &findData));
+            ::FindClose(hFind);
+        }
+
+        ::RemoveDirectoryW(spszDirectory);
+    }
+} /* namespace ft_glslparse */
@@ -0,0 +1,145 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+
+//  Class:      TranslationStatsTests
+//  Synopsis:   Defines tests for the stats gathered about a translation
+
+#include "headers.hxx"
+#include "TranslationStatsTests.hxx"
+#include "GLSLTranslate.hxx"
+#include "GLSLTranslateOptions.hxx"
+#include "GLSLConvertedShader.hxx"
+#include "GLSLTranslationStats.hxx"
+#include "GLSLSymbolTable.hxx"
+#include "MemoryStream.hxx"
+#include "WebGLFeatureLevel.hxx"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace ft_glslparse
+{
+    static const WCHAR s_wzStatsShader[] =
+        L"precision mediump float;\n"
+        L"#define SCALE 2.0\n"
+        L"#define TINT(c) ((c) * SCALE)\n"
+        L"uniform vec4 u;\n"
+        L"void main() {\n"
+        L"    gl_FragColor = TINT(u);\n"
+        L"}\n";
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   DisabledTests
+    //
+    //  Synopsis:   No stats are gathered unless they are asked for.
+    //
+    //-----------------------------------------------------------------------------
+    void TranslationStatsTests::DisabledTests()
+    {
+        CSmartBstr bstrShader;
+        bstrShader.Set(s_wzStatsShader);
+
+        TSmartPointer<CGLSLConvertedShader> spConvertedShader;
+        VERIFY_SUCCEEDED(::GLSLTranslate(bstrShader, GLSLShaderType::Fragment, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1, &spConvertedShader));
+        VERIFY_IS_TRUE(spConvertedShader->TranslationSucceeded());
+        VERIFY_IS_NULL(spConvertedShader->UseStats());
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   EnabledTests
+    //
+    //  Synopsis:   The sizes and counts gathered with GLSLTranslateOptions::
+    //              EnableStats match the translation. Timings depend on the
+    //              machine, so they are only logged.
+    //
+    //-----------------------------------------------------------------------------
+    void TranslationStatsTests::EnabledTests()
+    {
+        CSmartBstr bstrShader;
+        bstrShader.Set(s_wzStatsShader);
+
+        TSmartPointer<CGLSLConvertedShader> spConvertedShader;
+        VERIFY_SUCCEEDED(::GLSLTranslate(bstrShader, GLSLShaderType::Fragment, GLSLTranslateOptions::EnableStats, WebGLFeatureLevel::Level_9_1, &spConvertedShader));
+        VERIFY_IS_TRUE(spConvertedShader->TranslationSucceeded());
+
+        const CGLSLTranslationStats* pStats = spConvertedShader->UseStats();
+        VERIFY_IS_NOT_NULL(pStats);
+
+        // The converted input gets a newline added to the end
+        VERIFY_ARE_EQUAL(static_cast<UINT>(ARRAYSIZE(s_wzStatsShader)), pStats->GetInputSize());
+
+        // TINT and the SCALE inside of it
+        VERIFY_ARE_EQUAL(2U, pStats->GetMacroExpansionCount());
+        VERIFY_IS_TRUE(pStats->GetPreprocessedSize() > 0);
+
+        UINT uConvertedSize;
+        VERIFY_SUCCEEDED(spConvertedShader->UseConvertedStream()->GetSize(&uConvertedSize));
+        VERIFY_ARE_EQUAL(uConvertedSize, pStats->GetOutputSize());
+
+        // The per type node counts add up to the whole tree, which has one root
+        VERIFY_ARE_EQUAL(1U, pStats->GetNodeCount(ParseNodeType::translationUnit));
+        VERIFY_IS_TRUE(pStats->GetNodeCount(ParseNodeType::functionDefinition) >= 1);
+
+        UINT uNodeCount = 0;
+        for (UINT i = 0; i < ParseNodeType::count; i++)
+        {
+            uNodeCount += pStats->GetNodeCount(static_cast<ParseNodeType::Enum>(i));
+        }
+        VERIFY_ARE_EQUAL(uNodeCount, pStats->GetTotalNodeCount());
+
+        // The symbol table is layered on the known symbols
+        VERIFY_IS_TRUE(pStats->GetSymbolCount() >= static_cast<UINT>(GLSLSymbols::count));
+
+        // The tree is allocated from the arena
+        VERIFY_IS_TRUE(pStats->GetArenaAllocationCount() >= pStats->GetTotalNodeCount());
+        VERIFY_IS_TRUE(pStats->GetArenaChunkCount() > 0);
+        VERIFY_IS_TRUE(pStats->GetArenaBytesAllocated() > 0);
+
+        UINT64 ullPhaseTotal = 0;
+        for (UINT i = 0; i < GLSLTranslationPhase::count; i++)
+        {
+            ullPhaseTotal += pStats->GetPhaseMicroseconds(static_cast<GLSLTranslationPhase::Enum>(i));
+        }
+        VERIFY_ARE_EQUAL(ullPhaseTotal, pStats->GetTotalMicroseconds());
+
+        CMutableString<WCHAR> strResult;
+        VERIFY_SUCCEEDED(strResult.Format(
+            256,
+            L"Preprocess %I64uus, parse %I64uus, verify %I64uus, output %I64uus, %u nodes, %u arena allocations",
+            pStats->GetPhaseMicroseconds(GLSLTranslationPhase::Preprocess),
+            pStats->GetPhaseMicroseconds(GLSLTranslationPhase::Parse),
+            pStats->GetPhaseMicroseconds(GLSLTranslationPhase::Verify),
+            pStats->GetPhaseMicroseconds(GLSLTranslationPhase::Output),
+            pStats->GetTotalNodeCount(),
+            pStats->GetArenaAllocationCount()
+            ));
+        Log::Comment(strResult);
+    }
+} /* namespace ft_glslparse */
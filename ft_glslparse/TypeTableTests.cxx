@@ -0,0 +1,209 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+
+//  Class:      TypeTableTests
+//  Synopsis:   Defines tests for the table of shared GLSL types
+
+#include "headers.hxx"
+#include "TypeTableTests.hxx"
+#include "GLSLTypeTable.hxx"
+#include "GLSLParser.hxx"
+#include "GLSLTranslateOptions.hxx"
+#include "WebGLFeatureLevel.hxx"
+#include "RefCounted.hxx"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace ft_glslparse
+{
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   BasicTypeTests
+    //
+    //  Synopsis:   Each basic type token has one shared type, whether or not a
+    //              type table is current.
+    //
+    //-----------------------------------------------------------------------------
+    void TypeTableTests::BasicTypeTests()
+    {
+        TSmartPointer<GLSLType> spFirst;
+        TSmartPointer<GLSLType> spSecond;
+        VERIFY_SUCCEEDED(GLSLType::CreateFromBasicTypeToken(VEC4, &spFirst));
+        VERIFY_SUCCEEDED(GLSLType::CreateFromBasicTypeToken(VEC4, &spSecond));
+        VERIFY_ARE_EQUAL(static_cast<GLSLType*>(spFirst), static_cast<GLSLType*>(spSecond));
+        VERIFY_IS_TRUE(spFirst->IsEqualType(spSecond));
+
+        int basicType;
+        VERIFY_SUCCEEDED(spFirst->GetBasicType(&basicType));
+        VERIFY_ARE_EQUAL(VEC4, basicType);
+
+        TSmartPointer<GLSLType> spOther;
+        VERIFY_SUCCEEDED(GLSLType::CreateFromBasicTypeToken(VEC3, &spOther));
+        VERIFY_IS_FALSE(spFirst->IsEqualType(spOther));
+
+        // Tokens that are only used in built in function signatures have types too
+        VERIFY_SUCCEEDED(GLSLType::CreateFromBasicTypeToken(GENTYPE, &spOther));
+
+        // Releasing every reference does not destroy a basic type
+        spFirst.Release();
+        spSecond.Release();
+        VERIFY_SUCCEEDED(GLSLType::CreateFromBasicTypeToken(VEC4, &spFirst));
+        VERIFY_SUCCEEDED(spFirst->GetBasicType(&basicType));
+        VERIFY_ARE_EQUAL(VEC4, basicType);
+
+        // The table lives outside of any translation, so asking for a basic type
+        // only counts the request
+        TSmartPointer<CGLSLTypeTable> spTypeTable;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLTypeTable>::Create(/*out*/spTypeTable));
+        {
+            CGLSLTypeTableScope scope(spTypeTable);
+            VERIFY_SUCCEEDED(GLSLType::CreateFromBasicTypeToken(VEC4, &spSecond));
+        }
+
+        VERIFY_ARE_EQUAL(static_cast<GLSLType*>(spFirst), static_cast<GLSLType*>(spSecond));
+        VERIFY_ARE_EQUAL(1U, spTypeTable->GetRequestCount());
+        VERIFY_ARE_EQUAL(0U, spTypeTable->GetArrayTypeCount());
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   ArrayTypeTests
+    //
+    //  Synopsis:   Array types are shared through the current type table, and
+    //              still compare equal to array types created without one.
+    //
+    //-----------------------------------------------------------------------------
+    void TypeTableTests::ArrayTypeTests()
+    {
+        TSmartPointer<GLSLType> spVec4;
+        VERIFY_SUCCEEDED(GLSLType::CreateFromBasicTypeToken(VEC4, &spVec4));
+        TSmartPointer<GLSLType> spFloat;
+        VERIFY_SUCCEEDED(GLSLType::CreateFromBasicTypeToken(FLOAT_TOK, &spFloat));
+
+        TSmartPointer<CGLSLTypeTable> spTypeTable;
+        VERIFY_SUCCEEDED(RefCounted<CGLSLTypeTable>::Create(/*out*/spTypeTable));
+
+        TSmartPointer<GLSLType> spFirst;
+        TSmartPointer<GLSLType> spSecond;
+        TSmartPointer<GLSLType> spOtherSize;
+        TSmartPointer<GLSLType> spOtherElement;
+        {
+            CGLSLTypeTableScope scope(spTypeTable);
+
+            VERIFY_SUCCEEDED(GLSLType::CreateFromType(spVec4, 4, &spFirst));
+            VERIFY_SUCCEEDED(GLSLType::CreateFromType(spVec4, 4, &spSecond));
+            VERIFY_SUCCEEDED(GLSLType::CreateFromType(spVec4, 5, &spOtherSize));
+            VERIFY_SUCCEEDED(GLSLType::CreateFromType(spFloat, 4, &spOtherElement));
+
+            // Enough array types to make the table grow its buckets
+            for (int i = 1; i <= 64; i++)
+            {
+                TSmartPointer<GLSLType> spArrayType;
+                VERIFY_SUCCEEDED(GLSLType::CreateFromType(spFloat, i, &spArrayType));
+            }
+
+            // Everything is still found after growing
+            TSmartPointer<GLSLType> spAfterGrowth;
+            VERIFY_SUCCEEDED(GLSLType::CreateFromType(spVec4, 4, &spAfterGrowth));
+            VERIFY_ARE_EQUAL(static_cast<GLSLType*>(spFirst), static_cast<GLSLType*>(spAfterGrowth));
+        }
+
+        VERIFY_ARE_EQUAL(static_cast<GLSLType*>(spFirst), static_cast<GLSLType*>(spSecond));
+        VERIFY_ARE_NOT_EQUAL(static_cast<GLSLType*>(spFirst), static_cast<GLSLType*>(spOtherSize));
+        VERIFY_ARE_NOT_EQUAL(static_cast<GLSLType*>(spFirst), static_cast<GLSLType*>(spOtherElement));
+        VERIFY_IS_FALSE(spFirst->IsEqualType(spOtherSize));
+        VERIFY_IS_FALSE(spFirst->IsEqualType(spOtherElement));
+
+        // vec4[4], vec4[5] and float[1] to float[64]
+        VERIFY_ARE_EQUAL(66U, spTypeTable->GetArrayTypeCount());
+        VERIFY_ARE_EQUAL(70U, spTypeTable->GetRequestCount());
+
+        // Without a current table each array type is a new object, but it is
+        // still equal to the shared one
+        TSmartPointer<GLSLType> spUnshared;
+        VERIFY_SUCCEEDED(GLSLType::CreateFromType(spVec4, 4, &spUnshared));
+        VERIFY_ARE_NOT_EQUAL(static_cast<GLSLType*>(spFirst), static_cast<GLSLType*>(spUnshared));
+        VERIFY_IS_TRUE(spFirst->IsEqualType(spUnshared));
+        VERIFY_IS_TRUE(spUnshared->IsEqualType(spFirst));
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   AllocationBenchmark
+    //
+    //  Synopsis:   Translates a shader and logs how many types were asked for,
+    //              each of which used to be a new allocation, against how many
+    //              type objects the translation actually allocated.
+    //
+    //-----------------------------------------------------------------------------
+    void TypeTableTests::AllocationBenchmark()
+    {
+        CSmartBstr bstrShader;
+        bstrShader.Set(
+            L"precision mediump float;\n"
+            L"struct Light { vec3 dir; vec3 color; };\n"
+            L"uniform Light lights[4];\n"
+            L"uniform float weights[4];\n"
+            L"varying vec3 normal;\n"
+            L"varying vec2 uv;\n"
+            L"uniform sampler2D tex;\n"
+            L"vec3 shade(vec3 n, Light l) { return l.color * max(dot(n, l.dir), 0.0); }\n"
+            L"void main() {\n"
+            L"    vec3 n = normalize(normal);\n"
+            L"    vec3 sum = vec3(0.0);\n"
+            L"    for (int i = 0; i < 4; i++) { sum += shade(n, lights[i]) * weights[i]; }\n"
+            L"    vec4 texel = texture2D(tex, uv);\n"
+            L"    gl_FragColor = vec4(sum * texel.rgb, texel.a);\n"
+            L"}\n"
+            );
+
+        CGLSLParser parser;
+        VERIFY_SUCCEEDED(parser.Initialize(bstrShader, GLSLShaderType::Fragment, GLSLTranslateOptions::None, WebGLFeatureLevel::Level_9_1));
+
+        TSmartPointer<CGLSLConvertedShader> spConvertedShader;
+        VERIFY_SUCCEEDED(parser.Translate(&spConvertedShader));
+        VERIFY_IS_TRUE(spConvertedShader->TranslationSucceeded());
+
+        const CGLSLTypeTable* pTypeTable = parser.UseTypeTable();
+
+        CMutableString<WCHAR> spszComment;
+        VERIFY_SUCCEEDED(spszComment.Format(
+            128,
+            L"Types asked for: %u, type objects allocated: %u",
+            pTypeTable->GetRequestCount(),
+            pTypeTable->GetArrayTypeCount()
+            ));
+        Log::Comment(spszComment);
+
+        // Only array types need objects of their own, and the uniform arrays are
+        // among them
+        VERIFY_IS_TRUE(pTypeTable->GetArrayTypeCount() >= 2);
+        VERIFY_IS_TRUE(pTypeTable->GetRequestCount() > pTypeTable->GetArrayTypeCount());
+    }
+} /* namespace ft_glslparse */
@@ -0,0 +1,148 @@
+//--------------------------------------------------------------
+//
+// Microsoft Edge Implementation
+// Copyright(c) Microsoft Corporation
+// All rights reserved.
+//
+// MIT License
+//
+// Permission is hereby granted, free of charge, to any person obtaining
+// a copy of this software and associated documentation files(the ""Software""),
+// to deal in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and / or sell copies
+// of the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions :
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED *AS IS*, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS
+// OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+// WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF
+// OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+//--------------------------------------------------------------
+
+//  Class:      UnicodeConverterTests
+//  Synopsis:   Defines tests for converting shader text from UTF-16 to ASCII
+
+#include "headers.hxx"
+#include "UnicodeConverterTests.hxx"
+#include "GLSLUnicodeConverter.hxx"
+#include "MemoryStream.hxx"
+
+using namespace WEX::Common;
+using namespace WEX::Logging;
+using namespace WEX::TestExecution;
+
+namespace ft_glslparse
+{
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   EquivalenceTests
+    //
+    //  Synopsis:   The vectorized conversion must give the same result as the
+    //              table driven one for every UTF-16 code unit, at every
+    //              alignment and for lengths that do and do not fill a vector.
+    //
+    //-----------------------------------------------------------------------------
+    void UnicodeConverterTests::EquivalenceTests()
+    {
+        const UINT uCodeUnits = 0x10000;
+        const UINT uMaxOffset = 16;
+
+        TSmartArray<wchar_t> spInput;
+        VERIFY_SUCCEEDED(spInput.New(uCodeUnits + uMaxOffset));
+        for (UINT i = 0; i < uCodeUnits + uMaxOffset; i++)
+        {
+            spInput[i] = static_cast<wchar_t>(i);
+        }
+
+        TSmartArray<char> spExpected;
+        TSmartArray<char> spActual;
+        VERIFY_SUCCEEDED(spExpected.New(uCodeUnits + uMaxOffset));
+        VERIFY_SUCCEEDED(spActual.New(uCodeUnits + uMaxOffset));
+
+        for (UINT uOffset = 0; uOffset < uMaxOffset; uOffset++)
+        {
+            CGLSLUnicodeConverter::NarrowToAsciiScalar(spInput.GetOffsetPointer(uOffset), uCodeUnits, spExpected);
+            CGLSLUnicodeConverter::NarrowToAscii(spInput.GetOffsetPointer(uOffset), uCodeUnits, spActual);
+            VERIFY_ARE_EQUAL(0, ::memcmp(spExpected, spActual, uCodeUnits));
+        }
+
+        for (UINT uLength = 0; uLength <= 48; uLength++)
+        {
+            CGLSLUnicodeConverter::NarrowToAsciiScalar(spInput, uLength, spExpected);
+            CGLSLUnicodeConverter::NarrowToAscii(spInput, uLength, spActual);
+            VERIFY_ARE_EQUAL(0, ::memcmp(spExpected, spActual, uLength));
+        }
+
+        // Spot check the table itself through the full conversion
+        CSmartBstr bstrInput;
+        bstrInput.Set(L"void main() { gl_FragColor = vec4(1.0); } // \"$'@\\`\x7f\x80\xffff");
+
+        TSmartPointer<CMemoryStream> spConvertedStream;
+        VERIFY_SUCCEEDED(CGLSLUnicodeConverter::ConvertToAscii(bstrInput, &spConvertedStream));
+
+        CMutableString<char> spConverted;
+        VERIFY_SUCCEEDED(spConvertedStream->ExtractString(spConverted));
+        VERIFY_ARE_EQUAL(::strcmp(spConverted, "void main() { gl_FragColor = vec4(1.0); } // $$$$$$$$$\n"), 0);
+    }
+
+    //+----------------------------------------------------------------------------
+    //
+    //  Function:   ConversionThroughputTests
+    //
+    //  Synopsis:   Log the throughput of the vectorized and table driven
+    //              conversions over a maximum size shader.
+    //
+    //-----------------------------------------------------------------------------
+    void UnicodeConverterTests::ConversionThroughputTests()
+    {
+        const wchar_t szLine[] = L"    gl_FragColor = texture2D(uSampler, vec2(vTextureCoord.s, vTextureCoord.t)) * 0.5;\n";
+        const UINT uLineLength = ARRAYSIZE(szLine) - 1;
+        const UINT uLength = 128 * 1024;
+        const UINT uIterations = 100;
+
+        TSmartArray<wchar_t> spInput;
+        TSmartArray<char> spOutput;
+        VERIFY_SUCCEEDED(spInput.New(uLength));
+        VERIFY_SUCCEEDED(spOutput.New(uLength));
+        for (UINT i = 0; i < uLength; i++)
+        {
+            spInput[i] = szLine[i % uLineLength];
+        }
+
+        LARGE_INTEGER liFrequency;
+        ::QueryPerformanceFrequency(&liFrequency);
+
+        for (int pass = 0; pass < 2; pass++)
+        {
+            LARGE_INTEGER liStart;
+            LARGE_INTEGER liEnd;
+            ::QueryPerformanceCounter(&liStart);
+
+            for (UINT i = 0; i < uIterations; i++)
+            {
+                if (pass == 0)
+                {
+                    CGLSLUnicodeConverter::NarrowToAsciiScalar(spInput, uLength, spOutput);
+                }
+                else
+                {
+                    CGLSLUnicodeConverter::NarrowToAscii(spInput, uLength, spOutput);
+                }
+            }
+
+            ::QueryPerformanceCounter(&liEnd);
+
+            double seconds = static_cast<double>(liEnd.QuadPart - liStart.QuadPart) / static_cast<double>(liFrequency.QuadPart);
+            double megabytes = static_cast<double>(uLength) * uIterations * sizeof(wchar_t) / (1024.0 * 1024.0);
+            Log::Comment(String().Format(L"%s conversion: %.1f MB/s", (pass == 0) ? L"Scalar" : L"Vector", megabytes / seconds));
+        }
+
+        VERIFY_ARE_EQUAL(0, ::memcmp(spOutput, "    gl_FragColor", 16));
+    }
+} /* namespace ft_glslparse */